@@ -0,0 +1,160 @@
+#include "benchmarks.hpp"
+
+#include <boost/filesystem.hpp>
+
+using namespace shopschedulingsolver;
+
+namespace fs = boost::filesystem;
+
+Instance shopschedulingsolver::generate_pfss_instance(
+        JobId number_of_jobs,
+        MachineId number_of_machines,
+        Objective objective,
+        bool blocking,
+        Seed seed)
+{
+    std::mt19937_64 generator(seed);
+    GenerateInput input;
+    input.objective = objective;
+    input.blocking = blocking;
+    input.flow_shop = true;
+    input.permutation = true;
+    input.number_of_machine_groups = number_of_machines;
+    input.number_of_machines_per_group = 1;
+    input.number_of_jobs = number_of_jobs;
+    input.number_of_operations_per_job = number_of_machines;
+    input.processing_times_range = 99;
+    return generate(input, generator);
+}
+
+std::vector<JobId> shopschedulingsolver::random_permutation(
+        const Instance& instance,
+        std::mt19937_64& generator)
+{
+    std::vector<JobId> job_ids(instance.number_of_jobs());
+    std::iota(job_ids.begin(), job_ids.end(), 0);
+    std::shuffle(job_ids.begin(), job_ids.end(), generator);
+    return job_ids;
+}
+
+Solution shopschedulingsolver::solution_from_permutation(
+        const Instance& instance,
+        const std::vector<JobId>& job_ids)
+{
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.from_permutation(job_ids);
+    return solution_builder.build();
+}
+
+void shopschedulingsolver::write_instance(
+        const Instance& instance,
+        const std::string& instance_path,
+        const std::string& format)
+{
+    if (format == "" || format == "json") {
+        instance.write(instance_path, "json");
+        return;
+    }
+
+    std::ofstream file{instance_path};
+    if (!file.good()) {
+        throw std::runtime_error(
+                FUNC_SIGNATURE + ": "
+                "unable to open file \"" + instance_path + "\".");
+    }
+
+    auto processing_time = [&instance](JobId job_id, OperationId operation_id)
+    {
+        return instance.job(job_id).operations[operation_id].alternatives[0].processing_time;
+    };
+
+    if (format == "flexible-job-shop") {
+        // The third value is the average number of machines per operation.
+        file << instance.number_of_jobs() << " " << instance.number_of_machines() << " 1\n";
+    } else {
+        file << instance.number_of_jobs() << " " << instance.number_of_machines() << "\n";
+    }
+    if (format == "flow-shop" || format == "flow-shop-jobcol") {
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+                file << processing_time(job_id, machine_id) << " ";
+            file << "\n";
+        }
+    } else if (format == "flow-shop-jobrow") {
+        for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                file << processing_time(job_id, machine_id) << " ";
+            }
+            file << "\n";
+        }
+    } else if (format == "flow-shop-vallada2008" || format == "vallada2008") {
+        for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                file << machine_id << " " << processing_time(job_id, machine_id) << " ";
+            }
+            file << "\n";
+        }
+        file << "Reldue\n";
+        for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+            file << "-1 " << instance.job(job_id).due_date << " -1 -1\n";
+    } else if (format == "job-shop") {
+        for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+            const Job& job = instance.job(job_id);
+            for (OperationId operation_id = 0;
+                    operation_id < (OperationId)job.operations.size();
+                    ++operation_id) {
+                const Alternative& alternative = job.operations[operation_id].alternatives[0];
+                file << alternative.machine_id << " " << alternative.processing_time << " ";
+            }
+            file << "\n";
+        }
+    } else if (format == "flexible-job-shop") {
+        for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+            const Job& job = instance.job(job_id);
+            file << job.operations.size();
+            for (const Operation& operation: job.operations) {
+                file << " " << operation.alternatives.size();
+                for (const Alternative& alternative: operation.alternatives)
+                    file << " " << alternative.machine_id + 1 << " " << alternative.processing_time;
+            }
+            file << "\n";
+        }
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "unknown instance format \"" + format + "\".");
+    }
+}
+
+std::string shopschedulingsolver::get_temporary_path(const std::string& name)
+{
+    return (fs::temp_directory_path() / fs::path("shopschedulingsolver_benchmark_" + name)).string();
+}
+
+void shopschedulingsolver::pfss_sizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark
+        ->ArgNames({"n", "m"})
+        ->Args({20, 5})
+        ->Args({50, 10})
+        ->Args({100, 20})
+        ->Args({200, 20})
+        ->Args({500, 20});
+}
+
+void shopschedulingsolver::milp_sizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark
+        ->ArgNames({"n", "m"})
+        ->Args({10, 5})
+        ->Args({20, 5})
+        ->Args({50, 10})
+        ->Args({100, 20});
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "shopschedulingsolver/generator.hpp"
+#include "shopschedulingsolver/solution_builder.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace shopschedulingsolver
+{
+
+/**
+ * Generate a permutation flow shop instance with n jobs and m machines.
+ */
+Instance generate_pfss_instance(
+        JobId number_of_jobs,
+        MachineId number_of_machines,
+        Objective objective = Objective::Makespan,
+        bool blocking = false,
+        Seed seed = 0);
+
+/** Generate a random permutation of the jobs of an instance. */
+std::vector<JobId> random_permutation(
+        const Instance& instance,
+        std::mt19937_64& generator);
+
+/** Build the solution corresponding to a permutation. */
+Solution solution_from_permutation(
+        const Instance& instance,
+        const std::vector<JobId>& job_ids);
+
+/**
+ * Write an instance in one of the formats supported by InstanceBuilder::read.
+ */
+void write_instance(
+        const Instance& instance,
+        const std::string& instance_path,
+        const std::string& format);
+
+/** Get a temporary path for a benchmark file. */
+std::string get_temporary_path(const std::string& name);
+
+/** Register the n x m sizes used by the permutation flow shop benchmarks. */
+void pfss_sizes(benchmark::internal::Benchmark* benchmark);
+
+/** Register the n x m sizes used by the MILP model benchmarks. */
+void milp_sizes(benchmark::internal::Benchmark* benchmark);
+
+}
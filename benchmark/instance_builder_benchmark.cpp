@@ -0,0 +1,44 @@
+#include "benchmarks.hpp"
+
+#include "shopschedulingsolver/instance_builder.hpp"
+
+#include <cstdio>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+void instance_builder_read(
+        benchmark::State& state,
+        const std::string& format)
+{
+    JobId number_of_jobs = state.range(0);
+    MachineId number_of_machines = state.range(1);
+    const Instance instance = generate_pfss_instance(
+            number_of_jobs,
+            number_of_machines);
+    std::string instance_path = get_temporary_path(
+            format
+            + "_" + std::to_string(number_of_jobs)
+            + "_" + std::to_string(number_of_machines));
+    write_instance(instance, instance_path, format);
+
+    for (auto _: state) {
+        InstanceBuilder instance_builder;
+        instance_builder.read(instance_path, format);
+        Instance instance_read = instance_builder.build();
+        benchmark::DoNotOptimize(instance_read);
+    }
+
+    std::remove(instance_path.c_str());
+}
+
+}
+
+BENCHMARK_CAPTURE(instance_builder_read, json, std::string("json"))->Apply(pfss_sizes);
+BENCHMARK_CAPTURE(instance_builder_read, flow_shop_jobcol, std::string("flow-shop-jobcol"))->Apply(pfss_sizes);
+BENCHMARK_CAPTURE(instance_builder_read, flow_shop_jobrow, std::string("flow-shop-jobrow"))->Apply(pfss_sizes);
+BENCHMARK_CAPTURE(instance_builder_read, vallada2008, std::string("vallada2008"))->Apply(pfss_sizes);
+BENCHMARK_CAPTURE(instance_builder_read, job_shop, std::string("job-shop"))->Apply(pfss_sizes);
+BENCHMARK_CAPTURE(instance_builder_read, flexible_job_shop, std::string("flexible-job-shop"))->Apply(pfss_sizes);
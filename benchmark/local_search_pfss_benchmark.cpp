@@ -0,0 +1,131 @@
+// The kernels of the local search are internal to its translation unit, so
+// it is included directly. This target must not link against
+// ShopSchedulingSolver_local_search_pfss.
+#include "algorithms/local_search_pfss.cpp"
+
+#include "benchmarks.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+template <bool Blocking, typename TimeType>
+LocalSearchData<TimeType> create_data(
+        const Instance& instance,
+        std::mt19937_64& generator)
+{
+    LocalSearchData<TimeType> data;
+    initialize_data(instance, data);
+    load_solution<Blocking>(
+            data,
+            instance,
+            solution_from_permutation(instance, random_permutation(instance, generator)));
+    return data;
+}
+
+template <bool Blocking, typename TimeType>
+void local_search_pfss_add_job_at_best_position(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::TotalFlowTime,
+            Blocking);
+    std::mt19937_64 generator(0);
+    LocalSearchPfssParameters parameters;
+    LocalSearchData<TimeType> data = create_data<Blocking, TimeType>(instance, generator);
+    JobId job_id = data.solution.jobs.back();
+    remove_job<Blocking>(instance, data, data.solution.jobs.size() - 1);
+    data.solution.jobs_positions[job_id] = -1;
+    const LocalSearchData<TimeType> data_init = data;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        data = data_init;
+        state.ResumeTiming();
+        add_job_at_best_position<Blocking>(instance, parameters, generator, data, job_id);
+    }
+}
+
+template <bool Blocking, typename TimeType>
+void local_search_pfss_shift_neighborhood(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::TotalFlowTime,
+            Blocking);
+    std::mt19937_64 generator(0);
+    const LocalSearchData<TimeType> data_init = create_data<Blocking, TimeType>(instance, generator);
+    LocalSearchData<TimeType> data;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        data = data_init;
+        state.ResumeTiming();
+        bool improved = explore_shift_neighborhood<Blocking>(instance, data, generator, 1);
+        benchmark::DoNotOptimize(improved);
+    }
+}
+
+template <bool Blocking, typename TimeType>
+void local_search_pfss_shift_neighborhood_multi_lane(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::TotalFlowTime,
+            Blocking);
+    std::mt19937_64 generator(0);
+    const LocalSearchData<TimeType> data_init = create_data<Blocking, TimeType>(instance, generator);
+    LocalSearchData<TimeType> data;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        data = data_init;
+        state.ResumeTiming();
+        bool improved = explore_shift_neighborhood_multi_lane<Blocking>(instance, data, generator, 1);
+        benchmark::DoNotOptimize(improved);
+    }
+}
+
+template <bool Blocking, typename TimeType>
+void local_search_pfss_swap_neighborhood(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::TotalFlowTime,
+            Blocking);
+    std::mt19937_64 generator(0);
+    const LocalSearchData<TimeType> data_init = create_data<Blocking, TimeType>(instance, generator);
+    LocalSearchData<TimeType> data;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        data = data_init;
+        state.ResumeTiming();
+        bool improved = explore_swap_neighborhood<Blocking>(instance, data, generator, 1, 1);
+        benchmark::DoNotOptimize(improved);
+    }
+}
+
+}
+
+BENCHMARK_TEMPLATE(local_search_pfss_add_job_at_best_position, false, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_add_job_at_best_position, false, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_add_job_at_best_position, true, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_add_job_at_best_position, true, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_shift_neighborhood, false, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_shift_neighborhood, false, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_shift_neighborhood, true, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_shift_neighborhood, true, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_shift_neighborhood_multi_lane, false, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_shift_neighborhood_multi_lane, false, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_shift_neighborhood_multi_lane, true, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_shift_neighborhood_multi_lane, true, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_swap_neighborhood, false, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_swap_neighborhood, false, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_swap_neighborhood, true, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_swap_neighborhood, true, int32_t)->Apply(pfss_sizes);
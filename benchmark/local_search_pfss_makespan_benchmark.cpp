@@ -0,0 +1,130 @@
+// The kernels of the local search are internal to its translation unit, so
+// it is included directly. This target must not link against
+// ShopSchedulingSolver_local_search_pfss_makespan.
+#include "algorithms/local_search_pfss_makespan.cpp"
+
+#include "benchmarks.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+template <typename TimeType>
+LocalSearchData<TimeType> create_data(
+        const Instance& instance,
+        std::mt19937_64& generator)
+{
+    LocalSearchData<TimeType> data;
+    initialize_data(instance, data);
+    load_solution(
+            data,
+            solution_from_permutation(instance, random_permutation(instance, generator)));
+    return data;
+}
+
+template <bool Blocking, typename TimeType>
+void local_search_pfss_makespan_add_job_at_best_position(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::Makespan,
+            Blocking);
+    std::mt19937_64 generator(0);
+    LocalSearchParameters parameters;
+    LocalSearchData<TimeType> data = create_data<TimeType>(instance, generator);
+    JobId job_id = data.solution.jobs.back();
+    remove_job(instance, data, data.solution.jobs.size() - 1);
+    data.solution.jobs_positions[job_id] = -1;
+    const LocalSearchData<TimeType> data_init = data;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        data = data_init;
+        state.ResumeTiming();
+        add_job_at_best_position(instance, parameters, generator, data, job_id);
+    }
+}
+
+template <bool Blocking, typename TimeType>
+void local_search_pfss_makespan_shift_job_neighborhood(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::Makespan,
+            Blocking);
+    std::mt19937_64 generator(0);
+    const LocalSearchData<TimeType> data_init = create_data<TimeType>(instance, generator);
+    LocalSearchData<TimeType> data;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        data = data_init;
+        state.ResumeTiming();
+        bool improved = explore_shift_job_neighborhood(instance, data, generator);
+        benchmark::DoNotOptimize(improved);
+    }
+}
+
+template <bool Blocking, typename TimeType>
+void local_search_pfss_makespan_shift_block_neighborhood(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::Makespan,
+            Blocking);
+    std::mt19937_64 generator(0);
+    const LocalSearchData<TimeType> data_init = create_data<TimeType>(instance, generator);
+    LocalSearchData<TimeType> data;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        data = data_init;
+        state.ResumeTiming();
+        bool improved = explore_shift_block_neighborhood(instance, data, generator, 2);
+        benchmark::DoNotOptimize(improved);
+    }
+}
+
+template <bool Blocking, typename TimeType>
+void local_search_pfss_makespan_swap_neighborhood(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::Makespan,
+            Blocking);
+    std::mt19937_64 generator(0);
+    const LocalSearchData<TimeType> data_init = create_data<TimeType>(instance, generator);
+    LocalSearchData<TimeType> data;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        data = data_init;
+        state.ResumeTiming();
+        bool improved = explore_swap_neighborhood(instance, data, generator);
+        benchmark::DoNotOptimize(improved);
+    }
+}
+
+}
+
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_add_job_at_best_position, false, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_add_job_at_best_position, false, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_add_job_at_best_position, true, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_add_job_at_best_position, true, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_shift_job_neighborhood, false, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_shift_job_neighborhood, false, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_shift_job_neighborhood, true, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_shift_job_neighborhood, true, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_shift_block_neighborhood, false, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_shift_block_neighborhood, false, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_shift_block_neighborhood, true, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_shift_block_neighborhood, true, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_swap_neighborhood, false, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_swap_neighborhood, false, int32_t)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_swap_neighborhood, true, Time)->Apply(pfss_sizes);
+BENCHMARK_TEMPLATE(local_search_pfss_makespan_swap_neighborhood, true, int32_t)->Apply(pfss_sizes);
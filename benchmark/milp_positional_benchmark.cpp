@@ -0,0 +1,32 @@
+// The model is internal to the translation unit of the algorithm, so it is
+// included directly. This target must not link against
+// ShopSchedulingSolver_milp_positional.
+#include "algorithms/milp_positional.cpp"
+
+#include "benchmarks.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+void milp_positional_create_milp_model(
+        benchmark::State& state,
+        Objective objective)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            objective);
+
+    for (auto _: state) {
+        Model model = create_milp_model(instance);
+        benchmark::DoNotOptimize(model);
+    }
+}
+
+}
+
+BENCHMARK_CAPTURE(milp_positional_create_milp_model, makespan, Objective::Makespan)->Apply(milp_sizes);
+BENCHMARK_CAPTURE(milp_positional_create_milp_model, tft, Objective::TotalFlowTime)->Apply(milp_sizes);
+BENCHMARK_CAPTURE(milp_positional_create_milp_model, tt, Objective::TotalTardiness)->Apply(milp_sizes);
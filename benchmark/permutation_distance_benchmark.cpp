@@ -0,0 +1,85 @@
+#include "shopschedulingsolver/permutation_distance.hpp"
+
+#include "benchmarks.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+// Build two random permutations differing by a few random swaps, as two
+// solutions of a population typically do.
+std::pair<std::vector<JobId>, std::vector<JobId>> create_permutations(
+        const Instance& instance,
+        std::mt19937_64& generator)
+{
+    std::vector<JobId> job_ids_1 = random_permutation(instance, generator);
+    std::vector<JobId> job_ids_2 = job_ids_1;
+    std::uniform_int_distribution<JobId> distribution(0, instance.number_of_jobs() - 1);
+    for (JobId swap_id = 0; swap_id < instance.number_of_jobs() / 10; ++swap_id)
+        std::swap(job_ids_2[distribution(generator)], job_ids_2[distribution(generator)]);
+    return {job_ids_1, job_ids_2};
+}
+
+void permutation_distance_compute_adjacency(
+        benchmark::State& state,
+        Counter sketch_size)
+{
+    const Instance instance = generate_pfss_instance(state.range(0), 1);
+    std::mt19937_64 generator(0);
+    std::vector<JobId> job_ids = random_permutation(instance, generator);
+    PermutationAdjacency adjacency;
+
+    for (auto _: state) {
+        compute_permutation_adjacency(
+                job_ids,
+                instance.number_of_jobs(),
+                sketch_size,
+                adjacency);
+        benchmark::DoNotOptimize(adjacency);
+    }
+}
+
+void permutation_distance_exact(benchmark::State& state)
+{
+    const Instance instance = generate_pfss_instance(state.range(0), 1);
+    std::mt19937_64 generator(0);
+    auto job_ids = create_permutations(instance, generator);
+    PermutationAdjacency adjacency_1;
+    PermutationAdjacency adjacency_2;
+    compute_permutation_adjacency(job_ids.first, instance.number_of_jobs(), 0, adjacency_1);
+    compute_permutation_adjacency(job_ids.second, instance.number_of_jobs(), 0, adjacency_2);
+
+    for (auto _: state) {
+        Counter distance = permutation_distance(adjacency_1, adjacency_2);
+        benchmark::DoNotOptimize(distance);
+    }
+}
+
+void permutation_distance_estimate(
+        benchmark::State& state,
+        Counter sketch_size)
+{
+    const Instance instance = generate_pfss_instance(state.range(0), 1);
+    std::mt19937_64 generator(0);
+    auto job_ids = create_permutations(instance, generator);
+    PermutationAdjacency adjacency_1;
+    PermutationAdjacency adjacency_2;
+    compute_permutation_adjacency(job_ids.first, instance.number_of_jobs(), sketch_size, adjacency_1);
+    compute_permutation_adjacency(job_ids.second, instance.number_of_jobs(), sketch_size, adjacency_2);
+
+    for (auto _: state) {
+        Counter distance = permutation_distance_estimate(
+                adjacency_1,
+                adjacency_2,
+                instance.number_of_jobs());
+        benchmark::DoNotOptimize(distance);
+    }
+}
+
+}
+
+BENCHMARK_CAPTURE(permutation_distance_compute_adjacency, exact, 0)->Arg(100)->Arg(500)->Arg(1000);
+BENCHMARK_CAPTURE(permutation_distance_compute_adjacency, sketch_64, 64)->Arg(100)->Arg(500)->Arg(1000);
+BENCHMARK(permutation_distance_exact)->Arg(100)->Arg(500)->Arg(1000);
+BENCHMARK_CAPTURE(permutation_distance_estimate, sketch_64, 64)->Arg(100)->Arg(500)->Arg(1000);
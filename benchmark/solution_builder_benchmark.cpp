@@ -0,0 +1,32 @@
+#include "benchmarks.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+void solution_builder_from_permutation(
+        benchmark::State& state,
+        bool blocking)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            Objective::Makespan,
+            blocking);
+    std::mt19937_64 generator(0);
+    std::vector<JobId> job_ids = random_permutation(instance, generator);
+
+    for (auto _: state) {
+        SolutionBuilder solution_builder;
+        solution_builder.set_instance(instance);
+        solution_builder.from_permutation(job_ids);
+        Solution solution = solution_builder.build();
+        benchmark::DoNotOptimize(solution);
+    }
+}
+
+}
+
+BENCHMARK_CAPTURE(solution_builder_from_permutation, standard, false)->Apply(pfss_sizes);
+BENCHMARK_CAPTURE(solution_builder_from_permutation, blocking, true)->Apply(pfss_sizes);
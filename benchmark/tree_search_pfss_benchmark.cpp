@@ -0,0 +1,40 @@
+// The branching scheme is internal to the translation unit of the tree
+// search, so it is included directly. This target must not link against
+// ShopSchedulingSolver_tree_search_pfss.
+#include "algorithms/tree_search_pfss.cpp"
+
+#include "benchmarks.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+void tree_search_pfss_children(
+        benchmark::State& state,
+        Objective objective)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1),
+            objective);
+    BranchingScheme::Parameters branching_scheme_parameters;
+    if (objective == Objective::TotalTardiness)
+        branching_scheme_parameters.guide_id = 4;
+    BranchingScheme branching_scheme(instance, branching_scheme_parameters);
+
+    // Benchmark the children of a node in the middle of the tree.
+    auto node = branching_scheme.root();
+    for (JobId depth = 0; depth < instance.number_of_jobs() / 2; ++depth)
+        node = branching_scheme.children(node).front();
+
+    for (auto _: state) {
+        auto children = branching_scheme.children(node);
+        benchmark::DoNotOptimize(children);
+    }
+}
+
+}
+
+BENCHMARK_CAPTURE(tree_search_pfss_children, tft, Objective::TotalFlowTime)->Apply(pfss_sizes);
+BENCHMARK_CAPTURE(tree_search_pfss_children, tt, Objective::TotalTardiness)->Apply(pfss_sizes);
@@ -0,0 +1,38 @@
+// The branching scheme is internal to the translation unit of the tree
+// search, so it is included directly. This target must not link against
+// ShopSchedulingSolver_tree_search_pfss_makespan.
+#include "algorithms/tree_search_pfss_makespan.cpp"
+
+#include "benchmarks.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+void tree_search_pfss_makespan_children(
+        benchmark::State& state,
+        bool bidirectional)
+{
+    const Instance instance = generate_pfss_instance(
+            state.range(0),
+            state.range(1));
+    BranchingSchemeBidirectional::Parameters branching_scheme_parameters;
+    branching_scheme_parameters.bidirectional = bidirectional;
+    BranchingSchemeBidirectional branching_scheme(instance, branching_scheme_parameters);
+
+    // Benchmark the children of a node in the middle of the tree.
+    auto node = branching_scheme.root();
+    for (JobId depth = 0; depth < instance.number_of_jobs() / 2; ++depth)
+        node = branching_scheme.children(node).front();
+
+    for (auto _: state) {
+        auto children = branching_scheme.children(node);
+        benchmark::DoNotOptimize(children);
+    }
+}
+
+}
+
+BENCHMARK_CAPTURE(tree_search_pfss_makespan_children, forward, false)->Apply(pfss_sizes);
+BENCHMARK_CAPTURE(tree_search_pfss_makespan_children, bidirectional, true)->Apply(pfss_sizes);
@@ -2,6 +2,7 @@
 
 #include "shopschedulingsolver/solution.hpp"
 #include "shopschedulingsolver/solution_builder.hpp"
+#include "shopschedulingsolver/profiler.hpp"
 
 #include "optimizationtools/utils/output.hpp"
 #include "optimizationtools/utils/utils.hpp"
@@ -9,6 +10,73 @@
 namespace shopschedulingsolver
 {
 
+/**
+ * Compact history of the intermediary outputs of an algorithm.
+ *
+ * When the number of stored points reaches the maximum size, every other
+ * point is dropped (the first and the last points are always kept), so that
+ * the cost of adding a point remains constant in amortized time.
+ */
+struct IntermediaryOutputs
+{
+    /** Times. */
+    std::vector<double> times;
+
+    /** Values. */
+    std::vector<double> values;
+
+    /** Bounds. */
+    std::vector<double> bounds;
+
+
+    /** Add a point. */
+    void add(
+            double time,
+            double value,
+            double bound,
+            Counter maximum_size = -1)
+    {
+        times.push_back(time);
+        values.push_back(value);
+        bounds.push_back(bound);
+        if (maximum_size >= 2
+                && (Counter)times.size() > maximum_size) {
+            downsample();
+        }
+    }
+
+    /** Drop every other point, keeping the first and the last ones. */
+    void downsample()
+    {
+        std::size_t size = times.size();
+        std::size_t new_size = 0;
+        for (std::size_t pos = 0; pos < size; ++pos) {
+            if (pos % 2 == 1 && pos != size - 1)
+                continue;
+            times[new_size] = times[pos];
+            values[new_size] = values[pos];
+            bounds[new_size] = bounds[pos];
+            new_size++;
+        }
+        times.resize(new_size);
+        values.resize(new_size);
+        bounds.resize(new_size);
+    }
+
+    /** Export the history to a JSON structure. */
+    nlohmann::json to_json() const
+    {
+        nlohmann::json json = nlohmann::json::array();
+        for (std::size_t pos = 0; pos < times.size(); ++pos) {
+            json.push_back({
+                    {"Time", times[pos]},
+                    {"Value", values[pos]},
+                    {"Bound", bounds[pos]}});
+        }
+        return json;
+    }
+};
+
 struct Output: optimizationtools::Output
 {
     /** Constructor. */
@@ -30,6 +98,20 @@ struct Output: optimizationtools::Output
 
     Time throughput_bound = -1;
 
+    /** History of the intermediary outputs. */
+    IntermediaryOutputs intermediary_outputs;
+
+    /**
+     * Profile of the algorithm.
+     *
+     * It contains the statistics of the threads working for the algorithm,
+     * including the ones of the algorithms it runs, but not the ones of the
+     * algorithms running concurrently in the same process.
+     *
+     * Empty unless compiled with the SHOPSCHEDULINGSOLVER_PROFILE option.
+     */
+    Profile profile;
+
 
     double bound() const
     {
@@ -48,7 +130,7 @@ struct Output: optimizationtools::Output
 
     virtual nlohmann::json to_json() const
     {
-        return nlohmann::json {
+        nlohmann::json json {
             {"Solution", this->solution.to_json()},
             {"MakespanBound", this->makespan_bound},
             {"TotalFlowTimeBound", this->total_flow_time_bound},
@@ -59,6 +141,9 @@ struct Output: optimizationtools::Output
             {"Optimal", this->bound() == this->solution.objective_value()},
             {"Time", this->time}
         };
+        if (!this->profile.entries.empty())
+            json["Profile"] = this->profile.to_json();
+        return json;
     }
 
     virtual int format_width() const { return 24; }
@@ -81,6 +166,75 @@ struct Parameters: optimizationtools::Parameters
 {
     /** New solution callback. */
     NewSolutionCallback new_solution_callback = [](const Output&) { };
+
+    /**
+     * Maximum number of intermediary outputs stored.
+     *
+     * Beyond, the history is downsampled. -1 means no limit.
+     */
+    Counter maximum_number_of_intermediary_outputs = 1024;
+
+    /**
+     * Callback called at the end of the algorithm.
+     *
+     * It is typically used to flush the outputs written asynchronously by
+     * the new solution callback.
+     */
+    NewSolutionCallback end_callback = [](const Output&) { };
+};
+
+/**
+ * Check of the end of an algorithm, amortized over several calls.
+ *
+ * It is used in the inner loops of the algorithms, where reading the clock at
+ * each step would be noticeable on small instances. The timer is checked at
+ * the first call and then every 'period' steps, a call counting for the
+ * number of steps it is given. Once the end is reached, it stays reached.
+ */
+class EndCheck
+{
+
+public:
+
+    /** Constructor. */
+    EndCheck(
+            const optimizationtools::Timer& timer,
+            Counter period = 64):
+        timer_(timer),
+        period_(period) { }
+
+    /**
+     * Return true iff the algorithm needs to end.
+     *
+     * 'number_of_steps' is the number of candidate evaluations done since the
+     * previous call, for callers evaluating candidates by batches.
+     */
+    bool needs_to_end(Counter number_of_steps = 1)
+    {
+        if (end_)
+            return true;
+        number_of_steps_until_check_ -= number_of_steps;
+        if (number_of_steps_until_check_ > 0)
+            return false;
+        number_of_steps_until_check_ = period_;
+        end_ = timer_.needs_to_end();
+        return end_;
+    }
+
+private:
+
+    /** Timer. */
+    const optimizationtools::Timer& timer_;
+
+    /** Number of steps between two checks of the timer. */
+    Counter period_;
+
+    /** Number of steps before the next check of the timer. */
+    Counter number_of_steps_until_check_ = 0;
+
+    /** True iff the end has been reached. */
+    bool end_ = false;
+
 };
 
 class AlgorithmFormatter
@@ -139,6 +293,9 @@ public:
 
 private:
 
+    /** Add the current output to the history of intermediary outputs. */
+    void add_intermediary_output();
+
     /** Instance. */
     const Instance& instance_;
 
@@ -151,6 +308,16 @@ private:
     /** Output stream. */
     std::unique_ptr<optimizationtools::ComposeStream> os_;
 
+    /** Profile run of the algorithm. */
+    std::unique_ptr<ProfileRun> profile_run_;
+
+    /**
+     * Attachment of the profile run to the thread running the algorithm.
+     *
+     * Declared after the run so that it is detached before being destroyed.
+     */
+    std::unique_ptr<ScopedProfileRun> scoped_profile_run_;
+
 };
 
 }
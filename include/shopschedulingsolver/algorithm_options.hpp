@@ -0,0 +1,56 @@
+/**
+ * Options of the algorithms
+ *
+ * The options selecting the parameters of the algorithms are shared by the
+ * command line solver and by the server, so that both run the algorithms
+ * with the same parameters. The server reads them from the "parameters" of a
+ * solve, whose keys are the names of the options with underscores instead of
+ * dashes.
+ */
+
+#pragma once
+
+#include "shopschedulingsolver/algorithm_formatter.hpp"
+#include "shopschedulingsolver/thread_pool.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <functional>
+#include <random>
+
+namespace shopschedulingsolver
+{
+
+/** Add the options of the parameters of the algorithms to a description. */
+void add_algorithm_options(
+        boost::program_options::options_description& desc);
+
+/**
+ * Read the options of the parameters of the algorithms from a JSON object.
+ *
+ * The keys are the names of the options with underscores instead of dashes;
+ * the values of the options taking several tokens are arrays.
+ */
+boost::program_options::variables_map read_algorithm_options(
+        const boost::program_options::options_description& desc,
+        const nlohmann::json& json);
+
+/** Function setting the parameters common to all the algorithms. */
+using SetCommonParametersFunction = std::function<void(Parameters&)>;
+
+/**
+ * Run an algorithm with the parameters given by options.
+ *
+ * 'set_common_parameters' is called on the parameters of the algorithm
+ * before the options are read. If 'thread_pool' is not null, the parallel
+ * algorithms run their tasks on it.
+ */
+Output run_algorithm(
+        const Instance& instance,
+        const std::string& algorithm,
+        std::mt19937_64& generator,
+        const boost::program_options::variables_map& vm,
+        const SetCommonParametersFunction& set_common_parameters,
+        ThreadPool* thread_pool = nullptr);
+
+}
@@ -0,0 +1,182 @@
+/**
+ * Branch-and-bound for the permutation flow shop, makespan
+ *
+ * Depth-first search with the bidirectional branching of the tree search,
+ * that is, jobs are appended either to the front or to the back of the
+ * permutation.
+ *
+ * Lower bounds:
+ * - LB1: one-machine bound, for each machine, the completion time of the
+ *   front sequence, plus the remaining processing time, plus the length of
+ *   the back sequence
+ * - LB2: two-machine bound, for each pair of machines, the remaining jobs are
+ *   sequenced on the two machines by Johnson's rule, the machines in between
+ *   being replaced by time lags; it is only evaluated for the nodes which are
+ *   not pruned by LB1
+ *
+ * The upper bound is initialized with the local search. With several
+ * threads, each thread explores its own subtrees depth first and, when it
+ * has no node left, steals the shallowest open node of another thread.
+ */
+
+#pragma once
+
+#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
+#include "shopschedulingsolver/thread_pool.hpp"
+
+namespace shopschedulingsolver
+{
+
+enum class BranchAndBoundPfssMakespanLowerBound
+{
+    /** One-machine bound. */
+    Lb1,
+
+    /** One-machine bound, then two-machine bound. */
+    Lb2,
+};
+
+inline std::istream& operator>>(
+        std::istream& in,
+        BranchAndBoundPfssMakespanLowerBound& lower_bound)
+{
+    std::string token;
+    std::getline(in, token);
+    if (token == "lb1") {
+        lower_bound = BranchAndBoundPfssMakespanLowerBound::Lb1;
+    } else if (token == "lb2") {
+        lower_bound = BranchAndBoundPfssMakespanLowerBound::Lb2;
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+    return in;
+}
+
+inline std::ostream& operator<<(
+        std::ostream& os,
+        BranchAndBoundPfssMakespanLowerBound lower_bound)
+{
+    switch (lower_bound) {
+    case BranchAndBoundPfssMakespanLowerBound::Lb1: {
+        os << "lb1";
+        break;
+    } case BranchAndBoundPfssMakespanLowerBound::Lb2: {
+        os << "lb2";
+        break;
+    }
+    }
+    return os;
+}
+
+struct BranchAndBoundPfssMakespanParameters: Parameters
+{
+    /** Lower bound. */
+    BranchAndBoundPfssMakespanLowerBound lower_bound = BranchAndBoundPfssMakespanLowerBound::Lb2;
+
+    /** Number of threads exploring the tree. */
+    Counter number_of_threads = 1;
+
+    /**
+     * Thread pool running the threads.
+     *
+     * If null, a pool of 'number_of_threads - 1' threads is created for the
+     * run, the calling thread taking part as well.
+     */
+    ThreadPool* thread_pool = nullptr;
+
+    /**
+     * Parameters of the local search computing the initial upper bound.
+     *
+     * A negative maximum number of iterations without improvement is set to
+     * 1000.
+     */
+    LocalSearchPfssParameters local_search_parameters;
+
+    virtual int format_width() const override { return 37; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Parameters::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Lower bound: " << lower_bound << std::endl
+            << std::setw(width) << std::left << "Number of threads: " << number_of_threads << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Parameters::to_json();
+        std::stringstream lower_bound_ss;
+        lower_bound_ss << lower_bound;
+        json.merge_patch({
+                {"LowerBound", lower_bound_ss.str()},
+                {"NumberOfThreads", number_of_threads},
+                {"LocalSearchParameters", local_search_parameters.to_json()},
+                });
+        return json;
+    }
+};
+
+struct BranchAndBoundPfssMakespanOutput: Output
+{
+    BranchAndBoundPfssMakespanOutput(
+            const Instance& instance):
+        Output(instance) { }
+
+
+    /** Number of nodes expanded. */
+    Counter number_of_nodes = 0;
+
+    /** Number of nodes pruned by the two-machine bound. */
+    Counter number_of_lb2_prunings = 0;
+
+    /** Number of nodes stolen from another thread. */
+    Counter number_of_steals = 0;
+
+
+    virtual int format_width() const override { return 31; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Output::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Number of nodes: " << number_of_nodes << std::endl
+            << std::setw(width) << std::left << "Number of LB2 prunings: " << number_of_lb2_prunings << std::endl
+            << std::setw(width) << std::left << "Number of steals: " << number_of_steals << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Output::to_json();
+        json.merge_patch({
+                {"NumberOfNodes", this->number_of_nodes},
+                {"NumberOfLb2Prunings", this->number_of_lb2_prunings},
+                {"NumberOfSteals", this->number_of_steals},
+                });
+        return json;
+    }
+};
+
+/**
+ * Solve a permutation flow shop, makespan, to optimality with a
+ * branch-and-bound.
+ *
+ * Blocking is supported. No-wait, no-idle machines, fixed operations and
+ * machine availability times are not supported. Release dates are ignored by
+ * the bounds, so the search remains exact but prunes less.
+ *
+ * When the time limit is reached, the makespan bound is the smallest bound
+ * of the open nodes.
+ */
+const BranchAndBoundPfssMakespanOutput branch_and_bound_pfss_makespan(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        const BranchAndBoundPfssMakespanParameters& parameters = {});
+
+}
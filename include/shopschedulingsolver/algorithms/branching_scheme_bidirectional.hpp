@@ -0,0 +1,900 @@
+#pragma once
+
+/**
+ * Branching scheme for the permutation flow shop, makespan
+ *
+ * Bidirectional branching: the jobs are appended either at the end of the
+ * partial sequence at the front of the permutation, or at the start of the
+ * partial sequence at the back of the permutation. At each node, the
+ * direction leading to fewer children, then to children with larger bounds,
+ * is chosen.
+ *
+ * The bound of a node is the one-machine bound: for each machine, the
+ * completion time of the front sequence, plus the remaining processing time,
+ * plus the length of the back sequence.
+ *
+ * The fixed jobs, which form a frozen prefix of the permutation (see
+ * 'Instance::fixed_prefix()'), are scheduled at the root, and the front
+ * sequence starts after them and after the machine availability times.
+ *
+ * The branching scheme is shared by the tree search and the branch-and-bound
+ * algorithms. It is not thread-safe; concurrent searches use one branching
+ * scheme per thread.
+ */
+
+#include "shopschedulingsolver/solution.hpp"
+#include "shopschedulingsolver/profiler.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+namespace shopschedulingsolver
+{
+
+class BranchingSchemeBidirectional
+{
+
+public:
+
+    using NodeId = int64_t;
+    using GuideId = int64_t;
+
+    struct NodeMachine
+    {
+        Time time_forward = 0;
+        Time time_backward = 0;
+        Time remaining_processing_time = 0;
+        Time idle_time_forward = 0;
+        Time idle_time_backward = 0;
+    };
+
+    struct Node
+    {
+        /** Parent node. */
+        std::shared_ptr<Node> parent = nullptr;
+
+        /** Array indicating for each job, if it still available. */
+        std::vector<bool> available_jobs;
+
+        /** Position of the last job added in the solution. */
+        bool forward = true;
+
+        /** Last job added to the partial solution. */
+        JobId job_id = -1;
+
+        /** Number of jobs in the partial solution. */
+        JobId number_of_jobs = 0;
+
+        /** Machines. */
+        std::vector<NodeMachine> machines;
+
+        /** Idle time. */
+        Time idle_time = 0;
+
+        /** Weighted idle time. */
+        double weighted_idle_time = 0;
+
+        /** Bound. */
+        Time bound = 0;
+
+        /** Guide. */
+        double guide = 0;
+
+        /** Unique id of the node. */
+        NodeId id = -1;
+    };
+
+    struct Parameters
+    {
+        /** Enable bidirectional branching (otherwise forward branching). */
+        bool bidirectional = true;
+
+        /** Guide. */
+        GuideId guide_id = 3;
+
+        /** Callback returning an upper bound on the optimal makespan. */
+        std::function<Time()> makespan_upper_bound_callback
+            = []() { return std::numeric_limits<Time>::max(); };
+    };
+
+    BranchingSchemeBidirectional(
+            const Instance& instance,
+            const Parameters& parameters):
+        instance_(instance),
+        parameters_(parameters)
+    {
+    }
+
+    inline const std::shared_ptr<Node> root() const
+    {
+        auto r = std::shared_ptr<Node>(new BranchingSchemeBidirectional::Node());
+        r->id = node_id_;
+        node_id_++;
+        r->available_jobs.resize(instance_.number_of_jobs(), true);
+        r->machines.resize(instance_.number_of_machines());
+        // The front sequence starts with the fixed jobs, after the
+        // availability times of the machines.
+        for (MachineId machine_id = 0;
+                machine_id < instance_.number_of_machines();
+                ++machine_id) {
+            r->machines[machine_id].time_forward = instance_.machine(machine_id).availability_time;
+        }
+        for (JobId job_id: instance_.fixed_jobs()) {
+            const Job& job = instance_.job(job_id);
+            r->available_jobs[job_id] = false;
+            r->number_of_jobs++;
+            for (MachineId machine_id = 0;
+                    machine_id < instance_.number_of_machines();
+                    ++machine_id) {
+                const Operation& operation = job.operations[machine_id];
+                r->machines[machine_id].time_forward
+                    = operation.fixed_start + operation.alternatives[0].processing_time;
+            }
+        }
+        for (JobId job_id = 0; job_id < instance_.number_of_jobs(); ++job_id) {
+            if (!r->available_jobs[job_id])
+                continue;
+            const Job& job = instance_.job(job_id);
+            for (MachineId machine_id = 0;
+                    machine_id < instance_.number_of_machines();
+                    ++machine_id) {
+                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                r->machines[machine_id].remaining_processing_time += p;
+            }
+        }
+        MachineId last_machine_id = instance_.number_of_machines() - 1;
+        r->bound = r->machines[last_machine_id].time_forward
+            + r->machines[last_machine_id].remaining_processing_time;
+        if (best_node_ == nullptr)
+            best_node_ = r;
+        return r;
+    }
+
+    inline void compute_structures(
+            const std::shared_ptr<Node>& node) const
+    {
+        const Job& job = instance_.job(node->job_id);
+        auto parent = node->parent;
+        node->available_jobs = parent->available_jobs;
+        node->available_jobs[node->job_id] = false;
+        node->machines = parent->machines;
+        if (parent->forward) {
+            if (!instance_.blocking()) {
+                Time p0 = job.operations[0].alternatives[0].processing_time;
+                node->machines[0].time_forward = parent->machines[0].time_forward + p0;
+                node->machines[0].remaining_processing_time -= p0;
+                for (MachineId machine_id = 1;
+                        machine_id < instance_.number_of_machines();
+                        ++machine_id) {
+                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    if (node->machines[machine_id - 1].time_forward
+                            > parent->machines[machine_id].time_forward) {
+                        Time idle_time = node->machines[machine_id - 1].time_forward
+                            - parent->machines[machine_id].time_forward;
+                        node->machines[machine_id].time_forward
+                            = node->machines[machine_id - 1].time_forward + p;
+                        node->machines[machine_id].idle_time_forward += idle_time;
+                    } else {
+                        node->machines[machine_id].time_forward += p;
+                    }
+                    node->machines[machine_id].remaining_processing_time -= p;
+                }
+            } else {
+                MachineId last_machine_id = instance_.number_of_machines() - 1;
+
+                Time p0 = job.operations[0].alternatives[0].processing_time;
+                if (parent->machines[0].time_forward + p0
+                        > parent->machines[1].time_forward) {
+                    node->machines[0].time_forward
+                        = parent->machines[0].time_forward + p0;
+                } else {
+                    Time idle_time = parent->machines[1].time_forward
+                        - node->machines[0].time_forward - p0;
+                    node->machines[0].time_forward
+                        = parent->machines[1].time_forward;
+                    node->machines[0].idle_time_forward += idle_time;
+                }
+                node->machines[0].remaining_processing_time -= p0;
+
+                for (MachineId machine_id = 1;
+                        machine_id < last_machine_id;
+                        ++machine_id) {
+                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    if (node->machines[machine_id - 1].time_forward + p
+                            > parent->machines[machine_id + 1].time_forward) {
+                        Time idle_time = node->machines[machine_id - 1].time_forward
+                            - node->machines[machine_id].time_forward;
+                        node->machines[machine_id].time_forward
+                            = node->machines[machine_id - 1].time_forward + p;
+                        node->machines[machine_id].idle_time_forward += idle_time;
+                    } else {
+                        Time idle_time = node->machines[machine_id + 1].time_forward
+                            - node->machines[machine_id].time_forward - p;
+                        node->machines[machine_id].time_forward
+                            = node->machines[machine_id + 1].time_forward;
+                        node->machines[machine_id].idle_time_forward += idle_time;
+                    }
+                    node->machines[machine_id].remaining_processing_time -= p;
+                }
+
+                Time pm = job.operations[last_machine_id].alternatives[0].processing_time;
+                Time idle_time = node->machines[last_machine_id - 1].time_forward
+                    - node->machines[last_machine_id].time_forward;
+                node->machines[last_machine_id].time_forward
+                    = node->machines[last_machine_id - 1].time_forward + pm;
+                node->machines[last_machine_id].idle_time_forward += idle_time;
+                node->machines[last_machine_id].remaining_processing_time -= pm;
+            }
+        } else {
+            MachineId last_machine_id = instance_.number_of_machines() - 1;
+
+            if (!instance_.blocking()) {
+                Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                node->machines[last_machine_id].time_backward
+                    = parent->machines[last_machine_id].time_backward + p;
+                node->machines[last_machine_id].remaining_processing_time -= p;
+                for (MachineId machine_id = last_machine_id - 1;
+                        machine_id >= 0;
+                        --machine_id) {
+                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    if (node->machines[machine_id + 1].time_backward
+                            > parent->machines[machine_id].time_backward) {
+                        Time idle_time = node->machines[machine_id + 1].time_backward
+                            - parent->machines[machine_id].time_backward;
+                        node->machines[machine_id].time_backward
+                            = node->machines[machine_id + 1].time_backward + p;
+                        node->machines[machine_id].idle_time_backward += idle_time;
+                    } else {
+                        node->machines[machine_id].time_backward += p;
+                    }
+                    node->machines[machine_id].remaining_processing_time -= p;
+                }
+            } else {
+                Time pm = job.operations[last_machine_id].alternatives[0].processing_time;
+                if (parent->machines[last_machine_id].time_backward + pm
+                        > parent->machines[last_machine_id - 1].time_backward) {
+                    node->machines[last_machine_id].time_backward
+                        = parent->machines[last_machine_id].time_backward + pm;
+                } else {
+                    Time idle_time = parent->machines[last_machine_id - 1].time_backward
+                        - node->machines[last_machine_id].time_backward - pm;
+                    node->machines[last_machine_id].time_backward
+                        = parent->machines[last_machine_id - 1].time_backward;
+                    node->machines[last_machine_id].idle_time_backward += idle_time;
+                }
+                node->machines[last_machine_id].remaining_processing_time -= pm;
+
+                for (MachineId machine_id = last_machine_id - 1;
+                        machine_id > 0;
+                        --machine_id) {
+                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    if (node->machines[machine_id + 1].time_backward + p
+                            > parent->machines[machine_id - 1].time_backward) {
+                        Time idle_time = node->machines[machine_id + 1].time_backward
+                            - node->machines[machine_id].time_backward;
+                        node->machines[machine_id].time_backward
+                            = node->machines[machine_id + 1].time_backward + p;
+                        node->machines[machine_id].idle_time_backward += idle_time;
+                    } else {
+                        Time idle_time = node->machines[machine_id - 1].time_backward
+                            - node->machines[machine_id].time_backward - p;
+                        node->machines[machine_id].time_backward
+                            = node->machines[machine_id - 1].time_backward;
+                        node->machines[machine_id].idle_time_backward += idle_time;
+                    }
+                    node->machines[machine_id].remaining_processing_time -= p;
+                }
+
+                Time p0 = job.operations[0].alternatives[0].processing_time;
+                Time idle_time = node->machines[1].time_backward
+                    - node->machines[0].time_backward;
+                node->machines[0].time_backward
+                    = node->machines[1].time_backward + p0;
+                node->machines[0].idle_time_backward += idle_time;
+                node->machines[0].remaining_processing_time -= p0;
+            }
+        }
+    }
+
+    inline std::vector<std::shared_ptr<Node>> children(
+            const std::shared_ptr<Node>& parent) const
+    {
+        SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("TreeSearchPfssMakespan/Children");
+        // Compute parent's structures if needed.
+        if (parent->available_jobs.empty())
+            compute_structures(parent);
+
+        // Determine whether to use forward or backward.
+        if (!parameters_.bidirectional) {
+            parent->forward = true;
+        } else if (parent->parent == nullptr) {
+            parent->forward = true;
+        } else if (parent->parent->parent == nullptr) {
+            parent->forward = false;
+        } else {
+            JobId n_forward = 0;
+            JobId n_backward = 0;
+            Time bound_forward = 0;
+            Time bound_backward = 0;
+            for (JobId job_next_id = 0;
+                    job_next_id < instance_.number_of_jobs();
+                    ++job_next_id) {
+                if (!parent->available_jobs[job_next_id])
+                    continue;
+                const Job& job_next = instance_.job(job_next_id);
+                // Forward.
+                Time bf = 0;
+                Time t_prec = 0;
+                Time t = 0;
+                if (!instance_.blocking()) {
+                    Time p0 = job_next.operations[0].alternatives[0].processing_time;
+                    t_prec = parent->machines[0].time_forward + p0;
+                    bf = std::max(
+                        bf,
+                        t_prec
+                        + parent->machines[0].remaining_processing_time
+                        - p0
+                        + parent->machines[0].time_backward);
+                    for (MachineId machine_id = 1;
+                            machine_id < instance_.number_of_machines();
+                            ++machine_id) {
+                        Time p = job_next.operations[machine_id].alternatives[0].processing_time;
+                        if (t_prec > parent->machines[machine_id].time_forward) {
+                            t = t_prec + p;
+                        } else {
+                            t = parent->machines[machine_id].time_forward + p;
+                        }
+                        bf = std::max(
+                                bf,
+                                t
+                                + parent->machines[machine_id].remaining_processing_time
+                                - p
+                                + parent->machines[machine_id].time_backward);
+                        t_prec = t;
+                    }
+                } else {
+                    Time p0 = job_next.operations[0].alternatives[0].processing_time;
+                    if (parent->machines[0].time_forward + p0 > parent->machines[1].time_forward) {
+                        t_prec = parent->machines[0].time_forward + p0;
+                    } else {
+                        t_prec = parent->machines[1].time_forward;
+                    }
+                    bf = std::max(
+                        bf,
+                        t_prec
+                        + parent->machines[0].remaining_processing_time - p0
+                        + parent->machines[0].time_backward);
+                    MachineId last_machine_id = instance_.number_of_machines() - 1;
+                    for (MachineId machine_id = 1;
+                            machine_id < last_machine_id;
+                            ++machine_id) {
+                        Time p = job_next.operations[machine_id].alternatives[0].processing_time;
+                        Time t_departure;
+                        if (t_prec + p > parent->machines[machine_id + 1].time_forward) {
+                            t_departure = t_prec + p;
+                        } else {
+                            t_departure = parent->machines[machine_id + 1].time_forward;
+                        }
+                        bf = std::max(
+                                bf,
+                                t_departure
+                                + parent->machines[machine_id].remaining_processing_time - p
+                                + parent->machines[machine_id].time_backward);
+                        t_prec = t_departure;
+                    }
+                    bf = std::max(
+                            bf,
+                            t_prec
+                            + parent->machines[last_machine_id].remaining_processing_time
+                            + parent->machines[last_machine_id].time_backward);
+                }
+
+                if (best_node_->number_of_jobs != instance_.number_of_jobs()
+                        || bf < best_node_->bound) {
+                    n_forward++;
+                    bound_forward += bf;
+                }
+                // Backward.
+                MachineId machine_id_last = instance_.number_of_machines() - 1;
+                Time bb = 0;
+                t_prec = 0;
+                if (!instance_.blocking()) {
+                    Time pm1 = job_next.operations[machine_id_last].alternatives[0].processing_time;
+                    t_prec = parent->machines[machine_id_last].time_backward + pm1;
+                    bb = std::max(bb,
+                            parent->machines[machine_id_last].time_forward
+                            + parent->machines[machine_id_last].remaining_processing_time
+                            - pm1
+                            + t_prec);
+                    for (MachineId machine_id = machine_id_last - 1;
+                            machine_id >= 0;
+                            --machine_id) {
+                        Time p = job_next.operations[machine_id].alternatives[0].processing_time;
+                        if (t_prec > parent->machines[machine_id].time_backward) {
+                            t = t_prec + p;
+                        } else {
+                            t = parent->machines[machine_id].time_backward + p;
+                        }
+                        bb = std::max(
+                                bb,
+                                parent->machines[machine_id].time_forward
+                                + parent->machines[machine_id].remaining_processing_time
+                                - p
+                                + t);
+                        t_prec = t;
+                    }
+                } else {
+                    Time pm1 = job_next.operations[machine_id_last].alternatives[0].processing_time;
+                    if (parent->machines[machine_id_last].time_backward + pm1 > parent->machines[machine_id_last - 1].time_backward) {
+                        t_prec = parent->machines[machine_id_last].time_backward + pm1;
+                    } else {
+                        t_prec = parent->machines[machine_id_last - 1].time_backward;
+                    }
+                    bb = std::max(bb,
+                            parent->machines[machine_id_last].time_forward
+                            + parent->machines[machine_id_last].remaining_processing_time - pm1
+                            + t_prec);
+                    for (MachineId machine_id = machine_id_last - 1;
+                            machine_id > 0;
+                            --machine_id) {
+                        Time p = job_next.operations[machine_id].alternatives[0].processing_time;
+                        Time t_departure;
+                        if (t_prec + p > parent->machines[machine_id - 1].time_backward) {
+                            t_departure = t_prec + p;
+                        } else {
+                            t_departure = parent->machines[machine_id - 1].time_backward;
+                        }
+                        bb = std::max(
+                                bb,
+                                parent->machines[machine_id].time_forward
+                                + parent->machines[machine_id].remaining_processing_time - p
+                                + t_departure);
+                        t_prec = t_departure;
+                    }
+                    bb = std::max(
+                            bb,
+                            parent->machines[0].time_forward
+                            + parent->machines[0].remaining_processing_time
+                            + t_prec);
+                }
+
+                if (best_node_->number_of_jobs != instance_.number_of_jobs()
+                        || bb < best_node_->bound) {
+                    n_backward++;
+                    bound_backward += bb;
+                }
+            }
+            if (n_forward < n_backward) {
+                parent->forward = true;
+            } else if (n_forward > n_backward) {
+                parent->forward = false;
+            } else if (bound_forward > bound_backward) {
+                parent->forward = true;
+            } else if (bound_forward < bound_backward) {
+                parent->forward = false;
+            } else {
+                parent->forward = !parent->parent->forward;
+            }
+        }
+
+        // Generate children.
+        Time upper_bound = parameters_.makespan_upper_bound_callback();
+        std::vector<std::shared_ptr<Node>> result;
+        for (JobId job_next_id = 0;
+                job_next_id < instance_.number_of_jobs();
+                ++job_next_id) {
+            if (!parent->available_jobs[job_next_id])
+                continue;
+            const Job& job_next = instance_.job(job_next_id);
+
+            auto child = std::shared_ptr<Node>(new BranchingSchemeBidirectional::Node());
+            child->id = node_id_;
+            node_id_++;
+            child->parent = parent;
+            child->job_id = job_next_id;
+            child->number_of_jobs = parent->number_of_jobs + 1;
+            child->idle_time = parent->idle_time;
+            Time t = 0;
+            Time t_prec = 0;
+            if (parent->forward) {
+                if (!instance_.blocking()) {
+                    Time p0 = job_next.operations[0].alternatives[0].processing_time;
+                    t_prec = parent->machines[0].time_forward + p0;
+                    Time remaining_processing_time =
+                        parent->machines[0].remaining_processing_time - p0;
+                    child->weighted_idle_time += (parent->machines[0].time_backward == 0)? 1:
+                        (double)parent->machines[0].idle_time_backward / parent->machines[0].time_backward;
+                    child->bound = std::max(child->bound,
+                            parent->machines[0].time_forward
+                            + parent->machines[0].remaining_processing_time
+                            + parent->machines[0].time_backward);
+                    for (MachineId machine_id = 1;
+                            machine_id < instance_.number_of_machines();
+                            ++machine_id) {
+                        Time p = job_next.operations[machine_id].alternatives[0].processing_time;
+                        Time machine_idle_time = parent->machines[machine_id].idle_time_forward;
+                        if (t_prec > parent->machines[machine_id].time_forward) {
+                            Time idle_time = t_prec - parent->machines[machine_id].time_forward;
+                            t = t_prec + p;
+                            machine_idle_time += idle_time;
+                            child->idle_time += idle_time;
+                        } else {
+                            t = parent->machines[machine_id].time_forward + p;
+                        }
+                        remaining_processing_time =
+                            parent->machines[machine_id].remaining_processing_time - p;
+                        child->weighted_idle_time += (t == 0)? 1:
+                            (double)machine_idle_time / t;
+                        child->weighted_idle_time += (parent->machines[machine_id].time_backward == 0)? 1:
+                            (double)parent->machines[machine_id].idle_time_backward
+                            / parent->machines[machine_id].time_backward;
+                        child->bound = std::max(
+                                child->bound,
+                                t + remaining_processing_time
+                                + parent->machines[machine_id].time_backward);
+                        t_prec = t;
+                    }
+                } else {
+                    Time p0 = job_next.operations[0].alternatives[0].processing_time;
+                    if (parent->machines[0].time_forward + p0 > parent->machines[1].time_forward) {
+                        t_prec = parent->machines[0].time_forward + p0;
+                    } else {
+                        t_prec = parent->machines[1].time_forward;
+                    }
+                    Time remaining_processing_time =
+                        parent->machines[0].remaining_processing_time - p0;
+                    child->weighted_idle_time += (parent->machines[0].time_backward == 0)? 1:
+                        (double)parent->machines[0].idle_time_backward / parent->machines[0].time_backward;
+                    child->bound = std::max(child->bound,
+                            t_prec
+                            + parent->machines[0].remaining_processing_time - p0
+                            + parent->machines[0].time_backward);
+                    MachineId last_machine_id = instance_.number_of_machines() - 1;
+                    for (MachineId machine_id = 1;
+                            machine_id < last_machine_id;
+                            ++machine_id) {
+                        Time p = job_next.operations[machine_id].alternatives[0].processing_time;
+                        Time machine_idle_time = parent->machines[machine_id].idle_time_forward;
+                        Time idle_time;
+                        Time t_departure;
+                        if (t_prec + p > parent->machines[machine_id + 1].time_forward) {
+                            idle_time = t_prec - parent->machines[machine_id].time_forward;
+                            t_departure = t_prec + p;
+                        } else {
+                            idle_time = parent->machines[machine_id + 1].time_forward
+                                - parent->machines[machine_id].time_forward - p;
+                            t_departure = parent->machines[machine_id + 1].time_forward;
+                        }
+                        child->bound = std::max(
+                                child->bound,
+                                t_departure
+                                + parent->machines[machine_id].remaining_processing_time - p
+                                + parent->machines[machine_id].time_backward);
+                        machine_idle_time += idle_time;
+                        child->idle_time += idle_time;
+                        t_prec = t_departure;
+                        remaining_processing_time =
+                            parent->machines[machine_id].remaining_processing_time - p;
+                        child->weighted_idle_time += (t_prec == 0)? 1:
+                            (double)machine_idle_time / t_prec;
+                        child->weighted_idle_time += (parent->machines[machine_id].time_backward == 0)? 1:
+                            (double)parent->machines[machine_id].idle_time_backward
+                            / parent->machines[machine_id].time_backward;
+                    }
+                    Time pm = job_next.operations[last_machine_id].alternatives[0].processing_time;
+                    Time machine_idle_time = parent->machines[last_machine_id].idle_time_forward;
+                    Time idle_time = t_prec - parent->machines[last_machine_id].time_forward;
+                    machine_idle_time += idle_time;
+                    child->idle_time += idle_time;
+                    remaining_processing_time =
+                        parent->machines[last_machine_id].remaining_processing_time - pm;
+                    child->weighted_idle_time += (t_prec + pm == 0)? 1:
+                        (double)machine_idle_time / (t_prec + pm);
+                    child->weighted_idle_time += (parent->machines[last_machine_id].time_backward == 0)? 1:
+                        (double)parent->machines[last_machine_id].idle_time_backward
+                        / parent->machines[last_machine_id].time_backward;
+                    child->bound = std::max(
+                            child->bound,
+                            t_prec
+                            + parent->machines[last_machine_id].remaining_processing_time
+                            + parent->machines[last_machine_id].time_backward);
+                }
+            } else {
+                MachineId last_machine_id = instance_.number_of_machines() - 1;
+                if (!instance_.blocking()) {
+                    Time pm1 = job_next.operations[last_machine_id].alternatives[0].processing_time;
+                    t_prec = parent->machines[last_machine_id].time_backward + pm1;
+                    Time remaining_processing_time =
+                        parent->machines[last_machine_id].remaining_processing_time - pm1;
+                    child->weighted_idle_time += (parent->machines[last_machine_id].time_forward == 0)? 1:
+                        (double)parent->machines[last_machine_id].idle_time_forward / parent->machines[last_machine_id].time_forward;
+                    child->bound = std::max(child->bound,
+                            parent->machines[last_machine_id].time_forward
+                            + parent->machines[last_machine_id].remaining_processing_time
+                            + parent->machines[last_machine_id].time_backward);
+                    for (MachineId machine_id = last_machine_id - 1;
+                            machine_id >= 0;
+                            --machine_id) {
+                        Time p = job_next.operations[machine_id].alternatives[0].processing_time;
+                        Time machine_idle_time = parent->machines[machine_id].idle_time_backward;
+                        if (t_prec > parent->machines[machine_id].time_backward) {
+                            Time idle_time = t_prec - parent->machines[machine_id].time_backward;
+                            t = t_prec + p;
+                            machine_idle_time += idle_time;
+                            child->idle_time += idle_time;
+                        } else {
+                            t = parent->machines[machine_id].time_backward + p;
+                        }
+                        remaining_processing_time =
+                            parent->machines[machine_id].remaining_processing_time - p;
+                        child->weighted_idle_time += (parent->machines[machine_id].time_forward == 0)? 1:
+                            (double)parent->machines[machine_id].idle_time_forward
+                            / parent->machines[machine_id].time_forward;
+                        child->weighted_idle_time += (t == 0)? 1:
+                            (double)machine_idle_time / t;
+                        child->bound = std::max(
+                                child->bound,
+                                parent->machines[machine_id].time_forward
+                                + remaining_processing_time + t);
+                        t_prec = t;
+                    }
+                } else {
+                    Time pm1 = job_next.operations[last_machine_id].alternatives[0].processing_time;
+                    if (parent->machines[last_machine_id].time_backward + pm1 > parent->machines[last_machine_id - 1].time_backward) {
+                        t_prec = parent->machines[last_machine_id].time_backward + pm1;
+                    } else {
+                        t_prec = parent->machines[last_machine_id - 1].time_backward;
+                    }
+                    Time remaining_processing_time =
+                        parent->machines[last_machine_id].remaining_processing_time - pm1;
+                    child->weighted_idle_time += (parent->machines[last_machine_id].time_forward == 0)? 1:
+                        (double)parent->machines[last_machine_id].idle_time_forward / parent->machines[last_machine_id].time_forward;
+                    child->bound = std::max(child->bound,
+                            parent->machines[last_machine_id].time_forward
+                            + parent->machines[last_machine_id].remaining_processing_time - pm1
+                            + t_prec);
+                    for (MachineId machine_id = last_machine_id - 1;
+                            machine_id > 0;
+                            --machine_id) {
+                        Time p = job_next.operations[machine_id].alternatives[0].processing_time;
+                        Time machine_idle_time = parent->machines[machine_id].idle_time_backward;
+                        Time idle_time;
+                        Time t_departure;
+                        if (t_prec + p > parent->machines[machine_id - 1].time_backward) {
+                            idle_time = t_prec - parent->machines[machine_id].time_backward;
+                            t_departure = t_prec + p;
+                        } else {
+                            idle_time = parent->machines[machine_id - 1].time_backward
+                                - parent->machines[machine_id].time_backward - p;
+                            t_departure = parent->machines[machine_id - 1].time_backward;
+                        }
+                        child->bound = std::max(
+                                child->bound,
+                                parent->machines[machine_id].time_forward
+                                + parent->machines[machine_id].remaining_processing_time - p
+                                + t_departure);
+                        machine_idle_time += idle_time;
+                        child->idle_time += idle_time;
+                        t_prec = t_departure;
+                        remaining_processing_time =
+                            parent->machines[machine_id].remaining_processing_time - p;
+                        child->weighted_idle_time += (parent->machines[machine_id].time_forward == 0)? 1:
+                            (double)parent->machines[machine_id].idle_time_forward
+                            / parent->machines[machine_id].time_forward;
+                        child->weighted_idle_time += (t_prec == 0)? 1:
+                            (double)machine_idle_time / t_prec;
+                    }
+                    Time p0 = job_next.operations[0].alternatives[0].processing_time;
+                    Time machine_idle_time = parent->machines[0].idle_time_backward;
+                    Time idle_time = t_prec - parent->machines[0].time_backward;
+                    machine_idle_time += idle_time;
+                    child->idle_time += idle_time;
+                    remaining_processing_time =
+                        parent->machines[0].remaining_processing_time - p0;
+                    child->weighted_idle_time += (parent->machines[0].time_forward == 0)? 1:
+                        (double)parent->machines[0].idle_time_forward
+                        / parent->machines[0].time_forward;
+                    child->weighted_idle_time += (t_prec + p0 == 0)? 1:
+                        (double)machine_idle_time / (t_prec + p0);
+                    child->bound = std::max(
+                            child->bound,
+                            parent->machines[0].time_forward
+                            + parent->machines[0].remaining_processing_time
+                            + t_prec);
+                }
+            }
+            if (child->bound >= upper_bound)
+                continue;
+            // Compute guide.
+            double alpha = (double)child->number_of_jobs / instance_.number_of_jobs();
+            switch (parameters_.guide_id) {
+            case 0: {
+                child->guide = child->bound;
+                break;
+            } case 1: {
+                child->guide = child->idle_time;
+                break;
+            } case 2: {
+                child->guide = alpha * child->bound
+                    + (1.0 - alpha) * child->idle_time * child->number_of_jobs / instance_.number_of_machines();
+                break;
+            } case 3: {
+                child->guide = alpha * child->bound
+                    + (1.0 - alpha) * child->weighted_idle_time * child->bound;
+                break;
+            } case 4: {
+                double a1 = (best_node_->number_of_jobs == instance_.number_of_jobs())?
+                    (double)(best_node_->bound) / (best_node_->bound - child->bound):
+                    1 - alpha;
+                double a2 = (best_node_->number_of_jobs == instance_.number_of_jobs())?
+                    (double)(best_node_->bound - child->bound) / best_node_->bound:
+                    alpha;
+                child->guide = a1 * child->bound
+                    + a2 * child->weighted_idle_time;
+                break;
+            } default: {
+            }
+            }
+            if (better(child, best_node_))
+                best_node_ = child;
+            result.push_back(child);
+        }
+        return result;
+    }
+
+    inline bool operator()(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        if (node_1->number_of_jobs != node_2->number_of_jobs)
+            return node_1->number_of_jobs < node_2->number_of_jobs;
+        if (node_1->guide != node_2->guide)
+            return node_1->guide < node_2->guide;
+        return node_1->id < node_2->id;
+    }
+
+    inline bool leaf(
+            const std::shared_ptr<Node>& node) const
+    {
+        return node->number_of_jobs == instance_.number_of_jobs();
+    }
+
+    bool bound(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        if (node_2->number_of_jobs != instance_.number_of_jobs())
+            return false;
+        if (node_1->bound >= node_2->bound)
+            return true;
+        return false;
+    }
+
+    /*
+     * Solution pool.
+     */
+
+    bool better(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        if (node_1->number_of_jobs != instance_.number_of_jobs())
+            return false;
+        if (node_2->number_of_jobs != instance_.number_of_jobs())
+            return true;
+        return node_1->bound < node_2->bound;
+    }
+
+    bool equals(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        (void)node_1;
+        (void)node_2;
+        return false;
+    }
+
+    /*
+     * Dominances.
+     */
+
+    inline bool comparable(
+            const std::shared_ptr<Node>& node) const
+    {
+        (void)node;
+        return false;
+    }
+
+    const Instance& instance() const { return instance_; }
+
+    struct NodeHasher
+    {
+        const BranchingSchemeBidirectional& branching_scheme_;
+        std::hash<std::vector<bool>> hasher;
+
+        NodeHasher(const BranchingSchemeBidirectional& branching_scheme):
+            branching_scheme_(branching_scheme) { }
+
+        inline bool operator()(
+                const std::shared_ptr<Node>& node_1,
+                const std::shared_ptr<Node>& node_2) const
+        {
+            if (node_1->available_jobs != node_2->available_jobs)
+                return false;
+            return true;
+        }
+
+        inline std::size_t operator()(
+                const std::shared_ptr<Node>& node) const
+        {
+            size_t hash = hasher(node->available_jobs);
+            return hash;
+        }
+    };
+
+    inline NodeHasher node_hasher() const { return NodeHasher(*this); }
+
+    inline bool dominates(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        (void)node_1;
+        (void)node_2;
+        return false;
+    }
+
+    /*
+     * Outputs
+     */
+
+    std::string display(const std::shared_ptr<Node>& node) const
+    {
+        if (node->number_of_jobs != instance_.number_of_jobs())
+            return "";
+        std::stringstream ss;
+        ss << node->bound;
+        return ss.str();
+    }
+
+    /**
+     * Return the permutation of a node: the fixed jobs, the jobs appended to
+     * the front, then the jobs appended to the back.
+     */
+    std::vector<JobId> jobs(const std::shared_ptr<Node>& node) const
+    {
+        std::vector<JobId> jobs_forward;
+        std::vector<JobId> jobs_backward;
+        for (auto node_tmp = node;
+                node_tmp->parent != nullptr;
+                node_tmp = node_tmp->parent) {
+            if (node_tmp->parent->forward) {
+                jobs_forward.push_back(node_tmp->job_id);
+            } else {
+                jobs_backward.push_back(node_tmp->job_id);
+            }
+        }
+        std::vector<JobId> jobs = instance_.fixed_jobs();
+        jobs.insert(jobs.end(), jobs_forward.rbegin(), jobs_forward.rend());
+        jobs.insert(jobs.end(), jobs_backward.begin(), jobs_backward.end());
+        return jobs;
+    }
+
+private:
+
+    /** Instance. */
+    const Instance& instance_;
+
+    /** Parameters. */
+    Parameters parameters_;
+
+    /** Best node. */
+    mutable std::shared_ptr<Node> best_node_;
+
+    mutable NodeId node_id_ = 0;
+
+};
+
+}
@@ -0,0 +1,293 @@
+/**
+ * Large neighborhood search for the permutation flow shop
+ *
+ * Starting from a solution of the local search, the algorithm repeatedly
+ * frees a subset of k jobs and reoptimizes it with the positional MILP, the
+ * rest of the permutation being fixed:
+ * - the jobs before the freed ones are summarized by their completion times,
+ *   given to the MILP as machine availability times
+ * - the jobs after them keep their order and are fixed at the last
+ *   positions of the MILP, so that the subproblem objective is the objective
+ *   of the whole permutation, up to the constant contribution of the jobs
+ *   before the freed ones
+ * - for the makespan, if they have no release dates, the jobs after them
+ *   are summarized by a single job whose processing times are the
+ *   differences between the lengths of the longest paths of the rest of the
+ *   permutation from each machine
+ *
+ * For the random subsets, the jobs between the freed ones are thus modeled
+ * at their new positions, after the block.
+ *
+ * A subproblem solution is kept if it improves the whole permutation.
+ *
+ * The size k is adapted along the search: it increases when the
+ * subproblems are solved to optimality without improvement, and decreases
+ * when their time limit is reached. Since the MILP ignores the release
+ * dates, the optimality of subproblems with release dates does not
+ * increase it.
+ */
+
+#pragma once
+
+#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
+#include "shopschedulingsolver/algorithms/milp_positional.hpp"
+#include "shopschedulingsolver/thread_pool.hpp"
+
+namespace shopschedulingsolver
+{
+
+enum class LnsPfssNeighborhood
+{
+    /** Free k consecutive jobs of the permutation. */
+    Window,
+
+    /**
+     * Free k random jobs; they are reinserted as a block at the position of
+     * the first of them.
+     */
+    RandomSubset,
+};
+
+inline std::istream& operator>>(
+        std::istream& in,
+        LnsPfssNeighborhood& neighborhood)
+{
+    std::string token;
+    std::getline(in, token);
+    if (token == "window") {
+        neighborhood = LnsPfssNeighborhood::Window;
+    } else if (token == "random-subset") {
+        neighborhood = LnsPfssNeighborhood::RandomSubset;
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+    return in;
+}
+
+inline std::ostream& operator<<(
+        std::ostream& os,
+        LnsPfssNeighborhood neighborhood)
+{
+    switch (neighborhood) {
+    case LnsPfssNeighborhood::Window: {
+        os << "window";
+        break;
+    } case LnsPfssNeighborhood::RandomSubset: {
+        os << "random-subset";
+        break;
+    }
+    }
+    return os;
+}
+
+struct LnsPfssParameters: Parameters
+{
+    /** Maximum number of iterations. */
+    Counter maximum_number_of_iterations = -1;
+
+    /** Maximum number of iterations without improvement. */
+    Counter maximum_number_of_iterations_without_improvement = -1;
+
+    /**
+     * Neighborhoods.
+     *
+     * At each iteration, one of them is drawn uniformly.
+     */
+    std::vector<LnsPfssNeighborhood> neighborhoods = {
+        LnsPfssNeighborhood::Window,
+        LnsPfssNeighborhood::RandomSubset,
+    };
+
+    /** Initial number of jobs of a subproblem. */
+    JobId initial_subproblem_size = 10;
+
+    /** Minimum number of jobs of a subproblem. */
+    JobId minimum_subproblem_size = 4;
+
+    /** Maximum number of jobs of a subproblem. */
+    JobId maximum_subproblem_size = 30;
+
+    /** Time limit of a subproblem, in seconds. */
+    double subproblem_time_limit = 10;
+
+    /**
+     * Number of subproblems solved concurrently at each iteration.
+     *
+     * Their jobs are disjoint; their solutions are applied one after the
+     * other as long as they improve the permutation.
+     */
+    Counter number_of_threads = 1;
+
+    /**
+     * Thread pool running the threads.
+     *
+     * If null, a pool of 'number_of_threads - 1' threads is created for the
+     * run, the calling thread taking part as well.
+     */
+    ThreadPool* thread_pool = nullptr;
+
+    /**
+     * Parameters of the local search computing the initial solution when
+     * none is given.
+     *
+     * A negative maximum number of iterations without improvement is set to
+     * 1000.
+     */
+    LocalSearchPfssParameters local_search_parameters;
+
+    /** Parameters of the MILP solving the subproblems. */
+    MilpPositionalParameters milp_positional_parameters;
+
+    virtual int format_width() const override { return 37; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Parameters::format(os);
+        int width = format_width();
+        std::stringstream neighborhoods_ss;
+        for (std::size_t pos = 0; pos < neighborhoods.size(); ++pos)
+            neighborhoods_ss << ((pos == 0)? "": " ") << neighborhoods[pos];
+        os
+            << std::setw(width) << std::left << "Maximum number of iterations: " << maximum_number_of_iterations << std::endl
+            << std::setw(width) << std::left << "Max # iter. w/o improvement: " << maximum_number_of_iterations_without_improvement << std::endl
+            << std::setw(width) << std::left << "Neighborhoods: " << neighborhoods_ss.str() << std::endl
+            << std::setw(width) << std::left << "Subproblem size: " << initial_subproblem_size
+            << " [" << minimum_subproblem_size << ", " << maximum_subproblem_size << "]" << std::endl
+            << std::setw(width) << std::left << "Subproblem time limit: " << subproblem_time_limit << std::endl
+            << std::setw(width) << std::left << "Number of threads: " << number_of_threads << std::endl
+            << std::setw(width) << std::left << "MILP solver: " << milp_positional_parameters.solver << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Parameters::to_json();
+        nlohmann::json neighborhoods_json = nlohmann::json::array();
+        for (LnsPfssNeighborhood neighborhood: neighborhoods) {
+            std::stringstream ss;
+            ss << neighborhood;
+            neighborhoods_json.push_back(ss.str());
+        }
+        json.merge_patch({
+                {"MaximumNumberOfIterations", maximum_number_of_iterations},
+                {"MaximumNumberOfIterationsWithoutImprovement", maximum_number_of_iterations_without_improvement},
+                {"Neighborhoods", neighborhoods_json},
+                {"InitialSubproblemSize", initial_subproblem_size},
+                {"MinimumSubproblemSize", minimum_subproblem_size},
+                {"MaximumSubproblemSize", maximum_subproblem_size},
+                {"SubproblemTimeLimit", subproblem_time_limit},
+                {"NumberOfThreads", number_of_threads},
+                {"LocalSearchParameters", local_search_parameters.to_json()},
+                });
+        return json;
+    }
+};
+
+struct LnsPfssOutput: Output
+{
+    LnsPfssOutput(
+            const Instance& instance):
+        Output(instance) { }
+
+
+    /** Number of iterations. */
+    Counter number_of_iterations = 0;
+
+    /** Number of subproblems solved. */
+    Counter number_of_subproblems = 0;
+
+    /** Number of subproblem solutions which improved the permutation. */
+    Counter number_of_improvements = 0;
+
+    /** Number of jobs of the subproblems at the end of the search. */
+    JobId subproblem_size = 0;
+
+
+    virtual int format_width() const override { return 31; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Output::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Number of iterations: " << number_of_iterations << std::endl
+            << std::setw(width) << std::left << "Number of subproblems: " << number_of_subproblems << std::endl
+            << std::setw(width) << std::left << "Number of improvements: " << number_of_improvements << std::endl
+            << std::setw(width) << std::left << "Subproblem size: " << subproblem_size << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Output::to_json();
+        json.merge_patch({
+                {"NumberOfIterations", this->number_of_iterations},
+                {"NumberOfSubproblems", this->number_of_subproblems},
+                {"NumberOfImprovements", this->number_of_improvements},
+                {"SubproblemSize", this->subproblem_size},
+                });
+        return json;
+    }
+};
+
+/** Instance of a subproblem of the large neighborhood search. */
+struct LnsPfssSubproblemInstance
+{
+    /**
+     * Instance.
+     *
+     * Its first jobs are the freed jobs, in the order in which they are
+     * given.
+     */
+    Instance instance;
+
+    /**
+     * Ids of the jobs after the freed ones, which must keep this order at
+     * the last positions.
+     *
+     * For the makespan, if none of the jobs after the freed ones has a
+     * release date, a single job summarizes them; its processing times are
+     * only exact at the last position.
+     */
+    std::vector<JobId> tail_job_ids;
+};
+
+/**
+ * Build the instance of the subproblem in which the jobs 'job_ids' are
+ * removed from a sequence and reinserted as a block at position 'position'
+ * of the remaining sequence.
+ *
+ * The objective value of a subproblem solution ending with the tail jobs is
+ * the objective value of the corresponding sequence, minus, for the total
+ * flow time and the total tardiness, the contribution of the jobs before the
+ * block.
+ */
+LnsPfssSubproblemInstance build_lns_pfss_subproblem_instance(
+        const Instance& instance,
+        const std::vector<JobId>& sequence,
+        const std::vector<JobId>& job_ids,
+        JobId position);
+
+/**
+ * Solve a permutation flow shop with a large neighborhood search.
+ *
+ * The supported objectives are the makespan, the total flow time and the
+ * total tardiness. No-wait, blocking, no-idle machines, fixed operations and
+ * machine availability times are not supported. The positional MILP ignores
+ * release dates, so with release dates, the subproblems only guide the
+ * search.
+ *
+ * Unless a maximum number of iterations is given, the search only stops
+ * when a subproblem containing all the jobs is solved to optimality, so a
+ * time limit should be set.
+ */
+const LnsPfssOutput lns_pfss(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        const Solution* initial_solution = nullptr,
+        const LnsPfssParameters& parameters = {});
+
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "shopschedulingsolver/algorithm_formatter.hpp"
+
+#include <sstream>
+
+namespace shopschedulingsolver
+{
+
+enum class LocalSearchNeighborhoodType
+{
+    Shift,
+    ShiftReverse,
+    Swap,
+};
+
+/**
+ * Neighborhood of a permutation flow shop local search.
+ *
+ * Its text representation is "shift-<size>", "shift-reverse-<size>" or
+ * "swap-<size_1>-<size_2>".
+ */
+struct LocalSearchNeighborhood
+{
+    /** Type of the neighborhood. */
+    LocalSearchNeighborhoodType type = LocalSearchNeighborhoodType::Shift;
+
+    /** Size of the moved block, or of the first swapped block. */
+    JobId size_1 = 1;
+
+    /** Size of the second swapped block. */
+    JobId size_2 = 1;
+};
+
+inline std::istream& operator>>(
+        std::istream& in,
+        LocalSearchNeighborhood& neighborhood)
+{
+    std::string token;
+    std::getline(in, token);
+
+    std::string prefix;
+    if (token.compare(0, 14, "shift-reverse-") == 0) {
+        neighborhood.type = LocalSearchNeighborhoodType::ShiftReverse;
+        prefix = "shift-reverse-";
+    } else if (token.compare(0, 6, "shift-") == 0) {
+        neighborhood.type = LocalSearchNeighborhoodType::Shift;
+        prefix = "shift-";
+    } else if (token.compare(0, 5, "swap-") == 0) {
+        neighborhood.type = LocalSearchNeighborhoodType::Swap;
+        prefix = "swap-";
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+
+    std::string sizes = token.substr(prefix.size());
+    std::string::size_type separator = sizes.find('-');
+    try {
+        std::size_t length = 0;
+        if (neighborhood.type == LocalSearchNeighborhoodType::Swap) {
+            if (separator == std::string::npos)
+                throw std::invalid_argument("");
+            neighborhood.size_1 = std::stoll(sizes.substr(0, separator), &length);
+            if (length != separator)
+                throw std::invalid_argument("");
+            neighborhood.size_2 = std::stoll(sizes.substr(separator + 1), &length);
+            if (length != sizes.size() - separator - 1)
+                throw std::invalid_argument("");
+        } else {
+            neighborhood.size_1 = std::stoll(sizes, &length);
+            if (length != sizes.size())
+                throw std::invalid_argument("");
+            neighborhood.size_2 = 1;
+        }
+    } catch (const std::logic_error&) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+    if (neighborhood.size_1 < 1 || neighborhood.size_2 < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+    return in;
+}
+
+inline std::ostream& operator<<(
+        std::ostream& os,
+        const LocalSearchNeighborhood& neighborhood)
+{
+    switch (neighborhood.type) {
+    case LocalSearchNeighborhoodType::Shift: {
+        os << "shift-" << neighborhood.size_1;
+        break;
+    } case LocalSearchNeighborhoodType::ShiftReverse: {
+        os << "shift-reverse-" << neighborhood.size_1;
+        break;
+    } case LocalSearchNeighborhoodType::Swap: {
+        os << "swap-" << neighborhood.size_1 << "-" << neighborhood.size_2;
+        break;
+    }
+    }
+    return os;
+}
+
+enum class LocalSearchPerturbation
+{
+    RandomAdjacentSwaps,
+    RandomShifts,
+    RuinAndRecreate1,
+    RuinAndRecreateJobs,
+    RuinAndRecreateBlock,
+};
+
+inline std::istream& operator>>(
+        std::istream& in,
+        LocalSearchPerturbation& perturbation)
+{
+    std::string token;
+    std::getline(in, token);
+    if (token == "random-adjacent-swaps") {
+        perturbation = LocalSearchPerturbation::RandomAdjacentSwaps;
+    } else if (token == "random-shifts") {
+        perturbation = LocalSearchPerturbation::RandomShifts;
+    } else if (token == "ruin-and-recreate-1") {
+        perturbation = LocalSearchPerturbation::RuinAndRecreate1;
+    } else if (token == "ruin-and-recreate-jobs") {
+        perturbation = LocalSearchPerturbation::RuinAndRecreateJobs;
+    } else if (token == "ruin-and-recreate-block") {
+        perturbation = LocalSearchPerturbation::RuinAndRecreateBlock;
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+    return in;
+}
+
+inline std::ostream& operator<<(
+        std::ostream& os,
+        LocalSearchPerturbation perturbation)
+{
+    switch (perturbation) {
+    case LocalSearchPerturbation::RandomAdjacentSwaps: {
+        os << "random-adjacent-swaps";
+        break;
+    } case LocalSearchPerturbation::RandomShifts: {
+        os << "random-shifts";
+        break;
+    } case LocalSearchPerturbation::RuinAndRecreate1: {
+        os << "ruin-and-recreate-1";
+        break;
+    } case LocalSearchPerturbation::RuinAndRecreateJobs: {
+        os << "ruin-and-recreate-jobs";
+        break;
+    } case LocalSearchPerturbation::RuinAndRecreateBlock: {
+        os << "ruin-and-recreate-block";
+        break;
+    }
+    }
+    return os;
+}
+
+/**
+ * Parameters of the permutation flow shop local searches.
+ *
+ * The population sizes and the neighborhoods are size-dependent: when they
+ * are left to their default value (negative or empty), they are set by an
+ * automatic profile from the number of jobs of the instance, with cheaper
+ * settings for instances with at least 'large_number_of_jobs' jobs.
+ */
+struct LocalSearchParameters: Parameters
+{
+    /** Maximum number of iterations. */
+    Counter maximum_number_of_iterations = -1;
+
+    /** Maximum number of iterations without improvement. */
+    Counter maximum_number_of_iterations_without_improvement = -1;
+
+    /** Minimum size of the population; negative for automatic. */
+    Counter population_minimum_size = -1;
+
+    /** Maximum size of the population; negative for automatic. */
+    Counter population_maximum_size = -1;
+
+    /** Number of elite solutions of the population; negative for automatic. */
+    Counter number_of_elite_solutions = -1;
+
+    /**
+     * Number of closest neighbors used to compute the diversity contribution
+     * of a solution of the population; negative for automatic.
+     */
+    Counter number_of_closest_neighbors = -1;
+
+    /**
+     * Size of the MinHash sketches used to estimate the distance between two
+     * solutions of the population; 0 to compute exact distances.
+     */
+    Counter distance_sketch_size = 0;
+
+    /** Neighborhoods of the local search; empty for automatic. */
+    std::vector<LocalSearchNeighborhood> neighborhoods;
+
+    /** Perturbations; empty for automatic. */
+    std::vector<LocalSearchPerturbation> perturbations;
+
+    /** Maximum number of jobs moved or removed by a perturbation. */
+    JobId perturbation_strength = 4;
+
+    /**
+     * Number of jobs from which the automatic profile considers an instance
+     * as large.
+     */
+    JobId large_number_of_jobs = 256;
+
+    /**
+     * Number of jobs at the beginning of the initial solution which are kept
+     * at their positions.
+     *
+     * The initial solution may be partial: its missing jobs are inserted at
+     * their best positions after the frozen jobs. This is used to re-optimize
+     * a schedule whose beginning has already been executed.
+     *
+     * If the instance has fixed jobs, they are the frozen jobs, and this
+     * parameter must be left to 0.
+     */
+    JobId number_of_frozen_jobs = 0;
+
+    virtual int format_width() const override { return 37; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Parameters::format(os);
+        int width = format_width();
+        std::stringstream neighborhoods_ss;
+        for (std::size_t pos = 0; pos < neighborhoods.size(); ++pos)
+            neighborhoods_ss << ((pos == 0)? "": " ") << neighborhoods[pos];
+        std::stringstream perturbations_ss;
+        for (std::size_t pos = 0; pos < perturbations.size(); ++pos)
+            perturbations_ss << ((pos == 0)? "": " ") << perturbations[pos];
+        os
+            << std::setw(width) << std::left << "Max. # of iterations: " << maximum_number_of_iterations << std::endl
+            << std::setw(width) << std::left << "Max. # of iterations without impr.:  " << maximum_number_of_iterations_without_improvement << std::endl
+            << std::setw(width) << std::left << "Population minimum size: " << population_minimum_size << std::endl
+            << std::setw(width) << std::left << "Population maximum size: " << population_maximum_size << std::endl
+            << std::setw(width) << std::left << "Number of elite solutions: " << number_of_elite_solutions << std::endl
+            << std::setw(width) << std::left << "Number of closest neighbors: " << number_of_closest_neighbors << std::endl
+            << std::setw(width) << std::left << "Distance sketch size: " << distance_sketch_size << std::endl
+            << std::setw(width) << std::left << "Neighborhoods: " << neighborhoods_ss.str() << std::endl
+            << std::setw(width) << std::left << "Perturbations: " << perturbations_ss.str() << std::endl
+            << std::setw(width) << std::left << "Perturbation strength: " << perturbation_strength << std::endl
+            << std::setw(width) << std::left << "Large number of jobs: " << large_number_of_jobs << std::endl
+            << std::setw(width) << std::left << "Number of frozen jobs: " << number_of_frozen_jobs << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Parameters::to_json();
+        nlohmann::json neighborhoods_json = nlohmann::json::array();
+        for (const LocalSearchNeighborhood& neighborhood: neighborhoods) {
+            std::stringstream ss;
+            ss << neighborhood;
+            neighborhoods_json.push_back(ss.str());
+        }
+        nlohmann::json perturbations_json = nlohmann::json::array();
+        for (LocalSearchPerturbation perturbation: perturbations) {
+            std::stringstream ss;
+            ss << perturbation;
+            perturbations_json.push_back(ss.str());
+        }
+        json.merge_patch({
+                {"MaximumNumberOfIterations", maximum_number_of_iterations},
+                {"MaximumNumberOfIterationsWithoutImprovement", maximum_number_of_iterations_without_improvement},
+                {"PopulationMinimumSize", population_minimum_size},
+                {"PopulationMaximumSize", population_maximum_size},
+                {"NumberOfEliteSolutions", number_of_elite_solutions},
+                {"NumberOfClosestNeighbors", number_of_closest_neighbors},
+                {"DistanceSketchSize", distance_sketch_size},
+                {"Neighborhoods", neighborhoods_json},
+                {"Perturbations", perturbations_json},
+                {"PerturbationStrength", perturbation_strength},
+                {"LargeNumberOfJobs", large_number_of_jobs},
+                {"NumberOfFrozenJobs", number_of_frozen_jobs},
+                });
+        return json;
+    }
+};
+
+/**
+ * Build the initial solution of a local search on an instance with fixed jobs.
+ *
+ * The fixed jobs come first; they are followed by the other jobs of the
+ * initial solution, if any, in the same order. The remaining jobs are
+ * inserted by the local search.
+ */
+inline Solution fixed_jobs_initial_solution(
+        const Instance& instance,
+        const Solution* initial_solution)
+{
+    std::vector<JobId> job_ids = instance.fixed_jobs();
+    if (initial_solution != nullptr) {
+        for (SolutionOperationId solution_operation_id: initial_solution->machine(0).solution_operations) {
+            JobId job_id = initial_solution->operation(solution_operation_id).job_id;
+            if (!instance.job(job_id).fixed)
+                job_ids.push_back(job_id);
+        }
+    }
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.from_permutation(job_ids);
+    return solution_builder.build();
+}
+
+}
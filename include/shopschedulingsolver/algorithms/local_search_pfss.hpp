@@ -1,36 +1,59 @@
 #pragma once
 
-#include "shopschedulingsolver/algorithm_formatter.hpp"
+#include "shopschedulingsolver/algorithms/local_search_parameters.hpp"
+#include "shopschedulingsolver/thread_pool.hpp"
 
 namespace shopschedulingsolver
 {
 
-struct LocalSearchPfssParameters: Parameters
+struct LocalSearchPfssParameters: LocalSearchParameters
 {
-    /** Maximum number of iterations. */
-    Counter maximum_number_of_iterations = -1;
+    /**
+     * Evaluate the candidate insertion positions of the shift neighborhood
+     * several at a time.
+     */
+    bool multi_lane_shift_evaluation = true;
 
-    /** Maximum number of iterations without improvement. */
-    Counter maximum_number_of_iterations_without_improvement = -1;
+    /**
+     * Number of islands.
+     *
+     * Each island runs its own population in its own task. The islands form
+     * a ring; every 'migration_interval' iterations, each island sends its
+     * best solution to the next one.
+     */
+    Counter number_of_islands = 1;
+
+    /**
+     * Thread pool running the islands.
+     *
+     * If null, a pool of 'number_of_islands - 1' threads is created for the
+     * run, the calling thread taking part as well.
+     */
+    ThreadPool* thread_pool = nullptr;
+
+    /** Number of iterations of an island between two migrations. */
+    Counter migration_interval = 64;
 
     virtual int format_width() const override { return 37; }
 
     virtual void format(std::ostream& os) const override
     {
-        Parameters::format(os);
+        LocalSearchParameters::format(os);
         int width = format_width();
         os
-            << std::setw(width) << std::left << "Max. # of iterations: " << maximum_number_of_iterations << std::endl
-            << std::setw(width) << std::left << "Max. # of iterations without impr.:  " << maximum_number_of_iterations_without_improvement << std::endl
+            << std::setw(width) << std::left << "Multi-lane shift evaluation: " << multi_lane_shift_evaluation << std::endl
+            << std::setw(width) << std::left << "Number of islands: " << number_of_islands << std::endl
+            << std::setw(width) << std::left << "Migration interval: " << migration_interval << std::endl
             ;
     }
 
     virtual nlohmann::json to_json() const override
     {
-        nlohmann::json json = Parameters::to_json();
+        nlohmann::json json = LocalSearchParameters::to_json();
         json.merge_patch({
-                {"MaximumNumberOfIterations", maximum_number_of_iterations},
-                {"MaximumNumberOfIterationsWithoutImprovement", maximum_number_of_iterations_without_improvement},
+                {"MultiLaneShiftEvaluation", multi_lane_shift_evaluation},
+                {"NumberOfIslands", number_of_islands},
+                {"MigrationInterval", migration_interval},
                 });
         return json;
     }
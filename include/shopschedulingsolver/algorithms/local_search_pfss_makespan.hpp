@@ -1,41 +1,10 @@
 #pragma once
 
-#include "shopschedulingsolver/algorithm_formatter.hpp"
+#include "shopschedulingsolver/algorithms/local_search_parameters.hpp"
 
 namespace shopschedulingsolver
 {
 
-struct LocalSearchParameters: Parameters
-{
-    /** Maximum number of iterations. */
-    Counter maximum_number_of_iterations = -1;
-
-    /** Maximum number of iterations without improvement. */
-    Counter maximum_number_of_iterations_without_improvement = -1;
-
-    virtual int format_width() const override { return 37; }
-
-    virtual void format(std::ostream& os) const override
-    {
-        Parameters::format(os);
-        int width = format_width();
-        os
-            << std::setw(width) << std::left << "Max. # of iterations: " << maximum_number_of_iterations << std::endl
-            << std::setw(width) << std::left << "Max. # of iterations without impr.:  " << maximum_number_of_iterations_without_improvement << std::endl
-            ;
-    }
-
-    virtual nlohmann::json to_json() const override
-    {
-        nlohmann::json json = Parameters::to_json();
-        json.merge_patch({
-                {"MaximumNumberOfIterations", maximum_number_of_iterations},
-                {"MaximumNumberOfIterationsWithoutImprovement", maximum_number_of_iterations_without_improvement},
-                });
-        return json;
-    }
-};
-
 struct LocalSearchOutput: Output
 {
     LocalSearchOutput(
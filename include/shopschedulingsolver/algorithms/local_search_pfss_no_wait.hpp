@@ -0,0 +1,106 @@
+#pragma once
+
+#include "shopschedulingsolver/algorithm_formatter.hpp"
+
+namespace shopschedulingsolver
+{
+
+struct LocalSearchPfssNoWaitParameters: Parameters
+{
+    /** Maximum number of iterations. */
+    Counter maximum_number_of_iterations = -1;
+
+    /** Maximum number of iterations without improvement. */
+    Counter maximum_number_of_iterations_without_improvement = -1;
+
+    /** Number of jobs removed by the destruction phase. */
+    JobId destruction_size = 4;
+
+    /**
+     * Temperature factor of the acceptance criterion.
+     *
+     * The temperature is this factor times the mean processing time of the
+     * operations divided by 10.
+     */
+    double temperature_factor = 0.5;
+
+    /** Maximum size of the blocks moved by the Or-opt neighborhood. */
+    JobId maximum_block_size = 3;
+
+    virtual int format_width() const override { return 37; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Parameters::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Max. # of iterations: " << maximum_number_of_iterations << std::endl
+            << std::setw(width) << std::left << "Max. # of iterations without impr.:  " << maximum_number_of_iterations_without_improvement << std::endl
+            << std::setw(width) << std::left << "Destruction size: " << destruction_size << std::endl
+            << std::setw(width) << std::left << "Temperature factor: " << temperature_factor << std::endl
+            << std::setw(width) << std::left << "Maximum block size: " << maximum_block_size << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Parameters::to_json();
+        json.merge_patch({
+                {"MaximumNumberOfIterations", maximum_number_of_iterations},
+                {"MaximumNumberOfIterationsWithoutImprovement", maximum_number_of_iterations_without_improvement},
+                {"DestructionSize", destruction_size},
+                {"TemperatureFactor", temperature_factor},
+                {"MaximumBlockSize", maximum_block_size},
+                });
+        return json;
+    }
+};
+
+struct LocalSearchPfssNoWaitOutput: Output
+{
+    LocalSearchPfssNoWaitOutput(
+            const Instance& instance):
+        Output(instance) { }
+
+    /** Number of iterations. */
+    Counter number_of_iterations = 0;
+
+    virtual int format_width() const override { return 31; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Output::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Number of iterations: " << number_of_iterations << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Output::to_json();
+        json.merge_patch({
+                {"NumberOfIterations", this->number_of_iterations},
+                });
+        return json;
+    }
+};
+
+/**
+ * Iterated greedy for the no-wait permutation flow shop.
+ *
+ * With no-wait constraints, the start of a job only depends on the start of
+ * the previous job and on a delay between both jobs, so the problem reduces
+ * to an asymmetric TSP over a delay matrix computed once. Insertions of
+ * blocks of jobs and swaps of two jobs are then evaluated in constant time.
+ *
+ * Supported objectives are the makespan and the total weighted flow time,
+ * without release dates.
+ */
+const LocalSearchPfssNoWaitOutput local_search_pfss_no_wait(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        Solution* initial_solution = nullptr,
+        const LocalSearchPfssNoWaitParameters& parameters = {});
+
+}
@@ -56,9 +56,16 @@ Output milp_disjunctive(
         const Solution* initial_solution = NULL,
         const MilpDisjunctiveParameters& parameters = {});
 
+/**
+ * Write the model in an MPS file.
+ *
+ * The timer of the parameters bounds the time spent creating the model; if
+ * it ends before, nothing is written and an exception is thrown.
+ */
 void write_mps(
         const Instance& instance,
         mathoptsolverscmake::SolverName solver,
-        const std::string& output_path);
+        const std::string& output_path,
+        const Parameters& parameters = {});
 
 }
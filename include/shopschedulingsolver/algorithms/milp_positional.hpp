@@ -14,6 +14,9 @@
  *
  * It is adapted here to handle makespan and unweighted total flow time
  * objective as well, and to no-idle, no-wait and blocking constraints.
+ *
+ * If an initial solution is provided, its value is given to the solver as
+ * cutoff.
  */
 
 #pragma once
@@ -29,6 +32,14 @@ struct MilpPositionalParameters: Parameters
 {
     mathoptsolverscmake::SolverName solver = mathoptsolverscmake::SolverName::Highs;
 
+    /**
+     * Jobs fixed, in this order, at the last positions of the sequence.
+     *
+     * Their variables are fixed through their bounds, like those of the
+     * fixed jobs.
+     */
+    std::vector<JobId> last_job_ids;
+
 
     virtual int format_width() const override { return 37; }
 
@@ -38,6 +49,7 @@ struct MilpPositionalParameters: Parameters
         int width = format_width();
         os
             << std::setw(width) << std::left << "Solver: " << solver << std::endl
+            << std::setw(width) << std::left << "Number of last jobs: " << last_job_ids.size() << std::endl
             ;
     }
 
@@ -46,6 +58,7 @@ struct MilpPositionalParameters: Parameters
         nlohmann::json json = Parameters::to_json();
         json.merge_patch({
                 //{"Solver", solver},
+                {"LastJobIds", last_job_ids},
                 });
         return json;
     }
@@ -0,0 +1,198 @@
+/**
+ * Parallel algorithm portfolio
+ *
+ * Several algorithms are run concurrently, each in its own task of a thread
+ * pool. They share a single incumbent solution and a single bound:
+ * - the tree search prunes the nodes which are not strictly better than the
+ *   incumbent
+ * - the local search is restarted from the incumbent each time it stops
+ *   improving
+ * - the MILP is started once a first solution is known, which is used as
+ *   cutoff, or once the heuristics which have started have all ended
+ *
+ * All the algorithms are stopped as soon as the bound meets the value of the
+ * incumbent. Since the local search is restarted until then, a time limit
+ * should be set if no exact algorithm is part of the portfolio.
+ */
+
+#pragma once
+
+#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
+#include "shopschedulingsolver/algorithms/milp_positional.hpp"
+
+namespace shopschedulingsolver
+{
+
+enum class PortfolioAlgorithm
+{
+    TreeSearchPfssMakespan,
+    LocalSearchPfssMakespan,
+    LocalSearchPfss,
+    MilpPositional,
+};
+
+inline std::istream& operator>>(
+        std::istream& in,
+        PortfolioAlgorithm& algorithm)
+{
+    std::string token;
+    std::getline(in, token);
+    if (token == "tree-search-pfss-makespan") {
+        algorithm = PortfolioAlgorithm::TreeSearchPfssMakespan;
+    } else if (token == "local-search-pfss-makespan") {
+        algorithm = PortfolioAlgorithm::LocalSearchPfssMakespan;
+    } else if (token == "local-search-pfss") {
+        algorithm = PortfolioAlgorithm::LocalSearchPfss;
+    } else if (token == "milp-positional") {
+        algorithm = PortfolioAlgorithm::MilpPositional;
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+    return in;
+}
+
+inline std::ostream& operator<<(
+        std::ostream& os,
+        PortfolioAlgorithm algorithm)
+{
+    switch (algorithm) {
+    case PortfolioAlgorithm::TreeSearchPfssMakespan: {
+        os << "tree-search-pfss-makespan";
+        break;
+    } case PortfolioAlgorithm::LocalSearchPfssMakespan: {
+        os << "local-search-pfss-makespan";
+        break;
+    } case PortfolioAlgorithm::LocalSearchPfss: {
+        os << "local-search-pfss";
+        break;
+    } case PortfolioAlgorithm::MilpPositional: {
+        os << "milp-positional";
+        break;
+    }
+    }
+    return os;
+}
+
+struct PortfolioParameters: Parameters
+{
+    /**
+     * Algorithms run concurrently, one task each; empty for automatic.
+     *
+     * An algorithm may appear several times, in which case each run uses its
+     * own seed.
+     */
+    std::vector<PortfolioAlgorithm> algorithms;
+
+    /**
+     * Thread pool running the algorithms.
+     *
+     * If null, a pool of 'algorithms.size() - 1' threads is created for the
+     * run, the calling thread taking part as well. The islands of the local
+     * searches run on the same pool unless they are given their own.
+     */
+    ThreadPool* thread_pool = nullptr;
+
+    /**
+     * Parameters of the local searches.
+     *
+     * A negative maximum number of iterations without improvement is set to
+     * 'local_search_restart_interval'.
+     */
+    LocalSearchPfssParameters local_search_parameters;
+
+    /**
+     * Default number of iterations without improvement after which a local
+     * search is restarted from the incumbent.
+     */
+    Counter local_search_restart_interval = 1000;
+
+    /** Parameters of the MILP. */
+    MilpPositionalParameters milp_positional_parameters;
+
+    virtual int format_width() const override { return 37; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Parameters::format(os);
+        int width = format_width();
+        std::stringstream algorithms_ss;
+        for (std::size_t pos = 0; pos < algorithms.size(); ++pos)
+            algorithms_ss << ((pos == 0)? "": " ") << algorithms[pos];
+        os
+            << std::setw(width) << std::left << "Algorithms: " << algorithms_ss.str() << std::endl
+            << std::setw(width) << std::left << "Local search restart interval: " << local_search_restart_interval << std::endl
+            << std::setw(width) << std::left << "MILP solver: " << milp_positional_parameters.solver << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Parameters::to_json();
+        nlohmann::json algorithms_json = nlohmann::json::array();
+        for (PortfolioAlgorithm algorithm: algorithms) {
+            std::stringstream ss;
+            ss << algorithm;
+            algorithms_json.push_back(ss.str());
+        }
+        json.merge_patch({
+                {"Algorithms", algorithms_json},
+                {"LocalSearchParameters", local_search_parameters.to_json()},
+                {"LocalSearchRestartInterval", local_search_restart_interval},
+                });
+        return json;
+    }
+};
+
+struct PortfolioOutput: Output
+{
+    PortfolioOutput(
+            const Instance& instance):
+        Output(instance) { }
+
+
+    /** For each algorithm of the portfolio, number of solution improvements. */
+    std::vector<Counter> numbers_of_improvements;
+
+
+    virtual int format_width() const override { return 31; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Output::format(os);
+        int width = format_width();
+        std::stringstream numbers_of_improvements_ss;
+        for (std::size_t pos = 0; pos < numbers_of_improvements.size(); ++pos)
+            numbers_of_improvements_ss << ((pos == 0)? "": " ") << numbers_of_improvements[pos];
+        os
+            << std::setw(width) << std::left << "Numbers of improvements: " << numbers_of_improvements_ss.str() << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Output::to_json();
+        json.merge_patch({
+                {"NumbersOfImprovements", this->numbers_of_improvements},
+                });
+        return json;
+    }
+};
+
+/**
+ * Run a portfolio of algorithms concurrently.
+ *
+ * The supported objectives are the makespan, the total flow time and the
+ * total tardiness. When no algorithm is given, the tree search and the local
+ * search are used for the makespan and the local search is used for the
+ * other objectives.
+ */
+const PortfolioOutput portfolio(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        const Solution* initial_solution = nullptr,
+        const PortfolioParameters& parameters = {});
+
+}
@@ -0,0 +1,256 @@
+/**
+ * Rescheduling
+ *
+ * Re-optimize the solution of a permutation flow shop after a change on the
+ * shop floor: new jobs, cancelled jobs, changed processing times, while the
+ * beginning of the schedule has already been executed.
+ *
+ * Instead of solving the new instance from scratch, the local search is warm
+ * started from the previous solution:
+ * - the jobs started before the frozen time keep their starts; the other
+ *   jobs are sequenced after them and start after the frozen time
+ * - the other jobs of the previous solution keep their relative order
+ *   (depending on the warm start)
+ * - the new jobs are inserted at their best positions
+ *
+ * Typical usage:
+ *
+ *     UpdatedInstance updated_instance = apply_instance_delta(previous_solution, delta);
+ *     ReschedulingOutput output = reschedule(
+ *             previous_solution, delta, updated_instance, generator, parameters);
+ */
+
+#pragma once
+
+#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
+
+namespace shopschedulingsolver
+{
+
+/** Job added to an instance. */
+struct NewJob
+{
+    /** Processing times of the job on each machine, in the machine order. */
+    std::vector<Time> processing_times;
+
+    /** Release date. */
+    Time release_date = 0;
+
+    /** Due date. */
+    Time due_date = -1;
+
+    /** Weight. */
+    Time weight = 1;
+};
+
+/** Change of the processing time of an operation. */
+struct ProcessingTimeChange
+{
+    /** Id of the job in the previous instance. */
+    JobId job_id = -1;
+
+    /** Id of the operation. */
+    OperationId operation_id = -1;
+
+    /** New processing time. */
+    Time processing_time = 0;
+};
+
+/** Changes of an instance between two solves. */
+struct InstanceDelta
+{
+    /** New jobs. */
+    std::vector<NewJob> new_jobs;
+
+    /** Ids, in the previous instance, of the cancelled jobs. */
+    std::vector<JobId> removed_job_ids;
+
+    /** Changes of processing times. */
+    std::vector<ProcessingTimeChange> processing_time_changes;
+
+    /**
+     * Time up to which the previous schedule has been executed.
+     *
+     * The jobs which start before it on the first machine in the previous
+     * solution are frozen: they cannot be removed and their processing times
+     * cannot change. The other jobs, and the new jobs, cannot start before it.
+     */
+    Time frozen_time = 0;
+};
+
+/** Instance obtained by applying changes to a previous instance. */
+struct UpdatedInstance
+{
+    /** Instance. */
+    Instance instance;
+
+    /**
+     * For each job of the previous instance, its id in the new instance; -1
+     * if it has been removed.
+     *
+     * The remaining jobs keep their relative order; the new jobs come after
+     * them, in the order of the delta.
+     */
+    std::vector<JobId> job_ids;
+};
+
+/**
+ * Apply changes to the instance of a solution.
+ *
+ * The release dates of the jobs which are not frozen in the solution are
+ * raised to the frozen time of the delta.
+ */
+UpdatedInstance apply_instance_delta(
+        const Solution& previous_solution,
+        const InstanceDelta& delta);
+
+enum class ReschedulingWarmStart
+{
+    /**
+     * Keep the sequence of the previous solution and insert the new jobs at
+     * their best positions.
+     */
+    PreviousSequence,
+
+    /**
+     * Only keep the frozen jobs and insert all the other jobs at their best
+     * positions.
+     */
+    FrozenJobs,
+};
+
+inline std::istream& operator>>(
+        std::istream& in,
+        ReschedulingWarmStart& warm_start)
+{
+    std::string token;
+    std::getline(in, token);
+    if (token == "previous-sequence") {
+        warm_start = ReschedulingWarmStart::PreviousSequence;
+    } else if (token == "frozen-jobs") {
+        warm_start = ReschedulingWarmStart::FrozenJobs;
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+    return in;
+}
+
+inline std::ostream& operator<<(
+        std::ostream& os,
+        ReschedulingWarmStart warm_start)
+{
+    switch (warm_start) {
+    case ReschedulingWarmStart::PreviousSequence: {
+        os << "previous-sequence";
+        break;
+    } case ReschedulingWarmStart::FrozenJobs: {
+        os << "frozen-jobs";
+        break;
+    }
+    }
+    return os;
+}
+
+struct ReschedulingParameters: Parameters
+{
+    /** Warm start. */
+    ReschedulingWarmStart warm_start = ReschedulingWarmStart::PreviousSequence;
+
+    /**
+     * Parameters of the local search.
+     *
+     * The local search only sequences the jobs which are not frozen; its
+     * number of frozen jobs is ignored.
+     */
+    LocalSearchPfssParameters local_search_parameters;
+
+    virtual int format_width() const override { return 37; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Parameters::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Warm start: " << warm_start << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Parameters::to_json();
+        std::stringstream warm_start_ss;
+        warm_start_ss << warm_start;
+        json.merge_patch({
+                {"WarmStart", warm_start_ss.str()},
+                {"LocalSearchParameters", local_search_parameters.to_json()},
+                });
+        return json;
+    }
+};
+
+struct ReschedulingOutput: Output
+{
+    ReschedulingOutput(
+            const Instance& instance):
+        Output(instance) { }
+
+
+    /** Number of frozen jobs. */
+    JobId number_of_frozen_jobs = 0;
+
+    /** Number of jobs inserted in the warm start solution. */
+    JobId number_of_inserted_jobs = 0;
+
+
+    virtual int format_width() const override { return 31; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Output::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Number of frozen jobs: " << number_of_frozen_jobs << std::endl
+            << std::setw(width) << std::left << "Number of inserted jobs: " << number_of_inserted_jobs << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Output::to_json();
+        json.merge_patch({
+                {"NumberOfFrozenJobs", this->number_of_frozen_jobs},
+                {"NumberOfInsertedJobs", this->number_of_inserted_jobs},
+                });
+        return json;
+    }
+};
+
+/**
+ * Re-optimize a solution after changes of its instance.
+ *
+ * 'updated_instance' must be the result of
+ * 'apply_instance_delta(previous_solution, delta)'.
+ *
+ * The makespan is optimized with 'local_search_pfss_makespan', the total flow
+ * time and the total tardiness with 'local_search_pfss', on an instance of the
+ * jobs which are not frozen whose machines become available at the end of the
+ * frozen operations and at the frozen time. Frozen jobs cannot be removed.
+ *
+ * The instance must be a flow shop without no-wait, blocking and no-idle
+ * machines.
+ *
+ * The instance must not have fixed operations: the jobs already executed are
+ * frozen through the frozen time of the delta instead. An 'invalid_argument'
+ * exception is thrown otherwise.
+ */
+const ReschedulingOutput reschedule(
+        const Solution& previous_solution,
+        const InstanceDelta& delta,
+        const UpdatedInstance& updated_instance,
+        std::mt19937_64& generator,
+        const ReschedulingParameters& parameters = {});
+
+}
@@ -0,0 +1,209 @@
+/**
+ * Rolling horizon decomposition for the permutation flow shop
+ *
+ * For instances too large for a search over the whole sequence, the jobs are
+ * sorted according to an initial order and sequenced window by window:
+ * - a window contains the next 'window_size' jobs of the order, including
+ *   the jobs of the previous window which have not been committed
+ * - the window is solved with the local search, the jobs already committed
+ *   being summarized by the completion times of the last of them on each
+ *   machine
+ * - the first 'window_step' jobs of the solution of the window are
+ *   committed, and the window slides
+ *
+ * With several threads, the initial order is split into segments sequenced
+ * concurrently, each one starting from the completion times of the previous
+ * segment in the initial order. The windows around the boundaries between
+ * segments are then solved again from the actual completion times.
+ *
+ * The fixed jobs, which must form a frozen prefix of the permutation (see
+ * 'Instance::fixed_prefix()'), are scheduled first; the first window starts
+ * from their completion times and from the machine availability times.
+ */
+
+#pragma once
+
+#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
+#include "shopschedulingsolver/thread_pool.hpp"
+
+namespace shopschedulingsolver
+{
+
+enum class RollingHorizonOrder
+{
+    /** Non-decreasing release dates. */
+    ReleaseDates,
+
+    /**
+     * Non-increasing total processing times.
+     *
+     * This is the order in which the NEH heuristic inserts the jobs, not the
+     * sequence it builds.
+     */
+    DecreasingTotalProcessingTime,
+};
+
+inline std::istream& operator>>(
+        std::istream& in,
+        RollingHorizonOrder& order)
+{
+    std::string token;
+    std::getline(in, token);
+    if (token == "release-dates") {
+        order = RollingHorizonOrder::ReleaseDates;
+    } else if (token == "decreasing-total-processing-time") {
+        order = RollingHorizonOrder::DecreasingTotalProcessingTime;
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid input; "
+                "in: " + token + ".");
+    }
+    return in;
+}
+
+inline std::ostream& operator<<(
+        std::ostream& os,
+        RollingHorizonOrder order)
+{
+    switch (order) {
+    case RollingHorizonOrder::ReleaseDates: {
+        os << "release-dates";
+        break;
+    } case RollingHorizonOrder::DecreasingTotalProcessingTime: {
+        os << "decreasing-total-processing-time";
+        break;
+    }
+    }
+    return os;
+}
+
+struct RollingHorizonPfssParameters: Parameters
+{
+    /** Initial order of the jobs. */
+    RollingHorizonOrder initial_order = RollingHorizonOrder::DecreasingTotalProcessingTime;
+
+    /** Number of jobs of a window. */
+    JobId window_size = 100;
+
+    /**
+     * Number of jobs committed after solving a window.
+     *
+     * Two consecutive windows share 'window_size - window_step' jobs.
+     */
+    JobId window_step = 50;
+
+    /** Time limit of the local search of a window, in seconds; -1 for none. */
+    double window_time_limit = -1;
+
+    /**
+     * Default maximum number of iterations without improvement of the local
+     * search of a window.
+     */
+    Counter window_maximum_number_of_iterations_without_improvement = 100;
+
+    /** Number of threads, that is, of segments sequenced concurrently. */
+    Counter number_of_threads = 1;
+
+    /**
+     * Thread pool running the threads.
+     *
+     * If null, a pool of 'number_of_threads - 1' threads is created for the
+     * run, the calling thread taking part as well.
+     */
+    ThreadPool* thread_pool = nullptr;
+
+    /**
+     * Parameters of the local search of the windows.
+     *
+     * A negative maximum number of iterations without improvement is set to
+     * 'window_maximum_number_of_iterations_without_improvement'.
+     */
+    LocalSearchPfssParameters local_search_parameters;
+
+    virtual int format_width() const override { return 37; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Parameters::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Initial order: " << initial_order << std::endl
+            << std::setw(width) << std::left << "Window size: " << window_size << std::endl
+            << std::setw(width) << std::left << "Window step: " << window_step << std::endl
+            << std::setw(width) << std::left << "Window time limit: " << window_time_limit << std::endl
+            << std::setw(width) << std::left << "Window max # iter. w/o improvement: " << window_maximum_number_of_iterations_without_improvement << std::endl
+            << std::setw(width) << std::left << "Number of threads: " << number_of_threads << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Parameters::to_json();
+        std::stringstream initial_order_ss;
+        initial_order_ss << initial_order;
+        json.merge_patch({
+                {"InitialOrder", initial_order_ss.str()},
+                {"WindowSize", window_size},
+                {"WindowStep", window_step},
+                {"WindowTimeLimit", window_time_limit},
+                {"WindowMaximumNumberOfIterationsWithoutImprovement", window_maximum_number_of_iterations_without_improvement},
+                {"NumberOfThreads", number_of_threads},
+                {"LocalSearchParameters", local_search_parameters.to_json()},
+                });
+        return json;
+    }
+};
+
+struct RollingHorizonPfssOutput: Output
+{
+    RollingHorizonPfssOutput(
+            const Instance& instance):
+        Output(instance) { }
+
+
+    /** Number of segments. */
+    Counter number_of_segments = 0;
+
+    /** Number of windows solved. */
+    Counter number_of_windows = 0;
+
+
+    virtual int format_width() const override { return 31; }
+
+    virtual void format(std::ostream& os) const override
+    {
+        Output::format(os);
+        int width = format_width();
+        os
+            << std::setw(width) << std::left << "Number of segments: " << number_of_segments << std::endl
+            << std::setw(width) << std::left << "Number of windows: " << number_of_windows << std::endl
+            ;
+    }
+
+    virtual nlohmann::json to_json() const override
+    {
+        nlohmann::json json = Output::to_json();
+        json.merge_patch({
+                {"NumberOfSegments", this->number_of_segments},
+                {"NumberOfWindows", this->number_of_windows},
+                });
+        return json;
+    }
+};
+
+/**
+ * Solve a permutation flow shop with a rolling horizon decomposition.
+ *
+ * The supported objectives are the makespan, solved with
+ * 'local_search_pfss_makespan', and the total flow time and the total
+ * tardiness, solved with 'local_search_pfss'. No-wait, blocking, no-idle
+ * machines, fixed operations and machine availability times are not
+ * supported, nor are release dates with the makespan.
+ */
+const RollingHorizonPfssOutput rolling_horizon_pfss(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        const RollingHorizonPfssParameters& parameters = {});
+
+}
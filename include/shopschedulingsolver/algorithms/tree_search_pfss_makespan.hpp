@@ -2,11 +2,26 @@
 
 #include "shopschedulingsolver/algorithm_formatter.hpp"
 
+#include <limits>
+
 namespace shopschedulingsolver
 {
 
+struct TreeSearchPfssMakespanParameters: Parameters
+{
+    /**
+     * Callback returning an upper bound on the optimal makespan.
+     *
+     * It is typically used to share the makespan of the best solution found
+     * by other algorithms running concurrently. Children whose bound is not
+     * strictly smaller than this upper bound are not generated.
+     */
+    std::function<Time()> makespan_upper_bound_callback
+        = []() { return std::numeric_limits<Time>::max(); };
+};
+
 Output tree_search_pfss_makespan(
         const Instance& instance,
-        const Parameters& parameters = {});
+        const TreeSearchPfssMakespanParameters& parameters = {});
 
 }
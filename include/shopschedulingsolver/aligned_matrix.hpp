@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace shopschedulingsolver
+{
+
+/** Alignment in bytes of the buffers and rows of an AlignedMatrix. */
+constexpr std::size_t matrix_alignment = 64;
+
+/**
+ * Allocator returning buffers aligned on 'matrix_alignment' bytes.
+ *
+ * The buffer is over-allocated and the offset between the allocated and the
+ * aligned pointers is stored in the byte preceding the aligned pointer.
+ */
+template <typename T>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) { }
+
+    T* allocate(std::size_t n)
+    {
+        unsigned char* base = static_cast<unsigned char*>(
+                ::operator new(n * sizeof(T) + matrix_alignment));
+        std::size_t offset = matrix_alignment
+            - reinterpret_cast<std::uintptr_t>(base) % matrix_alignment;
+        unsigned char* aligned = base + offset;
+        aligned[-1] = static_cast<unsigned char>(offset);
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    void deallocate(T* pointer, std::size_t)
+    {
+        unsigned char* aligned = reinterpret_cast<unsigned char*>(pointer);
+        ::operator delete(aligned - aligned[-1]);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+/** Vector whose buffer is aligned on 'matrix_alignment' bytes. */
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * Row-major matrix stored in a single contiguous aligned buffer.
+ *
+ * The row stride is padded to a multiple of 'matrix_alignment' bytes, so
+ * that every row starts on an aligned address and a SIMD loop over a row
+ * never straddles two rows.
+ *
+ * 'matrix[row]' returns a pointer to the first element of the row, so that
+ * elements are accessed as 'matrix[row][column]'.
+ */
+template <typename T>
+class AlignedMatrix
+{
+
+public:
+
+    /** Constructor. */
+    AlignedMatrix() { }
+
+    /** Constructor. */
+    AlignedMatrix(
+            std::size_t number_of_rows,
+            std::size_t number_of_columns,
+            T value = T())
+    {
+        resize(number_of_rows, number_of_columns, value);
+    }
+
+    /** Resize the matrix and set all its elements to 'value'. */
+    void resize(
+            std::size_t number_of_rows,
+            std::size_t number_of_columns,
+            T value = T())
+    {
+        constexpr std::size_t elements_per_alignment
+            = (matrix_alignment >= sizeof(T))? matrix_alignment / sizeof(T): 1;
+        number_of_rows_ = number_of_rows;
+        number_of_columns_ = number_of_columns;
+        stride_ = (number_of_columns + elements_per_alignment - 1)
+            / elements_per_alignment * elements_per_alignment;
+        values_.assign(number_of_rows_ * stride_, value);
+    }
+
+    /** Get the number of rows. */
+    std::size_t number_of_rows() const { return number_of_rows_; }
+
+    /** Get the number of columns. */
+    std::size_t number_of_columns() const { return number_of_columns_; }
+
+    /** Get the number of elements between the starts of two consecutive rows. */
+    std::size_t stride() const { return stride_; }
+
+    /** Get a row. */
+    T* operator[](std::size_t row) { return values_.data() + row * stride_; }
+
+    /** Get a row. */
+    const T* operator[](std::size_t row) const { return values_.data() + row * stride_; }
+
+    /**
+     * Rotate rows [first, last) so that row 'middle' becomes row 'first'.
+     *
+     * Same semantics as std::rotate.
+     */
+    void rotate_rows(
+            std::size_t first,
+            std::size_t middle,
+            std::size_t last)
+    {
+        std::rotate(
+                values_.begin() + first * stride_,
+                values_.begin() + middle * stride_,
+                values_.begin() + last * stride_);
+    }
+
+private:
+
+    /** Number of rows. */
+    std::size_t number_of_rows_ = 0;
+
+    /** Number of columns. */
+    std::size_t number_of_columns_ = 0;
+
+    /** Row stride. */
+    std::size_t stride_ = 0;
+
+    /** Values. */
+    AlignedVector<T> values_;
+
+};
+
+}
@@ -65,6 +65,14 @@ struct Machine
     std::vector<MachineOperation> operations;
 
     bool no_idle = false;
+
+    /**
+     * Time from which the machine is available.
+     *
+     * It only applies to the operations which are not fixed; for example, the
+     * end of a breakdown or of the operations already executed.
+     */
+    Time availability_time = 0;
 };
 
 struct Alternative
@@ -81,6 +89,12 @@ struct Operation
 {
     /** Alternatives of the operation. */
     std::vector<Alternative> alternatives;
+
+    /** Start of the operation if it is fixed, -1 otherwise. */
+    Time fixed_start = -1;
+
+    /** Alternative of the operation if it is fixed, -1 otherwise. */
+    AlternativeId fixed_alternative_id = -1;
 };
 
 /**
@@ -106,6 +120,9 @@ struct Job
 
     /** Mean processing time. */
     double mean_processing_time = 0;
+
+    /** 'true' iff all the operations of the job are fixed. */
+    bool fixed = false;
 };
 
 /**
@@ -162,6 +179,37 @@ public:
     /** Get the flexible property. */
     bool flexible() const { return flexible_; }
 
+    /** Get the number of fixed operations. */
+    OperationId number_of_fixed_operations() const { return number_of_fixed_operations_; }
+
+    /** Return 'true' if some machine has an availability time. */
+    bool has_machine_availability_times() const { return has_machine_availability_times_; }
+
+    /**
+     * Get the jobs whose operations are all fixed, sorted by fixed start of
+     * their first operation.
+     */
+    const std::vector<JobId>& fixed_jobs() const { return fixed_jobs_; }
+
+    /**
+     * Return 'true' if the fixed operations can be handled as a frozen prefix
+     * of a permutation, and the machine availability times as the initial
+     * state of the machines.
+     *
+     * That is, the instance has neither fixed operations nor machine
+     * availability times, or it is a flow shop without no-wait, blocking or
+     * no-idle machines, the fixed operations are exactly the operations of the
+     * fixed jobs, and these jobs are processed in the order of 'fixed_jobs()'
+     * on all the machines, after the availability times of the machines.
+     *
+     * The fixed operations may start later than as early as possible; the
+     * other jobs start after the fixed jobs.
+     *
+     * This is the case of the operations already executed in a schedule
+     * built from a permutation.
+     */
+    bool fixed_prefix() const { return fixed_prefix_; }
+
     /*
      * Export
      */
@@ -226,6 +274,18 @@ private:
     /** Flexible. */
     bool flexible_ = false;
 
+    /** Number of fixed operations. */
+    OperationId number_of_fixed_operations_ = 0;
+
+    /** Some machine has an availability time. */
+    bool has_machine_availability_times_ = false;
+
+    /** Fixed jobs. */
+    std::vector<JobId> fixed_jobs_;
+
+    /** Fixed operations forming a frozen prefix of a permutation. */
+    bool fixed_prefix_ = true;
+
     friend class InstanceBuilder;
 
 };
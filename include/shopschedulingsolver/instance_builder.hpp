@@ -18,6 +18,11 @@ public:
             const std::string& instance_path,
             const std::string& format);
 
+    /** Read instance from a stream. */
+    void read(
+            std::istream& stream,
+            const std::string& format);
+
     /** Set the objective. */
     void set_objective(Objective objective) { this->instance_.objective_ = objective; }
 
@@ -36,6 +41,11 @@ public:
     /** Set no-idle property for all machines. */
     void set_all_machines_no_idle(bool no_idle = true);
 
+    /** Set the availability time of a machine. */
+    void set_machine_availability_time(
+            MachineId machine_id,
+            Time availability_time);
+
     /** Add a job. */
     JobId add_job();
 
@@ -68,6 +78,19 @@ public:
             JobId job_id,
             Time weight);
 
+    /**
+     * Fix an operation to an alternative and a start.
+     *
+     * The alternative must have been added before. Fixed operations typically
+     * are the operations already started or finished when re-solving a
+     * schedule in operation; the algorithms don't search over them.
+     */
+    void fix_operation(
+            JobId job_id,
+            OperationId operation_id,
+            AlternativeId alternative_id,
+            Time start);
+
     /** Set shop type. */
     void set_operations_arbitrary_order(bool operations_arbitrary_order = true) { instance_.operations_arbitrary_order_ = operations_arbitrary_order; }
 
@@ -93,17 +116,17 @@ private:
      * Private methods
      */
 
-    void read_json(std::ifstream& file);
+    void read_json(std::istream& file);
 
-    void read_flow_shop_jobcol(std::ifstream& file);
+    void read_flow_shop_jobcol(std::istream& file);
 
-    void read_flow_shop_jobrow(std::ifstream& file);
+    void read_flow_shop_jobrow(std::istream& file);
 
-    void read_flow_shop_vallada2008(std::ifstream& file);
+    void read_flow_shop_vallada2008(std::istream& file);
 
-    void read_job_shop(std::ifstream& file);
+    void read_job_shop(std::istream& file);
 
-    void read_flexible_job_shop(std::ifstream& file);
+    void read_flexible_job_shop(std::istream& file);
 
     /*
      * Private attributes
@@ -0,0 +1,468 @@
+#pragma once
+
+/**
+ * Evaluation of permutation flow shop schedules with no-idle machines.
+ *
+ * A no-idle machine processes its jobs contiguously. In a semi-active
+ * schedule of a permutation, the machines are split into segments: a segment
+ * starts at machine 0 or at a no-idle machine and contains the following
+ * machines which are not no-idle. Inside a segment, the times are given by
+ * the standard recurrences relative to the start of the segment, where the
+ * first machine of the segment processes its jobs back to back:
+ *
+ *     h[i][a] = h[i - 1][a] + p[i][a]                        (first machine)
+ *     h[i][k] = max(h[i - 1][k], h[i][k - 1]) + p[i][k]      (other machines)
+ *
+ * and the delay between the start of a segment and the start of the next
+ * one, whose first machine is b + 1, is:
+ *
+ *     D = max_i (h[i][b] - h[i - 1][b + 1])
+ *
+ * The makespan is the sum of the delays of the segments, the delay of the
+ * last segment being the relative completion time of its last job.
+ *
+ * Similarly to Taillard's acceleration for the standard permutation flow
+ * shop, heads, tails and prefix maxima of the delays are computed once for a
+ * sequence, so that the makespan of the insertion of a block of jobs at any
+ * position is then evaluated in time proportional to the number of machines
+ * times the size of the block. Evaluating all the insertion positions of a
+ * job thus takes O(n m).
+ *
+ * Release dates are not supported.
+ */
+
+#include "shopschedulingsolver/instance.hpp"
+#include "shopschedulingsolver/aligned_matrix.hpp"
+
+#include <limits>
+
+namespace shopschedulingsolver
+{
+
+class NoIdleEvaluator
+{
+
+public:
+
+    /** Create an empty evaluator. */
+    NoIdleEvaluator() { }
+
+    /** Create an evaluator for an instance. */
+    explicit NoIdleEvaluator(const Instance& instance):
+        number_of_machines_(instance.number_of_machines())
+    {
+        JobId n = instance.number_of_jobs();
+        MachineId m = number_of_machines_;
+        processing_times_.resize(n, m);
+        for (JobId job_id = 0; job_id < n; ++job_id) {
+            const Job& job = instance.job(job_id);
+            for (MachineId machine_id = 0; machine_id < m; ++machine_id) {
+                processing_times_[job_id][machine_id]
+                    = job.operations[machine_id].alternatives[0].processing_time;
+            }
+        }
+
+        machines_segments_.resize(m);
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id) {
+            if (machine_id == 0 || instance.machine(machine_id).no_idle)
+                segments_first_machines_.push_back(machine_id);
+            machines_segments_[machine_id] = segments_first_machines_.size() - 1;
+        }
+        MachineId number_of_segments = segments_first_machines_.size();
+        segments_first_machines_.push_back(m);
+
+        sequence_.reserve(n);
+        heads_.resize(n + 1, m, 0);
+        tails_.resize(n + 2, m, 0);
+        prefix_maxima_.resize(n + 1, number_of_segments, 0);
+        delays_.resize(number_of_segments, 0);
+        offsets_.resize(number_of_segments, 0);
+        insertion_heads_.resize(m, 0);
+        insertion_delays_.resize(number_of_segments, 0);
+        insertion_cumulated_times_.resize(number_of_segments, 0);
+        insertion_last_heads_.resize(n, 0);
+    }
+
+    /*
+     * Sequence
+     */
+
+    /**
+     * Set the current sequence.
+     *
+     * The jobs at positions 'pos_removed' to 'pos_removed +
+     * number_of_removed_jobs - 1' of 'job_ids' are skipped, which allows
+     * evaluating the re-insertion of a block of the sequence.
+     */
+    void set_sequence(
+            const std::vector<JobId>& job_ids,
+            JobId pos_removed = 0,
+            JobId number_of_removed_jobs = 0)
+    {
+        sequence_.clear();
+        for (JobId pos = 0; pos < (JobId)job_ids.size(); ++pos) {
+            if (pos >= pos_removed && pos < pos_removed + number_of_removed_jobs)
+                continue;
+            sequence_.push_back(job_ids[pos]);
+        }
+        JobId number_of_jobs = sequence_.size();
+        MachineId number_of_segments = delays_.size();
+        MachineId last_machine_id = number_of_machines_ - 1;
+
+        // Heads and prefix maxima of the delays.
+        for (JobId pos = 1; pos <= number_of_jobs; ++pos) {
+            const Time* p = processing_times_[sequence_[pos - 1]];
+            const Time* h_prev = heads_[pos - 1];
+            Time* h = heads_[pos];
+            advance(h_prev, h, p);
+            for (MachineId segment_id = 0;
+                    segment_id < number_of_segments - 1;
+                    ++segment_id) {
+                MachineId next_machine_id = segments_first_machines_[segment_id + 1];
+                Time value = h[next_machine_id - 1] - h_prev[next_machine_id];
+                prefix_maxima_[pos][segment_id] = (pos == 1)?
+                    value:
+                    (std::max)(prefix_maxima_[pos - 1][segment_id], value);
+            }
+        }
+        for (MachineId segment_id = 0;
+                segment_id < number_of_segments - 1;
+                ++segment_id) {
+            prefix_maxima_[0][segment_id] = minus_infinity;
+        }
+
+        // Delays and offsets.
+        makespan_ = 0;
+        for (MachineId segment_id = 0;
+                segment_id < number_of_segments;
+                ++segment_id) {
+            if (number_of_jobs == 0) {
+                delays_[segment_id] = 0;
+            } else if (segment_id == number_of_segments - 1) {
+                delays_[segment_id] = heads_[number_of_jobs][last_machine_id];
+            } else {
+                delays_[segment_id] = prefix_maxima_[number_of_jobs][segment_id];
+            }
+            offsets_[segment_id] = makespan_;
+            makespan_ += delays_[segment_id];
+        }
+
+        // Tails.
+        // tails_[pos][machine_id] is the longest path from operation
+        // (pos, machine_id) to the end of its segment, minus the relative
+        // start of the operation of the next job on the first machine of the
+        // next segment.
+        for (MachineId machine_id = 0;
+                machine_id < number_of_machines_;
+                ++machine_id) {
+            tails_[number_of_jobs + 1][machine_id] = minus_infinity;
+        }
+        for (JobId pos = number_of_jobs; pos >= 1; --pos) {
+            const Time* p = processing_times_[sequence_[pos - 1]];
+            const Time* t_next = tails_[pos + 1];
+            Time* t = tails_[pos];
+            for (MachineId segment_id = number_of_segments - 1;
+                    segment_id >= 0;
+                    --segment_id) {
+                MachineId first_machine_id = segments_first_machines_[segment_id];
+                MachineId segment_last_machine_id = segments_first_machines_[segment_id + 1] - 1;
+                Time end = minus_infinity;
+                if (segment_id != number_of_segments - 1) {
+                    end = -heads_[pos - 1][segment_last_machine_id + 1];
+                } else if (pos == number_of_jobs) {
+                    end = 0;
+                }
+                t[segment_last_machine_id] = p[segment_last_machine_id]
+                    + (std::max)(t_next[segment_last_machine_id], end);
+                for (MachineId machine_id = segment_last_machine_id - 1;
+                        machine_id >= first_machine_id;
+                        --machine_id) {
+                    t[machine_id] = p[machine_id]
+                        + (std::max)(t_next[machine_id], t[machine_id + 1]);
+                }
+            }
+        }
+    }
+
+    /** Get the number of jobs of the current sequence. */
+    JobId number_of_jobs() const { return sequence_.size(); }
+
+    /** Get the makespan of the current sequence. */
+    Time makespan() const { return makespan_; }
+
+    /**
+     * Get the completion time of the job at position 'pos' of the current
+     * sequence on a machine.
+     */
+    Time completion_time(
+            JobId pos,
+            MachineId machine_id) const
+    {
+        return offsets_[machines_segments_[machine_id]] + heads_[pos + 1][machine_id];
+    }
+
+    /**
+     * Compute the objective of the current sequence.
+     *
+     * 'contribution(job_id, completion_time)' returns the contribution of a
+     * job to the objective given its completion time on the last machine.
+     */
+    template <typename Contribution>
+    Time objective(Contribution contribution) const
+    {
+        MachineId last_machine_id = number_of_machines_ - 1;
+        Time offset = offsets_.back();
+        Time objective = 0;
+        for (JobId pos = 0; pos < (JobId)sequence_.size(); ++pos) {
+            objective += contribution(
+                    sequence_[pos],
+                    offset + heads_[pos + 1][last_machine_id]);
+        }
+        return objective;
+    }
+
+    /*
+     * Insertion
+     */
+
+    /**
+     * Evaluate the insertion of a block of jobs in the current sequence.
+     *
+     * 'pos' is the number of jobs of the current sequence before the block.
+     *
+     * Return the makespan of the resulting sequence. The evaluation is kept
+     * until the next call so that 'insertion_objective()' can be called.
+     */
+    Time evaluate_insertion(
+            const JobId* job_ids,
+            JobId size,
+            JobId pos)
+    {
+        JobId number_of_jobs = sequence_.size();
+        MachineId number_of_segments = delays_.size();
+
+        Time* f = insertion_heads_.data();
+        const Time* h_pos = heads_[pos];
+        for (MachineId machine_id = 0;
+                machine_id < number_of_machines_;
+                ++machine_id) {
+            f[machine_id] = h_pos[machine_id];
+        }
+        for (MachineId segment_id = 0;
+                segment_id < number_of_segments - 1;
+                ++segment_id) {
+            MachineId next_machine_id = segments_first_machines_[segment_id + 1];
+            insertion_delays_[segment_id] = prefix_maxima_[pos][segment_id];
+            insertion_cumulated_times_[segment_id] = h_pos[next_machine_id];
+        }
+
+        // Block.
+        for (JobId block_pos = 0; block_pos < size; ++block_pos) {
+            const Time* p = processing_times_[job_ids[block_pos]];
+            advance(f, f, p);
+            for (MachineId segment_id = 0;
+                    segment_id < number_of_segments - 1;
+                    ++segment_id) {
+                MachineId next_machine_id = segments_first_machines_[segment_id + 1];
+                insertion_delays_[segment_id] = (std::max)(
+                        insertion_delays_[segment_id],
+                        f[next_machine_id - 1] - insertion_cumulated_times_[segment_id]);
+                insertion_cumulated_times_[segment_id] += p[next_machine_id];
+            }
+            insertion_last_heads_[block_pos] = f[number_of_machines_ - 1];
+        }
+
+        // Suffix.
+        Time makespan = 0;
+        insertion_offset_ = 0;
+        const Time* t = tails_[pos + 1];
+        for (MachineId segment_id = 0;
+                segment_id < number_of_segments;
+                ++segment_id) {
+            MachineId first_machine_id = segments_first_machines_[segment_id];
+            MachineId next_machine_id = segments_first_machines_[segment_id + 1];
+            Time delay = 0;
+            if (segment_id == number_of_segments - 1) {
+                if (pos == number_of_jobs) {
+                    delay = f[number_of_machines_ - 1];
+                } else {
+                    delay = minus_infinity;
+                    for (MachineId machine_id = first_machine_id;
+                            machine_id < next_machine_id;
+                            ++machine_id) {
+                        delay = (std::max)(delay, f[machine_id] + t[machine_id]);
+                    }
+                }
+            } else {
+                delay = insertion_delays_[segment_id];
+                if (pos < number_of_jobs) {
+                    Time shift = insertion_cumulated_times_[segment_id]
+                        - h_pos[next_machine_id];
+                    for (MachineId machine_id = first_machine_id;
+                            machine_id < next_machine_id;
+                            ++machine_id) {
+                        delay = (std::max)(delay, f[machine_id] + t[machine_id] - shift);
+                    }
+                }
+                insertion_offset_ += delay;
+            }
+            makespan += delay;
+        }
+
+        insertion_job_ids_ = job_ids;
+        insertion_size_ = size;
+        insertion_pos_ = pos;
+        return makespan;
+    }
+
+    /**
+     * Compute the objective of the sequence of the last evaluated insertion.
+     *
+     * 'contribution(job_id, completion_time)' must be non-negative and
+     * non-decreasing in the completion time. The computation stops as soon
+     * as the objective reaches 'bound'; the returned value is then greater
+     * than or equal to 'bound'.
+     */
+    template <typename Contribution>
+    Time insertion_objective(
+            Contribution contribution,
+            Time bound = std::numeric_limits<Time>::max())
+    {
+        MachineId last_machine_id = number_of_machines_ - 1;
+        Time objective = 0;
+
+        // Prefix.
+        for (JobId pos = 0; pos < insertion_pos_; ++pos) {
+            objective += contribution(
+                    sequence_[pos],
+                    insertion_offset_ + heads_[pos + 1][last_machine_id]);
+            if (objective >= bound)
+                return objective;
+        }
+
+        // Block.
+        for (JobId block_pos = 0; block_pos < insertion_size_; ++block_pos) {
+            objective += contribution(
+                    insertion_job_ids_[block_pos],
+                    insertion_offset_ + insertion_last_heads_[block_pos]);
+            if (objective >= bound)
+                return objective;
+        }
+
+        // Suffix: only the heads of the last segment are needed.
+        MachineId first_machine_id = segments_first_machines_[delays_.size() - 1];
+        Time* f = insertion_heads_.data();
+        for (JobId pos = insertion_pos_; pos < (JobId)sequence_.size(); ++pos) {
+            JobId job_id = sequence_[pos];
+            const Time* p = processing_times_[job_id];
+            f[first_machine_id] += p[first_machine_id];
+            for (MachineId machine_id = first_machine_id + 1;
+                    machine_id <= last_machine_id;
+                    ++machine_id) {
+                f[machine_id] = (std::max)(f[machine_id], f[machine_id - 1])
+                    + p[machine_id];
+            }
+            objective += contribution(job_id, insertion_offset_ + f[last_machine_id]);
+            if (objective >= bound)
+                return objective;
+        }
+        return objective;
+    }
+
+private:
+
+    /*
+     * Private methods
+     */
+
+    /** Compute the relative heads of a job from the heads of the previous one. */
+    void advance(
+            const Time* h_prev,
+            Time* h,
+            const Time* p) const
+    {
+        for (MachineId machine_id = 0;
+                machine_id < number_of_machines_;
+                ++machine_id) {
+            if (segments_first_machines_[machines_segments_[machine_id]] == machine_id) {
+                h[machine_id] = h_prev[machine_id] + p[machine_id];
+            } else {
+                h[machine_id] = (std::max)(h_prev[machine_id], h[machine_id - 1])
+                    + p[machine_id];
+            }
+        }
+    }
+
+    /*
+     * Private attributes
+     */
+
+    /** Value used as minus infinity; small enough to never overflow. */
+    static constexpr Time minus_infinity = std::numeric_limits<Time>::min() / 4;
+
+    /** Number of machines. */
+    MachineId number_of_machines_ = 0;
+
+    /** Processing times; processing_times_[job_id][machine_id]. */
+    AlignedMatrix<Time> processing_times_;
+
+    /**
+     * First machine of each segment, followed by the number of machines as a
+     * sentinel.
+     */
+    std::vector<MachineId> segments_first_machines_;
+
+    /** Segment of each machine. */
+    std::vector<MachineId> machines_segments_;
+
+    /** Current sequence. */
+    std::vector<JobId> sequence_;
+
+    /**
+     * Relative heads; heads_[pos][machine_id] is the completion time of the
+     * pos-th job of the sequence relative to the start of its segment. Row 0
+     * is the all-zero initial state.
+     */
+    AlignedMatrix<Time> heads_;
+
+    /** Tails; row pos corresponds to the pos-th job, starting from 1. */
+    AlignedMatrix<Time> tails_;
+
+    /**
+     * Prefix maxima of the delays; prefix_maxima_[pos][segment_id] is the
+     * delay of segment 'segment_id' induced by the first pos jobs.
+     */
+    AlignedMatrix<Time> prefix_maxima_;
+
+    /** Delay of each segment. */
+    std::vector<Time> delays_;
+
+    /** Start of each segment. */
+    std::vector<Time> offsets_;
+
+    /** Makespan of the current sequence. */
+    Time makespan_ = 0;
+
+    /*
+     * Last evaluated insertion
+     */
+
+    std::vector<Time> insertion_heads_;
+
+    std::vector<Time> insertion_delays_;
+
+    std::vector<Time> insertion_cumulated_times_;
+
+    std::vector<Time> insertion_last_heads_;
+
+    const JobId* insertion_job_ids_ = nullptr;
+
+    JobId insertion_size_ = 0;
+
+    JobId insertion_pos_ = 0;
+
+    Time insertion_offset_ = 0;
+
+};
+
+}
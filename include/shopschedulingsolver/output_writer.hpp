@@ -0,0 +1,115 @@
+#pragma once
+
+#include "shopschedulingsolver/algorithm_formatter.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace shopschedulingsolver
+{
+
+/**
+ * Class that writes the JSON output and the certificate of the intermediary
+ * solutions of an algorithm from a background thread.
+ *
+ * The writer holds a single snapshot slot: if several solutions are pushed
+ * while a write is in progress, only the latest one is written. Two
+ * consecutive writes are separated by at least 'minimum_interval' seconds.
+ */
+class OutputWriter
+{
+
+public:
+
+    /** Constructor. */
+    OutputWriter(
+            const std::string& json_output_path,
+            const std::string& certificate_path,
+            const std::string& certificate_format,
+            double minimum_interval = 0.0);
+
+    /** Destructor; flush the pending snapshot and stop the thread. */
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    /**
+     * Push a snapshot of an output.
+     *
+     * This method copies the output and returns immediately.
+     */
+    void push(const Output& output);
+
+    /** Wait until the pending snapshot has been written. */
+    void flush();
+
+private:
+
+    /*
+     * Private methods
+     */
+
+    /** Snapshot of an output. */
+    struct Snapshot
+    {
+        /** JSON output. */
+        nlohmann::json json;
+
+        /** History of the intermediary outputs. */
+        IntermediaryOutputs intermediary_outputs;
+
+        /** Solution. */
+        Solution solution;
+    };
+
+    /** Loop of the writer thread. */
+    void run();
+
+    /** Write a snapshot. */
+    void write(Snapshot& snapshot) const;
+
+    /*
+     * Private attributes
+     */
+
+    /** Path of the JSON output file. */
+    std::string json_output_path_;
+
+    /** Path of the certificate file. */
+    std::string certificate_path_;
+
+    /** Format of the certificate file. */
+    std::string certificate_format_;
+
+    /** Minimum interval between two writes, in seconds. */
+    double minimum_interval_ = 0.0;
+
+    /** Mutex protecting the attributes below. */
+    std::mutex mutex_;
+
+    /** Condition variable used to wake up the writer thread. */
+    std::condition_variable condition_;
+
+    /** Condition variable used to notify that a write ended. */
+    std::condition_variable written_condition_;
+
+    /** Latest snapshot not written yet. */
+    std::unique_ptr<Snapshot> pending_;
+
+    /** True iff the writer thread is currently writing a snapshot. */
+    bool writing_ = false;
+
+    /** True iff a flush has been requested. */
+    bool flush_requested_ = false;
+
+    /** True iff the writer thread must stop. */
+    bool stop_ = false;
+
+    /** Writer thread. */
+    std::thread thread_;
+
+};
+
+}
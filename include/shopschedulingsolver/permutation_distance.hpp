@@ -0,0 +1,148 @@
+#pragma once
+
+/**
+ * Distance between job permutations.
+ *
+ * The distance between two permutations is the number of jobs whose
+ * predecessor differs plus the number of jobs whose successor differs; the
+ * first job has no predecessor and the last job has no successor.
+ *
+ * Each permutation caches its adjacency, i.e. the predecessor and the
+ * successor of each job packed in a single array of 32-bit integers, so that
+ * the distance is computed by a branch-free loop over two contiguous arrays
+ * instead of random accesses into the permutations.
+ *
+ * Optionally, a one-permutation MinHash sketch of the set of arcs of the
+ * permutation is computed as well. Comparing two sketches gives an estimate
+ * of the distance in time proportional to the size of the sketch instead of
+ * the number of jobs.
+ */
+
+#include "shopschedulingsolver/instance.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+namespace shopschedulingsolver
+{
+
+/** Cached adjacency of a permutation. */
+struct PermutationAdjacency
+{
+    /**
+     * Predecessor and successor of each job.
+     *
+     * 'neighbors[2 * job_id]' is the predecessor of job 'job_id' and
+     * 'neighbors[2 * job_id + 1]' its successor. The missing predecessor of
+     * the first job and the missing successor of the last job are encoded
+     * by the number of jobs.
+     */
+    std::vector<int32_t> neighbors;
+
+    /** MinHash sketch of the arcs; empty if not computed. */
+    std::vector<uint32_t> sketch;
+};
+
+namespace permutation_distance_internal
+{
+
+inline uint64_t hash(uint64_t value)
+{
+    // splitmix64 finalizer.
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+}
+
+/**
+ * Compute the adjacency of a complete permutation of 'number_of_jobs' jobs.
+ *
+ * If 'sketch_size' is positive, the MinHash sketch is computed as well.
+ */
+inline void compute_permutation_adjacency(
+        const std::vector<JobId>& jobs,
+        JobId number_of_jobs,
+        Counter sketch_size,
+        PermutationAdjacency& adjacency)
+{
+    int32_t none = (int32_t)number_of_jobs;
+    adjacency.neighbors.resize(2 * number_of_jobs);
+    for (JobId pos = 0; pos < (JobId)jobs.size(); ++pos) {
+        JobId job_id = jobs[pos];
+        adjacency.neighbors[2 * job_id] = (pos == 0)?
+            none: (int32_t)jobs[pos - 1];
+        adjacency.neighbors[2 * job_id + 1] = (pos == (JobId)jobs.size() - 1)?
+            none: (int32_t)jobs[pos + 1];
+    }
+
+    adjacency.sketch.clear();
+    if (sketch_size <= 0)
+        return;
+
+    // One-permutation hashing: each arc is hashed once, the hash selects a
+    // bin and the sketch keeps the minimum of the remaining bits in each bin.
+    // The arcs are the arcs between consecutive jobs, plus an arc from a
+    // dummy start to the first job and an arc from the last job to a dummy
+    // end.
+    adjacency.sketch.assign(sketch_size, UINT32_MAX);
+    uint64_t dummy = (uint64_t)number_of_jobs;
+    for (JobId pos = 0; pos <= (JobId)jobs.size(); ++pos) {
+        uint64_t from = (pos == 0)? dummy: (uint64_t)jobs[pos - 1];
+        uint64_t to = (pos == (JobId)jobs.size())? dummy + 1: (uint64_t)jobs[pos];
+        uint64_t h = permutation_distance_internal::hash((from << 32) | to);
+        Counter bin = (Counter)((h >> 32) % (uint64_t)sketch_size);
+        uint32_t value = (uint32_t)h;
+        if (value < adjacency.sketch[bin])
+            adjacency.sketch[bin] = value;
+    }
+}
+
+/** Compute the exact distance between two permutations. */
+inline Counter permutation_distance(
+        const PermutationAdjacency& adjacency_1,
+        const PermutationAdjacency& adjacency_2)
+{
+    const int32_t* neighbors_1 = adjacency_1.neighbors.data();
+    const int32_t* neighbors_2 = adjacency_2.neighbors.data();
+    std::size_t size = adjacency_1.neighbors.size();
+    int32_t distance = 0;
+    for (std::size_t pos = 0; pos < size; ++pos)
+        distance += (neighbors_1[pos] != neighbors_2[pos]);
+    return distance;
+}
+
+/**
+ * Estimate the distance between two permutations of 'number_of_jobs' jobs
+ * from their MinHash sketches.
+ */
+inline Counter permutation_distance_estimate(
+        const PermutationAdjacency& adjacency_1,
+        const PermutationAdjacency& adjacency_2,
+        JobId number_of_jobs)
+{
+    const uint32_t* sketch_1 = adjacency_1.sketch.data();
+    const uint32_t* sketch_2 = adjacency_2.sketch.data();
+    std::size_t size = adjacency_1.sketch.size();
+    int32_t number_of_matches = 0;
+    int32_t number_of_empty_bins = 0;
+    for (std::size_t pos = 0; pos < size; ++pos) {
+        number_of_matches += (sketch_1[pos] == sketch_2[pos]);
+        number_of_empty_bins += (sketch_1[pos] == UINT32_MAX) & (sketch_2[pos] == UINT32_MAX);
+    }
+    number_of_matches -= number_of_empty_bins;
+    Counter number_of_bins = (Counter)size - number_of_empty_bins;
+    if (number_of_bins == 0)
+        return 0;
+
+    // Both permutations have 'number_of_jobs + 1' arcs. With 'c' common arcs,
+    // the Jaccard index is J = c / (2 (n + 1) - c) and the distance is about
+    // 2 (n + 1 - c) = 2 (n + 1) (1 - J) / (1 + J).
+    double jaccard = (double)number_of_matches / number_of_bins;
+    return (Counter)std::round(
+            2.0 * (number_of_jobs + 1) * (1.0 - jaccard) / (1.0 + jaccard));
+}
+
+}
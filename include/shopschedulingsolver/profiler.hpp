@@ -0,0 +1,203 @@
+#pragma once
+
+/**
+ * Low-overhead instrumentation.
+ *
+ * Scoped timers and counters are accumulated in thread-local buffers and
+ * aggregated on demand. They are only enabled when the library is compiled
+ * with the SHOPSCHEDULINGSOLVER_PROFILE CMake option; otherwise the macros
+ * expand to nothing.
+ *
+ * The statistics are also accumulated in the runs attached to the thread
+ * adding them, so that the statistics of a run do not include the ones of
+ * the runs executed concurrently in the same process.
+ *
+ * Usage:
+ *
+ *     {
+ *         SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/Shift");
+ *         ...
+ *         SHOPSCHEDULINGSOLVER_PROFILE_COUNT("LocalSearchPfss/ShiftEvaluations", n);
+ *     }
+ */
+
+#include "shopschedulingsolver/instance.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace shopschedulingsolver
+{
+
+using ProfileEntryId = int64_t;
+
+/** Maximum number of distinct profile entries. */
+constexpr ProfileEntryId maximum_number_of_profile_entries = 256;
+
+/** Accumulated statistics of a profile entry. */
+struct ProfileEntry
+{
+    /** Name of the entry. */
+    std::string name;
+
+    /** Total time spent in the scopes of the entry, in seconds. */
+    double time = 0.0;
+
+    /** Number of scopes entered or value of the counter. */
+    Counter count = 0;
+};
+
+/** Profile, i.e. the statistics of all registered entries. */
+struct Profile
+{
+    /** Entries indexed by their id. */
+    std::vector<ProfileEntry> entries;
+
+
+    /**
+     * Compute the difference between two profiles.
+     *
+     * This is used to get the statistics of a period from two snapshots of
+     * the cumulative statistics. They include the statistics of all the runs
+     * executed concurrently during the period; the statistics of a single
+     * run are given by a ProfileRun.
+     */
+    Profile operator-(const Profile& profile) const;
+
+    /** Export the profile to a JSON structure. */
+    nlohmann::json to_json() const;
+};
+
+/**
+ * Get the id of a profile entry from its name, registering it if necessary.
+ */
+ProfileEntryId profile_register(const std::string& name);
+
+/** Add time (in nanoseconds) and count to a profile entry. */
+void profile_add(
+        ProfileEntryId profile_entry_id,
+        int64_t time,
+        Counter count);
+
+/** Get the cumulative statistics of all threads. */
+Profile profile_snapshot();
+
+/**
+ * Statistics of a single run.
+ *
+ * While a run is attached to a thread, the statistics added by the thread
+ * are also added to the run and to the runs in which it is nested, i.e. the
+ * run attached to the thread creating it. The threads working for a run must
+ * attach it with a ScopedProfileRun, and the run must outlive them.
+ */
+class ProfileRun
+{
+
+public:
+
+    /** Constructor. */
+    ProfileRun();
+
+    ProfileRun(const ProfileRun&) = delete;
+    ProfileRun& operator=(const ProfileRun&) = delete;
+
+    /** Get the statistics of the run. */
+    Profile profile() const;
+
+private:
+
+    friend void profile_add(ProfileEntryId, int64_t, Counter);
+
+    /** Run in which the run is nested. */
+    ProfileRun* parent_;
+
+    /** Time of each entry, in nanoseconds. */
+    std::atomic<int64_t> times_[maximum_number_of_profile_entries];
+
+    /** Count of each entry. */
+    std::atomic<int64_t> counts_[maximum_number_of_profile_entries];
+
+};
+
+/** Get the run attached to the current thread; null if there is none. */
+ProfileRun* profile_current_run();
+
+/** Attach a run to the current thread for the lifetime of the object. */
+class ScopedProfileRun
+{
+
+public:
+
+    /** Constructor. */
+    ScopedProfileRun(ProfileRun* profile_run);
+
+    /** Destructor; re-attach the previous run. */
+    ~ScopedProfileRun();
+
+    ScopedProfileRun(const ScopedProfileRun&) = delete;
+    ScopedProfileRun& operator=(const ScopedProfileRun&) = delete;
+
+private:
+
+    /** Run attached to the thread before. */
+    ProfileRun* previous_profile_run_;
+
+};
+
+/** Scoped timer adding its lifetime to a profile entry. */
+class ScopedProfileTimer
+{
+
+public:
+
+    /** Constructor. */
+    ScopedProfileTimer(ProfileEntryId profile_entry_id):
+        profile_entry_id_(profile_entry_id),
+        start_(std::chrono::steady_clock::now()) { }
+
+    /** Destructor. */
+    ~ScopedProfileTimer()
+    {
+        auto end = std::chrono::steady_clock::now();
+        profile_add(
+                profile_entry_id_,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count(),
+                1);
+    }
+
+private:
+
+    /** Profile entry. */
+    ProfileEntryId profile_entry_id_;
+
+    /** Start time. */
+    std::chrono::steady_clock::time_point start_;
+
+};
+
+}
+
+#define SHOPSCHEDULINGSOLVER_PROFILE_CONCAT_IMPL(x, y) x ## y
+#define SHOPSCHEDULINGSOLVER_PROFILE_CONCAT(x, y) SHOPSCHEDULINGSOLVER_PROFILE_CONCAT_IMPL(x, y)
+
+#ifdef SHOPSCHEDULINGSOLVER_PROFILE
+
+#define SHOPSCHEDULINGSOLVER_PROFILE_SCOPE(name) \
+    static const shopschedulingsolver::ProfileEntryId SHOPSCHEDULINGSOLVER_PROFILE_CONCAT(profile_entry_id_, __LINE__) \
+        = shopschedulingsolver::profile_register(name); \
+    shopschedulingsolver::ScopedProfileTimer SHOPSCHEDULINGSOLVER_PROFILE_CONCAT(profile_timer_, __LINE__)( \
+            SHOPSCHEDULINGSOLVER_PROFILE_CONCAT(profile_entry_id_, __LINE__))
+
+#define SHOPSCHEDULINGSOLVER_PROFILE_COUNT(name, value) \
+    do { \
+        static const shopschedulingsolver::ProfileEntryId profile_entry_id \
+            = shopschedulingsolver::profile_register(name); \
+        shopschedulingsolver::profile_add(profile_entry_id, 0, value); \
+    } while (0)
+
+#else
+
+#define SHOPSCHEDULINGSOLVER_PROFILE_SCOPE(name) do { } while (0)
+#define SHOPSCHEDULINGSOLVER_PROFILE_COUNT(name, value) do { } while (0)
+
+#endif
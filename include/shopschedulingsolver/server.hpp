@@ -0,0 +1,303 @@
+/**
+ * Solver server
+ *
+ * The server keeps running between solves, listening on a Unix domain socket.
+ * Clients exchange messages made of a 4-byte big-endian length followed by a
+ * JSON object. Each request has a "type":
+ *
+ * - "submit": submit an instance
+ *   {"type": "submit", "format": "flow-shop", "content": "...",
+ *    "objective": "makespan", "no_wait": false, ...}
+ *   The optional fields "objective", "operations_arbitrary_order", "no_wait",
+ *   "no_idle", "blocking" and "permutation" are the ones of the command line.
+ *   Reply: {"type": "instance", "instance_id": "...", "cached": true}
+ *   Instances are cached by a hash of their content, so submitting the same
+ *   instance again skips its parsing. The content is compared on a hit, so
+ *   that colliding instances are not mixed up.
+ *
+ * - "solve": solve a submitted instance
+ *   {"type": "solve", "instance_id": "...", "algorithm": "...",
+ *    "time_limit": 10.0, "seed": 0, "parameters": {...}}
+ *   The keys of the optional "parameters" are the options of the command
+ *   line, with underscores instead of dashes, e.g.
+ *   {"maximum_number_of_iterations": 100, "neighborhoods": ["shift-1"]}.
+ *   Reply: {"type": "solve", "solve_id": 0}
+ *   Then, for each new solution:
+ *   {"type": "solution", "solve_id": 0, "output": {...}}
+ *   And at the end:
+ *   {"type": "end", "solve_id": 0, "cancelled": false, "output": {...}}
+ *   Solves are run by a pool of worker threads, in submission order.
+ *
+ * - "cancel": cancel a solve of the same connection
+ *   {"type": "cancel", "solve_id": 0}
+ *   Reply: {"type": "cancel", "solve_id": 0}
+ *   The solve then ends as soon as its algorithm checks its timer.
+ *
+ * Invalid requests are answered by {"type": "error", "message": "..."}, with
+ * the "solve_id" if the error happened during a solve. The solves of a
+ * connection are cancelled when the connection is closed.
+ */
+
+#pragma once
+
+#include "shopschedulingsolver/algorithm_formatter.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace shopschedulingsolver
+{
+
+/**
+ * Write a message to a socket.
+ *
+ * Return false if the connection is closed.
+ */
+bool write_message(
+        int fd,
+        const nlohmann::json& message);
+
+/**
+ * Read a message from a socket.
+ *
+ * Return false if the connection is closed.
+ */
+bool read_message(
+        int fd,
+        nlohmann::json& message);
+
+/** Solve requested to the server. */
+struct ServerSolve
+{
+    /** Instance. */
+    std::shared_ptr<const Instance> instance;
+
+    /** Name of the algorithm. */
+    std::string algorithm;
+
+    /** Seed. */
+    Seed seed = 0;
+
+    /** Parameters specific to the algorithm, as given in the request. */
+    nlohmann::json algorithm_parameters;
+
+    /**
+     * Parameters common to all the algorithms.
+     *
+     * Their timer holds the time limit and the cancellation of the solve, and
+     * their new solution callback streams the solutions to the client.
+     */
+    Parameters parameters;
+
+    /** Set the parameters common to all the algorithms. */
+    void set_parameters(Parameters& algorithm_parameters) const
+    {
+        algorithm_parameters.timer = parameters.timer;
+        algorithm_parameters.verbosity_level = parameters.verbosity_level;
+        algorithm_parameters.log_path = parameters.log_path;
+        algorithm_parameters.log_to_stderr = parameters.log_to_stderr;
+        algorithm_parameters.messages_to_stdout = parameters.messages_to_stdout;
+        algorithm_parameters.new_solution_callback = parameters.new_solution_callback;
+    }
+};
+
+/** Function running the algorithm of a solve. */
+using ServerSolveFunction = std::function<Output(const ServerSolve&)>;
+
+struct ServerParameters
+{
+    /** Path of the Unix domain socket. */
+    std::string socket_path;
+
+    /** Number of solves run concurrently. */
+    Counter number_of_threads = std::thread::hardware_concurrency();
+
+    /**
+     * Maximum number of instances kept in cache.
+     *
+     * Beyond, the oldest instances are removed.
+     */
+    Counter maximum_number_of_cached_instances = 64;
+};
+
+class Server
+{
+
+public:
+
+    /** Constructor. */
+    Server(
+            const ServerParameters& parameters,
+            const ServerSolveFunction& solve_function);
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * Run the server.
+     *
+     * This method blocks until 'stop' is called.
+     */
+    void run();
+
+    /**
+     * Stop the server.
+     *
+     * The running solves are cancelled. This method may be called from any
+     * thread.
+     */
+    void stop();
+
+    /** Return true iff the server is listening. */
+    bool listening() const { return listening_; }
+
+private:
+
+    /*
+     * Private methods
+     */
+
+    /** Connection of a client. */
+    struct Connection
+    {
+        /** Socket. */
+        int fd = -1;
+
+        /** Mutex protecting the writes to the socket. */
+        std::mutex mutex;
+
+        /** Thread reading the requests of the connection. */
+        std::thread thread;
+
+        /** Destructor; close the socket. */
+        ~Connection();
+
+        /** Send a message; ignore the errors of closed connections. */
+        void send(const nlohmann::json& message);
+    };
+
+    /** Cached instance. */
+    struct CachedInstance
+    {
+        /** Serialized submit request from which the instance was built. */
+        std::string key;
+
+        /** Instance. */
+        std::shared_ptr<const Instance> instance;
+    };
+
+    /** Solve of the queue. */
+    struct Solve
+    {
+        /** Id of the solve. */
+        Counter id = -1;
+
+        /** Connection which requested the solve. */
+        std::shared_ptr<Connection> connection;
+
+        /**
+         * Solve.
+         *
+         * Its common parameters are set when it starts, so that the time
+         * spent in the queue does not count in its time limit.
+         */
+        ServerSolve solve;
+
+        /** Time limit, in seconds. */
+        double time_limit = std::numeric_limits<double>::infinity();
+
+        /** True iff the solve has been cancelled. */
+        bool cancelled = false;
+    };
+
+    /** Loop of a connection thread. */
+    void run_connection(std::shared_ptr<Connection> connection);
+
+    /** Loop of a worker thread. */
+    void run_worker();
+
+    /** Handle a "submit" request. */
+    nlohmann::json submit(const nlohmann::json& request);
+
+    /**
+     * Return the id of the cached instance built from a serialized submit
+     * request, or the id to give to it if it is not cached.
+     *
+     * The ids are the content hashes of the requests; colliding requests
+     * get a suffix. The mutex must be held.
+     */
+    std::string find_instance_id(
+            const std::string& key,
+            bool& cached) const;
+
+    /** Join the threads of the ended connections. */
+    void join_ended_connections();
+
+    /** Handle a "solve" request; the reply is sent before the solve starts. */
+    void queue_solve(
+            const std::shared_ptr<Connection>& connection,
+            const nlohmann::json& request);
+
+    /** Handle a "cancel" request. */
+    nlohmann::json cancel(
+            const std::shared_ptr<Connection>& connection,
+            const nlohmann::json& request);
+
+    /*
+     * Private attributes
+     */
+
+    /** Parameters. */
+    ServerParameters parameters_;
+
+    /** Function running the algorithm of a solve. */
+    ServerSolveFunction solve_function_;
+
+    /** Listening socket. */
+    int listen_fd_ = -1;
+
+    /** True iff the server is listening. */
+    std::atomic<bool> listening_{false};
+
+    /** Mutex protecting the attributes below. */
+    std::mutex mutex_;
+
+    /** Condition variable used to wake up the worker threads. */
+    std::condition_variable condition_;
+
+    /** True iff the server must stop. */
+    bool stop_ = false;
+
+    /** Cached instances, by id. */
+    std::map<std::string, CachedInstance> instances_;
+
+    /** Ids of the cached instances, from the oldest. */
+    std::deque<std::string> instance_ids_;
+
+    /** Solves not ended yet, by id. */
+    std::map<Counter, std::shared_ptr<Solve>> solves_;
+
+    /** Solves not started yet. */
+    std::deque<std::shared_ptr<Solve>> queue_;
+
+    /** Id of the next solve. */
+    Counter next_solve_id_ = 0;
+
+    /** Open connections. */
+    std::vector<std::shared_ptr<Connection>> connections_;
+
+    /** Ended connections whose threads have not been joined yet. */
+    std::vector<std::shared_ptr<Connection>> ended_connections_;
+
+    /** Worker threads. */
+    std::vector<std::thread> worker_threads_;
+
+};
+
+}
@@ -7,6 +7,12 @@ namespace shopschedulingsolver
 
 using SolutionOperationId = int64_t;
 
+/** Magic bytes at the beginning of a certificate in binary format. */
+constexpr char solution_binary_format_magic[] = "SSSB";
+
+/** Version of the binary certificate format. */
+constexpr int64_t solution_binary_format_version = 1;
+
 /**
  * Solution class.
  */
@@ -99,6 +105,12 @@ public:
     /** Get the number of precedence violations. */
     OperationId number_of_precedence_violations() const { return this->number_of_precedence_violations_; }
 
+    /** Get the number of fixed operations not scheduled as fixed. */
+    OperationId number_of_fixed_operation_violations() const { return this->number_of_fixed_operation_violations_; }
+
+    /** Get the number of operations scheduled before the availability of their machine. */
+    OperationId number_of_machine_availability_violations() const { return this->number_of_machine_availability_violations_; }
+
     /** Get no-wait feasibility. */
     bool no_wait() const { return no_wait_; }
 
@@ -136,7 +148,13 @@ public:
      * Export
      */
 
-    /** Write the solution to a file. */
+    /**
+     * Write the solution to a file.
+     *
+     * Available formats: "json" (default), "json-compact", "csv" and
+     * "binary". The file is written into a temporary file which is then
+     * renamed, so that readers never see a partially written certificate.
+     */
     void write(
             const std::string& certificate_path,
             const std::string& format) const;
@@ -186,6 +204,12 @@ private:
     /** Number of precedence violations. */
     OperationId number_of_precedence_violations_ = 0;
 
+    /** Number of fixed operations not scheduled as fixed. */
+    OperationId number_of_fixed_operation_violations_ = 0;
+
+    /** Number of operations scheduled before the availability of their machine. */
+    OperationId number_of_machine_availability_violations_ = 0;
+
     /** No-wait feasibility. */
     bool no_wait_ = true;
 
@@ -0,0 +1,251 @@
+/**
+ * Work-stealing thread pool
+ *
+ * The pool is meant to be shared by the algorithms running in a process
+ * instead of each of them creating its own threads.
+ *
+ * Tasks are submitted through task groups:
+ *
+ *     TaskGroup task_group(thread_pool, generator, parameters.timer);
+ *     for (...)
+ *         task_group.run([&](TaskContext& task_context) { ... });
+ *     task_group.wait();
+ *
+ * - Each worker thread owns a deque of tasks. A task submitted from a worker
+ *   is pushed at the back of its deque, and a worker runs the most recent
+ *   task of its deque first. An idle worker steals the oldest task of
+ *   another deque. Tasks submitted from another thread go to a shared queue.
+ * - A thread waiting for a task group runs tasks meanwhile, so that task
+ *   groups can be nested inside tasks, and so that a pool without worker
+ *   threads runs the tasks in the waiting thread.
+ * - Each task group has its own copy of the timer it is given, which also
+ *   ends when the group is cancelled. The tasks receive it, so that the
+ *   algorithms they run stop when the group is cancelled or when the time
+ *   limit is reached. The tasks which have not started by then are skipped.
+ *   A task group created inside a task from its timer is cancelled with it.
+ * - The seed of the generator of a task is drawn from the generator of the
+ *   group when the task is submitted. It depends only on the order in which
+ *   the tasks are submitted, not on the threads running them.
+ * - The profile run attached to the thread submitting a task is attached to
+ *   the thread running it.
+ */
+
+#pragma once
+
+#include "shopschedulingsolver/algorithm_formatter.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace shopschedulingsolver
+{
+
+/** Context given to a task. */
+struct TaskContext
+{
+    /** Rank of the task in its group. */
+    Counter task_id;
+
+    /** Generator of the task. */
+    std::mt19937_64 generator;
+
+    /** Timer of the task group. */
+    const optimizationtools::Timer& timer;
+};
+
+using TaskFunction = std::function<void(TaskContext&)>;
+
+class TaskGroup;
+
+class ThreadPool
+{
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * With 0 threads, the tasks are run by the threads waiting for their
+     * group.
+     */
+    ThreadPool(Counter number_of_threads = std::thread::hardware_concurrency());
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Destructor.
+     *
+     * The task groups must have been waited for.
+     */
+    ~ThreadPool();
+
+    /** Get the number of worker threads. */
+    Counter number_of_threads() const { return worker_threads_.size(); }
+
+private:
+
+    friend class TaskGroup;
+
+    /*
+     * Private methods
+     */
+
+    /** Task. */
+    struct Task
+    {
+        /** Group of the task. */
+        TaskGroup* task_group = nullptr;
+
+        /** Rank of the task in its group. */
+        Counter task_id = -1;
+
+        /** Seed of the generator of the task. */
+        std::mt19937_64::result_type seed = 0;
+
+        /** Profile run attached to the thread submitting the task. */
+        ProfileRun* profile_run = nullptr;
+
+        /** Function. */
+        TaskFunction function;
+    };
+
+    /** Tasks of a worker thread. */
+    struct WorkerDeque
+    {
+        /** Mutex protecting the tasks. */
+        std::mutex mutex;
+
+        /** Tasks. */
+        std::deque<Task> tasks;
+    };
+
+    /** Submit a task. */
+    void submit(Task&& task);
+
+    /**
+     * Take a task and run it.
+     *
+     * Return false if there was no task to run.
+     */
+    bool run_one();
+
+    /** Loop of a worker thread. */
+    void run_worker(Counter worker_id);
+
+    /*
+     * Private attributes
+     */
+
+    /** Deques of the worker threads. */
+    std::vector<WorkerDeque> worker_deques_;
+
+    /** Tasks submitted from threads which are not workers of the pool. */
+    WorkerDeque shared_deque_;
+
+    /** Worker threads. */
+    std::vector<std::thread> worker_threads_;
+
+    /** Mutex protecting the attributes below. */
+    std::mutex mutex_;
+
+    /** Condition variable used to wake up the worker threads. */
+    std::condition_variable condition_;
+
+    /** Number of tasks submitted and not taken yet. */
+    Counter number_of_queued_tasks_ = 0;
+
+    /** True iff the worker threads must stop. */
+    bool stop_ = false;
+
+};
+
+class TaskGroup
+{
+
+public:
+
+    /** Constructor. */
+    TaskGroup(
+            ThreadPool& thread_pool,
+            std::mt19937_64& generator,
+            const optimizationtools::Timer& timer = optimizationtools::Timer());
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * Destructor.
+     *
+     * If the group has not been waited for, it is cancelled and waited for;
+     * the exceptions of its tasks are ignored.
+     */
+    ~TaskGroup();
+
+    /** Submit a task. */
+    void run(const TaskFunction& function);
+
+    /**
+     * Wait for the end of the tasks of the group.
+     *
+     * If a task threw an exception, the group is cancelled and the first
+     * exception is rethrown.
+     */
+    void wait();
+
+    /**
+     * Cancel the group.
+     *
+     * The timer of the group ends and the tasks which have not started are
+     * skipped. This method may be called from any thread.
+     */
+    void cancel();
+
+    /** Return true iff the group has been cancelled. */
+    bool cancelled();
+
+    /** Get the timer of the group. */
+    const optimizationtools::Timer& timer() const { return timer_; }
+
+private:
+
+    friend class ThreadPool;
+
+    /** Run a task of the group. */
+    void execute(ThreadPool::Task& task);
+
+    /** Thread pool. */
+    ThreadPool& thread_pool_;
+
+    /** Generator from which the seeds of the tasks are drawn. */
+    std::mt19937_64& generator_;
+
+    /** Timer of the group; it also ends when the group is cancelled. */
+    optimizationtools::Timer timer_;
+
+    /** Number of tasks submitted. */
+    Counter number_of_tasks_ = 0;
+
+    /** Mutex protecting the attributes below. */
+    std::mutex mutex_;
+
+    /** Condition variable notified when a task of the group ends. */
+    std::condition_variable condition_;
+
+    /** Number of tasks not ended yet. */
+    Counter number_of_pending_tasks_ = 0;
+
+    /** True iff the group has been cancelled. */
+    bool cancelled_ = false;
+
+    /** First exception thrown by a task. */
+    std::exception_ptr exception_;
+
+};
+
+}
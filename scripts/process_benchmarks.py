@@ -40,6 +40,36 @@ output_directories.sort()
 bksv_field = "Best known solution value"
 
 
+def show_profiles(benchmark_directory, output_directories):
+    """Sum the "Profile" entries of the JSON outputs of each output
+    directory. They are only present when the solver is built with the
+    SHOPSCHEDULINGSOLVER_PROFILE CMake option."""
+    rows = []
+    columns = ["Output directory", "Number of instances"]
+    for output_directory in output_directories:
+        row = {"Output directory": output_directory, "Number of instances": 0}
+        directory = os.path.join(benchmark_directory, output_directory)
+        for json_output_path in pathlib.Path(directory).rglob("*_output.json"):
+            try:
+                with open(json_output_path) as json_output_file:
+                    json_data = json.load(json_output_file)
+                profile = json_data["Output"]["Profile"]
+            except:
+                continue
+            row["Number of instances"] += 1
+            for name, entry in profile.items():
+                for key in ["Time", "Count"]:
+                    column = name + " / " + key
+                    if column not in columns:
+                        columns.append(column)
+                    row[column] = row.get(column, 0) + entry[key]
+        rows.append(row)
+    if len(columns) == 2:
+        return
+    st.header("Profile")
+    show_datafram(pd.DataFrame.from_records(rows, columns=columns))
+
+
 if benchmark == "pfss_blocking_makespan":
 
     datacsv_path = os.path.join("data", "data_pfss_blocking_makespan.csv")
@@ -508,3 +538,6 @@ if benchmark == "pfss_tt":
                     for fieldname in out_fieldnames]
         df = df.style.apply(highlight, axis = 1)
         show_datafram(df)
+
+
+show_profiles(benchmark_directory, output_directories)
@@ -10,6 +10,11 @@ void AlgorithmFormatter::start(
         const std::string& algorithm_name)
 {
     output_.json["Parameters"] = parameters_.to_json();
+#ifdef SHOPSCHEDULINGSOLVER_PROFILE
+    scoped_profile_run_.reset();
+    profile_run_.reset(new ProfileRun());
+    scoped_profile_run_.reset(new ScopedProfileRun(profile_run_.get()));
+#endif
 
     if (parameters_.verbosity_level == 0)
         return;
@@ -143,7 +148,7 @@ void AlgorithmFormatter::update_solution(
         output_.time = parameters_.timer.elapsed_time();
         output_.solution = solution;
         print(s);
-        output_.json["IntermediaryOutputs"].push_back(output_.to_json());
+        add_intermediary_output();
         parameters_.new_solution_callback(output_);
     }
 }
@@ -159,7 +164,7 @@ void AlgorithmFormatter::update_makespan_bound(
         output_.time = parameters_.timer.elapsed_time();
         output_.makespan_bound = bound;
         print(s);
-        output_.json["IntermediaryOutputs"].push_back(output_.to_json());
+        add_intermediary_output();
         parameters_.new_solution_callback(output_);
     }
 }
@@ -175,7 +180,7 @@ void AlgorithmFormatter::update_total_flow_time_bound(
         output_.time = parameters_.timer.elapsed_time();
         output_.total_flow_time_bound = bound;
         print(s);
-        output_.json["IntermediaryOutputs"].push_back(output_.to_json());
+        add_intermediary_output();
         parameters_.new_solution_callback(output_);
     }
 }
@@ -191,7 +196,7 @@ void AlgorithmFormatter::update_total_tardiness_bound(
         output_.time = parameters_.timer.elapsed_time();
         output_.total_tardiness_bound = bound;
         print(s);
-        output_.json["IntermediaryOutputs"].push_back(output_.to_json());
+        add_intermediary_output();
         parameters_.new_solution_callback(output_);
     }
 }
@@ -207,15 +212,30 @@ void AlgorithmFormatter::update_throughput_bound(
         output_.time = parameters_.timer.elapsed_time();
         output_.throughput_bound = bound;
         print(s);
-        output_.json["IntermediaryOutputs"].push_back(output_.to_json());
+        add_intermediary_output();
         parameters_.new_solution_callback(output_);
     }
 }
 
+void AlgorithmFormatter::add_intermediary_output()
+{
+    output_.intermediary_outputs.add(
+            output_.time,
+            output_.solution.objective_value(),
+            output_.bound(),
+            parameters_.maximum_number_of_intermediary_outputs);
+}
+
 void AlgorithmFormatter::end()
 {
     output_.time = parameters_.timer.elapsed_time();
+#ifdef SHOPSCHEDULINGSOLVER_PROFILE
+    if (profile_run_ != nullptr)
+        output_.profile = profile_run_->profile();
+#endif
     output_.json["Output"] = output_.to_json();
+    output_.json["IntermediaryOutputs"] = output_.intermediary_outputs.to_json();
+    parameters_.end_callback(output_);
 
     if (parameters_.verbosity_level == 0)
         return;
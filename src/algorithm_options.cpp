@@ -0,0 +1,281 @@
+#include "shopschedulingsolver/algorithm_options.hpp"
+
+#include "shopschedulingsolver/algorithms/tree_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/algorithms/tree_search_pfss.hpp"
+#include "shopschedulingsolver/algorithms/milp_positional.hpp"
+#include "shopschedulingsolver/algorithms/milp_disjunctive.hpp"
+#ifdef OPTALCP_FOUND
+#include "shopschedulingsolver/algorithms/constraint_programming_optalcp.hpp"
+#endif
+#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss_no_wait.hpp"
+#include "shopschedulingsolver/algorithms/portfolio.hpp"
+#include "shopschedulingsolver/algorithms/rolling_horizon_pfss.hpp"
+#include "shopschedulingsolver/algorithms/lns_pfss.hpp"
+#include "shopschedulingsolver/algorithms/branch_and_bound_pfss_makespan.hpp"
+
+#include <algorithm>
+
+using namespace shopschedulingsolver;
+namespace po = boost::program_options;
+
+namespace
+{
+
+void read_local_search_parameters(
+        LocalSearchParameters& parameters,
+        const po::variables_map& vm)
+{
+    if (vm.count("maximum-number-of-iterations"))
+        parameters.maximum_number_of_iterations = vm["maximum-number-of-iterations"].as<Counter>();
+    if (vm.count("maximum-number-of-iterations-without-improvement"))
+        parameters.maximum_number_of_iterations_without_improvement = vm["maximum-number-of-iterations-without-improvement"].as<Counter>();
+    if (vm.count("population-minimum-size"))
+        parameters.population_minimum_size = vm["population-minimum-size"].as<Counter>();
+    if (vm.count("population-maximum-size"))
+        parameters.population_maximum_size = vm["population-maximum-size"].as<Counter>();
+    if (vm.count("number-of-elite-solutions"))
+        parameters.number_of_elite_solutions = vm["number-of-elite-solutions"].as<Counter>();
+    if (vm.count("number-of-closest-neighbors"))
+        parameters.number_of_closest_neighbors = vm["number-of-closest-neighbors"].as<Counter>();
+    if (vm.count("distance-sketch-size"))
+        parameters.distance_sketch_size = vm["distance-sketch-size"].as<Counter>();
+    if (vm.count("neighborhoods"))
+        parameters.neighborhoods = vm["neighborhoods"].as<std::vector<LocalSearchNeighborhood>>();
+    if (vm.count("perturbations"))
+        parameters.perturbations = vm["perturbations"].as<std::vector<LocalSearchPerturbation>>();
+    if (vm.count("perturbation-strength"))
+        parameters.perturbation_strength = vm["perturbation-strength"].as<JobId>();
+    if (vm.count("large-number-of-jobs"))
+        parameters.large_number_of_jobs = vm["large-number-of-jobs"].as<JobId>();
+}
+
+}
+
+void shopschedulingsolver::add_algorithm_options(
+        po::options_description& desc)
+{
+    desc.add_options()
+        ("solver,", po::value<mathoptsolverscmake::SolverName>(), "set solver")
+
+        ("maximum-number-of-iterations,", po::value<Counter>(), "set maximum number of iterations")
+        ("maximum-number-of-iterations-without-improvement,", po::value<Counter>(), "set maximum number of iterations without improvement")
+        ("population-minimum-size,", po::value<Counter>(), "set minimum size of the population")
+        ("population-maximum-size,", po::value<Counter>(), "set maximum size of the population")
+        ("number-of-elite-solutions,", po::value<Counter>(), "set number of elite solutions of the population")
+        ("number-of-closest-neighbors,", po::value<Counter>(), "set number of closest neighbors used to compute the diversity of a solution")
+        ("distance-sketch-size,", po::value<Counter>(), "set size of the MinHash sketches used to estimate distances between solutions (0 for exact distances)")
+        ("neighborhoods,", po::value<std::vector<LocalSearchNeighborhood>>()->multitoken(), "set neighborhoods (shift-<k>, shift-reverse-<k>, swap-<k1>-<k2>)")
+        ("perturbations,", po::value<std::vector<LocalSearchPerturbation>>()->multitoken(), "set perturbations (random-adjacent-swaps, random-shifts, ruin-and-recreate-1, ruin-and-recreate-jobs, ruin-and-recreate-block)")
+        ("perturbation-strength,", po::value<JobId>(), "set maximum number of jobs moved or removed by a perturbation")
+        ("large-number-of-jobs,", po::value<JobId>(), "set number of jobs from which the automatic profile considers an instance as large")
+        ("multi-lane-shift-evaluation,", po::value<bool>(), "set multi-lane evaluation of the shift neighborhood")
+        ("number-of-islands,", po::value<Counter>(), "set number of islands")
+        ("migration-interval,", po::value<Counter>(), "set number of iterations between two migrations")
+        ("destruction-size,", po::value<JobId>(), "set number of jobs removed by the destruction phase")
+        ("temperature-factor,", po::value<double>(), "set temperature factor of the acceptance criterion")
+        ("maximum-block-size,", po::value<JobId>(), "set maximum size of the blocks moved by the Or-opt neighborhood")
+        ("portfolio-algorithms,", po::value<std::vector<PortfolioAlgorithm>>()->multitoken(), "set algorithms run concurrently by the portfolio (tree-search-pfss-makespan, local-search-pfss-makespan, local-search-pfss, milp-positional)")
+        ("local-search-restart-interval,", po::value<Counter>(), "set number of iterations without improvement after which a local search of the portfolio is restarted from the incumbent")
+        ("initial-order,", po::value<RollingHorizonOrder>(), "set initial order of the rolling horizon (release-dates, decreasing-total-processing-time)")
+        ("window-size,", po::value<JobId>(), "set number of jobs of a window of the rolling horizon")
+        ("window-step,", po::value<JobId>(), "set number of jobs committed after solving a window of the rolling horizon")
+        ("window-time-limit,", po::value<double>(), "set time limit in seconds of a window of the rolling horizon")
+        ("number-of-threads,", po::value<Counter>(), "set number of threads of the rolling horizon, of the large neighborhood search and of the branch-and-bound")
+        ("lns-neighborhoods,", po::value<std::vector<LnsPfssNeighborhood>>()->multitoken(), "set neighborhoods of the large neighborhood search (window, random-subset)")
+        ("initial-subproblem-size,", po::value<JobId>(), "set initial number of jobs of a subproblem of the large neighborhood search")
+        ("minimum-subproblem-size,", po::value<JobId>(), "set minimum number of jobs of a subproblem of the large neighborhood search")
+        ("maximum-subproblem-size,", po::value<JobId>(), "set maximum number of jobs of a subproblem of the large neighborhood search")
+        ("subproblem-time-limit,", po::value<double>(), "set time limit in seconds of a subproblem of the large neighborhood search")
+        ("lower-bound,", po::value<BranchAndBoundPfssMakespanLowerBound>(), "set lower bound of the branch-and-bound (lb1, lb2)")
+        ;
+}
+
+po::variables_map shopschedulingsolver::read_algorithm_options(
+        const po::options_description& desc,
+        const nlohmann::json& json)
+{
+    if (!json.is_null() && !json.is_object()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the parameters must be a JSON object.");
+    }
+
+    // Convert the object into command line arguments, so that the values
+    // are parsed and checked as on the command line.
+    std::vector<std::string> args;
+    if (json.is_object()) {
+        for (auto it = json.begin(); it != json.end(); ++it) {
+            std::string option = it.key();
+            std::replace(option.begin(), option.end(), '_', '-');
+            if (it->is_array()) {
+                args.push_back("--" + option);
+                for (const nlohmann::json& value: *it)
+                    args.push_back((value.is_string())? value.get<std::string>(): value.dump());
+            } else {
+                // Attach the value to the option, so that negative numbers
+                // are not parsed as options.
+                args.push_back("--" + option + "="
+                        + ((it->is_string())? it->get<std::string>(): it->dump()));
+            }
+        }
+    }
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(args).options(desc).run(), vm);
+    po::notify(vm);
+    return vm;
+}
+
+Output shopschedulingsolver::run_algorithm(
+        const Instance& instance,
+        const std::string& algorithm,
+        std::mt19937_64& generator,
+        const po::variables_map& vm,
+        const SetCommonParametersFunction& set_common_parameters,
+        ThreadPool* thread_pool)
+{
+    if (algorithm == "tree-search-pfss-makespan") {
+        TreeSearchPfssMakespanParameters parameters;
+        set_common_parameters(parameters);
+        return tree_search_pfss_makespan(instance, parameters);
+
+    } else if (algorithm == "tree-search-pfss") {
+        TreeSearchPfssParameters parameters;
+        set_common_parameters(parameters);
+        return tree_search_pfss(instance, parameters);
+
+    } else if (algorithm == "milp-positional") {
+        MilpPositionalParameters parameters;
+        set_common_parameters(parameters);
+        if (vm.count("solver"))
+            parameters.solver = vm["solver"].as<mathoptsolverscmake::SolverName>();
+        return milp_positional(instance, nullptr, parameters);
+
+    } else if (algorithm == "milp-disjunctive") {
+        MilpDisjunctiveParameters parameters;
+        set_common_parameters(parameters);
+        if (vm.count("solver"))
+            parameters.solver = vm["solver"].as<mathoptsolverscmake::SolverName>();
+        return milp_disjunctive(instance, nullptr, parameters);
+
+#ifdef OPTALCP_FOUND
+    } else if (algorithm == "constraint-programming-optalcp") {
+        Parameters parameters;
+        set_common_parameters(parameters);
+        return constraint_programming_optalcp(instance, parameters);
+#endif
+
+    } else if (algorithm == "local-search-pfss-makespan") {
+        if (instance.objective() == Objective::Makespan) {
+            LocalSearchParameters parameters;
+            set_common_parameters(parameters);
+            read_local_search_parameters(parameters, vm);
+            return local_search_pfss_makespan(instance, generator, nullptr, parameters);
+        }
+
+    } else if (algorithm == "local-search-pfss") {
+        if (instance.objective() == Objective::TotalFlowTime
+                || instance.objective() == Objective::TotalTardiness) {
+            LocalSearchPfssParameters parameters;
+            set_common_parameters(parameters);
+            read_local_search_parameters(parameters, vm);
+            if (vm.count("multi-lane-shift-evaluation"))
+                parameters.multi_lane_shift_evaluation = vm["multi-lane-shift-evaluation"].as<bool>();
+            if (vm.count("number-of-islands"))
+                parameters.number_of_islands = vm["number-of-islands"].as<Counter>();
+            if (vm.count("migration-interval"))
+                parameters.migration_interval = vm["migration-interval"].as<Counter>();
+            parameters.thread_pool = thread_pool;
+            return local_search_pfss(instance, generator, nullptr, parameters);
+        }
+
+    } else if (algorithm == "local-search-pfss-no-wait") {
+        LocalSearchPfssNoWaitParameters parameters;
+        set_common_parameters(parameters);
+        if (vm.count("maximum-number-of-iterations"))
+            parameters.maximum_number_of_iterations = vm["maximum-number-of-iterations"].as<Counter>();
+        if (vm.count("maximum-number-of-iterations-without-improvement"))
+            parameters.maximum_number_of_iterations_without_improvement = vm["maximum-number-of-iterations-without-improvement"].as<Counter>();
+        if (vm.count("destruction-size"))
+            parameters.destruction_size = vm["destruction-size"].as<JobId>();
+        if (vm.count("temperature-factor"))
+            parameters.temperature_factor = vm["temperature-factor"].as<double>();
+        if (vm.count("maximum-block-size"))
+            parameters.maximum_block_size = vm["maximum-block-size"].as<JobId>();
+        return local_search_pfss_no_wait(instance, generator, nullptr, parameters);
+
+    } else if (algorithm == "portfolio") {
+        PortfolioParameters parameters;
+        set_common_parameters(parameters);
+        if (vm.count("portfolio-algorithms"))
+            parameters.algorithms = vm["portfolio-algorithms"].as<std::vector<PortfolioAlgorithm>>();
+        read_local_search_parameters(parameters.local_search_parameters, vm);
+        if (vm.count("local-search-restart-interval"))
+            parameters.local_search_restart_interval = vm["local-search-restart-interval"].as<Counter>();
+        if (vm.count("solver"))
+            parameters.milp_positional_parameters.solver = vm["solver"].as<mathoptsolverscmake::SolverName>();
+        parameters.thread_pool = thread_pool;
+        return portfolio(instance, generator, nullptr, parameters);
+
+    } else if (algorithm == "rolling-horizon-pfss") {
+        RollingHorizonPfssParameters parameters;
+        set_common_parameters(parameters);
+        if (vm.count("initial-order"))
+            parameters.initial_order = vm["initial-order"].as<RollingHorizonOrder>();
+        if (vm.count("window-size"))
+            parameters.window_size = vm["window-size"].as<JobId>();
+        if (vm.count("window-step"))
+            parameters.window_step = vm["window-step"].as<JobId>();
+        if (vm.count("window-time-limit"))
+            parameters.window_time_limit = vm["window-time-limit"].as<double>();
+        if (vm.count("number-of-threads"))
+            parameters.number_of_threads = vm["number-of-threads"].as<Counter>();
+        read_local_search_parameters(parameters.local_search_parameters, vm);
+        parameters.thread_pool = thread_pool;
+        return rolling_horizon_pfss(instance, generator, parameters);
+
+    } else if (algorithm == "lns-pfss") {
+        LnsPfssParameters parameters;
+        set_common_parameters(parameters);
+        if (vm.count("maximum-number-of-iterations"))
+            parameters.maximum_number_of_iterations = vm["maximum-number-of-iterations"].as<Counter>();
+        if (vm.count("maximum-number-of-iterations-without-improvement"))
+            parameters.maximum_number_of_iterations_without_improvement = vm["maximum-number-of-iterations-without-improvement"].as<Counter>();
+        if (vm.count("lns-neighborhoods"))
+            parameters.neighborhoods = vm["lns-neighborhoods"].as<std::vector<LnsPfssNeighborhood>>();
+        if (vm.count("initial-subproblem-size"))
+            parameters.initial_subproblem_size = vm["initial-subproblem-size"].as<JobId>();
+        if (vm.count("minimum-subproblem-size"))
+            parameters.minimum_subproblem_size = vm["minimum-subproblem-size"].as<JobId>();
+        if (vm.count("maximum-subproblem-size"))
+            parameters.maximum_subproblem_size = vm["maximum-subproblem-size"].as<JobId>();
+        if (vm.count("subproblem-time-limit"))
+            parameters.subproblem_time_limit = vm["subproblem-time-limit"].as<double>();
+        if (vm.count("number-of-threads"))
+            parameters.number_of_threads = vm["number-of-threads"].as<Counter>();
+        if (vm.count("solver"))
+            parameters.milp_positional_parameters.solver = vm["solver"].as<mathoptsolverscmake::SolverName>();
+        parameters.thread_pool = thread_pool;
+        return lns_pfss(instance, generator, nullptr, parameters);
+
+    } else if (algorithm == "branch-and-bound-pfss-makespan") {
+        BranchAndBoundPfssMakespanParameters parameters;
+        set_common_parameters(parameters);
+        if (vm.count("lower-bound"))
+            parameters.lower_bound = vm["lower-bound"].as<BranchAndBoundPfssMakespanLowerBound>();
+        if (vm.count("number-of-threads"))
+            parameters.number_of_threads = vm["number-of-threads"].as<Counter>();
+        read_local_search_parameters(parameters.local_search_parameters, vm);
+        parameters.thread_pool = thread_pool;
+        return branch_and_bound_pfss_makespan(instance, generator, parameters);
+
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "unknown algorithm \"" + algorithm + "\".");
+    }
+
+    return Output(instance);
+}
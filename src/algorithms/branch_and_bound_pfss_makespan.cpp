@@ -0,0 +1,471 @@
+#include "shopschedulingsolver/algorithms/branch_and_bound_pfss_makespan.hpp"
+
+#include "shopschedulingsolver/algorithms/branching_scheme_bidirectional.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/solution_builder.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+using NodePtr = std::shared_ptr<BranchingSchemeBidirectional::Node>;
+
+// Set the parameters left to automatic and check the others.
+BranchAndBoundPfssMakespanParameters resolve_parameters(
+        const BranchAndBoundPfssMakespanParameters& parameters)
+{
+    BranchAndBoundPfssMakespanParameters resolved_parameters = parameters;
+
+    if (resolved_parameters.number_of_threads < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "'number_of_threads' must be positive; "
+                "number_of_threads: " + std::to_string(resolved_parameters.number_of_threads) + ".");
+    }
+
+    LocalSearchPfssParameters& local_search_parameters = resolved_parameters.local_search_parameters;
+    if (local_search_parameters.maximum_number_of_iterations_without_improvement < 0)
+        local_search_parameters.maximum_number_of_iterations_without_improvement = 1000;
+    local_search_parameters.verbosity_level = 0;
+    local_search_parameters.log_path = "";
+    local_search_parameters.log_to_stderr = false;
+    local_search_parameters.messages_to_stdout = false;
+    local_search_parameters.new_solution_callback = [](const Output&) { };
+    local_search_parameters.end_callback = [](const Output&) { };
+
+    return resolved_parameters;
+}
+
+/**
+ * Two-machine bound.
+ *
+ * For a pair of machines k < l, the machines in between are relaxed into a
+ * time lag equal to the processing time of the job on them. The remaining
+ * jobs are then sequenced by Johnson's rule on the processing times
+ * increased by the lags, which is optimal for the two-machine problem with
+ * time lags. The machines k and l are available from the completion times
+ * of the front sequence, and the back sequence is processed after the last
+ * job on machine l.
+ *
+ * The orders only depend on the instance, so they are computed once; a node
+ * only skips the jobs already scheduled.
+ */
+class TwoMachineBound
+{
+
+public:
+
+    TwoMachineBound(const Instance& instance):
+        processing_times_(instance.number_of_jobs())
+    {
+        MachineId number_of_machines = instance.number_of_machines();
+        JobId number_of_jobs = instance.number_of_jobs();
+        for (JobId job_id = 0; job_id < number_of_jobs; ++job_id) {
+            const Job& job = instance.job(job_id);
+            for (MachineId machine_id = 0;
+                    machine_id < number_of_machines;
+                    ++machine_id) {
+                processing_times_[job_id].push_back(
+                        job.operations[machine_id].alternatives[0].processing_time);
+            }
+        }
+
+        for (MachineId machine_id_1 = 0;
+                machine_id_1 < number_of_machines;
+                ++machine_id_1) {
+            for (MachineId machine_id_2 = machine_id_1 + 1;
+                    machine_id_2 < number_of_machines;
+                    ++machine_id_2) {
+                MachinePair machine_pair;
+                machine_pair.machine_id_1 = machine_id_1;
+                machine_pair.machine_id_2 = machine_id_2;
+                machine_pair.lags.resize(number_of_jobs, 0);
+                for (JobId job_id = 0; job_id < number_of_jobs; ++job_id) {
+                    for (MachineId machine_id = machine_id_1 + 1;
+                            machine_id < machine_id_2;
+                            ++machine_id) {
+                        machine_pair.lags[job_id] += processing_times_[job_id][machine_id];
+                    }
+                }
+
+                // Johnson's rule: first the jobs whose first processing time
+                // is smaller, by non-decreasing first processing time, then
+                // the others, by non-increasing second processing time.
+                std::vector<JobId> jobs_1;
+                std::vector<JobId> jobs_2;
+                for (JobId job_id = 0; job_id < number_of_jobs; ++job_id) {
+                    if (processing_times_[job_id][machine_id_1]
+                            < processing_times_[job_id][machine_id_2]) {
+                        jobs_1.push_back(job_id);
+                    } else {
+                        jobs_2.push_back(job_id);
+                    }
+                }
+                std::sort(
+                        jobs_1.begin(),
+                        jobs_1.end(),
+                        [this, &machine_pair](JobId job_id_a, JobId job_id_b)
+                        {
+                            return processing_times_[job_id_a][machine_pair.machine_id_1] + machine_pair.lags[job_id_a]
+                                < processing_times_[job_id_b][machine_pair.machine_id_1] + machine_pair.lags[job_id_b];
+                        });
+                std::sort(
+                        jobs_2.begin(),
+                        jobs_2.end(),
+                        [this, &machine_pair](JobId job_id_a, JobId job_id_b)
+                        {
+                            return processing_times_[job_id_a][machine_pair.machine_id_2] + machine_pair.lags[job_id_a]
+                                > processing_times_[job_id_b][machine_pair.machine_id_2] + machine_pair.lags[job_id_b];
+                        });
+                machine_pair.jobs = jobs_1;
+                machine_pair.jobs.insert(machine_pair.jobs.end(), jobs_2.begin(), jobs_2.end());
+                machine_pairs_.push_back(machine_pair);
+            }
+        }
+    }
+
+    /** Compute the two-machine bound of a node whose structures are set. */
+    Time bound(const BranchingSchemeBidirectional::Node& node) const
+    {
+        Time bound = 0;
+        for (const MachinePair& machine_pair: machine_pairs_) {
+            const BranchingSchemeBidirectional::NodeMachine& node_machine_1
+                = node.machines[machine_pair.machine_id_1];
+            const BranchingSchemeBidirectional::NodeMachine& node_machine_2
+                = node.machines[machine_pair.machine_id_2];
+            Time time_1 = node_machine_1.time_forward;
+            Time time_2 = node_machine_2.time_forward;
+            for (JobId job_id: machine_pair.jobs) {
+                if (!node.available_jobs[job_id])
+                    continue;
+                time_1 += processing_times_[job_id][machine_pair.machine_id_1];
+                time_2 = (std::max)(time_2, time_1 + machine_pair.lags[job_id])
+                    + processing_times_[job_id][machine_pair.machine_id_2];
+            }
+            bound = (std::max)(bound, time_2 + node_machine_2.time_backward);
+        }
+        return bound;
+    }
+
+private:
+
+    struct MachinePair
+    {
+        /** First machine. */
+        MachineId machine_id_1 = -1;
+
+        /** Second machine. */
+        MachineId machine_id_2 = -1;
+
+        /** Processing times of the jobs on the machines in between. */
+        std::vector<Time> lags;
+
+        /** Jobs sorted by Johnson's rule. */
+        std::vector<JobId> jobs;
+    };
+
+    /** Processing times of the jobs on each machine. */
+    std::vector<std::vector<Time>> processing_times_;
+
+    /** Machine pairs. */
+    std::vector<MachinePair> machine_pairs_;
+
+};
+
+/** Open nodes of a thread. */
+struct NodeDeque
+{
+    /** Mutex protecting the nodes. */
+    std::mutex mutex;
+
+    /**
+     * Nodes.
+     *
+     * The owner pops the deepest node at the back; the other threads steal
+     * the shallowest one at the front.
+     */
+    std::deque<NodePtr> nodes;
+};
+
+struct SearchData
+{
+    SearchData(
+            const Instance& instance,
+            const BranchAndBoundPfssMakespanParameters& parameters,
+            AlgorithmFormatter& algorithm_formatter,
+            BranchAndBoundPfssMakespanOutput& output):
+        instance(instance),
+        parameters(parameters),
+        algorithm_formatter(algorithm_formatter),
+        output(output),
+        two_machine_bound(instance),
+        deques(parameters.number_of_threads) { }
+
+    const Instance& instance;
+
+    const BranchAndBoundPfssMakespanParameters& parameters;
+
+    AlgorithmFormatter& algorithm_formatter;
+
+    BranchAndBoundPfssMakespanOutput& output;
+
+    /** Mutex protecting the algorithm formatter and the output. */
+    std::mutex mutex;
+
+    /** Timer of the threads; it also ends when a thread fails. */
+    optimizationtools::Timer timer;
+
+    /** True iff a thread failed. */
+    bool end = false;
+
+    TwoMachineBound two_machine_bound;
+
+    /** Open nodes of each thread. */
+    std::vector<NodeDeque> deques;
+
+    /** Makespan of the best solution found. */
+    std::atomic<Time> upper_bound;
+
+    /**
+     * Number of open nodes, including the ones being expanded.
+     *
+     * The search is complete when it reaches 0.
+     */
+    std::atomic<Counter> number_of_open_nodes;
+};
+
+void update_solution(
+        SearchData& data,
+        const std::vector<JobId>& jobs)
+{
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(data.instance);
+    solution_builder.from_permutation(jobs);
+    Solution solution = solution_builder.build();
+
+    std::lock_guard<std::mutex> lock(data.mutex);
+    if (solution.makespan() >= data.upper_bound)
+        return;
+    data.upper_bound = solution.makespan();
+    data.algorithm_formatter.update_solution(solution, "branch-and-bound");
+}
+
+NodePtr pop(NodeDeque& deque)
+{
+    std::lock_guard<std::mutex> lock(deque.mutex);
+    if (deque.nodes.empty())
+        return nullptr;
+    NodePtr node = deque.nodes.back();
+    deque.nodes.pop_back();
+    return node;
+}
+
+NodePtr steal(
+        SearchData& data,
+        Counter thread_id)
+{
+    Counter number_of_threads = data.deques.size();
+    for (Counter offset = 1; offset < number_of_threads; ++offset) {
+        NodeDeque& deque = data.deques[(thread_id + offset) % number_of_threads];
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        if (deque.nodes.empty())
+            continue;
+        NodePtr node = deque.nodes.front();
+        deque.nodes.pop_front();
+        return node;
+    }
+    return nullptr;
+}
+
+void explore(
+        SearchData& data,
+        Counter thread_id)
+{
+    const Instance& instance = data.instance;
+    NodeDeque& deque = data.deques[thread_id];
+
+    BranchingSchemeBidirectional::Parameters branching_scheme_parameters;
+    branching_scheme_parameters.makespan_upper_bound_callback
+        = [&data]() { return data.upper_bound.load(); };
+    BranchingSchemeBidirectional branching_scheme(instance, branching_scheme_parameters);
+    // The branching scheme keeps its best node, which is initialized with
+    // its root.
+    branching_scheme.root();
+
+    Counter number_of_nodes = 0;
+    Counter number_of_lb2_prunings = 0;
+    Counter number_of_steals = 0;
+    EndCheck end_check(data.timer);
+    std::vector<NodePtr> open_children;
+    while (!end_check.needs_to_end()) {
+        NodePtr node = pop(deque);
+        if (node == nullptr) {
+            node = steal(data, thread_id);
+            if (node == nullptr) {
+                if (data.number_of_open_nodes == 0)
+                    break;
+                std::this_thread::yield();
+                continue;
+            }
+            number_of_steals++;
+        }
+
+        // The upper bound might have decreased since the node was created.
+        if (node->bound < data.upper_bound) {
+            number_of_nodes++;
+            open_children.clear();
+            for (const NodePtr& child: branching_scheme.children(node)) {
+                if (branching_scheme.leaf(child)) {
+                    update_solution(data, branching_scheme.jobs(child));
+                    continue;
+                }
+                if (data.parameters.lower_bound == BranchAndBoundPfssMakespanLowerBound::Lb2) {
+                    branching_scheme.compute_structures(child);
+                    Time bound = data.two_machine_bound.bound(*child);
+                    if (bound >= data.upper_bound) {
+                        number_of_lb2_prunings++;
+                        continue;
+                    }
+                    child->bound = (std::max)(child->bound, bound);
+                }
+                open_children.push_back(child);
+            }
+
+            // The child with the smallest bound is expanded first.
+            std::stable_sort(
+                    open_children.begin(),
+                    open_children.end(),
+                    [](const NodePtr& node_1, const NodePtr& node_2)
+                    {
+                        return node_1->bound > node_2->bound;
+                    });
+            data.number_of_open_nodes += open_children.size();
+            std::lock_guard<std::mutex> lock(deque.mutex);
+            deque.nodes.insert(
+                    deque.nodes.end(),
+                    open_children.begin(),
+                    open_children.end());
+        }
+        data.number_of_open_nodes--;
+    }
+
+    std::lock_guard<std::mutex> lock(data.mutex);
+    data.output.number_of_nodes += number_of_nodes;
+    data.output.number_of_lb2_prunings += number_of_lb2_prunings;
+    data.output.number_of_steals += number_of_steals;
+}
+
+}
+
+const BranchAndBoundPfssMakespanOutput shopschedulingsolver::branch_and_bound_pfss_makespan(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        const BranchAndBoundPfssMakespanParameters& unresolved_parameters)
+{
+    BranchAndBoundPfssMakespanOutput output(instance);
+    AlgorithmFormatter algorithm_formatter(instance, unresolved_parameters, output);
+    algorithm_formatter.start("Branch-and-bound");
+
+    BranchAndBoundPfssMakespanParameters parameters = resolve_parameters(unresolved_parameters);
+    if (instance.objective() != Objective::Makespan) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": unsupported objective; "
+                "only Makespan is supported.");
+    }
+    if (instance.no_wait() || instance.mixed_no_idle()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": no-wait and no-idle are not supported.");
+    }
+    if (instance.number_of_fixed_operations() > 0
+            || instance.has_machine_availability_times()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations and machine availability times are not supported.");
+    }
+
+    algorithm_formatter.print_header();
+
+    if (instance.number_of_jobs() == 0) {
+        algorithm_formatter.end();
+        return output;
+    }
+
+    // Initial upper bound.
+    {
+        LocalSearchPfssParameters local_search_parameters = parameters.local_search_parameters;
+        local_search_parameters.timer = parameters.timer;
+        Solution local_search_solution = local_search_pfss_makespan(
+                instance,
+                generator,
+                nullptr,
+                local_search_parameters).solution;
+        algorithm_formatter.update_solution(local_search_solution, "local search");
+    }
+
+    SearchData data(instance, parameters, algorithm_formatter, output);
+    data.timer = parameters.timer;
+    data.timer.add_end_boolean(&data.end);
+    data.upper_bound = (output.solution.feasible())?
+        output.solution.makespan():
+        std::numeric_limits<Time>::max();
+
+    // Root bound.
+    BranchingSchemeBidirectional::Parameters branching_scheme_parameters;
+    BranchingSchemeBidirectional branching_scheme(instance, branching_scheme_parameters);
+    NodePtr root = branching_scheme.root();
+    for (const BranchingSchemeBidirectional::NodeMachine& node_machine: root->machines)
+        root->bound = (std::max)(root->bound, node_machine.remaining_processing_time);
+    if (parameters.lower_bound == BranchAndBoundPfssMakespanLowerBound::Lb2)
+        root->bound = (std::max)(root->bound, data.two_machine_bound.bound(*root));
+    algorithm_formatter.update_makespan_bound(root->bound, "root");
+
+    // Explore the tree.
+    data.number_of_open_nodes = 0;
+    if (root->bound < data.upper_bound) {
+        data.deques[0].nodes.push_back(root);
+        data.number_of_open_nodes = 1;
+    }
+    std::unique_ptr<ThreadPool> local_thread_pool;
+    if (parameters.thread_pool == nullptr)
+        local_thread_pool.reset(new ThreadPool(parameters.number_of_threads - 1));
+    ThreadPool& thread_pool = (parameters.thread_pool != nullptr)?
+        *parameters.thread_pool:
+        *local_thread_pool;
+    TaskGroup task_group(thread_pool, generator, data.timer);
+    for (Counter thread_id = 0; thread_id < parameters.number_of_threads; ++thread_id) {
+        task_group.run([&data](TaskContext& task_context)
+        {
+            try {
+                explore(data, task_context.task_id);
+            } catch (...) {
+                // Stop the other explorers, which check the timer of the
+                // search.
+                std::lock_guard<std::mutex> lock(data.mutex);
+                data.end = true;
+                throw;
+            }
+        });
+    }
+    task_group.wait();
+
+    // Every node which has been pruned has a bound greater than or equal to
+    // the final upper bound, so the makespan bound is the smallest bound of
+    // the open nodes.
+    Time bound = data.upper_bound;
+    for (const NodeDeque& deque: data.deques)
+        for (const NodePtr& node: deque.nodes)
+            bound = (std::min)(bound, node->bound);
+    algorithm_formatter.update_makespan_bound(
+            bound,
+            (data.number_of_open_nodes == 0)? "search completed": "open nodes");
+
+    algorithm_formatter.end();
+    return output;
+}
@@ -338,6 +338,33 @@ async function main()
         model.constraint(machines_intervals[machine_id].length().eq(machine_length));
     }
 
+    // Fixed operations and machine availability times.
+    for (let job_id = 0; job_id < number_of_jobs; ++job_id) {
+        let job = instance.jobs[job_id];
+        for (let operation_id = 0;
+                operation_id < job.operations.length;
+                ++operation_id) {
+            let operation = job.operations[operation_id];
+            for (let alternative_id = 0;
+                    alternative_id < operation.alternatives.length;
+                    ++alternative_id) {
+                let alternative = operation.alternatives[alternative_id];
+                let optalcp_alternative = jobs_alternatives[job_id][operation_id][alternative_id];
+                if (operation.fixed_start !== undefined) {
+                    if (alternative_id == operation.fixed_alternative) {
+                        model.constraint(optalcp_alternative.start().eq(operation.fixed_start));
+                    } else {
+                        model.constraint(optalcp_alternative.presence().not());
+                    }
+                } else {
+                    const availability_time = instance.machines[alternative.machine].availability_time ?? 0;
+                    if (availability_time > 0)
+                        model.constraint(optalcp_alternative.start().ge(availability_time));
+                }
+            }
+        }
+    }
+
     //const txt = await CP.problem2txt(model);
     //if (txt !== undefined) {
     //    await writeFile("model.txt", txt, "utf8");
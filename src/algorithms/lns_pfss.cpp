@@ -0,0 +1,534 @@
+#include "shopschedulingsolver/algorithms/lns_pfss.hpp"
+
+#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/instance_builder.hpp"
+
+#include <memory>
+#include <numeric>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+// Set the parameters left to automatic and check the others.
+LnsPfssParameters resolve_parameters(
+        const LnsPfssParameters& parameters)
+{
+    LnsPfssParameters resolved_parameters = parameters;
+
+    if (resolved_parameters.neighborhoods.empty()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": at least one neighborhood is required.");
+    }
+    if (resolved_parameters.minimum_subproblem_size < 1
+            || resolved_parameters.minimum_subproblem_size > resolved_parameters.initial_subproblem_size
+            || resolved_parameters.initial_subproblem_size > resolved_parameters.maximum_subproblem_size) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the subproblem sizes must satisfy 1 <= minimum <= initial <= maximum; "
+                "minimum_subproblem_size: " + std::to_string(resolved_parameters.minimum_subproblem_size) + "; "
+                "initial_subproblem_size: " + std::to_string(resolved_parameters.initial_subproblem_size) + "; "
+                "maximum_subproblem_size: " + std::to_string(resolved_parameters.maximum_subproblem_size) + ".");
+    }
+    if (resolved_parameters.number_of_threads < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "'number_of_threads' must be positive; "
+                "number_of_threads: " + std::to_string(resolved_parameters.number_of_threads) + ".");
+    }
+
+    if (resolved_parameters.local_search_parameters.maximum_number_of_iterations_without_improvement < 0)
+        resolved_parameters.local_search_parameters.maximum_number_of_iterations_without_improvement = 1000;
+
+    for (Parameters* algorithm_parameters: std::vector<Parameters*>{
+            &resolved_parameters.local_search_parameters,
+            &resolved_parameters.milp_positional_parameters}) {
+        algorithm_parameters->verbosity_level = 0;
+        algorithm_parameters->log_path = "";
+        algorithm_parameters->log_to_stderr = false;
+        algorithm_parameters->messages_to_stdout = false;
+        algorithm_parameters->new_solution_callback = [](const Output&) { };
+        algorithm_parameters->end_callback = [](const Output&) { };
+    }
+
+    return resolved_parameters;
+}
+
+void update_bound(
+        const Instance& instance,
+        AlgorithmFormatter& algorithm_formatter,
+        Time bound,
+        const std::string& s)
+{
+    switch (instance.objective()) {
+    case Objective::Makespan: {
+        algorithm_formatter.update_makespan_bound(bound, s);
+        break;
+    } case Objective::TotalFlowTime: {
+        algorithm_formatter.update_total_flow_time_bound(bound, s);
+        break;
+    } case Objective::TotalTardiness: {
+        algorithm_formatter.update_total_tardiness_bound(bound, s);
+        break;
+    } case Objective::Throughput: {
+        algorithm_formatter.update_throughput_bound(bound, s);
+        break;
+    }
+    }
+}
+
+std::vector<JobId> get_sequence(const Solution& solution)
+{
+    std::vector<JobId> sequence;
+    for (SolutionOperationId solution_operation_id: solution.machine(0).solution_operations)
+        sequence.push_back(solution.operation(solution_operation_id).job_id);
+    return sequence;
+}
+
+Solution build_solution(
+        const Instance& instance,
+        const std::vector<JobId>& sequence)
+{
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.from_permutation(sequence);
+    return solution_builder.build();
+}
+
+/**
+ * Subproblem.
+ *
+ * The freed jobs are removed from the permutation and reinserted as a block,
+ * at a given position of the remaining permutation.
+ */
+struct Subproblem
+{
+    /** Freed jobs, in their order in the permutation. */
+    std::vector<JobId> job_ids;
+
+    /** Position of the block in the remaining permutation. */
+    JobId position = 0;
+
+    /** New order of the freed jobs. */
+    std::vector<JobId> new_job_ids;
+
+    /** True iff the MILP has proven the optimality of its solution. */
+    bool optimal = false;
+
+    /**
+     * True iff the MILP is exact for the subproblem, that is, iff none of
+     * its jobs has a release date, since the MILP ignores them.
+     */
+    bool exact = false;
+
+    /** Bound of the subproblem, valid for the whole instance if 'global'. */
+    Time bound = -1;
+
+    /** True iff the subproblem contains all the jobs. */
+    bool global = false;
+};
+
+/** Remove the freed jobs of a subproblem from a permutation. */
+std::vector<JobId> remaining_sequence(
+        const Instance& instance,
+        const std::vector<JobId>& sequence,
+        const std::vector<JobId>& job_ids)
+{
+    std::vector<uint8_t> freed(instance.number_of_jobs(), 0);
+    for (JobId job_id: job_ids)
+        freed[job_id] = 1;
+    std::vector<JobId> remaining;
+    for (JobId job_id: sequence)
+        if (!freed[job_id])
+            remaining.push_back(job_id);
+    return remaining;
+}
+
+/** Draw subproblems with disjoint sets of jobs. */
+std::vector<Subproblem> draw_subproblems(
+        const std::vector<JobId>& sequence,
+        LnsPfssNeighborhood neighborhood,
+        JobId subproblem_size,
+        Counter number_of_subproblems,
+        std::mt19937_64& generator)
+{
+    JobId number_of_jobs = sequence.size();
+    std::vector<Subproblem> subproblems;
+    switch (neighborhood) {
+    case LnsPfssNeighborhood::Window: {
+        // Windows starting at 'shift' modulo the subproblem size.
+        JobId number_of_windows = number_of_jobs / subproblem_size;
+        std::uniform_int_distribution<JobId> d_shift(0, number_of_jobs - number_of_windows * subproblem_size);
+        JobId shift = d_shift(generator);
+        std::vector<JobId> window_ids(number_of_windows);
+        std::iota(window_ids.begin(), window_ids.end(), 0);
+        std::shuffle(window_ids.begin(), window_ids.end(), generator);
+        for (JobId window_id: window_ids) {
+            if ((Counter)subproblems.size() == number_of_subproblems)
+                break;
+            Subproblem subproblem;
+            subproblem.position = shift + window_id * subproblem_size;
+            subproblem.job_ids = std::vector<JobId>(
+                    sequence.begin() + subproblem.position,
+                    sequence.begin() + subproblem.position + subproblem_size);
+            subproblems.push_back(subproblem);
+        }
+        break;
+    } case LnsPfssNeighborhood::RandomSubset: {
+        std::vector<JobId> positions(number_of_jobs);
+        std::iota(positions.begin(), positions.end(), 0);
+        std::shuffle(positions.begin(), positions.end(), generator);
+        for (JobId start = 0;
+                start + subproblem_size <= number_of_jobs
+                && (Counter)subproblems.size() < number_of_subproblems;
+                start += subproblem_size) {
+            std::vector<JobId> subset_positions(
+                    positions.begin() + start,
+                    positions.begin() + start + subproblem_size);
+            std::sort(subset_positions.begin(), subset_positions.end());
+            Subproblem subproblem;
+            // The jobs before the first freed one are not moved.
+            subproblem.position = subset_positions.front();
+            for (JobId pos: subset_positions)
+                subproblem.job_ids.push_back(sequence[pos]);
+            subproblems.push_back(subproblem);
+        }
+        break;
+    }
+    }
+    return subproblems;
+}
+
+/** Solve a subproblem with the positional MILP. */
+void solve_subproblem(
+        const Instance& instance,
+        const std::vector<JobId>& sequence,
+        Subproblem& subproblem,
+        const LnsPfssParameters& parameters,
+        const optimizationtools::Timer& timer)
+{
+    subproblem.global = (subproblem.job_ids.size() == sequence.size());
+    LnsPfssSubproblemInstance subproblem_instance = build_lns_pfss_subproblem_instance(
+            instance,
+            sequence,
+            subproblem.job_ids,
+            subproblem.position);
+
+    std::vector<JobId> subproblem_sequence(subproblem_instance.instance.number_of_jobs());
+    std::iota(subproblem_sequence.begin(), subproblem_sequence.end(), 0);
+    Solution initial_solution = build_solution(subproblem_instance.instance, subproblem_sequence);
+
+    MilpPositionalParameters milp_parameters = parameters.milp_positional_parameters;
+    milp_parameters.last_job_ids = subproblem_instance.tail_job_ids;
+    milp_parameters.timer = timer;
+    milp_parameters.timer.set_time_limit(
+            milp_parameters.timer.elapsed_time()
+            + (std::min)(
+                milp_parameters.timer.remaining_time(),
+                parameters.subproblem_time_limit));
+    Output milp_output = milp_positional(
+            subproblem_instance.instance,
+            &initial_solution,
+            milp_parameters);
+
+    subproblem.optimal = (milp_output.solution.feasible()
+            && milp_output.bound() >= milp_output.solution.objective_value());
+    subproblem.exact = true;
+    for (JobId subproblem_job_id = 0;
+            subproblem_job_id < subproblem_instance.instance.number_of_jobs();
+            ++subproblem_job_id) {
+        if (subproblem_instance.instance.job(subproblem_job_id).release_date > 0)
+            subproblem.exact = false;
+    }
+    subproblem.bound = milp_output.bound();
+    subproblem.new_job_ids.clear();
+    for (JobId subproblem_job_id: get_sequence(milp_output.solution))
+        if (subproblem_job_id < (JobId)subproblem.job_ids.size())
+            subproblem.new_job_ids.push_back(subproblem.job_ids[subproblem_job_id]);
+}
+
+}
+
+LnsPfssSubproblemInstance shopschedulingsolver::build_lns_pfss_subproblem_instance(
+        const Instance& instance,
+        const std::vector<JobId>& sequence,
+        const std::vector<JobId>& job_ids,
+        JobId position)
+{
+    std::vector<JobId> remaining = remaining_sequence(instance, sequence, job_ids);
+    if (position < 0 || position > (JobId)remaining.size()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid position; "
+                "position: " + std::to_string(position) + "; "
+                "number of remaining jobs: " + std::to_string(remaining.size()) + ".");
+    }
+
+    // Completion times of the jobs before the block.
+    std::vector<Time> completion_times(instance.number_of_machines(), 0);
+    for (JobId pos = 0; pos < position; ++pos) {
+        const Job& job = instance.job(remaining[pos]);
+        Time time = job.release_date;
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            time = (std::max)(time, completion_times[machine_id])
+                + job.operations[machine_id].alternatives[0].processing_time;
+            completion_times[machine_id] = time;
+        }
+    }
+
+    InstanceBuilder instance_builder;
+    instance_builder.set_objective(instance.objective());
+    instance_builder.set_permutation(instance.permutation());
+    instance_builder.set_number_of_machines(instance.number_of_machines());
+    for (MachineId machine_id = 0;
+            machine_id < instance.number_of_machines();
+            ++machine_id) {
+        instance_builder.set_machine_availability_time(
+                machine_id,
+                completion_times[machine_id]);
+    }
+    auto add_job = [&instance, &instance_builder](JobId job_id)
+    {
+        const Job& job = instance.job(job_id);
+        JobId subproblem_job_id = instance_builder.add_job();
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            OperationId operation_id = instance_builder.add_operation(subproblem_job_id);
+            instance_builder.add_alternative(
+                    subproblem_job_id,
+                    operation_id,
+                    machine_id,
+                    job.operations[machine_id].alternatives[0].processing_time);
+        }
+        instance_builder.set_job_release_date(subproblem_job_id, job.release_date);
+        if (job.due_date >= 0)
+            instance_builder.set_job_due_date(subproblem_job_id, job.due_date);
+        instance_builder.set_job_weight(subproblem_job_id, job.weight);
+        return subproblem_job_id;
+    };
+    for (JobId job_id: job_ids)
+        add_job(job_id);
+
+    // The jobs after the block keep their order at the last positions.
+    // For the makespan, if none of them has a release date, they are
+    // replaced by a single job ending at the same time whatever the
+    // completion times of the block, as long as it is scheduled after them.
+    // Otherwise, they are all kept: for the total flow time and the total
+    // tardiness, each of them contributes to the objective.
+    std::vector<JobId> tail_job_ids;
+    bool summarize = (instance.objective() == Objective::Makespan);
+    for (JobId pos = position; pos < (JobId)remaining.size(); ++pos)
+        if (instance.job(remaining[pos]).release_date > 0)
+            summarize = false;
+    if (summarize && position < (JobId)remaining.size()) {
+        std::vector<Time> tails(instance.number_of_machines() + 1, 0);
+        for (JobId pos = remaining.size() - 1; pos >= position; --pos) {
+            const Job& job = instance.job(remaining[pos]);
+            for (MachineId machine_id = instance.number_of_machines() - 1;
+                    machine_id >= 0;
+                    --machine_id) {
+                tails[machine_id] = (std::max)(tails[machine_id], tails[machine_id + 1])
+                    + job.operations[machine_id].alternatives[0].processing_time;
+            }
+        }
+        JobId tail_job_id = instance_builder.add_job();
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            OperationId operation_id = instance_builder.add_operation(tail_job_id);
+            instance_builder.add_alternative(
+                    tail_job_id,
+                    operation_id,
+                    machine_id,
+                    tails[machine_id] - tails[machine_id + 1]);
+        }
+        tail_job_ids.push_back(tail_job_id);
+    } else {
+        for (JobId pos = position; pos < (JobId)remaining.size(); ++pos)
+            tail_job_ids.push_back(add_job(remaining[pos]));
+    }
+    return {instance_builder.build(), tail_job_ids};
+}
+
+const LnsPfssOutput shopschedulingsolver::lns_pfss(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        const Solution* initial_solution,
+        const LnsPfssParameters& input_parameters)
+{
+    const LnsPfssParameters parameters = resolve_parameters(input_parameters);
+    LnsPfssOutput output(instance);
+    AlgorithmFormatter algorithm_formatter(instance, parameters, output);
+    algorithm_formatter.start("Large neighborhood search");
+
+    if (!instance.flow_shop() || instance.flexible()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the instance must be a flow shop.");
+    }
+    if (instance.no_wait() || instance.blocking() || instance.mixed_no_idle()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": no-wait, blocking and no-idle are not supported.");
+    }
+    if (instance.number_of_fixed_operations() > 0
+            || instance.has_machine_availability_times()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations and machine availability times are not supported.");
+    }
+    if (instance.objective() != Objective::Makespan
+            && instance.objective() != Objective::TotalFlowTime
+            && instance.objective() != Objective::TotalTardiness) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": unsupported objective; "
+                "only Makespan, TotalFlowTime and TotalTardiness are supported.");
+    }
+
+    algorithm_formatter.print_header();
+
+    // Initial solution.
+    if (initial_solution != nullptr && initial_solution->feasible()) {
+        algorithm_formatter.update_solution(*initial_solution, "initial solution");
+    } else {
+        LocalSearchPfssParameters local_search_parameters = parameters.local_search_parameters;
+        local_search_parameters.timer = parameters.timer;
+        if (local_search_parameters.thread_pool == nullptr)
+            local_search_parameters.thread_pool = parameters.thread_pool;
+        Solution local_search_solution = (instance.objective() == Objective::Makespan)?
+            local_search_pfss_makespan(
+                    instance,
+                    generator,
+                    nullptr,
+                    local_search_parameters).solution:
+            local_search_pfss(
+                    instance,
+                    generator,
+                    nullptr,
+                    local_search_parameters).solution;
+        algorithm_formatter.update_solution(local_search_solution, "local search");
+    }
+    if (!output.solution.feasible()) {
+        algorithm_formatter.end();
+        return output;
+    }
+    std::vector<JobId> sequence = get_sequence(output.solution);
+
+    JobId number_of_jobs = instance.number_of_jobs();
+    JobId subproblem_size = (std::min)(parameters.initial_subproblem_size, number_of_jobs);
+    std::unique_ptr<ThreadPool> local_thread_pool;
+    if (parameters.thread_pool == nullptr)
+        local_thread_pool.reset(new ThreadPool(parameters.number_of_threads - 1));
+    ThreadPool& thread_pool = (parameters.thread_pool != nullptr)?
+        *parameters.thread_pool:
+        *local_thread_pool;
+    Counter number_of_iterations_without_improvement = 0;
+    for (output.number_of_iterations = 0;
+            ;
+            ++output.number_of_iterations) {
+        // Check end.
+        if (parameters.timer.needs_to_end())
+            break;
+        if (parameters.maximum_number_of_iterations >= 0
+                && output.number_of_iterations >= parameters.maximum_number_of_iterations) {
+            break;
+        }
+        if (parameters.maximum_number_of_iterations_without_improvement >= 0
+                && number_of_iterations_without_improvement
+                >= parameters.maximum_number_of_iterations_without_improvement) {
+            break;
+        }
+        if (output.bound() >= output.solution.objective_value())
+            break;
+
+        // Draw and solve the subproblems.
+        std::uniform_int_distribution<Counter> d_neighborhood(0, parameters.neighborhoods.size() - 1);
+        LnsPfssNeighborhood neighborhood = parameters.neighborhoods[d_neighborhood(generator)];
+        std::vector<Subproblem> subproblems = draw_subproblems(
+                sequence,
+                neighborhood,
+                subproblem_size,
+                parameters.number_of_threads,
+                generator);
+        TaskGroup task_group(thread_pool, generator, parameters.timer);
+        for (Subproblem& subproblem: subproblems) {
+            task_group.run([&instance, &sequence, &subproblem, &parameters](TaskContext& task_context)
+            {
+                solve_subproblem(
+                        instance,
+                        sequence,
+                        subproblem,
+                        parameters,
+                        task_context.timer);
+            });
+        }
+        task_group.wait();
+        output.number_of_subproblems += subproblems.size();
+
+        // Apply the solutions of the subproblems which improve the
+        // permutation.
+        bool improved = false;
+        bool all_optimal = true;
+        bool all_exact = true;
+        for (const Subproblem& subproblem: subproblems) {
+            if (subproblem.global && subproblem.bound >= 0) {
+                update_bound(
+                        instance,
+                        algorithm_formatter,
+                        subproblem.bound,
+                        "subproblem " + std::to_string(output.number_of_subproblems));
+            }
+            if (!subproblem.optimal)
+                all_optimal = false;
+            if (!subproblem.exact)
+                all_exact = false;
+            if (subproblem.new_job_ids.size() != subproblem.job_ids.size()
+                    || subproblem.new_job_ids == subproblem.job_ids) {
+                continue;
+            }
+            std::vector<JobId> new_sequence = remaining_sequence(
+                    instance,
+                    sequence,
+                    subproblem.job_ids);
+            JobId position = (std::min)(subproblem.position, (JobId)new_sequence.size());
+            new_sequence.insert(
+                    new_sequence.begin() + position,
+                    subproblem.new_job_ids.begin(),
+                    subproblem.new_job_ids.end());
+            Solution solution = build_solution(instance, new_sequence);
+            if (solution.strictly_better(output.solution)) {
+                sequence.swap(new_sequence);
+                algorithm_formatter.update_solution(
+                        solution,
+                        "it " + std::to_string(output.number_of_iterations)
+                        + " k " + std::to_string(subproblem_size));
+                output.number_of_improvements++;
+                improved = true;
+            }
+        }
+
+        // Adapt the size of the subproblems. The size only increases when
+        // the subproblems have been proven optimal for the whole
+        // neighborhood, not only for the MILP relaxing the release dates.
+        if (improved) {
+            number_of_iterations_without_improvement = 0;
+        } else {
+            number_of_iterations_without_improvement++;
+            if (!all_optimal) {
+                subproblem_size = (std::max)(
+                        (std::min)(subproblem_size - 1, number_of_jobs),
+                        (std::min)(parameters.minimum_subproblem_size, number_of_jobs));
+            } else if (all_exact) {
+                subproblem_size = (std::min)(
+                        (std::min)(subproblem_size + 1, parameters.maximum_subproblem_size),
+                        number_of_jobs);
+            }
+        }
+    }
+    output.subproblem_size = subproblem_size;
+
+    algorithm_formatter.end();
+    return output;
+}
@@ -2,12 +2,20 @@
 
 #include "shopschedulingsolver/algorithm_formatter.hpp"
 #include "shopschedulingsolver/solution_builder.hpp"
+#include "shopschedulingsolver/profiler.hpp"
+#include "shopschedulingsolver/aligned_matrix.hpp"
+#include "shopschedulingsolver/permutation_distance.hpp"
+#include "shopschedulingsolver/no_idle_evaluator.hpp"
 #include "shopschedulingsolver/algorithms/tree_search_pfss.hpp"
 
 #include "localsearchsolver/population.hpp"
 
 #include "optimizationtools/utils/common.hpp"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 using namespace shopschedulingsolver;
 
 namespace
@@ -18,12 +26,17 @@ struct LocalSearchSolution
     std::vector<JobId> jobs;
     std::vector<JobId> jobs_positions;
     Time objective = 0;
+
+    // Adjacency used to compute the distance between solutions of the
+    // population. Only up to date for solutions of the population.
+    PermutationAdjacency adjacency;
 };
 
 Solution build_solution(
         const Instance& instance,
         LocalSearchSolution& ls_solution)
 {
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/BuildSolution");
     SolutionBuilder solution_builder;
     solution_builder.set_instance(instance);
     solution_builder.from_permutation(ls_solution.jobs);
@@ -37,14 +50,87 @@ Solution build_solution(
     return solution;
 }
 
+// Scratch structures of the multi-lane evaluation.
+//
+// Each lane evaluates one candidate sequence described as a list of at most 3
+// segments of the current solution. Vectors are stored in SoA form, i.e.
+// values[machine_id][lane], so that the inner loops over the lanes can be
+// vectorized. A row holds exactly one SIMD register of the widest supported
+// width, so the number of lanes doubles with 32-bit times.
+template <typename TimeType>
+struct ShiftLanes
+{
+    // Number of candidate insertion positions evaluated simultaneously by
+    // explore_shift_neighborhood_multi_lane().
+    static constexpr JobId number_of_lanes = matrix_alignment / sizeof(TimeType);
+
+    // completion_times[machine_id * number_of_lanes + lane]: completion time
+    // of the last job processed by the lane on machine machine_id.
+    AlignedVector<TimeType> completion_times;
+
+    // processing_times[machine_id * number_of_lanes + lane]: processing time
+    // on machine machine_id of the job processed by the lane at the current
+    // step; 0 for inactive lanes.
+    AlignedVector<TimeType> processing_times;
+
+    // Release date of the job processed by the lane at the current step; 0
+    // for inactive lanes.
+    alignas(matrix_alignment) TimeType release_dates[number_of_lanes];
+
+    // Contribution weight and contribution offset of the job processed by the
+    // lane at the current step; 0 for inactive lanes.
+    Time weights[number_of_lanes];
+    Time offsets[number_of_lanes];
+
+    // Objective of the partial sequence evaluated by the lane.
+    Time objectives[number_of_lanes];
+
+    // The lane is pruned as soon as its objective reaches its bound.
+    Time bounds[number_of_lanes];
+
+    // Segments [segments_begin, segments_end) of the candidate sequence. The
+    // last segment is the unchanged suffix of the current solution.
+    JobId segments_begin[number_of_lanes][3];
+    JobId segments_end[number_of_lanes][3];
+    JobId number_of_segments[number_of_lanes];
+
+    // Current segment and position of the next job to process.
+    JobId segments[number_of_lanes];
+    JobId positions[number_of_lanes];
+
+    // True iff the lane is still being evaluated.
+    bool active[number_of_lanes];
+
+    // True iff the evaluation of the lane completed without being pruned.
+    bool finished[number_of_lanes];
+};
+
+template <typename TimeType>
+constexpr JobId ShiftLanes<TimeType>::number_of_lanes;
+
+// TimeType is the type used to store completion times: Time, or int32_t when
+// all completion times fit (see fits_in_int32()). Objectives are always
+// stored as Time.
+template <typename TimeType>
 struct LocalSearchData
 {
     LocalSearchSolution solution;
 
+    // processing_times[job_id][machine_id]: copy of the processing times,
+    // used by the multi-lane evaluation.
+    AlignedMatrix<TimeType> processing_times;
+
+    // The objective contribution of job job_id completing at time C is
+    // contribution_weights[job_id] * max(0, C - contribution_offsets[job_id]).
+    // Used by the multi-lane evaluation.
+    std::vector<Time> contribution_weights;
+    std::vector<Time> contribution_offsets;
+
     // completion_times[pos][machine_id]: completion time of the pos-th job on
-    // machine machine_id in the current solution. Index 0 is the all-zero
-    // initial state. Never modified inside local_search().
-    std::vector<std::vector<Time>> completion_times;
+    // machine machine_id in the current solution. Index 0 is the initial
+    // state, that is, the availability times of the machines. Never modified
+    // inside local_search().
+    AlignedMatrix<TimeType> completion_times;
 
     // prefix_objective[pos]: cumulative TFT/TT of the first pos jobs in the
     // current solution. Recomputed by update_prefix_objective() after every
@@ -52,34 +138,133 @@ struct LocalSearchData
     std::vector<Time> prefix_objective;
 
     // Scratch CT vector used during move evaluation (block + suffix pass).
-    std::vector<Time> completion_times_tmp_1;
+    AlignedVector<TimeType> completion_times_tmp_1;
 
     // Scratch CT vector used in Loop 2 of local_search() as a rolling
     // skip-sequence CT (updated in-place each iteration).
-    std::vector<Time> completion_times_tmp_2;
+    AlignedVector<TimeType> completion_times_tmp_2;
 
     // Accumulates all moves that share the best objective found in the current
     // neighborhood exploration pass; one is picked at random at the end.
     std::vector<std::pair<JobId, JobId>> best_moves;
+
+    // Scratch structures of explore_shift_neighborhood_multi_lane().
+    ShiftLanes<TimeType> shift_lanes;
+
+    // Evaluator of the instances with no-idle machines. For these instances,
+    // completion_times is recomputed entirely after every mutation, since
+    // inserting a job delays the no-idle machines for all the jobs.
+    NoIdleEvaluator no_idle_evaluator;
+
+    // Scratch sequence of explore_swap_neighborhood_no_idle().
+    std::vector<JobId> no_idle_sequence;
+
+    // Number of jobs at the beginning of the sequence which are never moved.
+    // The neighborhoods, the insertions and the perturbations only consider
+    // the positions after them.
+    JobId number_of_frozen_jobs = 0;
 };
 
+// Return true iff all the completion times of any permutation schedule of the
+// instance fit in an int32_t.
+//
+// After the largest release date, machine availability time and fixed start,
+// whenever a job is in the shop, some machine is processing, so completion
+// times never exceed this time plus the sum of all processing times. This
+// holds with and without blocking. With no-idle machines, the delay between
+// the starts of two consecutive segments never exceeds the processing times
+// of the first of them, so the bound still holds.
+bool fits_in_int32(const Instance& instance)
+{
+    Time horizon = 0;
+    Time start_max = 0;
+    for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
+        start_max = (std::max)(start_max, instance.machine(machine_id).availability_time);
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+        const Job& job = instance.job(job_id);
+        start_max = (std::max)(start_max, job.release_date);
+        for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
+            const Operation& operation = job.operations[machine_id];
+            start_max = (std::max)(start_max, operation.fixed_start);
+            horizon += operation.alternatives[0].processing_time;
+        }
+    }
+    horizon += start_max;
+    return horizon <= std::numeric_limits<int32_t>::max();
+}
+
+// Allocate the structures of the local search data for an instance.
+template <typename TimeType>
+void initialize_data(
+        const Instance& instance,
+        LocalSearchData<TimeType>& data)
+{
+    JobId n = instance.number_of_jobs();
+    data.completion_times.resize(n + 1, instance.number_of_machines(), 0);
+    for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
+        data.completion_times[0][machine_id] = instance.machine(machine_id).availability_time;
+    data.completion_times_tmp_1.resize(instance.number_of_machines(), 0);
+    data.completion_times_tmp_2.resize(instance.number_of_machines(), 0);
+    data.prefix_objective.resize(n + 1, 0);
+    data.best_moves.reserve(n);
+    data.solution.jobs_positions.resize(n, -1);
+    data.processing_times.resize(n, instance.number_of_machines());
+    for (JobId job_id = 0; job_id < n; ++job_id) {
+        const Job& job = instance.job(job_id);
+        for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
+            data.processing_times[job_id][machine_id]
+                = job.operations[machine_id].alternatives[0].processing_time;
+        }
+    }
+    data.contribution_weights.resize(n);
+    data.contribution_offsets.resize(n);
+    for (JobId job_id = 0; job_id < n; ++job_id) {
+        const Job& job = instance.job(job_id);
+        if (instance.objective() == Objective::TotalFlowTime) {
+            data.contribution_weights[job_id] = job.weight;
+            data.contribution_offsets[job_id] = job.release_date;
+        } else {
+            data.contribution_weights[job_id] = (job.due_date == -1)? 0: job.weight;
+            data.contribution_offsets[job_id] = job.due_date;
+        }
+    }
+    data.shift_lanes.completion_times.resize(
+            instance.number_of_machines() * ShiftLanes<TimeType>::number_of_lanes, 0);
+    data.shift_lanes.processing_times.resize(
+            instance.number_of_machines() * ShiftLanes<TimeType>::number_of_lanes, 0);
+    if (instance.mixed_no_idle()) {
+        data.no_idle_evaluator = NoIdleEvaluator(instance);
+        data.no_idle_sequence.reserve(n);
+    }
+}
+
 // Return the objective contribution of one job given its completion time.
+//
+// Weighted flow time: w * (C - r).
+// Weighted tardiness: w * max(0, C - d), 0 for jobs without due date.
+//
+// Weights are non-negative and C >= r, so contributions are non-negative and
+// non-decreasing in C. The early-exit pruning (partial objective >= best) and
+// the CT-dominance pruning rely on these two properties.
 inline Time job_contribution(
         const Instance& instance,
         JobId job_id,
         Time completion_time)
 {
+    const Job& job = instance.job(job_id);
     if (instance.objective() == Objective::TotalFlowTime) {
-        return completion_time;
+        return job.weight * (completion_time - job.release_date);
     } else {
-        return std::max(Time(0), completion_time - instance.job(job_id).due_date);
+        if (job.due_date == -1)
+            return 0;
+        return job.weight * std::max(Time(0), completion_time - job.due_date);
     }
 }
 
 // Advance a 1-D completion-time vector by one job in-place.
 //
-// Standard:  ct[m] = max(ct[m], ct[m-1]) + p[m]
-// Blocking:  ct[0]   = max(ct[0]+p[0], ct[1])
+// Standard:  ct[m] = max(ct[m], ct[m-1]) + p[m], with ct[-1] = r
+// Blocking:  ct[0]   = max(max(ct[0], r)+p[0], ct[1])
 //            ct[m]   = max(ct[m-1]+p[m], ct[m+1])  for 0 < m < M-1
 //            ct[M-1] = ct[M-2]+p[M-1]
 //
@@ -88,32 +273,33 @@ inline Time job_contribution(
 //   Blocking: ct[m+1] (old) read before being overwritten by the m+1 step.
 //
 // Blocking is a compile-time constant: no runtime branch in the inner loops.
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 inline void advance_ct(
         const Instance& instance,
-        std::vector<Time>& ct,
+        AlignedVector<TimeType>& ct,
         const Job& job)
 {
     MachineId last_machine_id = instance.number_of_machines() - 1;
     if (Blocking) {
-        Time p0 = job.operations[0].alternatives[0].processing_time;
+        TimeType p0 = job.operations[0].alternatives[0].processing_time;
+        TimeType start0 = std::max(ct[0], (TimeType)job.release_date);
         if (last_machine_id > 0) {
-            ct[0] = std::max(ct[0] + p0, ct[1]);
+            ct[0] = std::max(start0 + p0, ct[1]);
         } else {
-            ct[0] += p0;
+            ct[0] = start0 + p0;
         }
         for (MachineId machine_id = 1; machine_id < last_machine_id; ++machine_id) {
-            Time p = job.operations[machine_id].alternatives[0].processing_time;
+            TimeType p = job.operations[machine_id].alternatives[0].processing_time;
             ct[machine_id] = std::max(ct[machine_id - 1] + p, ct[machine_id + 1]);
         }
         if (last_machine_id > 0) {
-            Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+            TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
             ct[last_machine_id] = ct[last_machine_id - 1] + p;
         }
     } else {
         for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
-            Time proc = job.operations[machine_id].alternatives[0].processing_time;
-            Time prev_machine = (machine_id > 0)? ct[machine_id - 1]: 0;
+            TimeType proc = job.operations[machine_id].alternatives[0].processing_time;
+            TimeType prev_machine = (machine_id > 0)? ct[machine_id - 1]: (TimeType)job.release_date;
             ct[machine_id] = std::max(ct[machine_id], prev_machine) + proc;
         }
     }
@@ -121,41 +307,64 @@ inline void advance_ct(
 
 // Recompute completion_times[p+1..n] using the current solution jobs.
 // completion_times[p] must already hold the correct starting state.
-template <bool Blocking>
+//
+// The fixed jobs are the first jobs of the sequence; their rows are set from
+// their fixed starts, which might be later than as early as possible.
+//
+// With no-idle machines, all the rows are recomputed.
+template <bool Blocking, typename TimeType>
 void update_completion_times(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId p)
 {
     MachineId last_machine_id = instance.number_of_machines() - 1;
-    if (Blocking) {
+    if (instance.mixed_no_idle()) {
+        data.no_idle_evaluator.set_sequence(data.solution.jobs);
+        for (JobId pos = 1; pos <= (JobId)data.solution.jobs.size(); ++pos) {
+            for (MachineId machine_id = 0; machine_id <= last_machine_id; ++machine_id) {
+                data.completion_times[pos][machine_id]
+                    = data.no_idle_evaluator.completion_time(pos - 1, machine_id);
+            }
+        }
+    } else if (Blocking) {
         for (JobId pos = p + 1; pos <= (JobId)data.solution.jobs.size(); ++pos) {
             const Job& job = instance.job(data.solution.jobs[pos - 1]);
-            Time p0 = job.operations[0].alternatives[0].processing_time;
+            TimeType p0 = job.operations[0].alternatives[0].processing_time;
+            TimeType start0 = std::max(data.completion_times[pos - 1][0], (TimeType)job.release_date);
             if (last_machine_id > 0) {
                 data.completion_times[pos][0] = std::max(
-                        data.completion_times[pos - 1][0] + p0,
+                        start0 + p0,
                         data.completion_times[pos - 1][1]);
             } else {
-                data.completion_times[pos][0] = data.completion_times[pos - 1][0] + p0;
+                data.completion_times[pos][0] = start0 + p0;
             }
             for (MachineId machine_id = 1; machine_id < last_machine_id; ++machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                 data.completion_times[pos][machine_id] = std::max(
                         data.completion_times[pos][machine_id - 1] + p,
                         data.completion_times[pos - 1][machine_id + 1]);
             }
             if (last_machine_id > 0) {
-                Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                 data.completion_times[pos][last_machine_id] = data.completion_times[pos][last_machine_id - 1] + p;
             }
         }
     } else {
-        for (JobId pos = p + 1; pos <= (JobId)data.solution.jobs.size(); ++pos) {
+        JobId number_of_fixed_jobs = instance.fixed_jobs().size();
+        for (JobId pos = p + 1; pos <= number_of_fixed_jobs; ++pos) {
             const Job& job = instance.job(data.solution.jobs[pos - 1]);
             for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
-                Time proc = job.operations[machine_id].alternatives[0].processing_time;
-                Time prev_machine = (machine_id > 0)? data.completion_times[pos][machine_id - 1]: 0;
+                const Operation& operation = job.operations[machine_id];
+                data.completion_times[pos][machine_id]
+                    = operation.fixed_start + operation.alternatives[0].processing_time;
+            }
+        }
+        for (JobId pos = std::max(p, number_of_fixed_jobs) + 1; pos <= (JobId)data.solution.jobs.size(); ++pos) {
+            const Job& job = instance.job(data.solution.jobs[pos - 1]);
+            for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
+                TimeType proc = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType prev_machine = (machine_id > 0)? data.completion_times[pos][machine_id - 1]: (TimeType)job.release_date;
                 data.completion_times[pos][machine_id] =
                     std::max(data.completion_times[pos - 1][machine_id], prev_machine) + proc;
             }
@@ -164,9 +373,10 @@ void update_completion_times(
 }
 
 // Recompute prefix_objective[1..n] from completion_times (current solution).
+template <typename TimeType>
 void update_prefix_objective(
         const Instance& instance,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     MachineId last_machine_id = instance.number_of_machines() - 1;
     data.prefix_objective[0] = 0;
@@ -181,9 +391,86 @@ void update_prefix_objective(
     data.solution.objective = data.prefix_objective[data.solution.jobs.size()];
 }
 
-template <bool Blocking>
+// Repair completion_times and prefix_objective after a move.
+//
+// The jobs at positions < p and >= q are the same as before the move, and
+// completion_times/prefix_objective rows of the jobs at positions >= q have
+// already been moved to their new indices. Rows p+1.. are recomputed until a
+// row of a job at position >= q is unchanged: the remaining rows are then
+// unchanged as well, and the remaining prefix objectives only need to be
+// shifted by the objective difference.
+template <bool Blocking, typename TimeType>
+void repair_completion_times(
+        const Instance& instance,
+        LocalSearchData<TimeType>& data,
+        JobId p,
+        JobId q)
+{
+    if (instance.mixed_no_idle()) {
+        update_completion_times<Blocking>(instance, data, 0);
+        update_prefix_objective(instance, data);
+        return;
+    }
+    MachineId last_machine_id = instance.number_of_machines() - 1;
+    JobId n = data.solution.jobs.size();
+    Time delta = 0;
+    JobId pos = p + 1;
+    for (; pos <= n; ++pos) {
+        const Job& job = instance.job(data.solution.jobs[pos - 1]);
+        TimeType* ct = data.completion_times[pos];
+        const TimeType* ct_prev = data.completion_times[pos - 1];
+        bool changed = false;
+        if (Blocking) {
+            TimeType p0 = job.operations[0].alternatives[0].processing_time;
+            TimeType start0 = std::max(ct_prev[0], (TimeType)job.release_date);
+            TimeType value = (last_machine_id > 0)?
+                std::max(start0 + p0, ct_prev[1]):
+                start0 + p0;
+            changed |= (value != ct[0]);
+            ct[0] = value;
+            for (MachineId machine_id = 1; machine_id < last_machine_id; ++machine_id) {
+                TimeType p = job.operations[machine_id].alternatives[0].processing_time;
+                value = std::max(ct[machine_id - 1] + p, ct_prev[machine_id + 1]);
+                changed |= (value != ct[machine_id]);
+                ct[machine_id] = value;
+            }
+            if (last_machine_id > 0) {
+                TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
+                value = ct[last_machine_id - 1] + p;
+                changed |= (value != ct[last_machine_id]);
+                ct[last_machine_id] = value;
+            }
+        } else {
+            for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
+                TimeType proc = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType prev_machine = (machine_id > 0)? ct[machine_id - 1]: (TimeType)job.release_date;
+                TimeType value = std::max(ct_prev[machine_id], prev_machine) + proc;
+                changed |= (value != ct[machine_id]);
+                ct[machine_id] = value;
+            }
+        }
+
+        Time prefix_objective_old = data.prefix_objective[pos];
+        data.prefix_objective[pos] = data.prefix_objective[pos - 1]
+            + job_contribution(
+                    instance,
+                    data.solution.jobs[pos - 1],
+                    ct[last_machine_id]);
+        if (!changed && pos > q) {
+            delta = data.prefix_objective[pos] - prefix_objective_old;
+            ++pos;
+            break;
+        }
+    }
+    if (delta != 0)
+        for (; pos <= n; ++pos)
+            data.prefix_objective[pos] += delta;
+    data.solution.objective = data.prefix_objective[n];
+}
+
+template <bool Blocking, typename TimeType>
 void load_solution(
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         const Instance& instance,
         const Solution& solution)
 {
@@ -202,24 +489,30 @@ void load_solution(
 
 // ---- Sequence-mutation helpers ----
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void add_job(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId job_id,
         JobId pos_new)
 {
     data.solution.jobs.insert(data.solution.jobs.begin() + pos_new, job_id);
-    for (JobId pos = pos_new; pos < (JobId)data.solution.jobs.size(); ++pos)
+    JobId n = data.solution.jobs.size();
+    for (JobId pos = pos_new; pos < n; ++pos)
         data.solution.jobs_positions[data.solution.jobs[pos]] = pos;
-    update_completion_times<Blocking>(instance, data, pos_new);
-    update_prefix_objective(instance, data);
+    // Move the rows of the jobs after the inserted one.
+    data.completion_times.rotate_rows(pos_new + 1, n, n + 1);
+    std::rotate(
+            data.prefix_objective.begin() + pos_new + 1,
+            data.prefix_objective.begin() + n,
+            data.prefix_objective.begin() + n + 1);
+    repair_completion_times<Blocking>(instance, data, pos_new, pos_new + 1);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void add_block(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         const std::vector<JobId>& job_ids,
         JobId pos_new)
 {
@@ -227,45 +520,64 @@ void add_block(
             data.solution.jobs.begin() + pos_new,
             job_ids.begin(),
             job_ids.end());
-    for (JobId pos = pos_new; pos < (JobId)data.solution.jobs.size(); ++pos)
+    JobId n = data.solution.jobs.size();
+    JobId size = job_ids.size();
+    for (JobId pos = pos_new; pos < n; ++pos)
         data.solution.jobs_positions[data.solution.jobs[pos]] = pos;
-    update_completion_times<Blocking>(instance, data, pos_new);
-    update_prefix_objective(instance, data);
+    // Move the rows of the jobs after the inserted block.
+    data.completion_times.rotate_rows(pos_new + 1, n + 1 - size, n + 1);
+    std::rotate(
+            data.prefix_objective.begin() + pos_new + 1,
+            data.prefix_objective.begin() + n + 1 - size,
+            data.prefix_objective.begin() + n + 1);
+    repair_completion_times<Blocking>(instance, data, pos_new, pos_new + size);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void remove_job(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId pos)
 {
     data.solution.jobs.erase(data.solution.jobs.begin() + pos);
-    for (JobId k = pos; k < (JobId)data.solution.jobs.size(); ++k)
+    JobId n = data.solution.jobs.size();
+    for (JobId k = pos; k < n; ++k)
         data.solution.jobs_positions[data.solution.jobs[k]] = k;
-    update_completion_times<Blocking>(instance, data, pos);
-    update_prefix_objective(instance, data);
+    // Move the rows of the jobs after the removed one.
+    data.completion_times.rotate_rows(pos + 1, pos + 2, n + 2);
+    std::rotate(
+            data.prefix_objective.begin() + pos + 1,
+            data.prefix_objective.begin() + pos + 2,
+            data.prefix_objective.begin() + n + 2);
+    repair_completion_times<Blocking>(instance, data, pos, pos);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void remove_block(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId pos,
         JobId size)
 {
     data.solution.jobs.erase(
             data.solution.jobs.begin() + pos,
             data.solution.jobs.begin() + pos + size);
-    for (JobId k = pos; k < (JobId)data.solution.jobs.size(); ++k)
+    JobId n = data.solution.jobs.size();
+    for (JobId k = pos; k < n; ++k)
         data.solution.jobs_positions[data.solution.jobs[k]] = k;
-    update_completion_times<Blocking>(instance, data, pos);
-    update_prefix_objective(instance, data);
+    // Move the rows of the jobs after the removed block.
+    data.completion_times.rotate_rows(pos + 1, pos + 1 + size, n + 1 + size);
+    std::rotate(
+            data.prefix_objective.begin() + pos + 1,
+            data.prefix_objective.begin() + pos + 1 + size,
+            data.prefix_objective.begin() + n + 1 + size);
+    repair_completion_times<Blocking>(instance, data, pos, pos);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void shift_jobs(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId size,
         JobId pos_old,
         JobId pos_new)
@@ -285,14 +597,17 @@ void shift_jobs(
         for (JobId k = pos_new; k < pos_old + size; ++k)
             data.solution.jobs_positions[data.solution.jobs[k]] = k;
     }
-    update_completion_times<Blocking>(instance, data, 0);
-    update_prefix_objective(instance, data);
+    repair_completion_times<Blocking>(
+            instance,
+            data,
+            std::min(pos_old, pos_new),
+            std::max(pos_old, pos_new) + size);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void swap_jobs(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId pos_1,
         JobId size_1,
         JobId pos_2,
@@ -320,42 +635,43 @@ void swap_jobs(
     for (JobId pos = pos_1; pos < pos_2 + size_2; ++pos)
         data.solution.jobs_positions[data.solution.jobs[pos]] = pos;
     // completion_times[pos_1] = CT after the first pos_1 jobs (unchanged).
-    update_completion_times<Blocking>(instance, data, pos_1);
-    update_prefix_objective(instance, data);
+    repair_completion_times<Blocking>(instance, data, pos_1, pos_2 + size_2);
 }
 
 // ---- Main local search (VND with block-insertion) ----
 
-enum class Neighborhood
-{
-    Shift,
-    Swap,
-};
-
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 bool explore_shift_neighborhood(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
+        EndCheck& end_check,
         JobId size)
 {
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/ShiftNeighborhood");
     MachineId last_machine_id = instance.number_of_machines() - 1;
     JobId n = (JobId)data.solution.jobs.size();
 
     bool improved = false;
 
-    for (JobId pos_old = 0; pos_old + size <= n; ) {
+    for (JobId pos_old = data.number_of_frozen_jobs; pos_old + size <= n; ) {
+        if (end_check.needs_to_end())
+            break;
         JobId pos_new_best = -1;
         Time objective_best = data.solution.objective;
 
         // Loop 1: block moves left (pos_new < pos_old).
         Time suffix_lb_left = data.prefix_objective[n] - data.prefix_objective[pos_old + size];
-        for (JobId pos_new = 0; pos_new < pos_old; ++pos_new) {
+        for (JobId pos_new = data.number_of_frozen_jobs; pos_new < pos_old; ++pos_new) {
             if (data.prefix_objective[pos_new] >= objective_best)
                 break;
+            if (end_check.needs_to_end())
+                break;
 
-            for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-                data.completion_times_tmp_1[machine_id] = data.completion_times[pos_new][machine_id];
+            std::copy(
+                    data.completion_times[pos_new],
+                    data.completion_times[pos_new] + instance.number_of_machines(),
+                    data.completion_times_tmp_1.begin());
 
             Time objective = data.prefix_objective[pos_new];
 
@@ -406,11 +722,15 @@ bool explore_shift_neighborhood(
 
         // Loop 2: block moves right (pos_new > pos_old).
         if (data.prefix_objective[pos_old] < objective_best) {
-            for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-                data.completion_times_tmp_2[machine_id] = data.completion_times[pos_old][machine_id];
+            std::copy(
+                    data.completion_times[pos_old],
+                    data.completion_times[pos_old] + instance.number_of_machines(),
+                    data.completion_times_tmp_2.begin());
 
             Time skip_prefix_obj = data.prefix_objective[pos_old];
             for (JobId pos_new = pos_old + 1; pos_new <= n - size; ++pos_new) {
+                if (end_check.needs_to_end())
+                    break;
                 JobId skip_job_id = data.solution.jobs[pos_new - 1 + size];
                 advance_ct<Blocking>(instance, data.completion_times_tmp_2, instance.job(skip_job_id));
                 skip_prefix_obj += job_contribution(instance, skip_job_id, data.completion_times_tmp_2[last_machine_id]);
@@ -476,28 +796,418 @@ bool explore_shift_neighborhood(
     return improved;
 }
 
-template <bool Blocking>
+// Explore the shift neighborhood of an instance with no-idle machines.
+//
+// The block is removed from the sequence and its re-insertions are evaluated
+// with the no-idle evaluator: the relative heads of the block are computed
+// from the heads of the reduced sequence, and the objective stops being
+// accumulated as soon as it reaches the best objective found so far.
+template <bool Blocking, typename TimeType>
+bool explore_shift_neighborhood_no_idle(
+        const Instance& instance,
+        LocalSearchData<TimeType>& data,
+        std::mt19937_64& generator,
+        EndCheck& end_check,
+        JobId size)
+{
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/ShiftNeighborhoodNoIdle");
+    JobId n = (JobId)data.solution.jobs.size();
+    auto contribution = [&instance](JobId job_id, Time completion_time)
+    {
+        return job_contribution(instance, job_id, completion_time);
+    };
+
+    bool improved = false;
+
+    for (JobId pos_old = data.number_of_frozen_jobs; pos_old + size <= n; ) {
+        if (end_check.needs_to_end())
+            break;
+        JobId pos_new_best = -1;
+        Time objective_best = data.solution.objective;
+
+        data.no_idle_evaluator.set_sequence(data.solution.jobs, pos_old, size);
+        const JobId* block_job_ids = data.solution.jobs.data() + pos_old;
+        for (JobId pos_new = data.number_of_frozen_jobs; pos_new <= n - size; ++pos_new) {
+            if (pos_new == pos_old)
+                continue;
+            if (end_check.needs_to_end())
+                break;
+            data.no_idle_evaluator.evaluate_insertion(block_job_ids, size, pos_new);
+            Time objective = data.no_idle_evaluator.insertion_objective(
+                    contribution,
+                    objective_best);
+            if (objective < objective_best) {
+                objective_best = objective;
+                pos_new_best = pos_new;
+            }
+        }
+
+        if (pos_new_best != -1) {
+            shift_jobs<Blocking>(instance, data, size, pos_old, pos_new_best);
+            if (data.solution.objective != objective_best) {
+                throw std::runtime_error(
+                        FUNC_SIGNATURE + ": wrong objective after move; "
+                        "data.solution.objective: " + std::to_string(data.solution.objective) + "; "
+                        "objective_best: " + std::to_string(objective_best) + ".");
+            }
+            improved = true;
+        } else {
+            ++pos_old;
+        }
+    }
+
+    return improved;
+}
+
+// Advance the SoA completion times of all lanes by one job in-place.
+//
+// Same recurrences as advance_ct(), with the loop over the lanes innermost.
+template <bool Blocking, typename TimeType>
+inline void advance_ct_lanes(
+        MachineId number_of_machines,
+        TimeType* ct,
+        const TimeType* p,
+        const TimeType* r)
+{
+    const JobId number_of_lanes = ShiftLanes<TimeType>::number_of_lanes;
+    MachineId last_machine_id = number_of_machines - 1;
+    if (Blocking) {
+        if (last_machine_id > 0) {
+            for (JobId lane = 0; lane < number_of_lanes; ++lane)
+                ct[lane] = std::max(std::max(ct[lane], r[lane]) + p[lane], ct[number_of_lanes + lane]);
+        } else {
+            for (JobId lane = 0; lane < number_of_lanes; ++lane)
+                ct[lane] = std::max(ct[lane], r[lane]) + p[lane];
+        }
+        for (MachineId machine_id = 1; machine_id < last_machine_id; ++machine_id) {
+            TimeType* ct_cur = ct + machine_id * number_of_lanes;
+            const TimeType* ct_prev = ct_cur - number_of_lanes;
+            const TimeType* ct_next = ct_cur + number_of_lanes;
+            const TimeType* p_cur = p + machine_id * number_of_lanes;
+            for (JobId lane = 0; lane < number_of_lanes; ++lane)
+                ct_cur[lane] = std::max(ct_prev[lane] + p_cur[lane], ct_next[lane]);
+        }
+        if (last_machine_id > 0) {
+            TimeType* ct_cur = ct + last_machine_id * number_of_lanes;
+            const TimeType* ct_prev = ct_cur - number_of_lanes;
+            const TimeType* p_cur = p + last_machine_id * number_of_lanes;
+            for (JobId lane = 0; lane < number_of_lanes; ++lane)
+                ct_cur[lane] = ct_prev[lane] + p_cur[lane];
+        }
+    } else {
+        for (JobId lane = 0; lane < number_of_lanes; ++lane)
+            ct[lane] = std::max(ct[lane], r[lane]) + p[lane];
+        for (MachineId machine_id = 1; machine_id < number_of_machines; ++machine_id) {
+            TimeType* ct_cur = ct + machine_id * number_of_lanes;
+            const TimeType* ct_prev = ct_cur - number_of_lanes;
+            const TimeType* p_cur = p + machine_id * number_of_lanes;
+            for (JobId lane = 0; lane < number_of_lanes; ++lane)
+                ct_cur[lane] = std::max(ct_cur[lane], ct_prev[lane]) + p_cur[lane];
+        }
+    }
+}
+
+// Move a lane to its next non-empty segment.
+//
+// When the lane enters its last segment (the unchanged suffix of the current
+// solution starting at position pos), it is pruned if its objective plus the
+// suffix contribution in the current solution reaches its bound and its CT
+// vector dominates completion_times[pos].
+template <typename TimeType>
+void next_segment(
+        const Instance& instance,
+        LocalSearchData<TimeType>& data,
+        JobId lane)
+{
+    ShiftLanes<TimeType>& lanes = data.shift_lanes;
+    const JobId number_of_lanes = ShiftLanes<TimeType>::number_of_lanes;
+    JobId n = data.solution.jobs.size();
+    for (;;) {
+        ++lanes.segments[lane];
+        JobId segment = lanes.segments[lane];
+        if (segment == lanes.number_of_segments[lane]) {
+            lanes.active[lane] = false;
+            lanes.finished[lane] = true;
+            // Tighten the bounds of the other lanes. Lanes of the previous
+            // candidates only need to be strictly better since ties are
+            // broken in favor of the first candidate.
+            for (JobId lane_2 = 0; lane_2 < number_of_lanes; ++lane_2) {
+                Time bound = (lane_2 < lane)?
+                    lanes.objectives[lane] + 1:
+                    lanes.objectives[lane];
+                lanes.bounds[lane_2] = std::min(lanes.bounds[lane_2], bound);
+            }
+            return;
+        }
+        JobId pos = lanes.segments_begin[lane][segment];
+        lanes.positions[lane] = pos;
+
+        if (segment == lanes.number_of_segments[lane] - 1) {
+            // CT-dominance pruning.
+            if (lanes.objectives[lane] + data.prefix_objective[n] - data.prefix_objective[pos]
+                    >= lanes.bounds[lane]) {
+                bool dominated = true;
+                for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
+                    if (lanes.completion_times[machine_id * number_of_lanes + lane]
+                            < data.completion_times[pos][machine_id]) {
+                        dominated = false;
+                        break;
+                    }
+                }
+                if (dominated) {
+                    lanes.active[lane] = false;
+                    return;
+                }
+            }
+        }
+
+        if (pos < lanes.segments_end[lane][segment])
+            return;
+    }
+}
+
+// Evaluate the candidate sequences of the lanes.
+//
+// Before calling this function, the completion times, objective, bound and
+// segments of each lane must be set, and the lanes without candidate must be
+// inactive.
+template <bool Blocking, typename TimeType>
+void evaluate_lanes(
+        const Instance& instance,
+        LocalSearchData<TimeType>& data)
+{
+    ShiftLanes<TimeType>& lanes = data.shift_lanes;
+    const JobId number_of_lanes = ShiftLanes<TimeType>::number_of_lanes;
+    MachineId number_of_machines = instance.number_of_machines();
+    MachineId last_machine_id = number_of_machines - 1;
+
+    for (JobId lane = 0; lane < number_of_lanes; ++lane) {
+        if (!lanes.active[lane])
+            continue;
+        if (lanes.objectives[lane] >= lanes.bounds[lane]) {
+            lanes.active[lane] = false;
+            continue;
+        }
+        lanes.segments[lane] = -1;
+        next_segment(instance, data, lane);
+    }
+
+    for (;;) {
+        // Gather the processing times of the next job of each lane.
+        bool found = false;
+        for (JobId lane = 0; lane < number_of_lanes; ++lane) {
+            if (!lanes.active[lane]) {
+                for (MachineId machine_id = 0; machine_id < number_of_machines; ++machine_id)
+                    lanes.processing_times[machine_id * number_of_lanes + lane] = 0;
+                lanes.release_dates[lane] = 0;
+                lanes.weights[lane] = 0;
+                lanes.offsets[lane] = 0;
+                continue;
+            }
+            found = true;
+            JobId job_id = data.solution.jobs[lanes.positions[lane]];
+            const TimeType* p = data.processing_times[job_id];
+            for (MachineId machine_id = 0; machine_id < number_of_machines; ++machine_id)
+                lanes.processing_times[machine_id * number_of_lanes + lane] = p[machine_id];
+            lanes.release_dates[lane] = instance.job(job_id).release_date;
+            lanes.weights[lane] = data.contribution_weights[job_id];
+            lanes.offsets[lane] = data.contribution_offsets[job_id];
+        }
+        if (!found)
+            break;
+
+        advance_ct_lanes<Blocking>(
+                number_of_machines,
+                lanes.completion_times.data(),
+                lanes.processing_times.data(),
+                lanes.release_dates);
+
+        // Update the objectives and prune.
+        const TimeType* ct_last = &lanes.completion_times[last_machine_id * number_of_lanes];
+        for (JobId lane = 0; lane < number_of_lanes; ++lane) {
+            if (!lanes.active[lane])
+                continue;
+            lanes.objectives[lane] += lanes.weights[lane] * std::max(Time(0), ct_last[lane] - lanes.offsets[lane]);
+            if (lanes.objectives[lane] >= lanes.bounds[lane]) {
+                lanes.active[lane] = false;
+                continue;
+            }
+            ++lanes.positions[lane];
+            if (lanes.positions[lane] == lanes.segments_end[lane][lanes.segments[lane]])
+                next_segment(instance, data, lane);
+        }
+    }
+}
+
+// Same neighborhood as explore_shift_neighborhood(), but the candidate
+// insertion positions of a block are evaluated number_of_lanes at a time.
+//
+// All lanes of a batch start with the best objective known at the beginning of
+// the batch as bound; bounds are then tightened per lane as soon as a lane
+// completes. The candidates are finally scanned in order, so the move selected
+// is the same as the one selected by explore_shift_neighborhood().
+template <bool Blocking, typename TimeType>
+bool explore_shift_neighborhood_multi_lane(
+        const Instance& instance,
+        LocalSearchData<TimeType>& data,
+        std::mt19937_64& generator,
+        EndCheck& end_check,
+        JobId size)
+{
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/ShiftNeighborhood");
+    ShiftLanes<TimeType>& lanes = data.shift_lanes;
+    const JobId number_of_lanes = ShiftLanes<TimeType>::number_of_lanes;
+    JobId n = (JobId)data.solution.jobs.size();
+    JobId candidates[number_of_lanes];
+
+    bool improved = false;
+
+    // Scan the lanes of a batch in order and update the best move.
+    auto select = [&lanes, &candidates](
+            Time& objective_best,
+            JobId& pos_new_best)
+    {
+        for (JobId lane = 0; lane < number_of_lanes; ++lane) {
+            if (!lanes.finished[lane])
+                continue;
+            if (lanes.objectives[lane] < objective_best) {
+                objective_best = lanes.objectives[lane];
+                pos_new_best = candidates[lane];
+            }
+        }
+    };
+
+    for (JobId pos_old = data.number_of_frozen_jobs; pos_old + size <= n; ) {
+        if (end_check.needs_to_end())
+            break;
+        JobId pos_new_best = -1;
+        Time objective_best = data.solution.objective;
+
+        // Loop 1: block moves left (pos_new < pos_old).
+        // Lane sequence: block, jobs[pos_new..pos_old-1], suffix.
+        for (JobId pos_new = data.number_of_frozen_jobs; pos_new < pos_old; ) {
+            if (data.prefix_objective[pos_new] >= objective_best)
+                break;
+            if (end_check.needs_to_end(number_of_lanes))
+                break;
+            for (JobId lane = 0; lane < number_of_lanes; ++lane) {
+                lanes.finished[lane] = false;
+                lanes.active[lane] = (pos_new < pos_old);
+                if (!lanes.active[lane])
+                    continue;
+                const TimeType* ct = data.completion_times[pos_new];
+                for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
+                    lanes.completion_times[machine_id * number_of_lanes + lane] = ct[machine_id];
+                lanes.objectives[lane] = data.prefix_objective[pos_new];
+                lanes.bounds[lane] = objective_best;
+                lanes.number_of_segments[lane] = 3;
+                lanes.segments_begin[lane][0] = pos_old;
+                lanes.segments_end[lane][0] = pos_old + size;
+                lanes.segments_begin[lane][1] = pos_new;
+                lanes.segments_end[lane][1] = pos_old;
+                lanes.segments_begin[lane][2] = pos_old + size;
+                lanes.segments_end[lane][2] = n;
+                candidates[lane] = pos_new;
+                ++pos_new;
+            }
+            evaluate_lanes<Blocking>(instance, data);
+            select(objective_best, pos_new_best);
+        }
+
+        // Loop 2: block moves right (pos_new > pos_old).
+        // Lane sequence: jobs[0..pos_old-1], jobs[pos_old+size..pos_new+size-1]
+        // (rolling skip-sequence CT), block, suffix.
+        if (data.prefix_objective[pos_old] < objective_best) {
+            std::copy(
+                    data.completion_times[pos_old],
+                    data.completion_times[pos_old] + instance.number_of_machines(),
+                    data.completion_times_tmp_2.begin());
+
+            MachineId last_machine_id = instance.number_of_machines() - 1;
+            Time skip_prefix_obj = data.prefix_objective[pos_old];
+            bool stop = false;
+            for (JobId pos_new = pos_old + 1; !stop && pos_new <= n - size; ) {
+                if (end_check.needs_to_end(number_of_lanes))
+                    break;
+                for (JobId lane = 0; lane < number_of_lanes; ++lane) {
+                    lanes.finished[lane] = false;
+                    lanes.active[lane] = false;
+                    if (stop || pos_new > n - size)
+                        continue;
+                    JobId skip_job_id = data.solution.jobs[pos_new - 1 + size];
+                    advance_ct<Blocking>(instance, data.completion_times_tmp_2, instance.job(skip_job_id));
+                    skip_prefix_obj += job_contribution(instance, skip_job_id, data.completion_times_tmp_2[last_machine_id]);
+                    if (skip_prefix_obj >= objective_best) {
+                        stop = true;
+                        continue;
+                    }
+                    lanes.active[lane] = true;
+                    for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
+                        lanes.completion_times[machine_id * number_of_lanes + lane]
+                            = data.completion_times_tmp_2[machine_id];
+                    }
+                    lanes.objectives[lane] = skip_prefix_obj;
+                    lanes.bounds[lane] = objective_best;
+                    lanes.number_of_segments[lane] = 2;
+                    lanes.segments_begin[lane][0] = pos_old;
+                    lanes.segments_end[lane][0] = pos_old + size;
+                    lanes.segments_begin[lane][1] = pos_new + size;
+                    lanes.segments_end[lane][1] = n;
+                    candidates[lane] = pos_new;
+                    ++pos_new;
+                }
+                evaluate_lanes<Blocking>(instance, data);
+                select(objective_best, pos_new_best);
+            }
+        }
+
+        if (pos_new_best != -1) {
+            shift_jobs<Blocking>(instance, data, size, pos_old, pos_new_best);
+            if (data.solution.objective != objective_best) {
+                throw std::runtime_error(
+                        FUNC_SIGNATURE + ": wrong objective after move; "
+                        "data.solution.objective: " + std::to_string(data.solution.objective) + "; "
+                        "objective_best: " + std::to_string(objective_best) + ".");
+            }
+            improved = true;
+        } else {
+            ++pos_old;
+        }
+    }
+
+    return improved;
+}
+
+template <bool Blocking, typename TimeType>
 bool explore_swap_neighborhood(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
+        EndCheck& end_check,
         JobId size_1,
         JobId size_2)
 {
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/SwapNeighborhood");
     MachineId last_machine_id = instance.number_of_machines() - 1;
     JobId n = data.solution.jobs.size();
 
     bool improved = false;
 
-    for (JobId pos_1 = 0; pos_1 < n; ) {
+    for (JobId pos_1 = data.number_of_frozen_jobs; pos_1 < n; ) {
         if (data.prefix_objective[pos_1] >= data.solution.objective)
             break;
+        if (end_check.needs_to_end())
+            break;
 
         bool applied = false;
 
         for (JobId pos_2 = pos_1 + size_1; pos_2 + size_2 <= n; ++pos_2) {
-            for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-                data.completion_times_tmp_1[machine_id] = data.completion_times[pos_1][machine_id];
+            if (end_check.needs_to_end())
+                break;
+            std::copy(
+                    data.completion_times[pos_1],
+                    data.completion_times[pos_1] + instance.number_of_machines(),
+                    data.completion_times_tmp_1.begin());
 
             Time objective = data.prefix_objective[pos_1];
 
@@ -541,14 +1251,74 @@ bool explore_swap_neighborhood(
                     goto next_pair;
             }
 
-            // Suffix: jobs[pos_2+size_2..n-1].
-            for (JobId pos = pos_2 + size_2; pos < n; ++pos) {
-                JobId job_id = data.solution.jobs[pos];
-                advance_ct<Blocking>(instance, data.completion_times_tmp_1, instance.job(job_id));
-                objective += job_contribution(instance, job_id, data.completion_times_tmp_1[last_machine_id]);
-                if (objective >= data.solution.objective)
-                    goto next_pair;
-            }
+            // Suffix: jobs[pos_2+size_2..n-1].
+            for (JobId pos = pos_2 + size_2; pos < n; ++pos) {
+                JobId job_id = data.solution.jobs[pos];
+                advance_ct<Blocking>(instance, data.completion_times_tmp_1, instance.job(job_id));
+                objective += job_contribution(instance, job_id, data.completion_times_tmp_1[last_machine_id]);
+                if (objective >= data.solution.objective)
+                    goto next_pair;
+            }
+
+            if (data.solution.objective > objective) {
+                swap_jobs<Blocking>(instance, data, pos_1, size_1, pos_2, size_2);
+                if (data.solution.objective != objective) {
+                    throw std::runtime_error(
+                            FUNC_SIGNATURE + ": wrong objective after swap; "
+                            "data.solution.objective: " + std::to_string(data.solution.objective) + "; "
+                            "objective: " + std::to_string(objective) + ".");
+                }
+                applied = true;
+                improved = true;
+            }
+            next_pair:;
+        }
+
+        if (!applied)
+            ++pos_1;
+    }
+
+    return improved;
+}
+
+// Explore the swap neighborhood of an instance with no-idle machines.
+//
+// Each swap is evaluated from scratch with the no-idle evaluator.
+template <bool Blocking, typename TimeType>
+bool explore_swap_neighborhood_no_idle(
+        const Instance& instance,
+        LocalSearchData<TimeType>& data,
+        std::mt19937_64& generator,
+        EndCheck& end_check,
+        JobId size_1,
+        JobId size_2)
+{
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/SwapNeighborhoodNoIdle");
+    JobId n = data.solution.jobs.size();
+    auto contribution = [&instance](JobId job_id, Time completion_time)
+    {
+        return job_contribution(instance, job_id, completion_time);
+    };
+
+    bool improved = false;
+
+    for (JobId pos_1 = data.number_of_frozen_jobs; pos_1 < n; ) {
+        if (end_check.needs_to_end())
+            break;
+        bool applied = false;
+
+        for (JobId pos_2 = pos_1 + size_1; pos_2 + size_2 <= n; ++pos_2) {
+            if (end_check.needs_to_end())
+                break;
+            // Sequence [P B1 M B2 S] becomes [P B2 M B1 S].
+            const auto& jobs = data.solution.jobs;
+            data.no_idle_sequence.assign(jobs.begin(), jobs.begin() + pos_1);
+            data.no_idle_sequence.insert(data.no_idle_sequence.end(), jobs.begin() + pos_2, jobs.begin() + pos_2 + size_2);
+            data.no_idle_sequence.insert(data.no_idle_sequence.end(), jobs.begin() + pos_1 + size_1, jobs.begin() + pos_2);
+            data.no_idle_sequence.insert(data.no_idle_sequence.end(), jobs.begin() + pos_1, jobs.begin() + pos_1 + size_1);
+            data.no_idle_sequence.insert(data.no_idle_sequence.end(), jobs.begin() + pos_2 + size_2, jobs.end());
+            data.no_idle_evaluator.set_sequence(data.no_idle_sequence);
+            Time objective = data.no_idle_evaluator.objective(contribution);
 
             if (data.solution.objective > objective) {
                 swap_jobs<Blocking>(instance, data, pos_1, size_1, pos_2, size_2);
@@ -561,7 +1331,6 @@ bool explore_swap_neighborhood(
                 applied = true;
                 improved = true;
             }
-            next_pair:;
         }
 
         if (!applied)
@@ -571,42 +1340,45 @@ bool explore_swap_neighborhood(
     return improved;
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void local_search(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchPfssOutput& output,
         AlgorithmFormatter& algorithm_formatter,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
-    std::vector<std::tuple<Neighborhood, JobId, JobId>> neighborhoods = {
-        {Neighborhood::Shift, 1, -1},
-        {Neighborhood::Shift, 2, -1},
-        {Neighborhood::Shift, 3, -1},
-        //{Neighborhood::Shift, 4, -1},
-        //{Neighborhood::Shift, 5, -1},
-        {Neighborhood::Swap, 1, 1},
-        //{Neighborhood::Swap, 1, 2},
-        //{Neighborhood::Swap, 2, 1},
-        //{Neighborhood::Swap, 2, 2},
-        //{Neighborhood::Swap, 1, 3},
-        //{Neighborhood::Swap, 3, 1},
-        //{Neighborhood::Swap, 2, 3},
-        //{Neighborhood::Swap, 3, 2},
-        //{Neighborhood::Swap, 3, 3},
-    };
-    for (;;) {
+    std::vector<LocalSearchNeighborhood> neighborhoods = parameters.neighborhoods;
+    // The end is checked after each candidate evaluation, so the descent
+    // stops early at the end of the algorithm; the best move found so far in
+    // the current neighborhood is still applied, and the solution is then the
+    // last one reached, which is still a complete permutation.
+    EndCheck end_check(parameters.timer);
+    while (!end_check.needs_to_end()) {
         std::shuffle(neighborhoods.begin(), neighborhoods.end(), generator);
 
         bool improved = false;
-        for (auto neighborhood: neighborhoods) {
-            switch (std::get<0>(neighborhood)) {
-            case Neighborhood::Shift: {
-                improved = explore_shift_neighborhood<Blocking>(instance, data, generator, std::get<1>(neighborhood));
+        for (const LocalSearchNeighborhood& neighborhood: neighborhoods) {
+            switch (neighborhood.type) {
+            case LocalSearchNeighborhoodType::Shift: {
+                if (instance.mixed_no_idle()) {
+                    improved = explore_shift_neighborhood_no_idle<Blocking>(instance, data, generator, end_check, neighborhood.size_1);
+                } else if (parameters.multi_lane_shift_evaluation) {
+                    improved = explore_shift_neighborhood_multi_lane<Blocking>(instance, data, generator, end_check, neighborhood.size_1);
+                } else {
+                    improved = explore_shift_neighborhood<Blocking>(instance, data, generator, end_check, neighborhood.size_1);
+                }
                 break;
-            } case Neighborhood::Swap: {
-                improved = explore_swap_neighborhood<Blocking>(instance, data, generator, std::get<1>(neighborhood), std::get<2>(neighborhood));
+            } case LocalSearchNeighborhoodType::ShiftReverse: {
+                // Rejected by resolve_parameters().
+                break;
+            } case LocalSearchNeighborhoodType::Swap: {
+                if (instance.mixed_no_idle()) {
+                    improved = explore_swap_neighborhood_no_idle<Blocking>(instance, data, generator, end_check, neighborhood.size_1, neighborhood.size_2);
+                } else {
+                    improved = explore_swap_neighborhood<Blocking>(instance, data, generator, end_check, neighborhood.size_1, neighborhood.size_2);
+                }
                 break;
             }
             }
@@ -629,17 +1401,69 @@ void local_search(
 
 // ---- Construction / perturbation helpers ----
 
+// Return the position minimising the objective when inserting a block of
+// jobs in the current solution of an instance with no-idle machines; ties
+// are broken at random.
+template <typename TimeType>
+JobId best_position_no_idle(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        LocalSearchData<TimeType>& data,
+        const JobId* job_ids,
+        JobId size,
+        JobId forbidden_position = -1)
+{
+    auto contribution = [&instance](JobId job_id, Time completion_time)
+    {
+        return job_contribution(instance, job_id, completion_time);
+    };
+
+    data.no_idle_evaluator.set_sequence(data.solution.jobs);
+    std::vector<JobId> best_positions;
+    Time objective_best = std::numeric_limits<Time>::max();
+    for (JobId pos = data.number_of_frozen_jobs; pos <= (JobId)data.solution.jobs.size(); ++pos) {
+        if (pos == forbidden_position)
+            continue;
+        data.no_idle_evaluator.evaluate_insertion(job_ids, size, pos);
+        // The bound is incremented so that ties are fully evaluated.
+        Time bound = (objective_best == std::numeric_limits<Time>::max())?
+            objective_best:
+            objective_best + 1;
+        Time objective = data.no_idle_evaluator.insertion_objective(contribution, bound);
+        if (objective > objective_best)
+            continue;
+        if (objective < objective_best) {
+            best_positions.clear();
+            objective_best = objective;
+        }
+        best_positions.push_back(pos);
+    }
+
+    if (best_positions.empty())
+        throw std::runtime_error(FUNC_SIGNATURE + ": best_positions is empty.");
+
+    return best_positions[
+        std::uniform_int_distribution<size_t>(0, best_positions.size() - 1)(generator)];
+}
+
 // Insert job_id at the position that minimises the current objective.
 // Uses completion_times (current solution CTs) and prefix_objective.
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void add_job_at_best_position(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId job_id,
         JobId forbidden_position = -1)
 {
+    if (instance.mixed_no_idle()) {
+        JobId pos_best = best_position_no_idle(
+                instance, generator, data, &job_id, 1, forbidden_position);
+        add_job<Blocking>(instance, data, job_id, pos_best);
+        return;
+    }
+
     MachineId last_machine_id = instance.number_of_machines() - 1;
     const Job& job = instance.job(job_id);
 
@@ -648,7 +1472,7 @@ void add_job_at_best_position(
     Time objective_best = 0;  // stores best+1 (the +1 trick) when best_positions is non-empty
     JobId n = data.solution.jobs.size();
 
-    for (JobId pos = 0; pos <= n; ++pos) {
+    for (JobId pos = data.number_of_frozen_jobs; pos <= n; ++pos) {
         if (pos == forbidden_position)
             continue;
         // prefix_objective is non-decreasing and the suffix is non-negative,
@@ -656,8 +1480,10 @@ void add_job_at_best_position(
         if (!best_positions.empty() && data.prefix_objective[pos] >= objective_best)
             break;
 
-        for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-            data.completion_times_tmp_1[machine_id] = data.completion_times[pos][machine_id];
+        std::copy(
+                data.completion_times[pos],
+                data.completion_times[pos] + instance.number_of_machines(),
+                data.completion_times_tmp_1.begin());
 
         advance_ct<Blocking>(instance, data.completion_times_tmp_1, job);
 
@@ -695,26 +1521,35 @@ void add_job_at_best_position(
     add_job<Blocking>(instance, data, job_id, pos_best);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void add_block_at_best_position(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         const std::vector<JobId>& job_ids)
 {
+    if (instance.mixed_no_idle()) {
+        JobId pos_best = best_position_no_idle(
+                instance, generator, data, job_ids.data(), job_ids.size());
+        add_block<Blocking>(instance, data, job_ids, pos_best);
+        return;
+    }
+
     MachineId last_machine_id = instance.number_of_machines() - 1;
 
     std::vector<JobId> best_positions;
     Time objective_best = 0;
     JobId n = data.solution.jobs.size();
 
-    for (JobId pos = 0; pos <= n; ++pos) {
+    for (JobId pos = data.number_of_frozen_jobs; pos <= n; ++pos) {
         if (!best_positions.empty() && data.prefix_objective[pos] >= objective_best)
             break;
 
-        for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-            data.completion_times_tmp_1[machine_id] = data.completion_times[pos][machine_id];
+        std::copy(
+                data.completion_times[pos],
+                data.completion_times[pos] + instance.number_of_machines(),
+                data.completion_times_tmp_1.begin());
 
         Time objective = data.prefix_objective[pos];
 
@@ -760,10 +1595,10 @@ void add_block_at_best_position(
 
 // Among unscheduled jobs (jobs_positions == -1), append the one with the
 // smallest objective contribution when placed at the end of the current solution.
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void append_best_job(
         const Instance& instance,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     MachineId last_machine_id = instance.number_of_machines() - 1;
     JobId n = data.solution.jobs.size();
@@ -776,8 +1611,10 @@ void append_best_job(
 
         const Job& job = instance.job(job_id);
 
-        for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-            data.completion_times_tmp_1[machine_id] = data.completion_times[n][machine_id];
+        std::copy(
+                data.completion_times[n],
+                data.completion_times[n] + instance.number_of_machines(),
+                data.completion_times_tmp_1.begin());
 
         advance_ct<Blocking>(instance, data.completion_times_tmp_1, job);
 
@@ -792,51 +1629,55 @@ void append_best_job(
     add_job<Blocking>(instance, data, best_job_id, n);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 JobId remove_random_job(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
-    std::uniform_int_distribution<JobId> d_pos(0, (JobId)data.solution.jobs.size() - 1);
+    std::uniform_int_distribution<JobId> d_pos(data.number_of_frozen_jobs, (JobId)data.solution.jobs.size() - 1);
     JobId pos = d_pos(generator);
     JobId job_id = data.solution.jobs[pos];
     remove_block<Blocking>(instance, data, pos, 1);
     return job_id;
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 std::vector<JobId> remove_random_block(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
-    JobId max_size = std::min((JobId)4, (JobId)data.solution.jobs.size());
+    JobId number_of_free_jobs = data.solution.jobs.size() - data.number_of_frozen_jobs;
+    JobId max_size = std::min(parameters.perturbation_strength, number_of_free_jobs);
     std::uniform_int_distribution<JobId> d_size(1, max_size);
     JobId size = d_size(generator);
-    std::uniform_int_distribution<JobId> d_pos(0, (JobId)data.solution.jobs.size() - size);
+    std::uniform_int_distribution<JobId> d_pos(data.number_of_frozen_jobs, (JobId)data.solution.jobs.size() - size);
     JobId pos = d_pos(generator);
     std::vector<JobId> removed(data.solution.jobs.begin() + pos, data.solution.jobs.begin() + pos + size);
     remove_block<Blocking>(instance, data, pos, size);
     return removed;
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 std::vector<JobId> remove_random_jobs(
         const Instance& instance,
         std::mt19937_64& generator,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId number_of_jobs_removed)
 {
+    JobId number_of_free_jobs = data.solution.jobs.size() - data.number_of_frozen_jobs;
     std::vector<JobId> positions = optimizationtools::bob_floyd(
-            number_of_jobs_removed,
-            (JobId)data.solution.jobs.size(),
+            std::min(number_of_jobs_removed, number_of_free_jobs),
+            number_of_free_jobs,
             generator);
     std::vector<JobId> removed_job_ids;
-    for (JobId pos: positions)
+    for (JobId& pos: positions) {
+        pos += data.number_of_frozen_jobs;
         removed_job_ids.push_back(data.solution.jobs[pos]);
+    }
     std::sort(positions.rbegin(), positions.rend());
     for (JobId pos: positions)
         data.solution.jobs.erase(data.solution.jobs.begin() + pos);
@@ -848,19 +1689,19 @@ std::vector<JobId> remove_random_jobs(
     return removed_job_ids;
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void generate_initial_solution_neh(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchPfssOutput& output,
         AlgorithmFormatter& algorithm_formatter,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     data.solution.jobs.clear();
     std::fill(data.solution.jobs_positions.begin(), data.solution.jobs_positions.end(), -1);
     for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-        data.completion_times[0][machine_id] = 0;
+        data.completion_times[0][machine_id] = instance.machine(machine_id).availability_time;
     data.prefix_objective[0] = 0;
     data.solution.objective = 0;
 
@@ -875,25 +1716,35 @@ void generate_initial_solution_neh(
                 return instance.job(job_1_id).mean_processing_time
                      > instance.job(job_2_id).mean_processing_time;
             });
-    for (JobId job_id: sorted_jobs) {
-        add_job_at_best_position<Blocking>(instance, parameters, generator, data, job_id);
+    for (JobId job_pos = 0; job_pos < instance.number_of_jobs(); ++job_pos) {
+        // At the end of the algorithm, the remaining jobs are appended so
+        // that the solution is complete.
+        if (parameters.timer.needs_to_end()) {
+            add_block<Blocking>(
+                    instance,
+                    data,
+                    std::vector<JobId>(sorted_jobs.begin() + job_pos, sorted_jobs.end()),
+                    data.solution.jobs.size());
+            break;
+        }
+        add_job_at_best_position<Blocking>(instance, parameters, generator, data, sorted_jobs[job_pos]);
         local_search<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
     }
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void generate_initial_solution_neh_edd(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchPfssOutput& output,
         AlgorithmFormatter& algorithm_formatter,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     data.solution.jobs.clear();
     std::fill(data.solution.jobs_positions.begin(), data.solution.jobs_positions.end(), -1);
     for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-        data.completion_times[0][machine_id] = 0;
+        data.completion_times[0][machine_id] = instance.machine(machine_id).availability_time;
     data.prefix_objective[0] = 0;
     data.solution.objective = 0;
 
@@ -908,21 +1759,31 @@ void generate_initial_solution_neh_edd(
                 return instance.job(job_1_id).due_date
                      < instance.job(job_2_id).due_date;
             });
-    for (JobId job_id: sorted_jobs)
-        add_job_at_best_position<Blocking>(instance, parameters, generator, data, job_id);
+    EndCheck end_check(parameters.timer);
+    for (JobId job_pos = 0; job_pos < instance.number_of_jobs(); ++job_pos) {
+        if (end_check.needs_to_end()) {
+            add_block<Blocking>(
+                    instance,
+                    data,
+                    std::vector<JobId>(sorted_jobs.begin() + job_pos, sorted_jobs.end()),
+                    data.solution.jobs.size());
+            break;
+        }
+        add_job_at_best_position<Blocking>(instance, parameters, generator, data, sorted_jobs[job_pos]);
+    }
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void generate_initial_solution_pf_neh(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     data.solution.jobs.clear();
     std::fill(data.solution.jobs_positions.begin(), data.solution.jobs_positions.end(), -1);
     for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-        data.completion_times[0][machine_id] = 0;
+        data.completion_times[0][machine_id] = instance.machine(machine_id).availability_time;
     data.prefix_objective[0] = 0;
     data.solution.objective = 0;
 
@@ -930,20 +1791,30 @@ void generate_initial_solution_pf_neh(
     std::uniform_int_distribution<JobId> d_first(0, instance.number_of_jobs() - 1);
     add_job<Blocking>(instance, data, d_first(generator), 0);
 
-    while ((JobId)data.solution.jobs.size() < instance.number_of_jobs())
+    EndCheck end_check(parameters.timer);
+    while ((JobId)data.solution.jobs.size() < instance.number_of_jobs()) {
+        if (end_check.needs_to_end()) {
+            std::vector<JobId> remaining_jobs;
+            for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+                if (data.solution.jobs_positions[job_id] == -1)
+                    remaining_jobs.push_back(job_id);
+            add_block<Blocking>(instance, data, remaining_jobs, data.solution.jobs.size());
+            break;
+        }
         append_best_job<Blocking>(instance, data);
+    }
 }
 
 // Initial solution: schedule jobs in earliest-due-date order.
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void generate_initial_solution_edd(
         const Instance& instance,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     data.solution.jobs.clear();
     std::fill(data.solution.jobs_positions.begin(), data.solution.jobs_positions.end(), -1);
     for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-        data.completion_times[0][machine_id] = 0;
+        data.completion_times[0][machine_id] = instance.machine(machine_id).availability_time;
     data.prefix_objective[0] = 0;
     data.solution.objective = 0;
 
@@ -959,16 +1830,53 @@ void generate_initial_solution_edd(
         add_job<Blocking>(instance, data, job_id, data.solution.jobs.size());
 }
 
+// Insert the jobs missing from the current solution at their best positions,
+// by decreasing mean processing time as in NEH.
+//
+// It is used to warm start from a partial solution, for example the solution
+// of a previous instance to which new jobs have been added.
+template <bool Blocking, typename TimeType>
+void complete_solution(
+        const Instance& instance,
+        const LocalSearchPfssParameters& parameters,
+        std::mt19937_64& generator,
+        LocalSearchData<TimeType>& data)
+{
+    std::vector<JobId> missing_jobs;
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+        if (data.solution.jobs_positions[job_id] == -1)
+            missing_jobs.push_back(job_id);
+    std::sort(
+            missing_jobs.begin(),
+            missing_jobs.end(),
+            [&instance](JobId job_1_id, JobId job_2_id) -> bool
+            {
+                return instance.job(job_1_id).mean_processing_time
+                     > instance.job(job_2_id).mean_processing_time;
+            });
+    for (JobId job_pos = 0; job_pos < (JobId)missing_jobs.size(); ++job_pos) {
+        if (parameters.timer.needs_to_end()) {
+            add_block<Blocking>(
+                    instance,
+                    data,
+                    std::vector<JobId>(missing_jobs.begin() + job_pos, missing_jobs.end()),
+                    data.solution.jobs.size());
+            break;
+        }
+        add_job_at_best_position<Blocking>(instance, parameters, generator, data, missing_jobs[job_pos]);
+    }
+}
+
 // Perturbation: d random adjacent swaps (IARAS from Fernandez-Viagas et al. 2018).
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void random_adjacent_swaps(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
         JobId d = 4)
 {
     JobId n = data.solution.jobs.size();
-    std::uniform_int_distribution<JobId> d_pos(0, n - 2);
+    std::uniform_int_distribution<JobId> d_pos(data.number_of_frozen_jobs, n - 2);
     for (JobId i = 0; i < d; ++i) {
         JobId pos = d_pos(generator);
         std::swap(data.solution.jobs[pos], data.solution.jobs[pos + 1]);
@@ -979,31 +1887,23 @@ void random_adjacent_swaps(
     update_prefix_objective(instance, data);
 }
 
-enum class Perturbation
-{
-    RandomAdjacentSwaps,
-    RandomShifts,
-    RuinAndRecreate1,
-    RuinAndRecreateJobs,
-    RuinAndRecreateBlock,
-};
-
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void random_shifts(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId d = 4)
 {
-    std::uniform_int_distribution<JobId> distribution(2, d);
+    JobId number_of_free_jobs = data.solution.jobs.size() - data.number_of_frozen_jobs;
+    std::uniform_int_distribution<JobId> distribution(2, std::min(d, number_of_free_jobs));
     std::vector<JobId> positions = optimizationtools::bob_floyd(
             distribution(generator),
-            (JobId)data.solution.jobs.size(),
+            number_of_free_jobs,
             generator);
     std::vector<JobId> job_ids;
     for (JobId pos: positions)
-        job_ids.push_back(data.solution.jobs[pos]);
+        job_ids.push_back(data.solution.jobs[data.number_of_frozen_jobs + pos]);
 
     for (JobId job_id: job_ids) {
         JobId forbidden_position = data.solution.jobs_positions[job_id];
@@ -1012,11 +1912,11 @@ void random_shifts(
     }
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void ruin_and_recreate_1(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
         const LocalSearchPfssOutput& output,
         AlgorithmFormatter& algorithm_formatter)
@@ -1026,11 +1926,11 @@ void ruin_and_recreate_1(
     add_job_at_best_position<Blocking>(instance, parameters, generator, data, removed_job_id);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void ruin_and_recreate_jobs(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
         const LocalSearchPfssOutput& output,
         AlgorithmFormatter& algorithm_formatter,
@@ -1042,11 +1942,11 @@ void ruin_and_recreate_jobs(
         add_job_at_best_position<Blocking>(instance, parameters, generator, data, job_id);
 }
 
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void ruin_and_recreate_block(
         const Instance& instance,
         const LocalSearchPfssParameters& parameters,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
         const LocalSearchPfssOutput& output,
         AlgorithmFormatter& algorithm_formatter)
@@ -1056,10 +1956,129 @@ void ruin_and_recreate_block(
     add_block_at_best_position<Blocking>(instance, parameters, generator, data, removed);
 }
 
+// Single-producer single-consumer lock-free queue of solutions migrating
+// from an island to the next one.
+//
+// When the queue is full, new migrants are dropped: the receiving island is
+// late and will get more recent migrants at the next migration.
+struct MigrationQueue
+{
+    static constexpr Counter capacity = 4;
+
+    // Slots of the ring buffer.
+    LocalSearchSolution solutions[capacity];
+
+    // Number of solutions popped since the creation of the queue. Only
+    // written by the consumer.
+    std::atomic<Counter> head {0};
+
+    // Number of solutions pushed since the creation of the queue. Only
+    // written by the producer.
+    std::atomic<Counter> tail {0};
+
+    // Push a solution; return false if the queue is full.
+    bool push(const LocalSearchSolution& solution)
+    {
+        Counter t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == capacity)
+            return false;
+        solutions[t % capacity] = solution;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pop a solution; return false if the queue is empty.
+    bool pop(LocalSearchSolution& solution)
+    {
+        Counter h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        solution = solutions[h % capacity];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Position of an island in the ring of islands.
+struct Island
+{
+    // Id of the island.
+    Counter id = 0;
+
+    // Migrants sent by the previous island; nullptr if there is a single
+    // island.
+    MigrationQueue* migrants_in = nullptr;
+
+    // Migrants sent to the next island; nullptr if there is a single island.
+    MigrationQueue* migrants_out = nullptr;
+};
+
+// Build an initial solution.
+//
+// The first island starts from the solution of the tree search; the other
+// ones cycle through the construction heuristics so that the populations
+// start in different regions of the search space.
+template <bool Blocking, typename TimeType>
+void generate_initial_solution(
+        const Instance& instance,
+        const LocalSearchPfssParameters& parameters,
+        std::mt19937_64& generator,
+        const LocalSearchPfssOutput& output,
+        AlgorithmFormatter& algorithm_formatter,
+        LocalSearchData<TimeType>& data,
+        const Island& island)
+{
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/InitialSolution");
+    std::string label;
+    if (island.id == 0) {
+        TreeSearchPfssParameters ts_parameters;
+        ts_parameters.timer = parameters.timer;
+        ts_parameters.verbosity_level = 0;
+        ts_parameters.minimum_size_of_the_queue = 1024;
+        ts_parameters.maximum_size_of_the_queue = 1024;
+        auto ts_output = tree_search_pfss(
+                instance,
+                ts_parameters);
+        if (ts_output.solution.feasible()) {
+            load_solution<Blocking>(data, instance, ts_output.solution);
+            label = "ts";
+        } else {
+            // The tree search has been interrupted before its first
+            // solution; fall back to the cheapest construction.
+            generate_initial_solution_edd<Blocking>(instance, data);
+            label = "edd";
+        }
+    } else {
+        switch ((island.id - 1) % 4) {
+        case 0:
+            generate_initial_solution_neh<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
+            label = "neh";
+            break;
+        case 1:
+            generate_initial_solution_neh_edd<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
+            label = "neh edd";
+            break;
+        case 2:
+            generate_initial_solution_pf_neh<Blocking>(instance, parameters, generator, data);
+            label = "pf-neh";
+            break;
+        default:
+            generate_initial_solution_edd<Blocking>(instance, data);
+            label = "edd";
+            break;
+        }
+    }
+    // A construction interrupted by the time limit may be partial.
+    if ((JobId)data.solution.jobs.size() == instance.number_of_jobs()) {
+        algorithm_formatter.update_solution(
+                build_solution(instance, data.solution), label);
+    }
+}
+
 // Run the full population-based iterated local search.
 // Blocking is resolved at compile time; called from local_search_pfss via
 // if/else dispatch so there is only one runtime branch.
-template <bool Blocking>
+template <bool Blocking, typename TimeType>
 void run_algorithm(
         const Instance& instance,
         std::mt19937_64& generator,
@@ -1067,62 +2086,51 @@ void run_algorithm(
         const LocalSearchPfssParameters& parameters,
         LocalSearchPfssOutput& output,
         AlgorithmFormatter& algorithm_formatter,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         const localsearchsolver::Population<LocalSearchSolution, Time>::Parameters& pop_params,
-        localsearchsolver::Population<LocalSearchSolution, Time>& population)
+        localsearchsolver::Population<LocalSearchSolution, Time>& population,
+        const Island& island)
 {
     if (initial_solution != nullptr) {
         load_solution<Blocking>(data, instance, *initial_solution);
-        local_search<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
+        if (parameters.number_of_frozen_jobs > (JobId)data.solution.jobs.size()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "the number of frozen jobs must not exceed the number of jobs of the initial solution; "
+                    "number_of_frozen_jobs: " + std::to_string(parameters.number_of_frozen_jobs) + "; "
+                    "initial solution number of jobs: " + std::to_string(data.solution.jobs.size()) + ".");
+        }
+        data.number_of_frozen_jobs = parameters.number_of_frozen_jobs;
+        complete_solution<Blocking>(instance, parameters, generator, data);
     } else {
-        TreeSearchPfssParameters ts_parameters;
-        ts_parameters.timer = parameters.timer;
-        ts_parameters.verbosity_level = 0;
-        ts_parameters.minimum_size_of_the_queue = 1024;
-        ts_parameters.maximum_size_of_the_queue = 1024;
-        auto ts_output = tree_search_pfss(
-                instance,
-                ts_parameters);
-        load_solution<Blocking>(data, instance, ts_output.solution);
-        std::stringstream ss;
-        ss << "ts";
+        generate_initial_solution<Blocking>(
+                instance, parameters, generator, output, algorithm_formatter, data, island);
+        if ((JobId)data.solution.jobs.size() < instance.number_of_jobs())
+            return;
+    }
+    local_search<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
+    // local_search() only reports the solutions it improves; a locally
+    // optimal warm start would otherwise never be reported.
+    if (initial_solution != nullptr) {
         algorithm_formatter.update_solution(
-                build_solution(instance, data.solution), ss.str());
-
-        //generate_initial_solution_neh_edd<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
-        //std::stringstream ss;
-        //ss << "NEH EDD";
-        //algorithm_formatter.update_solution(
-        //        build_solution(instance, data.solution), ss.str());
-
-        //generate_initial_solution_edd<Blocking>(instance, data);
-
-        local_search<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
-        population.add(data.solution, generator);
-
-        //for (JobId i = 0;
-        //        i < pop_params.maximum_size && !parameters.timer.needs_to_end();
-        //        ++i) {
-        //    generate_initial_solution_pf_neh<Blocking>(instance, parameters, generator, data);
-        //    std::stringstream ss;
-        //    ss << "neh " << i;
-        //    algorithm_formatter.update_solution(
-        //            build_solution(instance, data.solution), ss.str());
-        //    local_search<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
-        //    population.add(data.solution, generator);
-        //}
+                build_solution(instance, data.solution), "initial solution");
     }
+    compute_permutation_adjacency(
+            data.solution.jobs, instance.number_of_jobs(),
+            parameters.distance_sketch_size, data.solution.adjacency);
+    population.add(data.solution, generator);
 
     if (population.size() == 0)
         return;
 
+    // With less than two free jobs, the perturbations have nothing to move.
+    if (instance.number_of_jobs() - data.number_of_frozen_jobs < 2)
+        return;
+
     Counter number_of_iterations_without_improvement = 0;
     double previous_best = output.solution.objective_value();
 
-    std::vector<Perturbation> perturbations = {
-        Perturbation::RandomShifts,
-        Perturbation::RuinAndRecreateJobs,
-    };
+    const std::vector<LocalSearchPerturbation>& perturbations = parameters.perturbations;
     std::vector<Counter> perturbation_successes(perturbations.size(), 0);
 
     for (output.number_of_iterations = 1;
@@ -1140,9 +2148,12 @@ void run_algorithm(
                    > parameters.maximum_number_of_iterations_without_improvement)
             break;
 
-        data.solution = (output.number_of_iterations < 64)?
-            population.best_solution():
-            population.binary_tournament_single(generator);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/Population");
+            data.solution = (output.number_of_iterations < 64)?
+                population.best_solution():
+                population.binary_tournament_single(generator);
+        }
         update_completion_times<Blocking>(instance, data, 0);
         update_prefix_objective(instance, data);
         Time objective_before = data.solution.objective;
@@ -1153,24 +2164,27 @@ void run_algorithm(
             weights.push_back(2.0 + perturbation_successes[i]);
         std::discrete_distribution<Counter> distribution_perturbation(weights.begin(), weights.end());
         Counter perturbation_pos = distribution_perturbation(generator);
-        Perturbation perturbation = perturbations[perturbation_pos];
+        LocalSearchPerturbation perturbation = perturbations[perturbation_pos];
 
-        switch (perturbation) {
-        case Perturbation::RandomAdjacentSwaps:
-            random_adjacent_swaps<Blocking>(instance, data, generator);
-            break;
-        case Perturbation::RandomShifts:
-            random_shifts<Blocking>(instance, parameters, generator, data);
-            break;
-        case Perturbation::RuinAndRecreate1:
-            ruin_and_recreate_1<Blocking>(instance, parameters, data, generator, output, algorithm_formatter);
-            break;
-        case Perturbation::RuinAndRecreateJobs:
-            ruin_and_recreate_jobs<Blocking>(instance, parameters, data, generator, output, algorithm_formatter);
-            break;
-        case Perturbation::RuinAndRecreateBlock:
-            ruin_and_recreate_block<Blocking>(instance, parameters, data, generator, output, algorithm_formatter);
-            break;
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/Perturbation");
+            switch (perturbation) {
+            case LocalSearchPerturbation::RandomAdjacentSwaps:
+                random_adjacent_swaps<Blocking>(instance, data, generator, parameters.perturbation_strength);
+                break;
+            case LocalSearchPerturbation::RandomShifts:
+                random_shifts<Blocking>(instance, parameters, generator, data, parameters.perturbation_strength);
+                break;
+            case LocalSearchPerturbation::RuinAndRecreate1:
+                ruin_and_recreate_1<Blocking>(instance, parameters, data, generator, output, algorithm_formatter);
+                break;
+            case LocalSearchPerturbation::RuinAndRecreateJobs:
+                ruin_and_recreate_jobs<Blocking>(instance, parameters, data, generator, output, algorithm_formatter, parameters.perturbation_strength);
+                break;
+            case LocalSearchPerturbation::RuinAndRecreateBlock:
+                ruin_and_recreate_block<Blocking>(instance, parameters, data, generator, output, algorithm_formatter);
+                break;
+            }
         }
 
         local_search<Blocking>(instance, parameters, generator, output, algorithm_formatter, data);
@@ -1178,7 +2192,24 @@ void run_algorithm(
         if (data.solution.objective < objective_before)
             perturbation_successes[perturbation_pos]++;
 
-        population.add(data.solution, generator);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/Population");
+            compute_permutation_adjacency(
+                    data.solution.jobs, instance.number_of_jobs(),
+                    parameters.distance_sketch_size, data.solution.adjacency);
+            population.add(data.solution, generator);
+        }
+
+        // Send the best solution of the island to the next island and
+        // welcome the migrants of the previous one.
+        if (island.migrants_out != nullptr
+                && output.number_of_iterations % parameters.migration_interval == 0) {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfss/Migration");
+            island.migrants_out->push(population.best_solution());
+            LocalSearchSolution migrant;
+            while (island.migrants_in->pop(migrant))
+                population.add(migrant, generator);
+        }
 
         if (output.solution.objective_value() < previous_best) {
             previous_best = output.solution.objective_value();
@@ -1189,14 +2220,204 @@ void run_algorithm(
     }
 }
 
+// Run the islands.
+//
+// Each island runs run_algorithm() in its own task of the thread pool, with
+// its own population, data and generator. An island reports its new best
+// solutions through its own silent algorithm formatter, whose new solution
+// callback forwards them to the main algorithm formatter.
+template <bool Blocking, typename TimeType>
+void run_islands(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        Solution* initial_solution,
+        const LocalSearchPfssParameters& parameters,
+        LocalSearchPfssOutput& output,
+        AlgorithmFormatter& algorithm_formatter)
+{
+    localsearchsolver::PenalizedCostCallback<LocalSearchSolution, Time> penalized_cost_callback =
+        [](const LocalSearchSolution& s) { return s.objective; };
+
+    localsearchsolver::DistanceCallback<LocalSearchSolution> distance_callback =
+        [&instance, &parameters](const LocalSearchSolution& s1, const LocalSearchSolution& s2) {
+            if (parameters.distance_sketch_size > 0) {
+                return (localsearchsolver::Distance)permutation_distance_estimate(
+                        s1.adjacency, s2.adjacency, instance.number_of_jobs());
+            }
+            return (localsearchsolver::Distance)permutation_distance(
+                    s1.adjacency, s2.adjacency);
+        };
+
+    localsearchsolver::Population<LocalSearchSolution, Time>::Parameters pop_params;
+    pop_params.minimum_size = parameters.population_minimum_size;
+    pop_params.maximum_size = parameters.population_maximum_size;
+    pop_params.number_of_elite_solutions = parameters.number_of_elite_solutions;
+    pop_params.number_of_closest_neighbors = parameters.number_of_closest_neighbors;
+
+    if (parameters.number_of_islands == 1) {
+        LocalSearchData<TimeType> data;
+        initialize_data(instance, data);
+        localsearchsolver::Population<LocalSearchSolution, Time> population(
+                penalized_cost_callback, distance_callback, pop_params);
+        run_algorithm<Blocking>(
+                instance, generator, initial_solution, parameters,
+                output, algorithm_formatter, data, pop_params, population,
+                Island());
+        return;
+    }
+
+    Counter number_of_islands = parameters.number_of_islands;
+    std::vector<MigrationQueue> migration_queues(number_of_islands);
+    std::vector<Counter> numbers_of_iterations(number_of_islands, 0);
+    std::mutex mutex;
+
+    // An island failing cancels the group, so that the others stop.
+    std::unique_ptr<ThreadPool> local_thread_pool;
+    if (parameters.thread_pool == nullptr)
+        local_thread_pool.reset(new ThreadPool(number_of_islands - 1));
+    ThreadPool& thread_pool = (parameters.thread_pool != nullptr)?
+        *parameters.thread_pool:
+        *local_thread_pool;
+    TaskGroup task_group(thread_pool, generator, parameters.timer);
+    for (Counter island_id = 0; island_id < number_of_islands; ++island_id) {
+        task_group.run([&, island_id](TaskContext& task_context)
+        {
+            LocalSearchPfssParameters island_parameters = parameters;
+            island_parameters.timer = task_context.timer;
+            island_parameters.verbosity_level = 0;
+            island_parameters.log_path = "";
+            island_parameters.log_to_stderr = false;
+            island_parameters.messages_to_stdout = false;
+            island_parameters.new_solution_callback = [&, island_id](
+                    const Output& island_output)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                algorithm_formatter.update_solution(
+                        island_output.solution,
+                        "island " + std::to_string(island_id));
+            };
+            island_parameters.end_callback = [](const Output&) { };
+            LocalSearchPfssOutput island_output(instance);
+            AlgorithmFormatter island_algorithm_formatter(
+                    instance,
+                    island_parameters,
+                    island_output);
+
+            LocalSearchData<TimeType> data;
+            initialize_data(instance, data);
+            localsearchsolver::Population<LocalSearchSolution, Time> population(
+                    penalized_cost_callback, distance_callback, pop_params);
+            Island island;
+            island.id = island_id;
+            island.migrants_in = &migration_queues[island_id];
+            island.migrants_out = &migration_queues[(island_id + 1) % number_of_islands];
+            run_algorithm<Blocking>(
+                    instance, task_context.generator, initial_solution, island_parameters,
+                    island_output, island_algorithm_formatter, data, pop_params, population,
+                    island);
+            numbers_of_iterations[island_id] = island_output.number_of_iterations;
+        });
+    }
+    task_group.wait();
+
+    output.number_of_iterations = 0;
+    for (Counter island_id = 0; island_id < number_of_islands; ++island_id)
+        output.number_of_iterations += numbers_of_iterations[island_id];
+}
+
+// Set the parameters left to automatic according to the size of the instance
+// and check the others.
+//
+// On large instances, the population is smaller and the shift of blocks of
+// several jobs is not explored.
+LocalSearchPfssParameters resolve_parameters(
+        const Instance& instance,
+        const LocalSearchPfssParameters& parameters)
+{
+    LocalSearchPfssParameters resolved_parameters = parameters;
+    bool large = (instance.number_of_jobs() >= parameters.large_number_of_jobs);
+
+    if (resolved_parameters.population_minimum_size < 0)
+        resolved_parameters.population_minimum_size = (large)? 10: 20;
+    if (resolved_parameters.population_maximum_size < 0)
+        resolved_parameters.population_maximum_size = 2 * resolved_parameters.population_minimum_size;
+    if (resolved_parameters.number_of_elite_solutions < 0)
+        resolved_parameters.number_of_elite_solutions = (large)? 5: 10;
+    if (resolved_parameters.number_of_closest_neighbors < 0)
+        resolved_parameters.number_of_closest_neighbors = 3;
+    if (resolved_parameters.neighborhoods.empty()) {
+        resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Shift, 1, 1});
+        if (!large) {
+            resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Shift, 2, 1});
+            resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Shift, 3, 1});
+        }
+        resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Swap, 1, 1});
+    }
+    if (resolved_parameters.perturbations.empty()) {
+        resolved_parameters.perturbations = {
+            LocalSearchPerturbation::RandomShifts,
+            LocalSearchPerturbation::RuinAndRecreateJobs,
+        };
+    }
+
+    if (resolved_parameters.population_minimum_size < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the minimum size of the population must be positive; "
+                "population_minimum_size: " + std::to_string(resolved_parameters.population_minimum_size) + ".");
+    }
+    if (resolved_parameters.population_maximum_size < resolved_parameters.population_minimum_size) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the maximum size of the population must be greater than or equal to its minimum size; "
+                "population_minimum_size: " + std::to_string(resolved_parameters.population_minimum_size) + "; "
+                "population_maximum_size: " + std::to_string(resolved_parameters.population_maximum_size) + ".");
+    }
+    if (resolved_parameters.perturbation_strength < 2) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the perturbation strength must be at least 2; "
+                "perturbation_strength: " + std::to_string(resolved_parameters.perturbation_strength) + ".");
+    }
+    if (resolved_parameters.number_of_frozen_jobs < 0) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the number of frozen jobs must be non-negative; "
+                "number_of_frozen_jobs: " + std::to_string(resolved_parameters.number_of_frozen_jobs) + ".");
+    }
+    if (!instance.fixed_jobs().empty()) {
+        if (resolved_parameters.number_of_frozen_jobs > 0) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "frozen jobs cannot be set on an instance with fixed jobs; "
+                    "number_of_frozen_jobs: " + std::to_string(resolved_parameters.number_of_frozen_jobs) + "; "
+                    "instance.fixed_jobs().size(): " + std::to_string(instance.fixed_jobs().size()) + ".");
+        }
+        resolved_parameters.number_of_frozen_jobs = instance.fixed_jobs().size();
+    }
+    for (const LocalSearchNeighborhood& neighborhood: resolved_parameters.neighborhoods) {
+        if (neighborhood.type == LocalSearchNeighborhoodType::ShiftReverse) {
+            std::stringstream ss;
+            ss << neighborhood;
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "unsupported neighborhood; "
+                    "neighborhood: " + ss.str() + ".");
+        }
+    }
+
+    return resolved_parameters;
+}
+
 } // namespace
 
 const LocalSearchPfssOutput shopschedulingsolver::local_search_pfss(
         const Instance& instance,
         std::mt19937_64& generator,
         Solution* initial_solution,
-        const LocalSearchPfssParameters& parameters)
+        const LocalSearchPfssParameters& input_parameters)
 {
+    const LocalSearchPfssParameters parameters = resolve_parameters(instance, input_parameters);
     LocalSearchPfssOutput output(instance);
     AlgorithmFormatter algorithm_formatter(instance, parameters, output);
     algorithm_formatter.start("Local search (pfss)");
@@ -1213,69 +2434,91 @@ const LocalSearchPfssOutput shopschedulingsolver::local_search_pfss(
                 "only TotalFlowTime and TotalTardiness are supported.");
     }
 
-    if (instance.no_wait() || instance.no_idle()) {
+    if (instance.no_wait()) {
         throw std::invalid_argument(
-                FUNC_SIGNATURE + ": no-wait and no-idle are not supported.");
+                FUNC_SIGNATURE + ": no-wait is not supported.");
     }
 
-    algorithm_formatter.print_header();
-
-    JobId n = instance.number_of_jobs();
+    if (instance.mixed_no_idle()) {
+        if (instance.blocking()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": blocking with no-idle machines is not supported.");
+        }
+        for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+            if (instance.job(job_id).release_date != 0) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": release dates with no-idle machines are not supported.");
+            }
+        }
+    }
 
-    LocalSearchData data;
-    data.completion_times.assign(n + 1, std::vector<Time>(instance.number_of_machines(), 0));
-    data.completion_times_tmp_1.resize(instance.number_of_machines(), 0);
-    data.completion_times_tmp_2.resize(instance.number_of_machines(), 0);
-    data.prefix_objective.resize(n + 1, 0);
-    data.best_moves.reserve(n);
-    data.solution.jobs_positions.resize(n, -1);
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+        if (instance.job(job_id).weight < 0) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": negative job weights are not supported; "
+                    "job_id: " + std::to_string(job_id) + "; "
+                    "weight: " + std::to_string(instance.job(job_id).weight) + ".");
+        }
+    }
 
-    localsearchsolver::PenalizedCostCallback<LocalSearchSolution, Time> penalized_cost_callback =
-        [](const LocalSearchSolution& s) { return s.objective; };
+    if (parameters.number_of_islands < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the number of islands must be positive; "
+                "number_of_islands: " + std::to_string(parameters.number_of_islands) + ".");
+    }
+    if (parameters.migration_interval < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the migration interval must be positive; "
+                "migration_interval: " + std::to_string(parameters.migration_interval) + ".");
+    }
+    // The fixed jobs are frozen at the beginning of the sequence.
+    if (!instance.fixed_prefix()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations and machine availability times are only "
+                "supported on flow shops without no-wait, blocking and no-idle "
+                "machines, the fixed jobs being processed first in the same "
+                "order on all the machines.");
+    }
+    std::unique_ptr<Solution> fixed_jobs_solution;
+    if (!instance.fixed_jobs().empty()) {
+        fixed_jobs_solution.reset(new Solution(
+                    fixed_jobs_initial_solution(instance, initial_solution)));
+        initial_solution = fixed_jobs_solution.get();
+    }
 
-    localsearchsolver::DistanceCallback<LocalSearchSolution> distance_callback =
-        [&instance](const LocalSearchSolution& s1, const LocalSearchSolution& s2) {
-            localsearchsolver::Distance dist = 0;
-            for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
-                JobId p1 = s1.jobs_positions[job_id];
-                JobId p2 = s2.jobs_positions[job_id];
-                if (p1 == 0) {
-                    if (p2 != 0) dist++;
-                } else if (p2 == 0) {
-                    dist++;
-                } else {
-                    if (s1.jobs[p1 - 1] != s2.jobs[p2 - 1]) dist++;
-                }
-                JobId last_pos = (JobId)s1.jobs.size() - 1;
-                if (p1 == last_pos) {
-                    if (p2 != last_pos) dist++;
-                } else if (p2 == last_pos) {
-                    dist++;
-                } else {
-                    if (s1.jobs[p1 + 1] != s2.jobs[p2 + 1]) dist++;
-                }
-            }
-            return dist;
-        };
+    if (parameters.number_of_frozen_jobs > 0 && initial_solution == nullptr) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "frozen jobs require an initial solution.");
+    }
 
-    localsearchsolver::Population<LocalSearchSolution, Time>::Parameters pop_params;
-    pop_params.minimum_size = 20;
-    pop_params.maximum_size = 40;
-    pop_params.number_of_elite_solutions = 10;
-    pop_params.number_of_closest_neighbors = 3;
-    localsearchsolver::Population<LocalSearchSolution, Time> population(
-            penalized_cost_callback, distance_callback, pop_params);
+    algorithm_formatter.print_header();
 
     // Dispatch once here; all inner functions are templated so no further
-    // runtime branch occurs.
-    if (instance.blocking()) {
-        run_algorithm<true>(
-                instance, generator, initial_solution, parameters,
-                output, algorithm_formatter, data, pop_params, population);
+    // runtime branch occurs. Completion times are stored on 32 bits whenever
+    // they fit, which halves the memory traffic of the evaluations and doubles
+    // the number of lanes of the multi-lane evaluation.
+    if (fits_in_int32(instance)) {
+        if (instance.blocking()) {
+            run_islands<true, int32_t>(
+                    instance, generator, initial_solution, parameters,
+                    output, algorithm_formatter);
+        } else {
+            run_islands<false, int32_t>(
+                    instance, generator, initial_solution, parameters,
+                    output, algorithm_formatter);
+        }
     } else {
-        run_algorithm<false>(
-                instance, generator, initial_solution, parameters,
-                output, algorithm_formatter, data, pop_params, population);
+        if (instance.blocking()) {
+            run_islands<true, Time>(
+                    instance, generator, initial_solution, parameters,
+                    output, algorithm_formatter);
+        } else {
+            run_islands<false, Time>(
+                    instance, generator, initial_solution, parameters,
+                    output, algorithm_formatter);
+        }
     }
 
     algorithm_formatter.end();
@@ -1,6 +1,10 @@
 #include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
 
 #include "shopschedulingsolver/algorithm_formatter.hpp"
+#include "shopschedulingsolver/profiler.hpp"
+#include "shopschedulingsolver/aligned_matrix.hpp"
+#include "shopschedulingsolver/permutation_distance.hpp"
+#include "shopschedulingsolver/no_idle_evaluator.hpp"
 
 #include "localsearchsolver/population.hpp"
 
@@ -16,12 +20,17 @@ struct LocalSearchSolution
     std::vector<JobId> jobs;
     std::vector<JobId> jobs_positions;
     Time makespan = 0;
+
+    // Adjacency used to compute the distance between solutions of the
+    // population. Only up to date for solutions of the population.
+    PermutationAdjacency adjacency;
 };
 
 Solution build_solution(
         const Instance& instance,
         LocalSearchSolution& ls_solution)
 {
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/BuildSolution");
     SolutionBuilder solution_builder;
     solution_builder.set_instance(instance);
     solution_builder.from_permutation(ls_solution.jobs);
@@ -53,8 +62,9 @@ struct CriticalJob
 };
 
 // Returns sum of p[job_id][start..end] (inclusive), or 0 when end < start.
+template <typename TimeType>
 inline Time job_contribution(
-        const std::vector<std::vector<Time>>& job_prefix_sums,
+        const AlignedMatrix<TimeType>& job_prefix_sums,
         JobId job_id,
         MachineId start_machine,
         MachineId end_machine)
@@ -65,17 +75,20 @@ inline Time job_contribution(
         - job_prefix_sums[job_id][start_machine];
 }
 
+// TimeType is the type used to store completion times: Time, or int32_t when
+// the makespan of any permutation fits (see fits_in_int32()).
+template <typename TimeType>
 struct LocalSearchData
 {
     LocalSearchSolution solution;
 
-    std::vector<std::vector<Time>> completion_times_0;
-    std::vector<std::vector<Time>> reverse_completion_times_0;
+    AlignedMatrix<TimeType> completion_times_0;
+    AlignedMatrix<TimeType> reverse_completion_times_0;
 
-    std::vector<std::vector<Time>> completion_times;
-    std::vector<std::vector<Time>> reverse_completion_times;
+    AlignedMatrix<TimeType> completion_times;
+    AlignedMatrix<TimeType> reverse_completion_times;
 
-    std::vector<Time> completion_times_2;
+    AlignedVector<TimeType> completion_times_2;
     std::vector<Time> makespans;
 
     // critical_path[0..n-1]: per-position data; critical_path[n]: sentinel (start_machine_id = m-1).
@@ -83,12 +96,91 @@ struct LocalSearchData
 
     // job_prefix_sums[job_id][k] = sum of p[job_id][0..k-1], with job_prefix_sums[job_id][0] = 0.
     // Range sum: sum(p[job_id][first..last]) = job_prefix_sums[job_id][last+1] - job_prefix_sums[job_id][first].
-    std::vector<std::vector<Time>> job_prefix_sums;
+    AlignedMatrix<TimeType> job_prefix_sums;
+
+    // position_prefix_sums[pos][k] = sum of the processing times on machine k
+    // of the first pos jobs of the current solution.
+    // Range sum: sum(p[jobs[first..last - 1]][k]) = position_prefix_sums[last][k] - position_prefix_sums[first][k].
+    AlignedMatrix<TimeType> position_prefix_sums;
+
+    // Evaluator of the instances with no-idle machines. For these instances,
+    // completion_times_0 holds the completion times of the current solution,
+    // and the reverse completion times and the critical path are not used.
+    NoIdleEvaluator no_idle_evaluator;
+
+    // Scratch block of the no-idle shift evaluations.
+    std::vector<JobId> no_idle_block;
+
+    // Number of jobs at the beginning of the sequence which are never moved.
+    // The neighborhoods, the insertions and the perturbations only consider
+    // the positions after them.
+    JobId number_of_frozen_jobs = 0;
 };
 
+// Return true iff the makespan of any permutation schedule of the instance
+// fits in an int32_t.
+//
+// Once all the jobs are released, all the machines available and all the
+// fixed operations started, some machine is processing as long as a job is in
+// the shop, with and without blocking. The makespan never exceeds this time
+// plus the sum of all processing times. With no-idle machines, the delay
+// between the starts of two consecutive segments never exceeds the
+// processing times of the first of them, so the bound still holds.
+bool fits_in_int32(const Instance& instance)
+{
+    Time horizon = 0;
+    Time start_max = 0;
+    for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
+        start_max = (std::max)(start_max, instance.machine(machine_id).availability_time);
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+        const Job& job = instance.job(job_id);
+        start_max = (std::max)(start_max, job.release_date);
+        for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id) {
+            const Operation& operation = job.operations[machine_id];
+            start_max = (std::max)(start_max, operation.fixed_start);
+            horizon += operation.alternatives[0].processing_time;
+        }
+    }
+    horizon += start_max;
+    return horizon <= std::numeric_limits<int32_t>::max();
+}
+
+// Allocate the structures of the local search data for an instance.
+template <typename TimeType>
+void initialize_data(
+        const Instance& instance,
+        LocalSearchData<TimeType>& data)
+{
+    JobId n = instance.number_of_jobs();
+    MachineId m = instance.number_of_machines();
+    data.completion_times_0.resize(n + 1, m, 0);
+    for (MachineId machine_id = 0; machine_id < m; ++machine_id)
+        data.completion_times_0[0][machine_id] = instance.machine(machine_id).availability_time;
+    data.reverse_completion_times_0.resize(n + 1, m, 0);
+    data.completion_times.resize(n + 1, m, 0);
+    data.reverse_completion_times.resize(n + 1, m, 0);
+    data.completion_times_2.resize(m, 0);
+    data.critical_path = std::vector<CriticalJob>(n + 1);
+    data.job_prefix_sums.resize(n, m + 1, 0);
+    data.position_prefix_sums.resize(n + 1, m, 0);
+    for (JobId job_id = 0; job_id < n; ++job_id) {
+        const Job& job = instance.job(job_id);
+        for (MachineId k = 0; k < m; ++k) {
+            data.job_prefix_sums[job_id][k + 1] = data.job_prefix_sums[job_id][k]
+                + job.operations[k].alternatives[0].processing_time;
+        }
+    }
+    data.solution.jobs_positions = std::vector<JobId>(n, -1);
+    if (instance.mixed_no_idle()) {
+        data.no_idle_evaluator = NoIdleEvaluator(instance);
+        data.no_idle_block.reserve(n);
+    }
+}
+
+template <typename TimeType>
 void update_completion_times(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId p)
 {
     //std::cout << "update_completion_times p " << p << std::endl;
@@ -98,7 +190,7 @@ void update_completion_times(
             JobId job_id = data.solution.jobs[pos - 1];
             const Job& job = instance.job(job_id);
             {
-                Time p0 = job.operations[0].alternatives[0].processing_time;
+                TimeType p0 = job.operations[0].alternatives[0].processing_time;
                 // D[pos][0] = max(D[pos-1][0] + p, D[pos-1][1])
                 if (last_machine_id > 0) {
                     data.completion_times_0[pos][0] = (std::max)(
@@ -111,14 +203,14 @@ void update_completion_times(
             for (MachineId machine_id = 1;
                     machine_id < instance.number_of_machines() - 1;
                     ++machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                 // D[pos][m] = max(D[pos][m-1] + p, D[pos-1][m+1])
                 data.completion_times_0[pos][machine_id] = (std::max)(
                         data.completion_times_0[pos][machine_id - 1] + p,
                         data.completion_times_0[pos - 1][machine_id + 1]);
             }
             if (last_machine_id > 0) {
-                Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                 data.completion_times_0[pos][last_machine_id] = data.completion_times_0[pos][last_machine_id - 1] + p;
             }
         }
@@ -129,10 +221,24 @@ void update_completion_times(
         throw std::invalid_argument(
                 FUNC_SIGNATURE + ": no-wait not supported.");
     } else {
-        for (JobId pos = p + 1; pos <= (JobId)data.solution.jobs.size(); ++pos) {
+        // The fixed jobs are the first jobs of the sequence; their rows are
+        // set from their fixed starts, which might be later than as early as
+        // possible.
+        JobId number_of_fixed_jobs = instance.fixed_jobs().size();
+        for (JobId pos = p + 1; pos <= number_of_fixed_jobs; ++pos) {
+            const Job& job = instance.job(data.solution.jobs[pos - 1]);
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                const Operation& operation = job.operations[machine_id];
+                data.completion_times_0[pos][machine_id]
+                    = operation.fixed_start + operation.alternatives[0].processing_time;
+            }
+        }
+        for (JobId pos = (std::max)(p, number_of_fixed_jobs) + 1; pos <= (JobId)data.solution.jobs.size(); ++pos) {
             JobId job_id = data.solution.jobs[pos - 1];
             const Job& job = instance.job(job_id);
-            Time p0 = job.operations[0].alternatives[0].processing_time;
+            TimeType p0 = job.operations[0].alternatives[0].processing_time;
             data.completion_times_0[pos][0] = data.completion_times_0[pos - 1][0] + p0;
             //std::cout << "compute c"
             //    << " pos " << pos
@@ -144,7 +250,7 @@ void update_completion_times(
             for (MachineId machine_id = 1;
                     machine_id < instance.number_of_machines();
                     ++machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                 if (data.completion_times_0[pos - 1][machine_id] > data.completion_times_0[pos][machine_id - 1]) {
                     data.completion_times_0[pos][machine_id] = data.completion_times_0[pos - 1][machine_id] + p;
                 } else {
@@ -162,9 +268,10 @@ void update_completion_times(
     }
 }
 
+template <typename TimeType>
 void update_reverse_completion_times(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId p)
 {
     MachineId last_machine_id = instance.number_of_machines() - 1;
@@ -174,7 +281,7 @@ void update_reverse_completion_times(
             JobId job_id = data.solution.jobs[last_job_pos - pos + 1];
             const Job& job = instance.job(job_id);
             {
-                Time p0 = job.operations[last_machine_id].alternatives[0].processing_time;
+                TimeType p0 = job.operations[last_machine_id].alternatives[0].processing_time;
                 // R[pos][M-1] = max(R[pos-1][M-1] + p, R[pos-1][M-2])
                 if (last_machine_id > 0) {
                     data.reverse_completion_times_0[pos][last_machine_id] = (std::max)(
@@ -187,14 +294,14 @@ void update_reverse_completion_times(
             for (MachineId machine_id = last_machine_id - 1;
                     machine_id >= 1;
                     --machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                 // R[pos][m] = max(R[pos][m+1] + p, R[pos-1][m-1])
                 data.reverse_completion_times_0[pos][machine_id] = (std::max)(
                         data.reverse_completion_times_0[pos][machine_id + 1] + p,
                         data.reverse_completion_times_0[pos - 1][machine_id - 1]);
             }
             if (last_machine_id > 0) {
-                Time p = job.operations[0].alternatives[0].processing_time;
+                TimeType p = job.operations[0].alternatives[0].processing_time;
                 data.reverse_completion_times_0[pos][0] = data.reverse_completion_times_0[pos][1] + p;
             }
         }
@@ -208,12 +315,12 @@ void update_reverse_completion_times(
         for (JobId pos = p + 1; pos <= (JobId)data.solution.jobs.size(); ++pos) {
             JobId job_id = data.solution.jobs[last_job_pos - pos + 1];
             const Job& job = instance.job(job_id);
-            Time p0 = job.operations[last_machine_id].alternatives[0].processing_time;
+            TimeType p0 = job.operations[last_machine_id].alternatives[0].processing_time;
             data.reverse_completion_times_0[pos][last_machine_id] = data.reverse_completion_times_0[pos - 1][last_machine_id] + p0;
             for (MachineId machine_id = last_machine_id - 1;
                     machine_id >= 0;
                     --machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                 if (data.reverse_completion_times_0[pos - 1][machine_id] > data.reverse_completion_times_0[pos][machine_id + 1]) {
                     data.reverse_completion_times_0[pos][machine_id] = data.reverse_completion_times_0[pos - 1][machine_id] + p;
                 } else {
@@ -224,9 +331,10 @@ void update_reverse_completion_times(
     }
 }
 
+template <typename TimeType>
 void compute_critical_path_machines(
         const Instance& instance,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     if (data.solution.jobs.empty())
         return;
@@ -338,19 +446,43 @@ void compute_critical_path_machines(
     }
 }
 
+template <typename TimeType>
 void update_data(
         const Instance& instance,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
+    JobId n = data.solution.jobs.size();
+    if (instance.mixed_no_idle()) {
+        data.no_idle_evaluator.set_sequence(data.solution.jobs);
+        for (JobId pos = 1; pos <= n; ++pos) {
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                data.completion_times_0[pos][machine_id]
+                    = data.no_idle_evaluator.completion_time(pos - 1, machine_id);
+            }
+        }
+        data.solution.makespan = data.no_idle_evaluator.makespan();
+        return;
+    }
     update_completion_times(instance, data, 0);
     update_reverse_completion_times(instance, data, 0);
     compute_critical_path_machines(instance, data);
-    JobId n = data.solution.jobs.size();
+    for (JobId pos = 1; pos <= n; ++pos) {
+        const Job& job = instance.job(data.solution.jobs[pos - 1]);
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            data.position_prefix_sums[pos][machine_id] = data.position_prefix_sums[pos - 1][machine_id]
+                + job.operations[machine_id].alternatives[0].processing_time;
+        }
+    }
     data.solution.makespan = data.completion_times_0[n][instance.number_of_machines() - 1];
 }
 
+template <typename TimeType>
 void load_solution(
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         const Solution& solution)
 {
     const Instance& instance = solution.instance();
@@ -369,9 +501,10 @@ void load_solution(
     update_data(instance, data);
 };
 
+template <typename TimeType>
 void add_job(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId job_id,
         JobId pos_new)
 {
@@ -385,9 +518,10 @@ void add_job(
     update_data(instance, data);
 }
 
+template <typename TimeType>
 void add_block(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         const std::vector<JobId>& job_ids,
         JobId pos_new)
 {
@@ -404,9 +538,10 @@ void add_block(
     update_data(instance, data);
 }
 
+template <typename TimeType>
 void remove_job(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId pos_new)
 {
     data.solution.jobs.erase(data.solution.jobs.begin() + pos_new);
@@ -418,9 +553,10 @@ void remove_job(
     update_data(instance, data);
 }
 
+template <typename TimeType>
 void remove_jobs(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::vector<JobId>& positions)
 {
     // Update data.solution.jobs.
@@ -435,9 +571,10 @@ void remove_jobs(
     update_data(instance, data);
 }
 
+template <typename TimeType>
 void remove_block(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId pos_new,
         JobId size)
 {
@@ -452,9 +589,10 @@ void remove_block(
     update_data(instance, data);
 }
 
+template <typename TimeType>
 void shift_jobs(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId size,
         JobId pos_old,
         JobId pos_new,
@@ -484,9 +622,10 @@ void shift_jobs(
     update_data(instance, data);
 }
 
+template <typename TimeType>
 void swap_jobs(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId pos_1,
         JobId pos_2)
 {
@@ -496,30 +635,57 @@ void swap_jobs(
     update_data(instance, data);
 }
 
-enum class Neighborhood
+// Evaluate all the re-insertions of the block of 'size' jobs starting at
+// position 'pos_old' for an instance with no-idle machines, and update
+// 'makespan_new_best' and 'pos_new_best'.
+template <typename TimeType>
+void explore_no_idle_shifts(
+        LocalSearchData<TimeType>& data,
+        JobId size,
+        JobId pos_old,
+        bool reverse,
+        Time& makespan_new_best,
+        JobId& pos_new_best)
 {
-    Shift1,
-    Shift2,
-    Shift3,
-    Shift4,
-    ShiftReverse2,
-    ShiftReverse3,
-    ShiftReverse4,
-    Swap,
-};
+    data.no_idle_evaluator.set_sequence(data.solution.jobs, pos_old, size);
+    data.no_idle_block.assign(
+            data.solution.jobs.begin() + pos_old,
+            data.solution.jobs.begin() + pos_old + size);
+    if (reverse)
+        std::reverse(data.no_idle_block.begin(), data.no_idle_block.end());
+    for (JobId pos_new = data.number_of_frozen_jobs;
+            pos_new <= (JobId)data.solution.jobs.size() - size;
+            ++pos_new) {
+        if (pos_new == pos_old && !reverse)
+            continue;
+        Time makespan = data.no_idle_evaluator.evaluate_insertion(
+                data.no_idle_block.data(),
+                size,
+                pos_new);
+        if (makespan_new_best > makespan) {
+            makespan_new_best = makespan;
+            pos_new_best = pos_new;
+        }
+    }
+}
 
+template <typename TimeType>
 bool explore_shift_job_neighborhood(
         const Instance& instance,
-        LocalSearchData& data,
-        std::mt19937_64& generator)
+        LocalSearchData<TimeType>& data,
+        std::mt19937_64& generator,
+        EndCheck& end_check)
 {
     //std::cout << "explore_shift_job_neighborhood" << std::endl;
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/ShiftJobNeighborhood");
     MachineId last_machine_id = instance.number_of_machines() - 1;
     const JobId size = 1;
 
     bool improved = false;
 
-    for (JobId pos_old = 0; pos_old + size <= (JobId)data.solution.jobs.size(); ) {
+    for (JobId pos_old = data.number_of_frozen_jobs; pos_old + size <= (JobId)data.solution.jobs.size(); ) {
+        if (end_check.needs_to_end())
+            break;
         JobId pos_new_best = -1;
         Time makespan_new_best = data.solution.makespan;
         if (instance.blocking()) {
@@ -534,7 +700,7 @@ bool explore_shift_job_neighborhood(
                     ++pos) {
                 JobId job_id = data.solution.jobs[pos - 1 + size];
                 const Job& job = instance.job(job_id);
-                Time p0 = job.operations[0].alternatives[0].processing_time;
+                TimeType p0 = job.operations[0].alternatives[0].processing_time;
                 if (last_machine_id > 0) {
                     data.completion_times[pos][0] = (std::max)(
                             data.completion_times[pos - 1][0] + p0,
@@ -545,24 +711,24 @@ bool explore_shift_job_neighborhood(
                 for (MachineId machine_id = 1;
                         machine_id < instance.number_of_machines() - 1;
                         ++machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     data.completion_times[pos][machine_id] = (std::max)(
                             data.completion_times[pos][machine_id - 1] + p,
                             data.completion_times[pos - 1][machine_id + 1]);
                 }
                 if (last_machine_id > 0) {
-                    Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                     data.completion_times[pos][last_machine_id] = data.completion_times[pos][last_machine_id - 1] + p;
                 }
             }
 
             // Compute data.reverse_completion_times.
             JobId p = data.solution.jobs.size() - pos_old - size;
-            if (p < 0 || p >= data.reverse_completion_times.size()) {
+            if (p < 0 || p >= data.reverse_completion_times.number_of_rows()) {
                 throw std::logic_error(
                         FUNC_SIGNATURE + ": wrong 'p'; "
                         "p: " + std::to_string(p) + "; "
-                        "data.reverse_completion_times.size(): " + std::to_string(data.reverse_completion_times.size()) + "; "
+                        "data.reverse_completion_times.number_of_rows(): " + std::to_string(data.reverse_completion_times.number_of_rows()) + "; "
                         "pos_old: " + std::to_string(pos_old) + ".");
             }
             for (MachineId machine_id = 0;
@@ -583,7 +749,7 @@ bool explore_shift_job_neighborhood(
                 }
                 JobId job_id = data.solution.jobs[job_pos];
                 const Job& job = instance.job(job_id);
-                Time p0 = job.operations[last_machine_id].alternatives[0].processing_time;
+                TimeType p0 = job.operations[last_machine_id].alternatives[0].processing_time;
                 if (last_machine_id > 0) {
                     data.reverse_completion_times[pos][last_machine_id] = (std::max)(
                             data.reverse_completion_times[pos - 1][last_machine_id] + p0,
@@ -594,13 +760,13 @@ bool explore_shift_job_neighborhood(
                 for (MachineId machine_id = last_machine_id - 1;
                         machine_id >= 1;
                         --machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     data.reverse_completion_times[pos][machine_id] = (std::max)(
                             data.reverse_completion_times[pos][machine_id + 1] + p,
                             data.reverse_completion_times[pos - 1][machine_id - 1]);
                 }
                 if (last_machine_id > 0) {
-                    Time p = job.operations[0].alternatives[0].processing_time;
+                    TimeType p = job.operations[0].alternatives[0].processing_time;
                     data.reverse_completion_times[pos][0] = data.reverse_completion_times[pos][1] + p;
                 }
             }
@@ -646,7 +812,7 @@ bool explore_shift_job_neighborhood(
             // Same-block positions (including pos_old itself) are bounded by
             // left_shift_max and right_shift_min and skipped in one range check
             // (Grabowski & Pempera 2007).
-            for (JobId pos_new = 0;
+            for (JobId pos_new = data.number_of_frozen_jobs;
                     pos_new <= (JobId)data.solution.jobs.size() - size;
                     ++pos_new) {
                 if (pos_new > data.critical_path[pos_old].left_shift_max
@@ -678,7 +844,7 @@ bool explore_shift_job_neighborhood(
                 {
                     JobId job_id = data.solution.jobs[pos_old];
                     const Job& job = instance.job(job_id);
-                    Time p0 = job.operations[0].alternatives[0].processing_time;
+                    TimeType p0 = job.operations[0].alternatives[0].processing_time;
                     // D2[0] = max(D2[0] + p, D2[1]); D2[1] is still old at this point.
                     if (last_machine_id > 0) {
                         data.completion_times_2[0] = (std::max)(
@@ -690,14 +856,14 @@ bool explore_shift_job_neighborhood(
                     for (MachineId machine_id = 1;
                             machine_id < instance.number_of_machines() - 1;
                             ++machine_id) {
-                        Time p = job.operations[machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                         // D2[m] = max(new D2[m-1] + p, old D2[m+1])
                         data.completion_times_2[machine_id] = (std::max)(
                                 data.completion_times_2[machine_id - 1] + p,
                                 data.completion_times_2[machine_id + 1]);
                     }
                     if (last_machine_id > 0) {
-                        Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                         data.completion_times_2[last_machine_id] = data.completion_times_2[last_machine_id - 1] + p;
                     }
                 }
@@ -721,9 +887,10 @@ bool explore_shift_job_neighborhood(
                 }
             }
 
-        } else if (instance.no_idle()) {
-            throw std::invalid_argument(
-                    FUNC_SIGNATURE + ": no-idle not supported.");
+        } else if (instance.mixed_no_idle()) {
+            explore_no_idle_shifts(
+                    data, size, pos_old, false,
+                    makespan_new_best, pos_new_best);
 
         } else if (instance.no_wait()) {
             throw std::invalid_argument(
@@ -741,12 +908,12 @@ bool explore_shift_job_neighborhood(
                     ++pos) {
                 JobId job_id = data.solution.jobs[pos - 1 + size];
                 const Job& job = instance.job(job_id);
-                Time p0 = job.operations[0].alternatives[0].processing_time;
+                TimeType p0 = job.operations[0].alternatives[0].processing_time;
                 data.completion_times[pos][0] = data.completion_times[pos - 1][0] + p0;
                 for (MachineId machine_id = 1;
                         machine_id < instance.number_of_machines();
                         ++machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     if (data.completion_times[pos - 1][machine_id] > data.completion_times[pos][machine_id - 1]) {
                         data.completion_times[pos][machine_id] = data.completion_times[pos - 1][machine_id] + p;
                     } else {
@@ -757,11 +924,11 @@ bool explore_shift_job_neighborhood(
 
             // Compute data.reverse_completion_times.
             JobId p = data.solution.jobs.size() - pos_old - size;
-            if (p < 0 || p >= data.reverse_completion_times.size()) {
+            if (p < 0 || p >= data.reverse_completion_times.number_of_rows()) {
                 throw std::logic_error(
                         FUNC_SIGNATURE + ": wrong 'p'; "
                         "p: " + std::to_string(p) + "; "
-                        "data.reverse_completion_times.size(): " + std::to_string(data.reverse_completion_times.size()) + "; "
+                        "data.reverse_completion_times.number_of_rows(): " + std::to_string(data.reverse_completion_times.number_of_rows()) + "; "
                         "pos_old: " + std::to_string(pos_old) + ".");
             }
             for (MachineId machine_id = 0;
@@ -782,12 +949,12 @@ bool explore_shift_job_neighborhood(
                 }
                 JobId job_id = data.solution.jobs[job_pos];
                 const Job& job = instance.job(job_id);
-                Time p0 = job.operations[last_machine_id].alternatives[0].processing_time;
+                TimeType p0 = job.operations[last_machine_id].alternatives[0].processing_time;
                 data.reverse_completion_times[pos][last_machine_id] = data.reverse_completion_times[pos - 1][last_machine_id] + p0;
                 for (MachineId machine_id = last_machine_id - 1;
                         machine_id >= 0;
                         --machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     if (data.reverse_completion_times[pos - 1][machine_id] > data.reverse_completion_times[pos][machine_id + 1]) {
                         data.reverse_completion_times[pos][machine_id] = data.reverse_completion_times[pos - 1][machine_id] + p;
                     } else {
@@ -817,7 +984,7 @@ bool explore_shift_job_neighborhood(
             // Evaluate each candidate insertion position.
             // Same-block positions (including pos_old itself) are bounded by
             // left_shift_max and right_shift_min (Grabowski & Pempera 2007).
-            for (JobId pos_new = 0;
+            for (JobId pos_new = data.number_of_frozen_jobs;
                     pos_new <= (JobId)data.solution.jobs.size() - size;
                     ++pos_new) {
                 if (pos_new > data.critical_path[pos_old].left_shift_max
@@ -850,12 +1017,12 @@ bool explore_shift_job_neighborhood(
                 {
                     JobId job_id = data.solution.jobs[pos_old];
                     const Job& job = instance.job(job_id);
-                    Time p0 = job.operations[0].alternatives[0].processing_time;
+                    TimeType p0 = job.operations[0].alternatives[0].processing_time;
                     data.completion_times_2[0] = data.completion_times_2[0] + p0;
                     for (MachineId machine_id = 1;
                             machine_id < instance.number_of_machines();
                             ++machine_id) {
-                        Time p = job.operations[machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                         if (data.completion_times_2[machine_id] > data.completion_times_2[machine_id - 1]) {
                             data.completion_times_2[machine_id] = data.completion_times_2[machine_id] + p;
                         } else {
@@ -901,19 +1068,24 @@ bool explore_shift_job_neighborhood(
     return improved;
 }
 
+template <typename TimeType>
 bool explore_shift_block_neighborhood(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
+        EndCheck& end_check,
         JobId size,
         bool reverse = false)
 {
     //std::cout << "explore_shift_block_neighborhood " << size << std::endl;
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/ShiftBlockNeighborhood");
     MachineId last_machine_id = instance.number_of_machines() - 1;
 
     bool improved = false;
 
-    for (JobId pos_old = 0; pos_old + size <= (JobId)data.solution.jobs.size(); ) {
+    for (JobId pos_old = data.number_of_frozen_jobs; pos_old + size <= (JobId)data.solution.jobs.size(); ) {
+        if (end_check.needs_to_end())
+            break;
         JobId pos_new_best = -1;
         Time makespan_new_best = data.solution.makespan;
 
@@ -929,7 +1101,7 @@ bool explore_shift_block_neighborhood(
                     ++pos) {
                 JobId job_id = data.solution.jobs[pos - 1 + size];
                 const Job& job = instance.job(job_id);
-                Time p0 = job.operations[0].alternatives[0].processing_time;
+                TimeType p0 = job.operations[0].alternatives[0].processing_time;
                 if (last_machine_id > 0) {
                     data.completion_times[pos][0] = (std::max)(
                             data.completion_times[pos - 1][0] + p0,
@@ -940,24 +1112,24 @@ bool explore_shift_block_neighborhood(
                 for (MachineId machine_id = 1;
                         machine_id < instance.number_of_machines() - 1;
                         ++machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     data.completion_times[pos][machine_id] = (std::max)(
                             data.completion_times[pos][machine_id - 1] + p,
                             data.completion_times[pos - 1][machine_id + 1]);
                 }
                 if (last_machine_id > 0) {
-                    Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                     data.completion_times[pos][last_machine_id] = data.completion_times[pos][last_machine_id - 1] + p;
                 }
             }
 
             // Compute data.reverse_completion_times.
             JobId p = data.solution.jobs.size() - pos_old - size;
-            if (p < 0 || p >= data.reverse_completion_times.size()) {
+            if (p < 0 || p >= data.reverse_completion_times.number_of_rows()) {
                 throw std::logic_error(
                         FUNC_SIGNATURE + ": wrong 'p'; "
                         "p: " + std::to_string(p) + "; "
-                        "data.reverse_completion_times.size(): " + std::to_string(data.reverse_completion_times.size()) + "; "
+                        "data.reverse_completion_times.number_of_rows(): " + std::to_string(data.reverse_completion_times.number_of_rows()) + "; "
                         "pos_old: " + std::to_string(pos_old) + "; "
                         "size: " + std::to_string(size) + ".");
             }
@@ -979,7 +1151,7 @@ bool explore_shift_block_neighborhood(
                 }
                 JobId job_id = data.solution.jobs[job_pos];
                 const Job& job = instance.job(job_id);
-                Time p0 = job.operations[last_machine_id].alternatives[0].processing_time;
+                TimeType p0 = job.operations[last_machine_id].alternatives[0].processing_time;
                 if (last_machine_id > 0) {
                     data.reverse_completion_times[pos][last_machine_id] = (std::max)(
                             data.reverse_completion_times[pos - 1][last_machine_id] + p0,
@@ -990,19 +1162,19 @@ bool explore_shift_block_neighborhood(
                 for (MachineId machine_id = last_machine_id - 1;
                         machine_id >= 1;
                         --machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     data.reverse_completion_times[pos][machine_id] = (std::max)(
                             data.reverse_completion_times[pos][machine_id + 1] + p,
                             data.reverse_completion_times[pos - 1][machine_id - 1]);
                 }
                 if (last_machine_id > 0) {
-                    Time p = job.operations[0].alternatives[0].processing_time;
+                    TimeType p = job.operations[0].alternatives[0].processing_time;
                     data.reverse_completion_times[pos][0] = data.reverse_completion_times[pos][1] + p;
                 }
             }
 
             // Evaluate each candidate insertion position.
-            for (JobId pos_new = 0;
+            for (JobId pos_new = data.number_of_frozen_jobs;
                     pos_new <= (JobId)data.solution.jobs.size() - size;
                     ++pos_new) {
                 if (pos_new == pos_old)
@@ -1024,7 +1196,7 @@ bool explore_shift_block_neighborhood(
                     JobId pos_0 = reverse ? (pos_old + size - 1 - i) : (pos_old + i);
                     JobId job_id = data.solution.jobs[pos_0];
                     const Job& job = instance.job(job_id);
-                    Time p0 = job.operations[0].alternatives[0].processing_time;
+                    TimeType p0 = job.operations[0].alternatives[0].processing_time;
                     // D2[0] = max(D2[0] + p, D2[1]); D2[1] is still old at this point.
                     if (last_machine_id > 0) {
                         data.completion_times_2[0] = (std::max)(
@@ -1036,14 +1208,14 @@ bool explore_shift_block_neighborhood(
                     for (MachineId machine_id = 1;
                             machine_id < instance.number_of_machines() - 1;
                             ++machine_id) {
-                        Time p = job.operations[machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                         // D2[m] = max(new D2[m-1] + p, old D2[m+1])
                         data.completion_times_2[machine_id] = (std::max)(
                                 data.completion_times_2[machine_id - 1] + p,
                                 data.completion_times_2[machine_id + 1]);
                     }
                     if (last_machine_id > 0) {
-                        Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                         data.completion_times_2[last_machine_id] = data.completion_times_2[last_machine_id - 1] + p;
                     }
                 }
@@ -1067,9 +1239,10 @@ bool explore_shift_block_neighborhood(
                 }
             }
 
-        } else if (instance.no_idle()) {
-            throw std::invalid_argument(
-                    FUNC_SIGNATURE + ": no-idle not supported.");
+        } else if (instance.mixed_no_idle()) {
+            explore_no_idle_shifts(
+                    data, size, pos_old, reverse,
+                    makespan_new_best, pos_new_best);
 
         } else if (instance.no_wait()) {
             throw std::invalid_argument(
@@ -1087,12 +1260,12 @@ bool explore_shift_block_neighborhood(
                     ++pos) {
                 JobId job_id = data.solution.jobs[pos - 1 + size];
                 const Job& job = instance.job(job_id);
-                Time p0 = job.operations[0].alternatives[0].processing_time;
+                TimeType p0 = job.operations[0].alternatives[0].processing_time;
                 data.completion_times[pos][0] = data.completion_times[pos - 1][0] + p0;
                 for (MachineId machine_id = 1;
                         machine_id < instance.number_of_machines();
                         ++machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     if (data.completion_times[pos - 1][machine_id] > data.completion_times[pos][machine_id - 1]) {
                         data.completion_times[pos][machine_id] = data.completion_times[pos - 1][machine_id] + p;
                     } else {
@@ -1103,11 +1276,11 @@ bool explore_shift_block_neighborhood(
 
             // Compute data.reverse_completion_times.
             JobId p = data.solution.jobs.size() - pos_old - size;
-            if (p < 0 || p >= data.reverse_completion_times.size()) {
+            if (p < 0 || p >= data.reverse_completion_times.number_of_rows()) {
                 throw std::logic_error(
                         FUNC_SIGNATURE + ": wrong 'p'; "
                         "p: " + std::to_string(p) + "; "
-                        "data.reverse_completion_times.size(): " + std::to_string(data.reverse_completion_times.size()) + "; "
+                        "data.reverse_completion_times.number_of_rows(): " + std::to_string(data.reverse_completion_times.number_of_rows()) + "; "
                         "pos_old: " + std::to_string(pos_old) + "; "
                         "size: " + std::to_string(size) + ".");
             }
@@ -1129,12 +1302,12 @@ bool explore_shift_block_neighborhood(
                 }
                 JobId job_id = data.solution.jobs[job_pos];
                 const Job& job = instance.job(job_id);
-                Time p0 = job.operations[last_machine_id].alternatives[0].processing_time;
+                TimeType p0 = job.operations[last_machine_id].alternatives[0].processing_time;
                 data.reverse_completion_times[pos][last_machine_id] = data.reverse_completion_times[pos - 1][last_machine_id] + p0;
                 for (MachineId machine_id = last_machine_id - 1;
                         machine_id >= 0;
                         --machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     if (data.reverse_completion_times[pos - 1][machine_id] > data.reverse_completion_times[pos][machine_id + 1]) {
                         data.reverse_completion_times[pos][machine_id] = data.reverse_completion_times[pos - 1][machine_id] + p;
                     } else {
@@ -1144,7 +1317,7 @@ bool explore_shift_block_neighborhood(
             }
 
             // Evaluate each candidate insertion position.
-            for (JobId pos_new = 0;
+            for (JobId pos_new = data.number_of_frozen_jobs;
                     pos_new <= (JobId)data.solution.jobs.size() - size;
                     ++pos_new) {
                 if (pos_new == pos_old)
@@ -1166,12 +1339,12 @@ bool explore_shift_block_neighborhood(
                     JobId pos_0 = reverse ? (pos_old + size - 1 - i) : (pos_old + i);
                     JobId job_id = data.solution.jobs[pos_0];
                     const Job& job = instance.job(job_id);
-                    Time p0 = job.operations[0].alternatives[0].processing_time;
+                    TimeType p0 = job.operations[0].alternatives[0].processing_time;
                     data.completion_times_2[0] = data.completion_times_2[0] + p0;
                     for (MachineId machine_id = 1;
                             machine_id < instance.number_of_machines();
                             ++machine_id) {
-                        Time p = job.operations[machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                         if (data.completion_times_2[machine_id] > data.completion_times_2[machine_id - 1]) {
                             data.completion_times_2[machine_id] = data.completion_times_2[machine_id] + p;
                         } else {
@@ -1216,18 +1389,23 @@ bool explore_shift_block_neighborhood(
     return improved;
 }
 
+template <typename TimeType>
 bool explore_swap_neighborhood(
         const Instance& instance,
-        LocalSearchData& data,
-        std::mt19937_64& generator)
+        LocalSearchData<TimeType>& data,
+        std::mt19937_64& generator,
+        EndCheck& end_check)
 {
     //std::cout << "explore_swap_neighborhood" << std::endl;
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/SwapNeighborhood");
     MachineId last_machine_id = instance.number_of_machines() - 1;
     JobId n = data.solution.jobs.size();
 
     bool improved = false;
 
-    for (JobId pos_1 = 0; pos_1 < n - 1; ) {
+    for (JobId pos_1 = data.number_of_frozen_jobs; pos_1 < n - 1; ) {
+        if (end_check.needs_to_end())
+            break;
 
         bool applied = false;
 
@@ -1267,7 +1445,7 @@ bool explore_swap_neighborhood(
                         pos_2:
                         (pos_0 < pos_2? pos_0: pos_1)];
                     const Job& job = instance.job(job_id);
-                    Time p0 = job.operations[0].alternatives[0].processing_time;
+                    TimeType p0 = job.operations[0].alternatives[0].processing_time;
                     if (last_machine_id > 0) {
                         data.completion_times_2[0] = (std::max)(
                                 data.completion_times_2[0] + p0,
@@ -1278,13 +1456,13 @@ bool explore_swap_neighborhood(
                     for (MachineId machine_id = 1;
                             machine_id < instance.number_of_machines() - 1;
                             ++machine_id) {
-                        Time p = job.operations[machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                         data.completion_times_2[machine_id] = (std::max)(
                                 data.completion_times_2[machine_id - 1] + p,
                                 data.completion_times_2[machine_id + 1]);
                     }
                     if (last_machine_id > 0) {
-                        Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                         data.completion_times_2[last_machine_id] =
                                 data.completion_times_2[last_machine_id - 1] + p;
                     }
@@ -1319,9 +1497,21 @@ bool explore_swap_neighborhood(
                 next_pos_2_b:;
             }
 
-        } else if (instance.no_idle()) {
-            throw std::invalid_argument(
-                    FUNC_SIGNATURE + ": no-idle not supported.");
+        } else if (instance.mixed_no_idle()) {
+
+            // Swaps are evaluated from scratch.
+            for (JobId pos_2 = pos_1 + 1; pos_2 < n; ++pos_2) {
+                std::swap(data.solution.jobs[pos_1], data.solution.jobs[pos_2]);
+                data.no_idle_evaluator.set_sequence(data.solution.jobs);
+                std::swap(data.solution.jobs[pos_1], data.solution.jobs[pos_2]);
+                Time makespan = data.no_idle_evaluator.makespan();
+                if (data.solution.makespan > makespan) {
+                    swap_jobs(instance, data, pos_1, pos_2);
+                    applied = true;
+                    improved = true;
+                }
+            }
+
         } else if (instance.no_wait()) {
             throw std::invalid_argument(
                     FUNC_SIGNATURE + ": no-wait not supported.");
@@ -1361,12 +1551,12 @@ bool explore_swap_neighborhood(
                         pos_2:
                         (pos_0 < pos_2? pos_0: pos_1)];
                     const Job& job = instance.job(job_id);
-                    Time p0 = job.operations[0].alternatives[0].processing_time;
+                    TimeType p0 = job.operations[0].alternatives[0].processing_time;
                     data.completion_times_2[0] += p0;
                     for (MachineId machine_id = 1;
                             machine_id < instance.number_of_machines();
                             ++machine_id) {
-                        Time p = job.operations[machine_id].alternatives[0].processing_time;
+                        TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                         if (data.completion_times_2[machine_id]
                                 > data.completion_times_2[machine_id - 1]) {
                             data.completion_times_2[machine_id] += p;
@@ -1377,6 +1567,25 @@ bool explore_swap_neighborhood(
                     }
                     if (data.completion_times_2[last_machine_id] >= data.solution.makespan)
                         goto next_pos_2;
+
+                    if (pos_0 < pos_2) {
+                        // One-machine lower bound in O(m): on each machine,
+                        // the remaining jobs between both positions and
+                        // job[pos_1] are processed after the current job and
+                        // before the tail of the jobs after pos_2.
+                        const Job& first_job = instance.job(job_1);
+                        for (MachineId machine_id = 0;
+                                machine_id < instance.number_of_machines();
+                                ++machine_id) {
+                            Time lower_bound = data.completion_times_2[machine_id]
+                                + data.position_prefix_sums[pos_2][machine_id]
+                                - data.position_prefix_sums[pos_0 + 1][machine_id]
+                                + first_job.operations[machine_id].alternatives[0].processing_time
+                                + data.reverse_completion_times_0[tail][machine_id];
+                            if (lower_bound >= data.solution.makespan)
+                                goto next_pos_2;
+                        }
+                    }
                 }
                 for (MachineId machine_id = 0;
                         machine_id < instance.number_of_machines();
@@ -1397,7 +1606,7 @@ bool explore_swap_neighborhood(
                         for (MachineId machine_id = 1;
                                 machine_id < instance.number_of_machines();
                                 ++machine_id) {
-                            Time p = job.operations[machine_id].alternatives[0].processing_time;
+                            TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                             if (data.completion_times_2[machine_id]
                                     > data.completion_times_2[machine_id - 1]) {
                                 data.completion_times_2[machine_id] += p;
@@ -1434,55 +1643,39 @@ bool explore_swap_neighborhood(
     return improved;
 }
 
+template <typename TimeType>
 void local_search(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
         AlgorithmFormatter& algorithm_formatter,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
-    std::vector<Neighborhood> neighborhoods = {
-        Neighborhood::Shift1,
-    };
-    if (instance.number_of_jobs() < 256) {
-        neighborhoods.push_back(Neighborhood::Shift2);
-        neighborhoods.push_back(Neighborhood::Shift3);
-        neighborhoods.push_back(Neighborhood::Shift4);
-        neighborhoods.push_back(Neighborhood::Swap);
-    }
-    for (;;) {
+    // The descent stops early at the end of the algorithm; the solution is
+    // then the last one reached, which is still a complete permutation.
+    EndCheck end_check(parameters.timer);
+    while (!end_check.needs_to_end()) {
         //std::cout << "makespan " << data.solution.makespan << std::endl;
         //for (JobId job_id: data.solution.jobs)
         //    std::cout << " " << job_id;
         //std::cout << std::endl;
 
         bool improved = false;
-        for (Neighborhood neighborhood: neighborhoods) {
-            switch (neighborhood) {
-            case Neighborhood::Shift1: {
-                improved = explore_shift_job_neighborhood(instance, data, generator);
-                break;
-            } case Neighborhood::Shift2: {
-                improved = explore_shift_block_neighborhood(instance, data, generator, 2);
-                break;
-            } case Neighborhood::Shift3: {
-                improved = explore_shift_block_neighborhood(instance, data, generator, 3);
-                break;
-            } case Neighborhood::Shift4: {
-                improved = explore_shift_block_neighborhood(instance, data, generator, 4);
-                break;
-            } case Neighborhood::ShiftReverse2: {
-                improved = explore_shift_block_neighborhood(instance, data, generator, 2, true);
-                break;
-            } case Neighborhood::ShiftReverse3: {
-                improved = explore_shift_block_neighborhood(instance, data, generator, 3, true);
+        for (const LocalSearchNeighborhood& neighborhood: parameters.neighborhoods) {
+            switch (neighborhood.type) {
+            case LocalSearchNeighborhoodType::Shift: {
+                if (neighborhood.size_1 == 1) {
+                    improved = explore_shift_job_neighborhood(instance, data, generator, end_check);
+                } else {
+                    improved = explore_shift_block_neighborhood(instance, data, generator, end_check, neighborhood.size_1);
+                }
                 break;
-            } case Neighborhood::ShiftReverse4: {
-                improved = explore_shift_block_neighborhood(instance, data, generator, 4, true);
+            } case LocalSearchNeighborhoodType::ShiftReverse: {
+                improved = explore_shift_block_neighborhood(instance, data, generator, end_check, neighborhood.size_1, true);
                 break;
-            } case Neighborhood::Swap: {
-                improved = explore_swap_neighborhood(instance, data, generator);
+            } case LocalSearchNeighborhoodType::Swap: {
+                improved = explore_swap_neighborhood(instance, data, generator, end_check);
                 break;
             }
             }
@@ -1506,11 +1699,12 @@ void local_search(
 }
 
 // Forward declaration — defined later in this file.
+template <typename TimeType>
 void add_job_at_best_position(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId job_id,
         JobId forbidden_position = -1)
 {
@@ -1519,105 +1713,27 @@ void add_job_at_best_position(
     std::vector<JobId> best_positions;
     Time makespan_best = 0;  // stores best+1 when best_positions is non-empty
 
-    for (JobId pos = 0; pos <= (JobId)data.solution.jobs.size(); ++pos) {
+    if (instance.mixed_no_idle())
+        data.no_idle_evaluator.set_sequence(data.solution.jobs);
+
+    for (JobId pos = data.number_of_frozen_jobs; pos <= (JobId)data.solution.jobs.size(); ++pos) {
 
         if (pos == forbidden_position)
             continue;
 
-        for (MachineId machine_id = 0;
-                machine_id < instance.number_of_machines();
-                ++machine_id) {
-            data.completion_times_2[machine_id] = data.completion_times_0[pos][machine_id];
-        }
-
-        if (instance.blocking()) {
-            MachineId last_machine_id = instance.number_of_machines() - 1;
-            Time p0 = job.operations[0].alternatives[0].processing_time;
-            if (last_machine_id > 0) {
-                data.completion_times_2[0] = (std::max)(
-                        data.completion_times_2[0] + p0,
-                        data.completion_times_2[1]);
-            } else {
-                data.completion_times_2[0] += p0;
-            }
-            for (MachineId machine_id = 1;
-                    machine_id < instance.number_of_machines() - 1;
-                    ++machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
-                data.completion_times_2[machine_id] = (std::max)(
-                        data.completion_times_2[machine_id - 1] + p,
-                        data.completion_times_2[machine_id + 1]);
-            }
-            if (last_machine_id > 0) {
-                Time p = job.operations[last_machine_id].alternatives[0].processing_time;
-                data.completion_times_2[last_machine_id] =
-                        data.completion_times_2[last_machine_id - 1] + p;
-            }
+        Time makespan = 0;
+        if (instance.mixed_no_idle()) {
+            makespan = data.no_idle_evaluator.evaluate_insertion(&job_id, 1, pos);
         } else {
-            Time p0 = job.operations[0].alternatives[0].processing_time;
-            data.completion_times_2[0] = data.completion_times_2[0] + p0;
-            for (MachineId machine_id = 1;
+            for (MachineId machine_id = 0;
                     machine_id < instance.number_of_machines();
                     ++machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
-                if (data.completion_times_2[machine_id] > data.completion_times_2[machine_id - 1]) {
-                    data.completion_times_2[machine_id] = data.completion_times_2[machine_id] + p;
-                } else {
-                    data.completion_times_2[machine_id] = data.completion_times_2[machine_id - 1] + p;
-                }
+                data.completion_times_2[machine_id] = data.completion_times_0[pos][machine_id];
             }
-        }
-
-        Time makespan = 0;
-        // pos = solution.jobs.size() => p = 0
-        // pos = solution.jobs.size() - 1 => p = 1
-        JobId p = data.solution.jobs.size() - pos;
-        for (MachineId machine_id = 0;
-                machine_id < instance.number_of_machines();
-                ++machine_id) {
-            makespan = std::max(makespan,
-                    data.completion_times_2[machine_id]
-                    + data.reverse_completion_times_0[p][machine_id]);
-        }
 
-        if (makespan + 1 < makespan_best)
-            best_positions.clear();
-        if (!best_positions.empty() && makespan >= makespan_best)
-            continue;
-        makespan_best = makespan + 1;
-        best_positions.push_back(pos);
-    }
-
-    if (best_positions.empty())
-        throw std::runtime_error(FUNC_SIGNATURE + ": best_positions is empty.");
-
-    JobId pos_best = best_positions[0];
-    add_job(instance, data, job_id, pos_best);
-}
-
-void add_block_at_best_position(
-        const Instance& instance,
-        const LocalSearchParameters& parameters,
-        std::mt19937_64& generator,
-        LocalSearchData& data,
-        const std::vector<JobId>& job_ids)
-{
-    std::vector<JobId> best_positions;
-    Time makespan_best = 0;
-
-    for (JobId pos = 0; pos <= (JobId)data.solution.jobs.size(); ++pos) {
-
-        for (MachineId machine_id = 0;
-                machine_id < instance.number_of_machines();
-                ++machine_id) {
-            data.completion_times_2[machine_id] = data.completion_times_0[pos][machine_id];
-        }
-
-        for (JobId job_id: job_ids) {
-            const Job& job = instance.job(job_id);
             if (instance.blocking()) {
                 MachineId last_machine_id = instance.number_of_machines() - 1;
-                Time p0 = job.operations[0].alternatives[0].processing_time;
+                TimeType p0 = job.operations[0].alternatives[0].processing_time;
                 if (last_machine_id > 0) {
                     data.completion_times_2[0] = (std::max)(
                             data.completion_times_2[0] + p0,
@@ -1628,23 +1744,23 @@ void add_block_at_best_position(
                 for (MachineId machine_id = 1;
                         machine_id < instance.number_of_machines() - 1;
                         ++machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     data.completion_times_2[machine_id] = (std::max)(
                             data.completion_times_2[machine_id - 1] + p,
                             data.completion_times_2[machine_id + 1]);
                 }
                 if (last_machine_id > 0) {
-                    Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                     data.completion_times_2[last_machine_id] =
                             data.completion_times_2[last_machine_id - 1] + p;
                 }
             } else {
-                Time p0 = job.operations[0].alternatives[0].processing_time;
+                TimeType p0 = job.operations[0].alternatives[0].processing_time;
                 data.completion_times_2[0] = data.completion_times_2[0] + p0;
                 for (MachineId machine_id = 1;
                         machine_id < instance.number_of_machines();
                         ++machine_id) {
-                    Time p = job.operations[machine_id].alternatives[0].processing_time;
+                    TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                     if (data.completion_times_2[machine_id] > data.completion_times_2[machine_id - 1]) {
                         data.completion_times_2[machine_id] = data.completion_times_2[machine_id] + p;
                     } else {
@@ -1652,18 +1768,114 @@ void add_block_at_best_position(
                     }
                 }
             }
+
+            // pos = solution.jobs.size() => p = 0
+            // pos = solution.jobs.size() - 1 => p = 1
+            JobId p = data.solution.jobs.size() - pos;
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                makespan = std::max<Time>(makespan,
+                        data.completion_times_2[machine_id]
+                        + data.reverse_completion_times_0[p][machine_id]);
+            }
         }
 
+        if (makespan + 1 < makespan_best)
+            best_positions.clear();
+        if (!best_positions.empty() && makespan >= makespan_best)
+            continue;
+        makespan_best = makespan + 1;
+        best_positions.push_back(pos);
+    }
+
+    if (best_positions.empty())
+        throw std::runtime_error(FUNC_SIGNATURE + ": best_positions is empty.");
+
+    JobId pos_best = best_positions[0];
+    add_job(instance, data, job_id, pos_best);
+}
+
+template <typename TimeType>
+void add_block_at_best_position(
+        const Instance& instance,
+        const LocalSearchParameters& parameters,
+        std::mt19937_64& generator,
+        LocalSearchData<TimeType>& data,
+        const std::vector<JobId>& job_ids)
+{
+    std::vector<JobId> best_positions;
+    Time makespan_best = 0;
+
+    if (instance.mixed_no_idle())
+        data.no_idle_evaluator.set_sequence(data.solution.jobs);
+
+    for (JobId pos = data.number_of_frozen_jobs; pos <= (JobId)data.solution.jobs.size(); ++pos) {
+
         Time makespan = 0;
-        // pos = solution.jobs.size() => p = 0
-        // pos = solution.jobs.size() - 1 => p = 1
-        JobId p = data.solution.jobs.size() - pos;
-        for (MachineId machine_id = 0;
-                machine_id < instance.number_of_machines();
-                ++machine_id) {
-            makespan = std::max(makespan,
-                    data.completion_times_2[machine_id]
-                    + data.reverse_completion_times_0[p][machine_id]);
+        if (instance.mixed_no_idle()) {
+            makespan = data.no_idle_evaluator.evaluate_insertion(
+                    job_ids.data(),
+                    job_ids.size(),
+                    pos);
+        } else {
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                data.completion_times_2[machine_id] = data.completion_times_0[pos][machine_id];
+            }
+
+            for (JobId job_id: job_ids) {
+                const Job& job = instance.job(job_id);
+                if (instance.blocking()) {
+                    MachineId last_machine_id = instance.number_of_machines() - 1;
+                    TimeType p0 = job.operations[0].alternatives[0].processing_time;
+                    if (last_machine_id > 0) {
+                        data.completion_times_2[0] = (std::max)(
+                                data.completion_times_2[0] + p0,
+                                data.completion_times_2[1]);
+                    } else {
+                        data.completion_times_2[0] += p0;
+                    }
+                    for (MachineId machine_id = 1;
+                            machine_id < instance.number_of_machines() - 1;
+                            ++machine_id) {
+                        TimeType p = job.operations[machine_id].alternatives[0].processing_time;
+                        data.completion_times_2[machine_id] = (std::max)(
+                                data.completion_times_2[machine_id - 1] + p,
+                                data.completion_times_2[machine_id + 1]);
+                    }
+                    if (last_machine_id > 0) {
+                        TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
+                        data.completion_times_2[last_machine_id] =
+                                data.completion_times_2[last_machine_id - 1] + p;
+                    }
+                } else {
+                    TimeType p0 = job.operations[0].alternatives[0].processing_time;
+                    data.completion_times_2[0] = data.completion_times_2[0] + p0;
+                    for (MachineId machine_id = 1;
+                            machine_id < instance.number_of_machines();
+                            ++machine_id) {
+                        TimeType p = job.operations[machine_id].alternatives[0].processing_time;
+                        if (data.completion_times_2[machine_id] > data.completion_times_2[machine_id - 1]) {
+                            data.completion_times_2[machine_id] = data.completion_times_2[machine_id] + p;
+                        } else {
+                            data.completion_times_2[machine_id] = data.completion_times_2[machine_id - 1] + p;
+                        }
+                    }
+                }
+            }
+
+            // pos = solution.jobs.size() => p = 0
+            // pos = solution.jobs.size() - 1 => p = 1
+            JobId p = data.solution.jobs.size() - pos;
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                makespan = std::max<Time>(makespan,
+                        data.completion_times_2[machine_id]
+                        + data.reverse_completion_times_0[p][machine_id]);
+            }
         }
 
         if (makespan + 1 < makespan_best)
@@ -1684,9 +1896,10 @@ void add_block_at_best_position(
 
 // Among unscheduled jobs (jobs_positions == -1), append the one minimizing
 // the sum of departure times across all machines (PF construction, Eq. 4-5).
+template <typename TimeType>
 void append_best_job(
         const Instance& instance,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     MachineId last_machine_id = instance.number_of_machines() - 1;
     JobId n = data.solution.jobs.size();
@@ -1710,7 +1923,7 @@ void append_best_job(
             data.completion_times_2[machine_id] = data.completion_times_0[n][machine_id];
 
         if (instance.blocking()) {
-            Time p0 = job.operations[0].alternatives[0].processing_time;
+            TimeType p0 = job.operations[0].alternatives[0].processing_time;
             if (last_machine_id > 0) {
                 data.completion_times_2[0] = (std::max)(
                         data.completion_times_2[0] + p0,
@@ -1719,20 +1932,20 @@ void append_best_job(
                 data.completion_times_2[0] += p0;
             }
             for (MachineId machine_id = 1; machine_id < instance.number_of_machines() - 1; ++machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                 data.completion_times_2[machine_id] = (std::max)(
                         data.completion_times_2[machine_id - 1] + p,
                         data.completion_times_2[machine_id + 1]);
             }
             if (last_machine_id > 0) {
-                Time p = job.operations[last_machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[last_machine_id].alternatives[0].processing_time;
                 data.completion_times_2[last_machine_id] = data.completion_times_2[last_machine_id - 1] + p;
             }
         } else {
-            Time p0 = job.operations[0].alternatives[0].processing_time;
+            TimeType p0 = job.operations[0].alternatives[0].processing_time;
             data.completion_times_2[0] += p0;
             for (MachineId machine_id = 1; machine_id < instance.number_of_machines(); ++machine_id) {
-                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                TimeType p = job.operations[machine_id].alternatives[0].processing_time;
                 data.completion_times_2[machine_id] = (std::max)(
                         data.completion_times_2[machine_id],
                         data.completion_times_2[machine_id - 1]) + p;
@@ -1756,14 +1969,15 @@ void append_best_job(
     add_job(instance, data, best_job_id, n);
 }
 
+template <typename TimeType>
 JobId remove_random_job(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
-    std::uniform_int_distribution<JobId> d_pos(0, data.solution.jobs.size() - 1);
+    std::uniform_int_distribution<JobId> d_pos(data.number_of_frozen_jobs, data.solution.jobs.size() - 1);
     JobId pos = d_pos(generator);
     JobId job_id = data.solution.jobs[pos];
     remove_job(instance, data, pos);
@@ -1771,20 +1985,23 @@ JobId remove_random_job(
     return job_id;
 }
 
+template <typename TimeType>
 std::vector<JobId> remove_random_jobs(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId number_of_jobs_removed)
 {
+    JobId number_of_free_jobs = data.solution.jobs.size() - data.number_of_frozen_jobs;
     std::vector<JobId> positions = optimizationtools::bob_floyd(
-            number_of_jobs_removed,
-            (JobId)data.solution.jobs.size(),
+            std::min(number_of_jobs_removed, number_of_free_jobs),
+            number_of_free_jobs,
             generator);
     std::vector<JobId> remove_job_ids;
-    for (JobId pos: positions) {
+    for (JobId& pos: positions) {
+        pos += data.number_of_frozen_jobs;
         if (pos >= data.solution.jobs.size()) {
             throw std::logic_error(
                     FUNC_SIGNATURE + ": wrong pos; "
@@ -1798,17 +2015,19 @@ std::vector<JobId> remove_random_jobs(
     return remove_job_ids;
 }
 
+template <typename TimeType>
 std::vector<JobId> remove_random_block(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
-    JobId max_size = std::min((JobId)4, (JobId)data.solution.jobs.size());
+    JobId number_of_free_jobs = data.solution.jobs.size() - data.number_of_frozen_jobs;
+    JobId max_size = std::min(parameters.perturbation_strength, number_of_free_jobs);
     std::uniform_int_distribution<JobId> d_size(1, max_size);
     JobId size = d_size(generator);
-    std::uniform_int_distribution<JobId> d_pos(0, (JobId)data.solution.jobs.size() - size);
+    std::uniform_int_distribution<JobId> d_pos(data.number_of_frozen_jobs, (JobId)data.solution.jobs.size() - size);
     JobId pos = d_pos(generator);
     std::vector<JobId> removed_jobs_ids(
             data.solution.jobs.begin() + pos,
@@ -1818,12 +2037,13 @@ std::vector<JobId> remove_random_block(
     return removed_jobs_ids;
 }
 
+template <typename TimeType>
 JobId remove_worst_job(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     Time p_total = 0;
     for (JobId pos = 0; pos < (JobId)data.solution.jobs.size(); ++pos) {
@@ -1877,13 +2097,14 @@ JobId remove_worst_job(
 ////////////////////////////// Initial solutions ///////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+template <typename TimeType>
 void generate_initial_solution_neh(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
         AlgorithmFormatter& algorithm_formatter,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     // Clear the solution.
     data.solution.jobs.clear();
@@ -1894,7 +2115,7 @@ void generate_initial_solution_neh(
     for (MachineId machine_id = 0;
             machine_id < instance.number_of_machines();
             ++machine_id) {
-        data.completion_times_0[0][machine_id] = 0;
+        data.completion_times_0[0][machine_id] = instance.machine(machine_id).availability_time;
     }
     data.solution.makespan = 0;
 
@@ -1910,17 +2131,28 @@ void generate_initial_solution_neh(
                 const Job& job_2 = instance.job(job_2_id);
                 return job_1.mean_processing_time > job_2.mean_processing_time;
             });
-    for (JobId job_id: sorted_jobs) {
-        add_job_at_best_position(instance, parameters, generator, data, job_id);
+    for (JobId job_pos = 0; job_pos < instance.number_of_jobs(); ++job_pos) {
+        // At the end of the algorithm, the remaining jobs are appended so
+        // that the solution is complete.
+        if (parameters.timer.needs_to_end()) {
+            add_block(
+                    instance,
+                    data,
+                    std::vector<JobId>(sorted_jobs.begin() + job_pos, sorted_jobs.end()),
+                    data.solution.jobs.size());
+            break;
+        }
+        add_job_at_best_position(instance, parameters, generator, data, sorted_jobs[job_pos]);
         local_search(instance, parameters, generator, output, algorithm_formatter, data);
     }
 }
 
+template <typename TimeType>
 void generate_initial_solution_pf_neh(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data)
+        LocalSearchData<TimeType>& data)
 {
     // Clear the solution.
     data.solution.jobs.clear();
@@ -1929,7 +2161,7 @@ void generate_initial_solution_pf_neh(
             data.solution.jobs_positions.end(),
             -1);
     for (MachineId machine_id = 0; machine_id < instance.number_of_machines(); ++machine_id)
-        data.completion_times_0[0][machine_id] = 0;
+        data.completion_times_0[0][machine_id] = instance.machine(machine_id).availability_time;
     data.solution.makespan = 0;
 
     // Pick a random first job for diversity.
@@ -1939,10 +2171,23 @@ void generate_initial_solution_pf_neh(
     //std::cout << "first_job " << first_job << std::endl;
     add_job(instance, data, first_job, 0);
 
+    // At the end of the algorithm, the construction is completed by
+    // appending the remaining jobs in any order.
+    EndCheck end_check(parameters.timer);
+
     // PF construction: repeatedly append the job minimizing the sum of
     // departure times across all machines (Eq. 4-5).
-    while ((JobId)data.solution.jobs.size() < instance.number_of_jobs())
+    while ((JobId)data.solution.jobs.size() < instance.number_of_jobs()) {
+        if (end_check.needs_to_end()) {
+            std::vector<JobId> remaining_jobs;
+            for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+                if (data.solution.jobs_positions[job_id] == -1)
+                    remaining_jobs.push_back(job_id);
+            add_block(instance, data, remaining_jobs, data.solution.jobs.size());
+            return;
+        }
         append_best_job(instance, data);
+    }
 
     // Remove the last a = 4 jobs.
     //static const JobId a = 4;
@@ -1956,38 +2201,78 @@ void generate_initial_solution_pf_neh(
 
     // Reinsert in random order, each at the position minimizing makespan.
     std::shuffle(removed_jobs.begin(), removed_jobs.end(), generator);
-    for (JobId job_id: removed_jobs)
-        add_job_at_best_position(instance, parameters, generator, data, job_id);
+    for (JobId job_pos = 0; job_pos < (JobId)removed_jobs.size(); ++job_pos) {
+        if (end_check.needs_to_end()) {
+            add_block(
+                    instance,
+                    data,
+                    std::vector<JobId>(removed_jobs.begin() + job_pos, removed_jobs.end()),
+                    data.solution.jobs.size());
+            break;
+        }
+        add_job_at_best_position(instance, parameters, generator, data, removed_jobs[job_pos]);
+    }
+}
+
+// Insert the jobs missing from the current solution at their best positions,
+// by decreasing total processing time as in NEH.
+//
+// It is used to warm start from a partial solution, for example the solution
+// of a previous instance to which new jobs have been added.
+template <typename TimeType>
+void complete_solution(
+        const Instance& instance,
+        const LocalSearchParameters& parameters,
+        std::mt19937_64& generator,
+        LocalSearchData<TimeType>& data)
+{
+    std::vector<JobId> missing_jobs;
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+        if (data.solution.jobs_positions[job_id] == -1)
+            missing_jobs.push_back(job_id);
+    std::sort(
+            missing_jobs.begin(),
+            missing_jobs.end(),
+            [&instance](JobId job_1_id, JobId job_2_id) -> bool
+            {
+                const Job& job_1 = instance.job(job_1_id);
+                const Job& job_2 = instance.job(job_2_id);
+                return job_1.mean_processing_time > job_2.mean_processing_time;
+            });
+    for (JobId job_pos = 0; job_pos < (JobId)missing_jobs.size(); ++job_pos) {
+        if (parameters.timer.needs_to_end()) {
+            add_block(
+                    instance,
+                    data,
+                    std::vector<JobId>(missing_jobs.begin() + job_pos, missing_jobs.end()),
+                    data.solution.jobs.size());
+            break;
+        }
+        add_job_at_best_position(instance, parameters, generator, data, missing_jobs[job_pos]);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////// Perturbations /////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-enum class Perturbation
-{
-    RandomAdjacentSwaps,
-    RandomShifts,
-    RuinAndRecreate1,
-    RuinAndRecreateJobs,
-    RuinAndRecreateBlock,
-};
-
+template <typename TimeType>
 void random_shifts(
         const Instance& instance,
         const LocalSearchParameters& parameters,
         std::mt19937_64& generator,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         JobId d = 4)
 {
-    std::uniform_int_distribution<JobId> distribution(2, d);
+    JobId number_of_free_jobs = data.solution.jobs.size() - data.number_of_frozen_jobs;
+    std::uniform_int_distribution<JobId> distribution(2, std::min(d, number_of_free_jobs));
     std::vector<JobId> positions = optimizationtools::bob_floyd(
             distribution(generator),
-            (JobId)data.solution.jobs.size(),
+            number_of_free_jobs,
             generator);
     std::vector<JobId> job_ids;
     for (JobId pos: positions)
-        job_ids.push_back(data.solution.jobs[pos]);
+        job_ids.push_back(data.solution.jobs[data.number_of_frozen_jobs + pos]);
 
     for (JobId job_id: job_ids) {
         JobId forbidden_position = data.solution.jobs_positions[job_id];
@@ -1997,14 +2282,15 @@ void random_shifts(
 }
 
 // Perturbation: d random adjacent swaps (IARAS from Fernandez-Viagas et al. 2018).
+template <typename TimeType>
 void random_adjacent_swaps(
         const Instance& instance,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
         JobId d = 4)
 {
     JobId n = data.solution.jobs.size();
-    std::uniform_int_distribution<JobId> d_pos(0, n - 2);
+    std::uniform_int_distribution<JobId> d_pos(data.number_of_frozen_jobs, n - 2);
     for (JobId i = 0; i < d; ++i) {
         JobId pos = d_pos(generator);
         std::swap(data.solution.jobs[pos], data.solution.jobs[pos + 1]);
@@ -2014,10 +2300,11 @@ void random_adjacent_swaps(
     update_data(instance, data);
 }
 
+template <typename TimeType>
 void ruin_and_recreate_1(
         const Instance& instance,
         const LocalSearchParameters& parameters,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
         AlgorithmFormatter& algorithm_formatter)
@@ -2027,25 +2314,27 @@ void ruin_and_recreate_1(
     add_job_at_best_position(instance, parameters, generator, data, removed_job_id);
 }
 
+template <typename TimeType>
 void ruin_and_recreate_jobs(
         const Instance& instance,
         const LocalSearchParameters& parameters,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
         AlgorithmFormatter& algorithm_formatter,
         JobId d = 4)
 {
-    std::vector<JobId> removed = remove_random_jobs(instance, parameters, generator, output, data, 4);
+    std::vector<JobId> removed = remove_random_jobs(instance, parameters, generator, output, data, d);
     local_search(instance, parameters, generator, output, algorithm_formatter, data);
     for (JobId job_id: removed)
         add_job_at_best_position(instance, parameters, generator, data, job_id);
 }
 
+template <typename TimeType>
 void ruin_and_recreate_block(
         const Instance& instance,
         const LocalSearchParameters& parameters,
-        LocalSearchData& data,
+        LocalSearchData<TimeType>& data,
         std::mt19937_64& generator,
         const LocalSearchOutput& output,
         AlgorithmFormatter& algorithm_formatter,
@@ -2056,128 +2345,66 @@ void ruin_and_recreate_block(
     add_block_at_best_position(instance, parameters, generator, data, removed_jobs_ids);
 }
 
-}
-
-const LocalSearchOutput shopschedulingsolver::local_search_pfss_makespan(
+// Run the population-based iterated local search.
+template <typename TimeType>
+void run_algorithm(
         const Instance& instance,
         std::mt19937_64& generator,
         Solution* initial_solution,
-        const LocalSearchParameters& parameters)
+        const LocalSearchParameters& parameters,
+        LocalSearchOutput& output,
+        AlgorithmFormatter& algorithm_formatter,
+        LocalSearchData<TimeType>& data,
+        const localsearchsolver::Population<LocalSearchSolution, Time>::Parameters& population_parameters,
+        localsearchsolver::Population<LocalSearchSolution, Time>& population)
 {
-    LocalSearchOutput output(instance);
-    AlgorithmFormatter algorithm_formatter(instance, parameters, output);
-    algorithm_formatter.start("Local search");
-
-    if (parameters.timer.needs_to_end()) {
-        algorithm_formatter.end();
-        return output;
-    }
-
-    algorithm_formatter.print_header();
-
-    // Initialize data.
-    LocalSearchData data;
-    data.completion_times_0 = std::vector<std::vector<Time>>(
-            instance.number_of_jobs() + 1,
-            std::vector<Time>(instance.number_of_machines(), 0));
-    data.reverse_completion_times_0 = std::vector<std::vector<Time>>(
-            instance.number_of_jobs() + 1,
-            std::vector<Time>(instance.number_of_machines(), 0));
-    data.completion_times = std::vector<std::vector<Time>>(
-            instance.number_of_jobs() + 1,
-            std::vector<Time>(instance.number_of_machines(), 0));
-    data.reverse_completion_times = std::vector<std::vector<Time>>(
-            instance.number_of_jobs() + 1,
-            std::vector<Time>(instance.number_of_machines(), 0));
-    data.completion_times_2 = std::vector<Time>(instance.number_of_machines(), 0);
-    data.critical_path = std::vector<CriticalJob>(instance.number_of_jobs() + 1);
-    data.job_prefix_sums = std::vector<std::vector<Time>>(
-            instance.number_of_jobs(),
-            std::vector<Time>(instance.number_of_machines() + 1, 0));
-    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
-        const Job& job = instance.job(job_id);
-        for (MachineId k = 0; k < instance.number_of_machines(); ++k) {
-            data.job_prefix_sums[job_id][k + 1] = data.job_prefix_sums[job_id][k]
-                + job.operations[k].alternatives[0].processing_time;
-        }
-    }
-    data.solution.jobs_positions = std::vector<JobId>(instance.number_of_jobs(), -1);
-
-    // Initialize population.
-    localsearchsolver::PenalizedCostCallback<LocalSearchSolution, Time> penalized_cost_callback = [](
-                const LocalSearchSolution& solution)
-            {
-                return solution.makespan;
-            };
-    localsearchsolver::DistanceCallback<LocalSearchSolution> distance_callback = [&instance](
-                const LocalSearchSolution& solution_1,
-                const LocalSearchSolution& solution_2)
-            {
-                localsearchsolver::Distance distance = 0;
-                for (JobId job_id = 0;
-                        job_id < instance.number_of_jobs();
-                        ++job_id) {
-                    JobId job_pos_1 = solution_1.jobs_positions[job_id];
-                    JobId job_pos_2 = solution_2.jobs_positions[job_id];
-                    if (job_pos_1 == 0) {
-                        if (job_pos_2 != 0)
-                            distance++;
-                    } else if (job_pos_2 == 0) {
-                        distance++;
-                    } else {
-                        JobId job_prev_1_id = solution_1.jobs[job_pos_1 - 1];
-                        JobId job_prev_2_id = solution_2.jobs[job_pos_2 - 1];
-                        if (job_prev_1_id != job_prev_2_id)
-                            distance++;
-                    }
-                    JobId last_job_pos = solution_1.jobs.size() - 1;
-                    if (job_pos_1 == last_job_pos) {
-                        if (job_pos_2 != last_job_pos)
-                            distance++;
-                    } else if (job_pos_2 == last_job_pos) {
-                        distance++;
-                    } else {
-                        JobId job_next_1_id = solution_1.jobs[job_pos_1 + 1];
-                        JobId job_next_2_id = solution_2.jobs[job_pos_2 + 1];
-                        if (job_next_1_id != job_next_2_id)
-                            distance++;
-                    }
-                }
-                return distance;
-            };
-    localsearchsolver::Population<LocalSearchSolution, Time>::Parameters population_parameters;
-    population_parameters.minimum_size = 20;
-    population_parameters.maximum_size = 40;
-    population_parameters.number_of_elite_solutions = 10;
-    population_parameters.number_of_closest_neighbors = 3;
-    localsearchsolver::Population<LocalSearchSolution, Time> population(
-            penalized_cost_callback,
-            distance_callback,
-            population_parameters);
-
     if (initial_solution != nullptr) {
         load_solution(data, *initial_solution);
+        if (parameters.number_of_frozen_jobs > (JobId)data.solution.jobs.size()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "the number of frozen jobs must not exceed the number of jobs of the initial solution; "
+                    "number_of_frozen_jobs: " + std::to_string(parameters.number_of_frozen_jobs) + "; "
+                    "initial solution number of jobs: " + std::to_string(data.solution.jobs.size()) + ".");
+        }
+        data.number_of_frozen_jobs = parameters.number_of_frozen_jobs;
+        complete_solution(instance, parameters, generator, data);
         local_search(instance, parameters, generator, output, algorithm_formatter, data);
+        compute_permutation_adjacency(
+                data.solution.jobs, instance.number_of_jobs(),
+                parameters.distance_sketch_size, data.solution.adjacency);
+        population.add(data.solution, generator);
     } else {
         // Seed the population with PF-NEH(v=1) solutions (Section 4.1).
         for (JobId i = 0;
                 i < population_parameters.minimum_size
                         && !parameters.timer.needs_to_end();
                 ++i) {
-            generate_initial_solution_pf_neh(instance, parameters, generator, data);
+            {
+                SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/InitialSolution");
+                generate_initial_solution_pf_neh(instance, parameters, generator, data);
+            }
             //std::cout << "[construction] " << data.solution.makespan << std::endl;
             local_search(instance, parameters, generator, output, algorithm_formatter, data);
             //std::cout << "[local search] " << data.solution.makespan << std::endl;
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/Population");
+            compute_permutation_adjacency(
+                    data.solution.jobs, instance.number_of_jobs(),
+                    parameters.distance_sketch_size, data.solution.adjacency);
             population.add(data.solution, generator);
         }
     }
 
-    std::vector<Perturbation> perturbations = {
-        Perturbation::RandomShifts,
-        Perturbation::RuinAndRecreateJobs,
-    };
+    Counter number_of_iterations_without_improvement = 0;
+    Time previous_best = output.solution.makespan();
+
+    const std::vector<LocalSearchPerturbation>& perturbations = parameters.perturbations;
     std::vector<Counter> perturbation_successes(perturbations.size(), 0);
 
+    // With less than two free jobs, the perturbations have nothing to move.
+    if (instance.number_of_jobs() - data.number_of_frozen_jobs < 2)
+        return;
+
     for (output.number_of_iterations = 1;
             !parameters.timer.needs_to_end();
             ++output.number_of_iterations) {
@@ -2192,8 +2419,18 @@ const LocalSearchOutput shopschedulingsolver::local_search_pfss_makespan(
                 && output.solution.makespan() == output.makespan_bound) {
             break;
         }
+        if (parameters.maximum_number_of_iterations >= 0
+                && output.number_of_iterations > parameters.maximum_number_of_iterations)
+            break;
+        if (parameters.maximum_number_of_iterations_without_improvement >= 0
+                && number_of_iterations_without_improvement
+                   > parameters.maximum_number_of_iterations_without_improvement)
+            break;
 
-        data.solution = population.binary_tournament_single(generator);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/Population");
+            data.solution = population.binary_tournament_single(generator);
+        }
         update_data(instance, data);
         Time makespan_before = data.solution.makespan;
 
@@ -2206,24 +2443,27 @@ const LocalSearchOutput shopschedulingsolver::local_search_pfss_makespan(
         }
         std::discrete_distribution<Counter> distribution_perturbation(weights.begin(), weights.end());
         Counter perturbation_pos = distribution_perturbation(generator);
-        Perturbation perturbation = perturbations[perturbation_pos];
+        LocalSearchPerturbation perturbation = perturbations[perturbation_pos];
 
-        switch (perturbation) {
-        case Perturbation::RandomAdjacentSwaps:
-            random_adjacent_swaps(instance, data, generator, 4);
-            break;
-        case Perturbation::RandomShifts:
-            random_shifts(instance, parameters, generator, data, 4);
-            break;
-        case Perturbation::RuinAndRecreate1:
-            ruin_and_recreate_1(instance, parameters, data, generator, output, algorithm_formatter);
-            break;
-        case Perturbation::RuinAndRecreateJobs:
-            ruin_and_recreate_jobs(instance, parameters, data, generator, output, algorithm_formatter, 4);
-            break;
-        case Perturbation::RuinAndRecreateBlock:
-            ruin_and_recreate_block(instance, parameters, data, generator, output, algorithm_formatter, 4);
-            break;
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/Perturbation");
+            switch (perturbation) {
+            case LocalSearchPerturbation::RandomAdjacentSwaps:
+                random_adjacent_swaps(instance, data, generator, parameters.perturbation_strength);
+                break;
+            case LocalSearchPerturbation::RandomShifts:
+                random_shifts(instance, parameters, generator, data, parameters.perturbation_strength);
+                break;
+            case LocalSearchPerturbation::RuinAndRecreate1:
+                ruin_and_recreate_1(instance, parameters, data, generator, output, algorithm_formatter);
+                break;
+            case LocalSearchPerturbation::RuinAndRecreateJobs:
+                ruin_and_recreate_jobs(instance, parameters, data, generator, output, algorithm_formatter, parameters.perturbation_strength);
+                break;
+            case LocalSearchPerturbation::RuinAndRecreateBlock:
+                ruin_and_recreate_block(instance, parameters, data, generator, output, algorithm_formatter, parameters.perturbation_strength);
+                break;
+            }
         }
 
         local_search(instance, parameters, generator, output, algorithm_formatter, data);
@@ -2231,7 +2471,20 @@ const LocalSearchOutput shopschedulingsolver::local_search_pfss_makespan(
         if (data.solution.makespan < makespan_before)
             perturbation_successes[perturbation_pos]++;
 
-        population.add(data.solution, generator);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssMakespan/Population");
+            compute_permutation_adjacency(
+                    data.solution.jobs, instance.number_of_jobs(),
+                    parameters.distance_sketch_size, data.solution.adjacency);
+            population.add(data.solution, generator);
+        }
+
+        if (output.solution.makespan() < previous_best) {
+            previous_best = output.solution.makespan();
+            number_of_iterations_without_improvement = 0;
+        } else {
+            ++number_of_iterations_without_improvement;
+        }
 
         //double mean_makespan = 0;
         //for (Counter solution_id = 0;
@@ -2247,6 +2500,201 @@ const LocalSearchOutput shopschedulingsolver::local_search_pfss_makespan(
         //mean_makespan /= population.size();
         //std::cout << "mean_makespan " << mean_makespan << std::endl;
     }
+}
+
+// Set the parameters left to automatic according to the size of the instance
+// and check the others.
+//
+// On large instances, the population is smaller and only the shift of single
+// jobs is explored, since the other neighborhoods are too slow to pay off.
+LocalSearchParameters resolve_parameters(
+        const Instance& instance,
+        const LocalSearchParameters& parameters)
+{
+    LocalSearchParameters resolved_parameters = parameters;
+    bool large = (instance.number_of_jobs() >= parameters.large_number_of_jobs);
+
+    if (resolved_parameters.population_minimum_size < 0)
+        resolved_parameters.population_minimum_size = (large)? 10: 20;
+    if (resolved_parameters.population_maximum_size < 0)
+        resolved_parameters.population_maximum_size = 2 * resolved_parameters.population_minimum_size;
+    if (resolved_parameters.number_of_elite_solutions < 0)
+        resolved_parameters.number_of_elite_solutions = (large)? 5: 10;
+    if (resolved_parameters.number_of_closest_neighbors < 0)
+        resolved_parameters.number_of_closest_neighbors = 3;
+    if (resolved_parameters.neighborhoods.empty()) {
+        resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Shift, 1, 1});
+        if (!large) {
+            resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Shift, 2, 1});
+            resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Shift, 3, 1});
+            resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Shift, 4, 1});
+        }
+        // For large instances, the swap neighborhood is only cheap enough
+        // with the lower bounds of the standard evaluation.
+        if (!large || (!instance.blocking() && !instance.mixed_no_idle()))
+            resolved_parameters.neighborhoods.push_back({LocalSearchNeighborhoodType::Swap, 1, 1});
+    }
+    if (resolved_parameters.perturbations.empty()) {
+        resolved_parameters.perturbations = {
+            LocalSearchPerturbation::RandomShifts,
+            LocalSearchPerturbation::RuinAndRecreateJobs,
+        };
+    }
+
+    if (resolved_parameters.population_minimum_size < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the minimum size of the population must be positive; "
+                "population_minimum_size: " + std::to_string(resolved_parameters.population_minimum_size) + ".");
+    }
+    if (resolved_parameters.population_maximum_size < resolved_parameters.population_minimum_size) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the maximum size of the population must be greater than or equal to its minimum size; "
+                "population_minimum_size: " + std::to_string(resolved_parameters.population_minimum_size) + "; "
+                "population_maximum_size: " + std::to_string(resolved_parameters.population_maximum_size) + ".");
+    }
+    if (resolved_parameters.perturbation_strength < 2) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the perturbation strength must be at least 2; "
+                "perturbation_strength: " + std::to_string(resolved_parameters.perturbation_strength) + ".");
+    }
+    if (resolved_parameters.number_of_frozen_jobs < 0) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the number of frozen jobs must be non-negative; "
+                "number_of_frozen_jobs: " + std::to_string(resolved_parameters.number_of_frozen_jobs) + ".");
+    }
+    if (!instance.fixed_jobs().empty()) {
+        if (resolved_parameters.number_of_frozen_jobs > 0) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "frozen jobs cannot be set on an instance with fixed jobs; "
+                    "number_of_frozen_jobs: " + std::to_string(resolved_parameters.number_of_frozen_jobs) + "; "
+                    "instance.fixed_jobs().size(): " + std::to_string(instance.fixed_jobs().size()) + ".");
+        }
+        resolved_parameters.number_of_frozen_jobs = instance.fixed_jobs().size();
+    }
+    for (const LocalSearchNeighborhood& neighborhood: resolved_parameters.neighborhoods) {
+        if ((neighborhood.type == LocalSearchNeighborhoodType::ShiftReverse
+                    && neighborhood.size_1 < 2)
+                || (neighborhood.type == LocalSearchNeighborhoodType::Swap
+                    && (neighborhood.size_1 != 1 || neighborhood.size_2 != 1))) {
+            std::stringstream ss;
+            ss << neighborhood;
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "unsupported neighborhood; "
+                    "neighborhood: " + ss.str() + ".");
+        }
+    }
+
+    return resolved_parameters;
+}
+
+}
+
+const LocalSearchOutput shopschedulingsolver::local_search_pfss_makespan(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        Solution* initial_solution,
+        const LocalSearchParameters& input_parameters)
+{
+    const LocalSearchParameters parameters = resolve_parameters(instance, input_parameters);
+    LocalSearchOutput output(instance);
+    AlgorithmFormatter algorithm_formatter(instance, parameters, output);
+    algorithm_formatter.start("Local search");
+
+    if (parameters.timer.needs_to_end()) {
+        algorithm_formatter.end();
+        return output;
+    }
+
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+        if (instance.job(job_id).release_date != 0) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": release dates are not supported.");
+        }
+    }
+
+    if (instance.mixed_no_idle()
+            && (instance.blocking() || instance.no_wait())) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": no-idle machines are only supported "
+                "without blocking and no-wait.");
+    }
+
+    // The fixed jobs are frozen at the beginning of the sequence.
+    if (!instance.fixed_prefix()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations and machine availability times are only "
+                "supported on flow shops without no-wait, blocking and no-idle "
+                "machines, the fixed jobs being processed first in the same "
+                "order on all the machines.");
+    }
+    std::unique_ptr<Solution> fixed_jobs_solution;
+    if (!instance.fixed_jobs().empty()) {
+        fixed_jobs_solution.reset(new Solution(
+                    fixed_jobs_initial_solution(instance, initial_solution)));
+        initial_solution = fixed_jobs_solution.get();
+    }
+
+    if (parameters.number_of_frozen_jobs > 0 && initial_solution == nullptr) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "frozen jobs require an initial solution.");
+    }
+
+    algorithm_formatter.print_header();
+
+    // Initialize population.
+    localsearchsolver::PenalizedCostCallback<LocalSearchSolution, Time> penalized_cost_callback = [](
+                const LocalSearchSolution& solution)
+            {
+                return solution.makespan;
+            };
+    localsearchsolver::DistanceCallback<LocalSearchSolution> distance_callback = [&instance, &parameters](
+                const LocalSearchSolution& solution_1,
+                const LocalSearchSolution& solution_2)
+            {
+                if (parameters.distance_sketch_size > 0) {
+                    return (localsearchsolver::Distance)permutation_distance_estimate(
+                            solution_1.adjacency,
+                            solution_2.adjacency,
+                            instance.number_of_jobs());
+                }
+                return (localsearchsolver::Distance)permutation_distance(
+                        solution_1.adjacency,
+                        solution_2.adjacency);
+            };
+    localsearchsolver::Population<LocalSearchSolution, Time>::Parameters population_parameters;
+    population_parameters.minimum_size = parameters.population_minimum_size;
+    population_parameters.maximum_size = parameters.population_maximum_size;
+    population_parameters.number_of_elite_solutions = parameters.number_of_elite_solutions;
+    population_parameters.number_of_closest_neighbors = parameters.number_of_closest_neighbors;
+    localsearchsolver::Population<LocalSearchSolution, Time> population(
+            penalized_cost_callback,
+            distance_callback,
+            population_parameters);
+
+    // Dispatch once here; all inner functions are templated so no further
+    // runtime branch occurs. Completion times are stored on 32 bits whenever
+    // they fit, which halves the memory traffic of the evaluations.
+    if (fits_in_int32(instance)) {
+        LocalSearchData<int32_t> data;
+        initialize_data(instance, data);
+        run_algorithm(
+                instance, generator, initial_solution, parameters,
+                output, algorithm_formatter, data, population_parameters, population);
+    } else {
+        LocalSearchData<Time> data;
+        initialize_data(instance, data);
+        run_algorithm(
+                instance, generator, initial_solution, parameters,
+                output, algorithm_formatter, data, population_parameters, population);
+    }
 
     algorithm_formatter.end();
     return output;
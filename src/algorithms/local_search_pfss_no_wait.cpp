@@ -0,0 +1,589 @@
+#include "shopschedulingsolver/algorithms/local_search_pfss_no_wait.hpp"
+
+#include "shopschedulingsolver/algorithm_formatter.hpp"
+#include "shopschedulingsolver/solution_builder.hpp"
+#include "shopschedulingsolver/profiler.hpp"
+#include "shopschedulingsolver/aligned_matrix.hpp"
+
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+// Reduction of the no-wait permutation flow shop to an asymmetric TSP.
+//
+// A single dummy node is used both as the start and as the end of the
+// sequences. The start of the first job is 0 and the start of each other job
+// is the start of its predecessor plus the delay between them. The start of
+// the end dummy is the makespan.
+//
+// The objective is the weighted sum of the completion times of the nodes,
+// where the completion time of the end dummy is its start. For the makespan,
+// only the end dummy has a non-zero weight.
+struct NoWaitData
+{
+    // Dummy node.
+    JobId dummy = -1;
+
+    // delays[job_id_1][job_id_2] is the minimum difference between the start
+    // of 'job_id_2' and the start of 'job_id_1' when 'job_id_2' directly
+    // follows 'job_id_1'.
+    //
+    // The delay from the dummy to a job is 0 and the delay from a job to the
+    // dummy is its total processing time.
+    AlignedMatrix<Time> delays;
+
+    // Total processing time of each node; 0 for the dummy.
+    std::vector<Time> processing_times;
+
+    // Weight of the completion time of each node.
+    std::vector<Time> weights;
+};
+
+NoWaitData build_data(
+        const Instance& instance)
+{
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssNoWait/BuildData");
+    JobId n = instance.number_of_jobs();
+    MachineId m = instance.number_of_machines();
+    NoWaitData data;
+    data.dummy = n;
+    data.processing_times = std::vector<Time>(n + 1, 0);
+    data.weights = std::vector<Time>(n + 1, 0);
+
+    // ends[job_id][machine_id]: end of the operation on machine 'machine_id'
+    // relative to the start of the job.
+    // starts[job_id][machine_id]: start of the operation on machine
+    // 'machine_id' relative to the start of the job.
+    AlignedMatrix<Time> ends(n, m);
+    AlignedMatrix<Time> starts(n, m);
+    for (JobId job_id = 0; job_id < n; ++job_id) {
+        const Job& job = instance.job(job_id);
+        Time current_time = 0;
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id) {
+            starts[job_id][machine_id] = current_time;
+            current_time += job.operations[machine_id].alternatives[0].processing_time;
+            ends[job_id][machine_id] = current_time;
+        }
+        data.processing_times[job_id] = current_time;
+        if (instance.objective() == Objective::TotalFlowTime)
+            data.weights[job_id] = job.weight;
+    }
+    if (instance.objective() == Objective::Makespan)
+        data.weights[data.dummy] = 1;
+
+    data.delays.resize(n + 1, n + 1, 0);
+    for (JobId job_id_1 = 0; job_id_1 < n; ++job_id_1) {
+        const Time* ends_1 = ends[job_id_1];
+        Time* delays_1 = data.delays[job_id_1];
+        for (JobId job_id_2 = 0; job_id_2 < n; ++job_id_2) {
+            if (job_id_2 == job_id_1)
+                continue;
+            const Time* starts_2 = starts[job_id_2];
+            Time delay = 0;
+            for (MachineId machine_id = 0; machine_id < m; ++machine_id)
+                delay = (std::max)(delay, ends_1[machine_id] - starts_2[machine_id]);
+            delays_1[job_id_2] = delay;
+        }
+        delays_1[data.dummy] = data.processing_times[job_id_1];
+    }
+    return data;
+}
+
+// Times of a sequence of nodes starting and ending with the dummy.
+struct SequenceTimes
+{
+    // Start of the node at each position.
+    std::vector<Time> starts;
+
+    // suffix_weights[pos]: sum of the weights of the nodes at positions
+    // 'pos' and after.
+    std::vector<Time> suffix_weights;
+
+    // Objective value of the sequence.
+    Time objective = 0;
+};
+
+void compute_times(
+        const NoWaitData& data,
+        const std::vector<JobId>& sequence,
+        SequenceTimes& times)
+{
+    JobId size = sequence.size();
+    times.starts.resize(size);
+    times.suffix_weights.resize(size + 1);
+    times.starts[0] = 0;
+    times.objective = 0;
+    for (JobId pos = 1; pos < size; ++pos) {
+        times.starts[pos] = times.starts[pos - 1]
+            + data.delays[sequence[pos - 1]][sequence[pos]];
+        times.objective += data.weights[sequence[pos]]
+            * (times.starts[pos] + data.processing_times[sequence[pos]]);
+    }
+    times.suffix_weights[size] = 0;
+    for (JobId pos = size - 1; pos >= 0; --pos)
+        times.suffix_weights[pos] = times.suffix_weights[pos + 1] + data.weights[sequence[pos]];
+}
+
+// Block of consecutive jobs.
+struct Block
+{
+    // First job of the block.
+    JobId first_job_id = -1;
+
+    // Last job of the block.
+    JobId last_job_id = -1;
+
+    // Difference between the start of the last job and the start of the
+    // first job.
+    Time length = 0;
+
+    // Sum of the weights of the jobs.
+    Time weight = 0;
+
+    // Weighted sum of the completion times of the jobs relative to the start
+    // of the first job.
+    Time weighted_completion_times = 0;
+};
+
+Block build_block(
+        const NoWaitData& data,
+        const std::vector<JobId>& sequence,
+        JobId pos_first,
+        JobId size)
+{
+    Block block;
+    block.first_job_id = sequence[pos_first];
+    block.last_job_id = sequence[pos_first + size - 1];
+    for (JobId pos = pos_first; pos < pos_first + size; ++pos) {
+        JobId job_id = sequence[pos];
+        if (pos > pos_first)
+            block.length += data.delays[sequence[pos - 1]][job_id];
+        block.weight += data.weights[job_id];
+        block.weighted_completion_times += data.weights[job_id]
+            * (block.length + data.processing_times[job_id]);
+    }
+    return block;
+}
+
+// Objective value of the sequence after inserting a block between positions
+// 'pos - 1' and 'pos'.
+inline Time insertion_objective(
+        const NoWaitData& data,
+        const std::vector<JobId>& sequence,
+        const SequenceTimes& times,
+        const Block& block,
+        JobId pos)
+{
+    JobId job_id_prev = sequence[pos - 1];
+    JobId job_id_next = sequence[pos];
+    Time delay_in = data.delays[job_id_prev][block.first_job_id];
+    Time start = times.starts[pos - 1] + delay_in;
+    Time shift = delay_in + block.length
+        + data.delays[block.last_job_id][job_id_next]
+        - data.delays[job_id_prev][job_id_next];
+    return times.objective
+        + block.weight * start + block.weighted_completion_times
+        + times.suffix_weights[pos] * shift;
+}
+
+// Objective value of the sequence after swapping the jobs at positions
+// 'pos_1' and 'pos_2', with 'pos_1 < pos_2'.
+inline Time swap_objective(
+        const NoWaitData& data,
+        const std::vector<JobId>& sequence,
+        const SequenceTimes& times,
+        JobId pos_1,
+        JobId pos_2)
+{
+    const AlignedMatrix<Time>& d = data.delays;
+    JobId job_id_1 = sequence[pos_1];
+    JobId job_id_2 = sequence[pos_2];
+    JobId job_id_1_prev = sequence[pos_1 - 1];
+    JobId job_id_2_next = sequence[pos_2 + 1];
+    Time weight_1 = data.weights[job_id_1];
+    Time weight_2 = data.weights[job_id_2];
+    Time objective = times.objective
+        - weight_1 * (times.starts[pos_1] + data.processing_times[job_id_1])
+        - weight_2 * (times.starts[pos_2] + data.processing_times[job_id_2]);
+    Time start_2 = times.starts[pos_1 - 1] + d[job_id_1_prev][job_id_2];
+    Time start_1 = -1;
+    if (pos_2 == pos_1 + 1) {
+        start_1 = start_2 + d[job_id_2][job_id_1];
+    } else {
+        JobId job_id_1_next = sequence[pos_1 + 1];
+        JobId job_id_2_prev = sequence[pos_2 - 1];
+        // Shift of the jobs between both positions.
+        Time shift = start_2 + d[job_id_2][job_id_1_next]
+            - times.starts[pos_1 + 1];
+        objective += shift
+            * (times.suffix_weights[pos_1 + 1] - times.suffix_weights[pos_2]);
+        start_1 = times.starts[pos_2 - 1] + shift + d[job_id_2_prev][job_id_1];
+    }
+    // Shift of the nodes after both positions.
+    Time shift = start_1 + d[job_id_1][job_id_2_next]
+        - times.starts[pos_2 + 1];
+    objective += weight_2 * (start_2 + data.processing_times[job_id_2])
+        + weight_1 * (start_1 + data.processing_times[job_id_1])
+        + shift * times.suffix_weights[pos_2 + 1];
+    return objective;
+}
+
+struct LocalSearchData
+{
+    // Current sequence, starting and ending with the dummy.
+    std::vector<JobId> sequence;
+
+    // Times of the current sequence.
+    SequenceTimes times;
+
+    // Scratch sequence.
+    std::vector<JobId> reduced_sequence;
+
+    // Times of the scratch sequence.
+    SequenceTimes reduced_times;
+};
+
+// Insert a block at its best position in 'data.reduced_sequence', whose
+// times must be up to date. Return the position and the objective value.
+std::pair<JobId, Time> best_insertion(
+        const NoWaitData& no_wait_data,
+        LocalSearchData& data,
+        const Block& block)
+{
+    JobId pos_best = -1;
+    Time objective_best = std::numeric_limits<Time>::max();
+    for (JobId pos = 1; pos < (JobId)data.reduced_sequence.size(); ++pos) {
+        Time objective = insertion_objective(
+                no_wait_data,
+                data.reduced_sequence,
+                data.reduced_times,
+                block,
+                pos);
+        if (objective < objective_best) {
+            pos_best = pos;
+            objective_best = objective;
+        }
+    }
+    return {pos_best, objective_best};
+}
+
+// Insert jobs one by one at their best position in the current sequence.
+void insert_jobs(
+        const NoWaitData& no_wait_data,
+        LocalSearchData& data,
+        const std::vector<JobId>& job_ids)
+{
+    for (JobId job_id: job_ids) {
+        data.reduced_sequence = data.sequence;
+        compute_times(no_wait_data, data.reduced_sequence, data.reduced_times);
+        Block block = build_block(no_wait_data, {job_id}, 0, 1);
+        auto p = best_insertion(no_wait_data, data, block);
+        data.sequence.insert(data.sequence.begin() + p.first, job_id);
+    }
+    compute_times(no_wait_data, data.sequence, data.times);
+}
+
+// Or-opt neighborhood: move a block of consecutive jobs to its best position.
+bool explore_block_neighborhood(
+        const NoWaitData& no_wait_data,
+        LocalSearchData& data,
+        JobId block_size,
+        std::mt19937_64& generator,
+        EndCheck& end_check)
+{
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssNoWait/BlockNeighborhood");
+    JobId number_of_jobs = data.sequence.size() - 2;
+    if (block_size >= number_of_jobs)
+        return false;
+    std::vector<JobId> positions;
+    for (JobId pos = 1; pos + block_size - 1 <= number_of_jobs; ++pos)
+        positions.push_back(pos);
+    std::shuffle(positions.begin(), positions.end(), generator);
+
+    bool improved = false;
+    for (JobId pos_first: positions) {
+        if (end_check.needs_to_end())
+            break;
+        Block block = build_block(no_wait_data, data.sequence, pos_first, block_size);
+        data.reduced_sequence.clear();
+        data.reduced_sequence.insert(
+                data.reduced_sequence.end(),
+                data.sequence.begin(),
+                data.sequence.begin() + pos_first);
+        data.reduced_sequence.insert(
+                data.reduced_sequence.end(),
+                data.sequence.begin() + pos_first + block_size,
+                data.sequence.end());
+        compute_times(no_wait_data, data.reduced_sequence, data.reduced_times);
+        auto p = best_insertion(no_wait_data, data, block);
+        if (p.second >= data.times.objective)
+            continue;
+        std::vector<JobId> jobs(
+                data.sequence.begin() + pos_first,
+                data.sequence.begin() + pos_first + block_size);
+        data.sequence = data.reduced_sequence;
+        data.sequence.insert(data.sequence.begin() + p.first, jobs.begin(), jobs.end());
+        compute_times(no_wait_data, data.sequence, data.times);
+        improved = true;
+    }
+    return improved;
+}
+
+// Swap neighborhood: swap two jobs.
+bool explore_swap_neighborhood(
+        const NoWaitData& no_wait_data,
+        LocalSearchData& data,
+        std::mt19937_64& generator,
+        EndCheck& end_check)
+{
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssNoWait/SwapNeighborhood");
+    JobId number_of_jobs = data.sequence.size() - 2;
+    std::vector<JobId> positions(number_of_jobs);
+    std::iota(positions.begin(), positions.end(), 1);
+    std::shuffle(positions.begin(), positions.end(), generator);
+
+    bool improved = false;
+    for (JobId pos_1: positions) {
+        if (end_check.needs_to_end())
+            break;
+        JobId pos_best = -1;
+        Time objective_best = data.times.objective;
+        for (JobId pos_2 = 1; pos_2 <= number_of_jobs; ++pos_2) {
+            if (pos_2 == pos_1)
+                continue;
+            Time objective = swap_objective(
+                    no_wait_data,
+                    data.sequence,
+                    data.times,
+                    (std::min)(pos_1, pos_2),
+                    (std::max)(pos_1, pos_2));
+            if (objective < objective_best) {
+                pos_best = pos_2;
+                objective_best = objective;
+            }
+        }
+        if (pos_best == -1)
+            continue;
+        std::swap(data.sequence[pos_1], data.sequence[pos_best]);
+        compute_times(no_wait_data, data.sequence, data.times);
+        improved = true;
+    }
+    return improved;
+}
+
+void local_search(
+        const NoWaitData& no_wait_data,
+        const LocalSearchPfssNoWaitParameters& parameters,
+        LocalSearchData& data,
+        std::mt19937_64& generator)
+{
+    EndCheck end_check(parameters.timer);
+    while (!end_check.needs_to_end()) {
+        bool improved = false;
+        for (JobId block_size = 1;
+                block_size <= parameters.maximum_block_size;
+                ++block_size) {
+            if (explore_block_neighborhood(no_wait_data, data, block_size, generator, end_check))
+                improved = true;
+        }
+        if (explore_swap_neighborhood(no_wait_data, data, generator, end_check))
+            improved = true;
+        if (!improved)
+            break;
+    }
+}
+
+Solution build_solution(
+        const Instance& instance,
+        const LocalSearchData& data)
+{
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("LocalSearchPfssNoWait/BuildSolution");
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.from_permutation(std::vector<JobId>(
+                data.sequence.begin() + 1,
+                data.sequence.end() - 1));
+    Solution solution = solution_builder.build();
+    if (solution.objective_value() != data.times.objective) {
+        throw std::runtime_error(
+                FUNC_SIGNATURE + ": wrong objective; "
+                "solution: " + std::to_string(solution.objective_value()) + "; "
+                "data: " + std::to_string(data.times.objective) + ".");
+    }
+    return solution;
+}
+
+}
+
+const LocalSearchPfssNoWaitOutput shopschedulingsolver::local_search_pfss_no_wait(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        Solution*,
+        const LocalSearchPfssNoWaitParameters& parameters)
+{
+    LocalSearchPfssNoWaitOutput output(instance);
+    AlgorithmFormatter algorithm_formatter(instance, parameters, output);
+    algorithm_formatter.start("Local search (no-wait pfss)");
+
+    if (parameters.timer.needs_to_end()) {
+        algorithm_formatter.end();
+        return output;
+    }
+
+    if (!instance.flow_shop() || instance.flexible()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the instance must be a flow shop.");
+    }
+    if (!instance.no_wait()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the instance must be no-wait.");
+    }
+
+    if (instance.objective() != Objective::Makespan
+            && instance.objective() != Objective::TotalFlowTime) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": unsupported objective; "
+                "only Makespan and TotalFlowTime are supported.");
+    }
+
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+        if (instance.job(job_id).release_date != 0) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": release dates are not supported.");
+        }
+        if (instance.job(job_id).weight < 0) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": negative job weights are not supported; "
+                    "job_id: " + std::to_string(job_id) + "; "
+                    "weight: " + std::to_string(instance.job(job_id).weight) + ".");
+        }
+    }
+
+    if (instance.number_of_fixed_operations() > 0
+            || instance.has_machine_availability_times()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations and machine availability times are not supported.");
+    }
+
+    if (parameters.destruction_size < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the destruction size must be positive; "
+                "destruction_size: " + std::to_string(parameters.destruction_size) + ".");
+    }
+    if (parameters.maximum_block_size < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the maximum block size must be positive; "
+                "maximum_block_size: " + std::to_string(parameters.maximum_block_size) + ".");
+    }
+
+    algorithm_formatter.print_header();
+
+    const NoWaitData no_wait_data = build_data(instance);
+    JobId number_of_jobs = instance.number_of_jobs();
+
+    // Initial solution: NEH, with the jobs sorted by non-increasing total
+    // processing time for the makespan and by weighted shortest processing
+    // time for the total flow time.
+    std::vector<JobId> sorted_jobs(number_of_jobs);
+    std::iota(sorted_jobs.begin(), sorted_jobs.end(), 0);
+    if (instance.objective() == Objective::Makespan) {
+        std::stable_sort(
+                sorted_jobs.begin(),
+                sorted_jobs.end(),
+                [&no_wait_data](JobId job_id_1, JobId job_id_2)
+                {
+                    return no_wait_data.processing_times[job_id_1]
+                        > no_wait_data.processing_times[job_id_2];
+                });
+    } else {
+        std::stable_sort(
+                sorted_jobs.begin(),
+                sorted_jobs.end(),
+                [&no_wait_data](JobId job_id_1, JobId job_id_2)
+                {
+                    return no_wait_data.processing_times[job_id_1] * no_wait_data.weights[job_id_2]
+                        < no_wait_data.processing_times[job_id_2] * no_wait_data.weights[job_id_1];
+                });
+    }
+    LocalSearchData data;
+    data.sequence = {no_wait_data.dummy, no_wait_data.dummy};
+    insert_jobs(no_wait_data, data, sorted_jobs);
+    algorithm_formatter.update_solution(build_solution(instance, data), "neh");
+
+    local_search(no_wait_data, parameters, data, generator);
+    if (data.times.objective < output.solution.objective_value())
+        algorithm_formatter.update_solution(build_solution(instance, data), "local search");
+
+    // Temperature of the acceptance criterion.
+    Time processing_times_sum = 0;
+    for (JobId job_id = 0; job_id < number_of_jobs; ++job_id)
+        processing_times_sum += no_wait_data.processing_times[job_id];
+    double temperature = parameters.temperature_factor * processing_times_sum
+        / ((std::max)(number_of_jobs, (JobId)1) * instance.number_of_machines() * 10);
+
+    std::vector<JobId> best_sequence = data.sequence;
+    Time best_objective = data.times.objective;
+    Counter number_of_iterations_without_improvement = 0;
+    std::uniform_real_distribution<double> distribution(0, 1);
+    for (output.number_of_iterations = 1;
+            number_of_jobs > 1;
+            ++output.number_of_iterations) {
+        // Check end.
+        if (parameters.timer.needs_to_end())
+            break;
+        if (output.solution.feasible()
+                && output.solution.objective_value() <= output.bound())
+            break;
+        if (parameters.maximum_number_of_iterations != -1
+                && output.number_of_iterations > parameters.maximum_number_of_iterations)
+            break;
+        if (parameters.maximum_number_of_iterations_without_improvement != -1
+                && number_of_iterations_without_improvement
+                >= parameters.maximum_number_of_iterations_without_improvement)
+            break;
+
+        // Destruction.
+        std::vector<JobId> sequence_prev = data.sequence;
+        Time objective_prev = data.times.objective;
+        JobId destruction_size = (std::min)(parameters.destruction_size, number_of_jobs - 1);
+        std::vector<JobId> removed_jobs;
+        for (JobId r = 0; r < destruction_size; ++r) {
+            std::uniform_int_distribution<JobId> distribution_pos(
+                    1, data.sequence.size() - 2);
+            JobId pos = distribution_pos(generator);
+            removed_jobs.push_back(data.sequence[pos]);
+            data.sequence.erase(data.sequence.begin() + pos);
+        }
+
+        // Reconstruction.
+        insert_jobs(no_wait_data, data, removed_jobs);
+        local_search(no_wait_data, parameters, data, generator);
+
+        // Acceptance.
+        if (data.times.objective < best_objective) {
+            best_objective = data.times.objective;
+            best_sequence = data.sequence;
+            number_of_iterations_without_improvement = 0;
+            std::stringstream ss;
+            ss << "iteration " << output.number_of_iterations;
+            algorithm_formatter.update_solution(build_solution(instance, data), ss.str());
+        } else {
+            number_of_iterations_without_improvement++;
+            if (data.times.objective > objective_prev
+                    && distribution(generator) > std::exp(
+                        -(double)(data.times.objective - objective_prev) / temperature)) {
+                data.sequence = sequence_prev;
+                compute_times(no_wait_data, data.sequence, data.times);
+            }
+        }
+    }
+
+    algorithm_formatter.end();
+    return output;
+}
@@ -1,5 +1,7 @@
 #include "shopschedulingsolver/algorithms/milp_disjunctive.hpp"
 
+#include "shopschedulingsolver/profiler.hpp"
+
 #ifdef CBC_FOUND
 #include "mathoptsolverscmake/mathopt_cbc.hpp"
 #endif
@@ -114,9 +116,39 @@ struct Model
     std::vector<int> pmsum;
 };
 
+// Return true iff the relative order of two operations of a machine is known
+// from the fixed operations: both are fixed on this machine, or one of them is
+// fixed on another machine. In this case, their disjunction variable is fixed
+// and, without blocking, their disjunction constraints are not created.
+bool fixed_disjunction(
+        const Instance& instance,
+        const MachineOperation& machine_operation_1,
+        const MachineOperation& machine_operation_2)
+{
+    const Operation& operation_1 = instance.job(machine_operation_1.job_id).operations[machine_operation_1.operation_id];
+    const Operation& operation_2 = instance.job(machine_operation_2.job_id).operations[machine_operation_2.operation_id];
+    if (operation_1.fixed_start != -1
+            && operation_1.fixed_alternative_id != machine_operation_1.alternative_id) {
+        return true;
+    }
+    if (operation_2.fixed_start != -1
+            && operation_2.fixed_alternative_id != machine_operation_2.alternative_id) {
+        return true;
+    }
+    return (operation_1.fixed_start != -1 && operation_2.fixed_start != -1);
+}
+
+// Create the model. The model is incomplete if the timer ends meanwhile, so
+// the caller must check it.
+//
+// The variables of the fixed operations are fixed through their bounds, so
+// that the presolve of the solver removes them, and the disjunctions between
+// fixed operations are not created.
 Model create_milp_model(
-        const Instance& instance)
+        const Instance& instance,
+        const optimizationtools::Timer& timer)
 {
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("MilpDisjunctive/CreateMilpModel");
     Model model;
 
     /////////////////////////////
@@ -133,12 +165,25 @@ Model create_milp_model(
         const Machine& machine = instance.machine(machine_id);
         model.y[machine_id] = std::vector<std::vector<int>>(machine.operations.size());
         for (JobId pos = 0; pos < machine.operations.size(); ++pos) {
+            if (timer.needs_to_end())
+                return model;
             const MachineOperation& machine_operation = machine.operations[pos];
             model.y[machine_id][pos] = std::vector<int>(pos);
+            const Operation& operation = instance.job(machine_operation.job_id).operations[machine_operation.operation_id];
             for (JobId pos_2 = 0; pos_2 < pos; ++pos_2) {
+                const MachineOperation& machine_operation_2 = machine.operations[pos_2];
+                const Operation& operation_2 = instance.job(machine_operation_2.job_id).operations[machine_operation_2.operation_id];
+                double lower_bound = 0;
+                double upper_bound = 1;
+                if (fixed_disjunction(instance, machine_operation, machine_operation_2)) {
+                    lower_bound = (operation.fixed_alternative_id == machine_operation.alternative_id
+                            && operation_2.fixed_alternative_id == machine_operation_2.alternative_id
+                            && operation.fixed_start < operation_2.fixed_start)? 1: 0;
+                    upper_bound = lower_bound;
+                }
                 model.y[machine_id][pos][pos_2] = model.model.variables_lower_bounds.size();
-                model.model.variables_lower_bounds.push_back(0);
-                model.model.variables_upper_bounds.push_back(1);
+                model.model.variables_lower_bounds.push_back(lower_bound);
+                model.model.variables_upper_bounds.push_back(upper_bound);
                 model.model.variables_types.push_back(mathoptsolverscmake::VariableType::Binary);
                 model.model.objective_coefficients.push_back(0);
                 model.model.variables_names.push_back("y_{" + std::to_string(machine_id) + "," + std::to_string(pos) + "," + std::to_string(pos_2) + "}");
@@ -163,9 +208,15 @@ Model create_milp_model(
                         alternative_id < (AlternativeId)operation.alternatives.size();
                         ++alternative_id) {
                     const Alternative& alternative = operation.alternatives[alternative_id];
+                    double lower_bound = 0;
+                    double upper_bound = 1;
+                    if (operation.fixed_start != -1) {
+                        lower_bound = (operation.fixed_alternative_id == alternative_id)? 1: 0;
+                        upper_bound = lower_bound;
+                    }
                     model.x[job_id][operation_id][alternative_id] = model.model.variables_lower_bounds.size();
-                    model.model.variables_lower_bounds.push_back(0);
-                    model.model.variables_upper_bounds.push_back(1);
+                    model.model.variables_lower_bounds.push_back(lower_bound);
+                    model.model.variables_upper_bounds.push_back(upper_bound);
                     model.model.variables_types.push_back(mathoptsolverscmake::VariableType::Binary);
                     model.model.objective_coefficients.push_back(0);
                     model.model.variables_names.push_back("x_{" + std::to_string(job_id) + "," + std::to_string(operation_id) + "," + std::to_string(alternative_id) + "}");
@@ -186,12 +237,20 @@ Model create_milp_model(
                     operation_id < job.operations.size();
                     ++operation_id) {
                 model.z[job_id][operation_id] = std::vector<int>(operation_id);
+                const Operation& operation = job.operations[operation_id];
                 for (OperationId operation_2_id = 0;
                         operation_2_id < operation_id;
                         ++operation_2_id) {
+                    const Operation& operation_2 = job.operations[operation_2_id];
+                    double lower_bound = 0;
+                    double upper_bound = 1;
+                    if (operation.fixed_start != -1 && operation_2.fixed_start != -1) {
+                        lower_bound = (operation.fixed_start < operation_2.fixed_start)? 1: 0;
+                        upper_bound = lower_bound;
+                    }
                     model.z[job_id][operation_id][operation_2_id] = model.model.variables_lower_bounds.size();
-                    model.model.variables_lower_bounds.push_back(0);
-                    model.model.variables_upper_bounds.push_back(1);
+                    model.model.variables_lower_bounds.push_back(lower_bound);
+                    model.model.variables_upper_bounds.push_back(upper_bound);
                     model.model.variables_types.push_back(mathoptsolverscmake::VariableType::Binary);
                     model.model.objective_coefficients.push_back(0);
                     model.model.variables_names.push_back("z_{" + std::to_string(job_id) + "," + std::to_string(operation_id) + "," + std::to_string(operation_2_id) + "}");
@@ -227,9 +286,25 @@ Model create_milp_model(
                 lb = pmin;
             }
 
+            double lower_bound = lb;
+            double upper_bound = std::numeric_limits<double>::infinity();
+            if (!instance.blocking()) {
+                if (operation.fixed_start != -1) {
+                    lower_bound = operation.fixed_start
+                        + operation.alternatives[operation.fixed_alternative_id].processing_time;
+                    upper_bound = lower_bound;
+                } else if (!instance.flexible()) {
+                    const Alternative& alternative = operation.alternatives[0];
+                    lower_bound = (std::max)(
+                            lower_bound,
+                            (double)(instance.machine(alternative.machine_id).availability_time
+                                + alternative.processing_time));
+                }
+            }
+
             model.co[job_id][operation_id] = model.model.variables_lower_bounds.size();
-            model.model.variables_lower_bounds.push_back(lb);
-            model.model.variables_upper_bounds.push_back(std::numeric_limits<double>::infinity());
+            model.model.variables_lower_bounds.push_back(lower_bound);
+            model.model.variables_upper_bounds.push_back(upper_bound);
             model.model.variables_types.push_back(mathoptsolverscmake::VariableType::Integer);
             if (instance.objective() == Objective::TotalFlowTime
                     && !instance.operations_arbitrary_order()
@@ -259,9 +334,13 @@ Model create_milp_model(
                         alternative_id < (AlternativeId)operation.alternatives.size();
                         ++alternative_id) {
                     const Alternative& alternative = operation.alternatives[alternative_id];
+                    double lower_bound = 0;
+                    double upper_bound = std::numeric_limits<double>::infinity();
+                    if (operation.fixed_start != -1 && operation.fixed_alternative_id != alternative_id)
+                        upper_bound = 0;
                     model.ck[job_id][operation_id][alternative_id] = model.model.variables_lower_bounds.size();
-                    model.model.variables_lower_bounds.push_back(0);
-                    model.model.variables_upper_bounds.push_back(std::numeric_limits<double>::infinity());
+                    model.model.variables_lower_bounds.push_back(lower_bound);
+                    model.model.variables_upper_bounds.push_back(upper_bound);
                     model.model.variables_types.push_back(mathoptsolverscmake::VariableType::Integer);
                     model.model.objective_coefficients.push_back(0);
                     model.model.variables_names.push_back("ck_{" + std::to_string(job_id) + "," + std::to_string(operation_id) + "," + std::to_string(alternative_id) + "}");
@@ -625,6 +704,35 @@ Model create_milp_model(
             m += pmax;
         }
     }
+    // The operations which are not fixed can be scheduled after the fixed
+    // operations and the availability times of the machines.
+    Time fixed_horizon = 0;
+    for (MachineId machine_id = 0;
+            machine_id < instance.number_of_machines();
+            ++machine_id) {
+        fixed_horizon = (std::max)(fixed_horizon, instance.machine(machine_id).availability_time);
+    }
+    for (JobId job_id: instance.fixed_jobs()) {
+        for (const Operation& operation: instance.job(job_id).operations) {
+            fixed_horizon = (std::max)(
+                    fixed_horizon,
+                    operation.fixed_start + operation.alternatives[operation.fixed_alternative_id].processing_time);
+        }
+    }
+    if (instance.number_of_fixed_operations() > (OperationId)instance.fixed_jobs().size()) {
+        for (JobId job_id = 0;
+                job_id < instance.number_of_jobs();
+                ++job_id) {
+            for (const Operation& operation: instance.job(job_id).operations) {
+                if (operation.fixed_start == -1)
+                    continue;
+                fixed_horizon = (std::max)(
+                        fixed_horizon,
+                        operation.fixed_start + operation.alternatives[operation.fixed_alternative_id].processing_time);
+            }
+        }
+    }
+    m += fixed_horizon;
     if (instance.flexible()) {
         // ck_{j, o, k} <= M x_{j, o, k}
         // <=>
@@ -700,6 +808,8 @@ Model create_milp_model(
             ++machine_id) {
         const Machine& machine = instance.machine(machine_id);
         for (JobId pos = 0; pos < machine.operations.size(); ++pos) {
+            if (timer.needs_to_end())
+                return model;
             const MachineOperation& machine_operation = machine.operations[pos];
             const Job& job = instance.job(machine_operation.job_id);
             const Operation& operation = job.operations[machine_operation.operation_id];
@@ -709,6 +819,10 @@ Model create_milp_model(
                 const Job& job_2 = instance.job(machine_operation_2.job_id);
                 const Operation& operation_2 = job_2.operations[machine_operation_2.operation_id];
                 const Alternative& alternative_2 = operation_2.alternatives[machine_operation_2.alternative_id];
+                if (!instance.blocking()
+                        && fixed_disjunction(instance, machine_operation, machine_operation_2)) {
+                    continue;
+                }
 
                 {
                     model.model.constraints_starts.push_back(model.model.elements_variables.size());
@@ -790,6 +904,11 @@ Model create_milp_model(
                         operation_2_id < operation_id;
                         ++operation_2_id) {
                     const Operation& operation_2 = job.operations[operation_2_id];
+                    if (!instance.blocking()
+                            && operation.fixed_start != -1
+                            && operation_2.fixed_start != -1) {
+                        continue;
+                    }
 
                     {
                         model.model.constraints_starts.push_back(model.model.elements_variables.size());
@@ -1138,6 +1257,68 @@ Model create_milp_model(
         }
     }
 
+    // Fixed operations and machine availability times.
+    // Without blocking, the completion times of the fixed operations and the
+    // availability times of the machines of the operations with a single
+    // alternative are handled by the bounds of the variables.
+    //
+    // C_{j, o} - p_{j, o} = s_{j, o}                 if o is fixed
+    // C_{j, o} - p_{j, o} - a_{k} x_{j, o, k} >= 0   otherwise
+    if (instance.flexible() || instance.blocking()) {
+        for (JobId job_id = 0;
+                job_id < instance.number_of_jobs();
+                ++job_id) {
+            const Job& job = instance.job(job_id);
+            for (OperationId operation_id = 0;
+                    operation_id < (OperationId)job.operations.size();
+                    ++operation_id) {
+                const Operation& operation = job.operations[operation_id];
+                if (operation.fixed_start != -1) {
+                    if (!instance.blocking())
+                        continue;
+                    model.model.constraints_starts.push_back(model.model.elements_variables.size());
+                    model.model.elements_variables.push_back(model.co[job_id][operation_id]);
+                    model.model.elements_coefficients.push_back(1.0);
+                    model.model.elements_variables.push_back(model.p[job_id][operation_id]);
+                    model.model.elements_coefficients.push_back(-1.0);
+                    model.model.constraints_lower_bounds.push_back(operation.fixed_start);
+                    model.model.constraints_upper_bounds.push_back(operation.fixed_start);
+                    continue;
+                }
+                if (!instance.flexible()) {
+                    Time availability_time = instance.machine(operation.alternatives[0].machine_id).availability_time;
+                    if (availability_time == 0)
+                        continue;
+                    model.model.constraints_starts.push_back(model.model.elements_variables.size());
+                    model.model.elements_variables.push_back(model.co[job_id][operation_id]);
+                    model.model.elements_coefficients.push_back(1.0);
+                    model.model.elements_variables.push_back(model.p[job_id][operation_id]);
+                    model.model.elements_coefficients.push_back(-1.0);
+                    model.model.constraints_lower_bounds.push_back(availability_time);
+                    model.model.constraints_upper_bounds.push_back(std::numeric_limits<double>::infinity());
+                    continue;
+                }
+                for (AlternativeId alternative_id = 0;
+                        alternative_id < (AlternativeId)operation.alternatives.size();
+                        ++alternative_id) {
+                    const Alternative& alternative = operation.alternatives[alternative_id];
+                    Time availability_time = instance.machine(alternative.machine_id).availability_time;
+                    if (availability_time == 0)
+                        continue;
+                    model.model.constraints_starts.push_back(model.model.elements_variables.size());
+                    model.model.elements_variables.push_back(model.co[job_id][operation_id]);
+                    model.model.elements_coefficients.push_back(1.0);
+                    model.model.elements_variables.push_back(model.p[job_id][operation_id]);
+                    model.model.elements_coefficients.push_back(-1.0);
+                    model.model.elements_variables.push_back(model.x[job_id][operation_id][alternative_id]);
+                    model.model.elements_coefficients.push_back(-availability_time);
+                    model.model.constraints_lower_bounds.push_back(0);
+                    model.model.constraints_upper_bounds.push_back(std::numeric_limits<double>::infinity());
+                }
+            }
+        }
+    }
+
     //std::cout << "MILP model" << std::endl;
     //std::cout << "----------" << std::endl;
     //model.model.format(std::cout, 4);
@@ -1401,7 +1582,11 @@ Output shopschedulingsolver::milp_disjunctive(
 
     algorithm_formatter.print_header();
 
-    Model milp_model = create_milp_model(instance);
+    Model milp_model = create_milp_model(instance, parameters.timer);
+    if (parameters.timer.needs_to_end()) {
+        algorithm_formatter.end();
+        return output;
+    }
 
     std::vector<double> milp_solution;
     double milp_bound = 0;
@@ -1415,7 +1600,10 @@ Output shopschedulingsolver::milp_disjunctive(
         mathoptsolverscmake::load(cbc_model, milp_model.model);
         EventHandler cbc_event_handler(instance, parameters, milp_model, output, algorithm_formatter);
         cbc_model.passInEventHandler(&cbc_event_handler);
-        mathoptsolverscmake::solve(cbc_model);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("MilpDisjunctive/Solve");
+            mathoptsolverscmake::solve(cbc_model);
+        }
         milp_solution = mathoptsolverscmake::get_solution(cbc_model);
         milp_bound = mathoptsolverscmake::get_bound(cbc_model);
 #else
@@ -1467,7 +1655,10 @@ Output shopschedulingsolver::milp_disjunctive(
         HighsStatus highs_status;
         highs_status = highs.startCallback(HighsCallbackType::kCallbackMipImprovingSolution);
         highs_status = highs.startCallback(HighsCallbackType::kCallbackMipInterrupt);
-        mathoptsolverscmake::solve(highs);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("MilpDisjunctive/Solve");
+            mathoptsolverscmake::solve(highs);
+        }
         milp_solution = mathoptsolverscmake::get_solution(highs);
         milp_bound = mathoptsolverscmake::get_bound(highs);
 #else
@@ -1484,7 +1675,10 @@ Output shopschedulingsolver::milp_disjunctive(
         //mathoptsolverscmake::write_mps(xpress_model, "kpc.mps");
         XpressCallbackUser xpress_callback_user{instance, parameters, output, algorithm_formatter};
         XPRSaddcbprenode(xpress_model, xpress_callback, (void*)&xpress_callback_user, 0);
-        mathoptsolverscmake::solve(xpress_model);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("MilpDisjunctive/Solve");
+            mathoptsolverscmake::solve(xpress_model);
+        }
         milp_solution = mathoptsolverscmake::get_solution(xpress_model);
         milp_bound = mathoptsolverscmake::get_bound(xpress_model);
         XPRSdestroyprob(xpress_model);
@@ -1518,9 +1712,16 @@ Output shopschedulingsolver::milp_disjunctive(
 void shopschedulingsolver::write_mps(
         const Instance& instance,
         mathoptsolverscmake::SolverName solver,
-        const std::string& output_path)
+        const std::string& output_path,
+        const Parameters& parameters)
 {
-    Model milp_model = create_milp_model(instance);
+    Model milp_model = create_milp_model(instance, parameters.timer);
+    if (parameters.timer.needs_to_end()) {
+        throw std::runtime_error(
+                FUNC_SIGNATURE + ": "
+                "the end has been reached before the model was created; "
+                "output_path: " + output_path + ".");
+    }
 
     if (solver == mathoptsolverscmake::SolverName::Cbc) {
 #ifdef CBC_FOUND
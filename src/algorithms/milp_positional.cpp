@@ -1,5 +1,7 @@
 #include "shopschedulingsolver/algorithms/milp_positional.hpp"
 
+#include "shopschedulingsolver/profiler.hpp"
+
 #ifdef CBC_FOUND
 #include "mathoptsolverscmake/mathopt_cbc.hpp"
 #endif
@@ -10,6 +12,8 @@
 #include "mathoptsolverscmake/mathopt_xpress.hpp"
 #endif
 
+#include <limits>
+
 using namespace shopschedulingsolver;
 
 namespace
@@ -47,11 +51,78 @@ struct Model
     std::vector<int> t;
 };
 
+// Create the model. The model is incomplete if the timer ends meanwhile, so
+// the caller must check it.
 Model create_milp_model(
-        const Instance& instance)
+        const Instance& instance,
+        const MilpPositionalParameters& parameters)
 {
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("MilpPositional/CreateMilpModel");
     Model model;
 
+    // The fixed jobs take the first positions, in the order of their fixed
+    // starts. Their variables are fixed through their bounds, so that the
+    // presolve of the solver removes them, and only the other positions are
+    // searched.
+    if (instance.number_of_fixed_operations() > 0
+            && (instance.blocking()
+                || instance.number_of_fixed_operations()
+                != (OperationId)instance.fixed_jobs().size() * instance.number_of_machines())) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations are only supported without blocking, "
+                "for jobs whose operations are all fixed.");
+    }
+    JobId number_of_fixed_jobs = instance.fixed_jobs().size();
+    std::vector<JobId> fixed_positions(instance.number_of_jobs(), -1);
+    for (JobId pos = 0; pos < number_of_fixed_jobs; ++pos) {
+        JobId job_id = instance.fixed_jobs()[pos];
+        fixed_positions[job_id] = pos;
+        if (pos == 0)
+            continue;
+        const Job& previous_job = instance.job(instance.fixed_jobs()[pos - 1]);
+        const Job& job = instance.job(job_id);
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            if (job.operations[machine_id].fixed_start
+                    < previous_job.operations[machine_id].fixed_start) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "the fixed jobs are not in the same order on all machines; "
+                        "machine_id: " + std::to_string(machine_id) + ".");
+            }
+        }
+    }
+
+    // The last jobs, if any, take the last positions, in their order.
+    JobId number_of_last_jobs = parameters.last_job_ids.size();
+    if (number_of_fixed_jobs + number_of_last_jobs > instance.number_of_jobs()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "too many last jobs; "
+                "number of last jobs: " + std::to_string(number_of_last_jobs) + "; "
+                "number of fixed jobs: " + std::to_string(number_of_fixed_jobs) + "; "
+                "number of jobs: " + std::to_string(instance.number_of_jobs()) + ".");
+    }
+    for (JobId last_pos = 0; last_pos < number_of_last_jobs; ++last_pos) {
+        JobId last_job_id = parameters.last_job_ids[last_pos];
+        if (last_job_id < 0 || last_job_id >= instance.number_of_jobs()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "invalid last job; "
+                    "last_job_id: " + std::to_string(last_job_id) + "; "
+                    "number of jobs: " + std::to_string(instance.number_of_jobs()) + ".");
+        }
+        if (fixed_positions[last_job_id] != -1) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "the last jobs must be distinct and must not be fixed jobs; "
+                    "last_job_id: " + std::to_string(last_job_id) + ".");
+        }
+        fixed_positions[last_job_id] = instance.number_of_jobs() - number_of_last_jobs + last_pos;
+    }
+
     /////////////////////////////
     // Variables and objective //
     /////////////////////////////
@@ -64,9 +135,18 @@ Model create_milp_model(
             std::vector<int>(instance.number_of_jobs()));
     for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
         for (JobId pos = 0; pos < instance.number_of_jobs(); ++pos) {
+            double lower_bound = 0;
+            double upper_bound = 1;
+            if (fixed_positions[job_id] != -1) {
+                lower_bound = (fixed_positions[job_id] == pos)? 1: 0;
+                upper_bound = lower_bound;
+            } else if (pos < number_of_fixed_jobs
+                    || pos >= instance.number_of_jobs() - number_of_last_jobs) {
+                upper_bound = 0;
+            }
             model.x[job_id][pos] = model.model.variables_lower_bounds.size();
-            model.model.variables_lower_bounds.push_back(0);
-            model.model.variables_upper_bounds.push_back(1);
+            model.model.variables_lower_bounds.push_back(lower_bound);
+            model.model.variables_upper_bounds.push_back(upper_bound);
             model.model.variables_types.push_back(mathoptsolverscmake::VariableType::Binary);
             model.model.objective_coefficients.push_back(0);
         }
@@ -106,9 +186,16 @@ Model create_milp_model(
             machine_id < instance.number_of_machines();
             ++machine_id) {
         for (JobId pos = 0; pos < instance.number_of_jobs(); ++pos) {
+            double lower_bound = 0;
+            double upper_bound = std::numeric_limits<double>::infinity();
+            if (pos < number_of_fixed_jobs) {
+                const Operation& operation = instance.job(instance.fixed_jobs()[pos]).operations[machine_id];
+                lower_bound = operation.fixed_start + operation.alternatives[0].processing_time;
+                upper_bound = lower_bound;
+            }
             model.c[machine_id][pos] = model.model.variables_lower_bounds.size();
-            model.model.variables_lower_bounds.push_back(0);
-            model.model.variables_upper_bounds.push_back(std::numeric_limits<double>::infinity());
+            model.model.variables_lower_bounds.push_back(lower_bound);
+            model.model.variables_upper_bounds.push_back(upper_bound);
             model.model.variables_types.push_back(mathoptsolverscmake::VariableType::Integer);
             if (instance.objective() == Objective::TotalFlowTime
                     && machine_id == instance.number_of_machines() - 1) {
@@ -151,6 +238,8 @@ Model create_milp_model(
     for (MachineId machine_id = 0;
             machine_id < instance.number_of_machines();
             ++machine_id) {
+        if (parameters.timer.needs_to_end())
+            return model;
         for (JobId pos = 0; pos < instance.number_of_jobs(); ++pos) {
             model.model.constraints_starts.push_back(model.model.elements_variables.size());
 
@@ -246,6 +335,9 @@ Model create_milp_model(
         }
     }
 
+    if (parameters.timer.needs_to_end())
+        return model;
+
     // Constraints: each job must have a position.
     // sum x_{j, k} = 1 for all job j.
     for (JobId job_id = 0;
@@ -284,6 +376,9 @@ Model create_milp_model(
     {
         MachineId machine_id = 0;
         JobId pos = 0;
+        Time start = (number_of_fixed_jobs > 0)?
+            instance.job(instance.fixed_jobs()[0]).operations[machine_id].fixed_start:
+            instance.machine(machine_id).availability_time;
 
         model.model.constraints_starts.push_back(model.model.elements_variables.size());
 
@@ -292,8 +387,8 @@ Model create_milp_model(
         model.model.elements_variables.push_back(model.p[machine_id][pos]);
         model.model.elements_coefficients.push_back(-1.0);
 
-        model.model.constraints_lower_bounds.push_back(0);
-        model.model.constraints_upper_bounds.push_back(0);
+        model.model.constraints_lower_bounds.push_back(start);
+        model.model.constraints_upper_bounds.push_back(start);
     }
     for (JobId pos = 0; pos < instance.number_of_jobs(); ++pos) {
         for (MachineId machine_id = 1;
@@ -345,6 +440,34 @@ Model create_milp_model(
         }
     }
 
+    // Constraints: the first job which is not fixed must start after the
+    // availability times of the machines.
+    // C_{i, k} >= a_i + p_{i, k}
+    // <=>
+    // a_i <= C_{i, k} - p_{i, k}
+    if (number_of_fixed_jobs < instance.number_of_jobs()) {
+        JobId pos = number_of_fixed_jobs;
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            const Machine& machine = instance.machine(machine_id);
+            if (machine.availability_time == 0
+                    || (machine_id == 0 && pos == 0)) {
+                continue;
+            }
+
+            model.model.constraints_starts.push_back(model.model.elements_variables.size());
+
+            model.model.elements_variables.push_back(model.c[machine_id][pos]);
+            model.model.elements_coefficients.push_back(1.0);
+            model.model.elements_variables.push_back(model.p[machine_id][pos]);
+            model.model.elements_coefficients.push_back(-1.0);
+
+            model.model.constraints_lower_bounds.push_back(machine.availability_time);
+            model.model.constraints_upper_bounds.push_back(std::numeric_limits<double>::infinity());
+        }
+    }
+
     return model;
 }
 
@@ -577,7 +700,19 @@ Output shopschedulingsolver::milp_positional(
 
     algorithm_formatter.print_header();
 
-    Model milp_model = create_milp_model(instance);
+    // The value of the initial solution is used as cutoff, so that the solver
+    // only looks for strictly better solutions.
+    double cutoff = std::numeric_limits<double>::infinity();
+    if (initial_solution != nullptr && initial_solution->feasible()) {
+        algorithm_formatter.update_solution(*initial_solution, "initial solution");
+        cutoff = initial_solution->objective_value();
+    }
+
+    Model milp_model = create_milp_model(instance, parameters);
+    if (parameters.timer.needs_to_end()) {
+        algorithm_formatter.end();
+        return output;
+    }
 
     std::vector<double> milp_solution;
     double milp_bound = 0;
@@ -589,9 +724,14 @@ Output shopschedulingsolver::milp_positional(
         mathoptsolverscmake::reduce_printout(cbc_model);
         mathoptsolverscmake::set_time_limit(cbc_model, parameters.timer.remaining_time());
         mathoptsolverscmake::load(cbc_model, milp_model.model);
+        if (cutoff != std::numeric_limits<double>::infinity())
+            cbc_model.setCutoff(cutoff);
         EventHandler cbc_event_handler(instance, parameters, milp_model, output, algorithm_formatter);
         cbc_model.passInEventHandler(&cbc_event_handler);
-        mathoptsolverscmake::solve(cbc_model);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("MilpPositional/Solve");
+            mathoptsolverscmake::solve(cbc_model);
+        }
         milp_solution = mathoptsolverscmake::get_solution(cbc_model);
         milp_bound = mathoptsolverscmake::get_bound(cbc_model);
 #else
@@ -605,6 +745,8 @@ Output shopschedulingsolver::milp_positional(
         mathoptsolverscmake::set_time_limit(highs, parameters.timer.remaining_time());
         mathoptsolverscmake::set_log_file(highs, "highs.log");
         mathoptsolverscmake::load(highs, milp_model.model);
+        if (cutoff != std::numeric_limits<double>::infinity())
+            highs.setOptionValue("objective_bound", cutoff);
         highs.setCallback([
                 &instance,
                 &parameters,
@@ -649,7 +791,10 @@ Output shopschedulingsolver::milp_positional(
         HighsStatus highs_status;
         highs_status = highs.startCallback(HighsCallbackType::kCallbackMipImprovingSolution);
         highs_status = highs.startCallback(HighsCallbackType::kCallbackMipInterrupt);
-        mathoptsolverscmake::solve(highs);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("MilpPositional/Solve");
+            mathoptsolverscmake::solve(highs);
+        }
         milp_solution = mathoptsolverscmake::get_solution(highs);
         milp_bound = mathoptsolverscmake::get_bound(highs);
 #else
@@ -663,10 +808,15 @@ Output shopschedulingsolver::milp_positional(
         mathoptsolverscmake::set_time_limit(xpress_model, parameters.timer.remaining_time());
         mathoptsolverscmake::set_log_file(xpress_model, "xpress.log");
         mathoptsolverscmake::load(xpress_model, milp_model);
+        if (cutoff != std::numeric_limits<double>::infinity())
+            XPRSsetdblcontrol(xpress_model, XPRS_MIPABSCUTOFF, cutoff);
         //mathoptsolverscmake::write_mps(xpress_model, "kpc.mps");
         XpressCallbackUser xpress_callback_user{instance, parameters, output, algorithm_formatter};
         XPRSaddcbprenode(xpress_model, xpress_callback, (void*)&xpress_callback_user, 0);
-        mathoptsolverscmake::solve(xpress_model);
+        {
+            SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("MilpPositional/Solve");
+            mathoptsolverscmake::solve(xpress_model);
+        }
         milp_solution = mathoptsolverscmake::get_solution(xpress_model);
         milp_bound = mathoptsolverscmake::get_bound(xpress_model);
         XPRSdestroyprob(xpress_model);
@@ -679,10 +829,16 @@ Output shopschedulingsolver::milp_positional(
     }
 
     // Retrieve solution.
-    Solution solution = retrieve_solution(instance, milp_model, milp_solution);
-    algorithm_formatter.update_solution(solution, "");
+    if (!milp_solution.empty()) {
+        Solution solution = retrieve_solution(instance, milp_model, milp_solution);
+        algorithm_formatter.update_solution(solution, "");
+    }
 
     // Retrieve bound.
+    // Solutions which are not strictly better than the cutoff have been
+    // discarded, so the cutoff is a valid bound.
+    if (milp_bound > cutoff)
+        milp_bound = cutoff;
     if (instance.objective() == Objective::Makespan) {
         algorithm_formatter.update_makespan_bound(milp_bound, "");
     } else if (instance.objective() == Objective::TotalFlowTime) {
@@ -0,0 +1,314 @@
+#include "shopschedulingsolver/algorithms/portfolio.hpp"
+
+#include "shopschedulingsolver/algorithms/tree_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+void update_bound(
+        const Instance& instance,
+        AlgorithmFormatter& algorithm_formatter,
+        Time bound,
+        const std::string& s)
+{
+    switch (instance.objective()) {
+    case Objective::Makespan: {
+        algorithm_formatter.update_makespan_bound(bound, s);
+        break;
+    } case Objective::TotalFlowTime: {
+        algorithm_formatter.update_total_flow_time_bound(bound, s);
+        break;
+    } case Objective::TotalTardiness: {
+        algorithm_formatter.update_total_tardiness_bound(bound, s);
+        break;
+    } case Objective::Throughput: {
+        algorithm_formatter.update_throughput_bound(bound, s);
+        break;
+    }
+    }
+}
+
+// Set the parameters common to all the algorithms of the portfolio: they are
+// silent, report their solutions and bounds through the given callback and
+// stop with the timer of their task or when 'end' is set.
+void set_algorithm_parameters(
+        const optimizationtools::Timer& timer,
+        const bool* end,
+        const NewSolutionCallback& new_solution_callback,
+        Parameters& algorithm_parameters)
+{
+    algorithm_parameters.timer = timer;
+    algorithm_parameters.timer.add_end_boolean(end);
+    algorithm_parameters.verbosity_level = 0;
+    algorithm_parameters.log_path = "";
+    algorithm_parameters.log_to_stderr = false;
+    algorithm_parameters.messages_to_stdout = false;
+    algorithm_parameters.new_solution_callback = new_solution_callback;
+    algorithm_parameters.end_callback = [](const Output&) { };
+}
+
+bool supports_objective(
+        PortfolioAlgorithm algorithm,
+        Objective objective)
+{
+    switch (algorithm) {
+    case PortfolioAlgorithm::TreeSearchPfssMakespan:
+    case PortfolioAlgorithm::LocalSearchPfssMakespan: {
+        return objective == Objective::Makespan;
+    } case PortfolioAlgorithm::LocalSearchPfss: {
+        return objective == Objective::TotalFlowTime
+            || objective == Objective::TotalTardiness;
+    } case PortfolioAlgorithm::MilpPositional: {
+        return objective == Objective::Makespan
+            || objective == Objective::TotalFlowTime
+            || objective == Objective::TotalTardiness;
+    }
+    }
+    return false;
+}
+
+// Set the parameters left to automatic and check the others.
+PortfolioParameters resolve_parameters(
+        const Instance& instance,
+        const PortfolioParameters& parameters)
+{
+    PortfolioParameters resolved_parameters = parameters;
+
+    if (instance.objective() == Objective::Throughput) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the throughput objective is not supported.");
+    }
+
+    if (resolved_parameters.algorithms.empty()) {
+        if (instance.objective() == Objective::Makespan) {
+            resolved_parameters.algorithms = {
+                PortfolioAlgorithm::TreeSearchPfssMakespan,
+                PortfolioAlgorithm::LocalSearchPfssMakespan,
+            };
+        } else {
+            resolved_parameters.algorithms = {
+                PortfolioAlgorithm::LocalSearchPfss,
+            };
+        }
+    }
+
+    for (PortfolioAlgorithm algorithm: resolved_parameters.algorithms) {
+        if (!supports_objective(algorithm, instance.objective())) {
+            std::stringstream ss;
+            ss << algorithm;
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "unsupported objective; "
+                    "algorithm: " + ss.str() + ".");
+        }
+        // The tree search and the local searches only support fixed
+        // operations forming a frozen prefix.
+        if (!instance.fixed_prefix() && algorithm != PortfolioAlgorithm::MilpPositional) {
+            std::stringstream ss;
+            ss << algorithm;
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "unsupported fixed operations or machine availability times; "
+                    "algorithm: " + ss.str() + ".");
+        }
+    }
+
+    if (resolved_parameters.local_search_parameters.maximum_number_of_iterations_without_improvement < 0) {
+        resolved_parameters.local_search_parameters.maximum_number_of_iterations_without_improvement
+            = resolved_parameters.local_search_restart_interval;
+    }
+    if (resolved_parameters.local_search_parameters.maximum_number_of_iterations_without_improvement < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the local search restart interval must be positive; "
+                "maximum_number_of_iterations_without_improvement: " + std::to_string(resolved_parameters.local_search_parameters.maximum_number_of_iterations_without_improvement) + ".");
+    }
+
+    return resolved_parameters;
+}
+
+}
+
+const PortfolioOutput shopschedulingsolver::portfolio(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        const Solution* initial_solution,
+        const PortfolioParameters& input_parameters)
+{
+    const PortfolioParameters parameters = resolve_parameters(instance, input_parameters);
+    PortfolioOutput output(instance);
+    AlgorithmFormatter algorithm_formatter(instance, parameters, output);
+    algorithm_formatter.start("Portfolio");
+    algorithm_formatter.print_header();
+
+    Counter number_of_algorithms = parameters.algorithms.size();
+    output.numbers_of_improvements.resize(number_of_algorithms, 0);
+
+    // The mutex protects the output, 'end' and the number of running
+    // heuristics. The makespan of the incumbent is also stored in an atomic
+    // variable, since the tree search reads it at each node expansion.
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    bool end = false;
+    std::atomic<Time> makespan_upper_bound(std::numeric_limits<Time>::max());
+    Counter number_of_running_heuristics = 0;
+
+    // Must be called with the mutex locked.
+    auto update_end = [&instance, &output, &end, &makespan_upper_bound]()
+    {
+        if (!output.solution.feasible())
+            return;
+        if (instance.objective() == Objective::Makespan)
+            makespan_upper_bound = output.solution.makespan();
+        if (output.bound() >= output.solution.objective_value())
+            end = true;
+    };
+
+    if (initial_solution != nullptr) {
+        algorithm_formatter.update_solution(*initial_solution, "initial solution");
+        update_end();
+    }
+
+    std::unique_ptr<ThreadPool> local_thread_pool;
+    if (parameters.thread_pool == nullptr)
+        local_thread_pool.reset(new ThreadPool(number_of_algorithms - 1));
+    ThreadPool& thread_pool = (parameters.thread_pool != nullptr)?
+        *parameters.thread_pool:
+        *local_thread_pool;
+
+    // The heuristics are submitted first, so that they start before the MILP
+    // when the pool has fewer threads than algorithms. The MILP does not wait
+    // for the heuristics which have not started, since they might be queued
+    // behind it.
+    std::vector<Counter> algorithm_positions;
+    for (Counter algorithm_pos = 0; algorithm_pos < number_of_algorithms; ++algorithm_pos)
+        if (parameters.algorithms[algorithm_pos] != PortfolioAlgorithm::MilpPositional)
+            algorithm_positions.push_back(algorithm_pos);
+    for (Counter algorithm_pos = 0; algorithm_pos < number_of_algorithms; ++algorithm_pos)
+        if (parameters.algorithms[algorithm_pos] == PortfolioAlgorithm::MilpPositional)
+            algorithm_positions.push_back(algorithm_pos);
+
+    // An algorithm failing cancels the group, so that the others stop.
+    TaskGroup task_group(thread_pool, generator, parameters.timer);
+    for (Counter algorithm_pos: algorithm_positions) {
+        task_group.run([&, algorithm_pos](TaskContext& task_context)
+        {
+            PortfolioAlgorithm algorithm = parameters.algorithms[algorithm_pos];
+            std::stringstream name_ss;
+            name_ss << algorithm;
+            std::string name = name_ss.str();
+
+            NewSolutionCallback new_solution_callback = [&, algorithm_pos, name](
+                    const Output& algorithm_output)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (algorithm_output.solution.strictly_better(output.solution))
+                    output.numbers_of_improvements[algorithm_pos]++;
+                algorithm_formatter.update_solution(algorithm_output.solution, name);
+                update_bound(instance, algorithm_formatter, algorithm_output.bound(), name);
+                update_end();
+                condition_variable.notify_all();
+            };
+
+            bool heuristic = (algorithm != PortfolioAlgorithm::MilpPositional);
+            auto update_number_of_running_heuristics = [&, heuristic](Counter delta)
+            {
+                if (!heuristic)
+                    return;
+                std::lock_guard<std::mutex> lock(mutex);
+                number_of_running_heuristics += delta;
+                condition_variable.notify_all();
+            };
+            update_number_of_running_heuristics(1);
+
+            try {
+                std::mt19937_64& algorithm_generator = task_context.generator;
+                switch (algorithm) {
+                case PortfolioAlgorithm::TreeSearchPfssMakespan: {
+                    TreeSearchPfssMakespanParameters tree_search_parameters;
+                    set_algorithm_parameters(task_context.timer, &end, new_solution_callback, tree_search_parameters);
+                    tree_search_parameters.makespan_upper_bound_callback
+                        = [&makespan_upper_bound]() { return makespan_upper_bound.load(); };
+                    tree_search_pfss_makespan(instance, tree_search_parameters);
+                    break;
+
+                } case PortfolioAlgorithm::LocalSearchPfssMakespan:
+                case PortfolioAlgorithm::LocalSearchPfss: {
+                    LocalSearchPfssParameters local_search_parameters = parameters.local_search_parameters;
+                    set_algorithm_parameters(task_context.timer, &end, new_solution_callback, local_search_parameters);
+                    if (local_search_parameters.thread_pool == nullptr)
+                        local_search_parameters.thread_pool = &thread_pool;
+                    // Each run stops once it does not improve anymore, and
+                    // the next one starts from the incumbent, which might
+                    // have been found by another algorithm meanwhile.
+                    while (!local_search_parameters.timer.needs_to_end()) {
+                        Solution incumbent = SolutionBuilder().set_instance(instance).build();
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            incumbent = output.solution;
+                        }
+                        Solution* local_search_initial_solution
+                            = (incumbent.feasible())? &incumbent: nullptr;
+                        if (algorithm == PortfolioAlgorithm::LocalSearchPfssMakespan) {
+                            local_search_pfss_makespan(
+                                    instance,
+                                    algorithm_generator,
+                                    local_search_initial_solution,
+                                    local_search_parameters);
+                        } else {
+                            local_search_pfss(
+                                    instance,
+                                    algorithm_generator,
+                                    local_search_initial_solution,
+                                    local_search_parameters);
+                        }
+                    }
+                    break;
+
+                } case PortfolioAlgorithm::MilpPositional: {
+                    MilpPositionalParameters milp_parameters = parameters.milp_positional_parameters;
+                    set_algorithm_parameters(task_context.timer, &end, new_solution_callback, milp_parameters);
+                    // The MILP cannot receive new cutoffs once the solver has
+                    // started, so it waits for a first solution from the
+                    // heuristics which are running.
+                    Solution incumbent = SolutionBuilder().set_instance(instance).build();
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        while (!output.solution.feasible()
+                                && number_of_running_heuristics > 0
+                                && !milp_parameters.timer.needs_to_end()) {
+                            condition_variable.wait_for(lock, std::chrono::milliseconds(100));
+                        }
+                        incumbent = output.solution;
+                    }
+                    if (!milp_parameters.timer.needs_to_end()) {
+                        milp_positional(
+                                instance,
+                                (incumbent.feasible())? &incumbent: nullptr,
+                                milp_parameters);
+                    }
+                    break;
+                }
+                }
+            } catch (...) {
+                update_number_of_running_heuristics(-1);
+                throw;
+            }
+            update_number_of_running_heuristics(-1);
+        });
+    }
+    task_group.wait();
+
+    algorithm_formatter.end();
+    return output;
+}
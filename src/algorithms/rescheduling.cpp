@@ -0,0 +1,426 @@
+#include "shopschedulingsolver/algorithms/rescheduling.hpp"
+
+#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/instance_builder.hpp"
+
+#include <algorithm>
+
+using namespace shopschedulingsolver;
+
+UpdatedInstance shopschedulingsolver::apply_instance_delta(
+        const Solution& previous_solution,
+        const InstanceDelta& delta)
+{
+    const Instance& instance = previous_solution.instance();
+
+    // Retrieve the frozen jobs, that is, the jobs which start before the
+    // frozen time on the first machine.
+    std::vector<uint8_t> frozen(instance.number_of_jobs(), 0);
+    for (SolutionOperationId solution_operation_id: previous_solution.machine(0).solution_operations) {
+        const Solution::Operation& solution_operation = previous_solution.operation(solution_operation_id);
+        if (solution_operation.start < delta.frozen_time)
+            frozen[solution_operation.job_id] = 1;
+    }
+
+    // Check the delta.
+    std::vector<uint8_t> removed(instance.number_of_jobs(), 0);
+    for (JobId job_id: delta.removed_job_ids) {
+        if (job_id < 0 || job_id >= instance.number_of_jobs()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "invalid removed job id; "
+                    "job_id: " + std::to_string(job_id) + "; "
+                    "instance.number_of_jobs(): " + std::to_string(instance.number_of_jobs()) + ".");
+        }
+        if (frozen[job_id]) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "a frozen job cannot be removed; "
+                    "job_id: " + std::to_string(job_id) + "; "
+                    "frozen_time: " + std::to_string(delta.frozen_time) + ".");
+        }
+        removed[job_id] = 1;
+    }
+    std::vector<std::vector<Time>> processing_times(instance.number_of_jobs());
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+        const Job& job = instance.job(job_id);
+        for (const Operation& operation: job.operations)
+            processing_times[job_id].push_back(operation.alternatives[0].processing_time);
+    }
+    for (const ProcessingTimeChange& change: delta.processing_time_changes) {
+        if (change.job_id < 0 || change.job_id >= instance.number_of_jobs()
+                || change.operation_id < 0
+                || change.operation_id >= (OperationId)instance.job(change.job_id).operations.size()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "invalid operation of a processing time change; "
+                    "job_id: " + std::to_string(change.job_id) + "; "
+                    "operation_id: " + std::to_string(change.operation_id) + ".");
+        }
+        if (instance.job(change.job_id).operations[change.operation_id].alternatives.size() != 1) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "processing time changes of operations with several alternatives are not supported; "
+                    "job_id: " + std::to_string(change.job_id) + "; "
+                    "operation_id: " + std::to_string(change.operation_id) + ".");
+        }
+        if (frozen[change.job_id]) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "the processing times of a frozen job cannot change; "
+                    "job_id: " + std::to_string(change.job_id) + "; "
+                    "operation_id: " + std::to_string(change.operation_id) + "; "
+                    "frozen_time: " + std::to_string(delta.frozen_time) + ".");
+        }
+        processing_times[change.job_id][change.operation_id] = change.processing_time;
+    }
+    for (const NewJob& new_job: delta.new_jobs) {
+        if ((MachineId)new_job.processing_times.size() != instance.number_of_machines()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "a new job must have one processing time per machine; "
+                    "new_job.processing_times.size(): " + std::to_string(new_job.processing_times.size()) + "; "
+                    "instance.number_of_machines(): " + std::to_string(instance.number_of_machines()) + ".");
+        }
+    }
+
+    // Build the new instance.
+    InstanceBuilder instance_builder;
+    instance_builder.set_objective(instance.objective());
+    instance_builder.set_operations_arbitrary_order(instance.operations_arbitrary_order());
+    instance_builder.set_no_wait(instance.no_wait());
+    instance_builder.set_blocking(instance.blocking());
+    instance_builder.set_permutation(instance.permutation());
+    instance_builder.set_number_of_machines(instance.number_of_machines());
+    for (MachineId machine_id = 0;
+            machine_id < instance.number_of_machines();
+            ++machine_id) {
+        if (instance.machine(machine_id).no_idle)
+            instance_builder.set_machine_no_idle(machine_id);
+        instance_builder.set_machine_availability_time(
+                machine_id,
+                instance.machine(machine_id).availability_time);
+    }
+
+    std::vector<JobId> job_ids(instance.number_of_jobs(), -1);
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+        if (removed[job_id])
+            continue;
+        const Job& job = instance.job(job_id);
+        JobId new_job_id = instance_builder.add_job();
+        job_ids[job_id] = new_job_id;
+        for (OperationId operation_id = 0;
+                operation_id < (OperationId)job.operations.size();
+                ++operation_id) {
+            const Operation& operation = job.operations[operation_id];
+            instance_builder.add_operation(new_job_id);
+            for (const Alternative& alternative: operation.alternatives) {
+                Time processing_time = (operation.alternatives.size() == 1)?
+                    processing_times[job_id][operation_id]:
+                    alternative.processing_time;
+                instance_builder.add_alternative(
+                        new_job_id,
+                        operation_id,
+                        alternative.machine_id,
+                        processing_time);
+            }
+            if (operation.fixed_start != -1) {
+                instance_builder.fix_operation(
+                        new_job_id,
+                        operation_id,
+                        operation.fixed_alternative_id,
+                        operation.fixed_start);
+            }
+        }
+        // The jobs which are not frozen have not started yet.
+        instance_builder.set_job_release_date(
+                new_job_id,
+                (frozen[job_id])?
+                job.release_date:
+                (std::max)(job.release_date, delta.frozen_time));
+        if (job.due_date >= 0)
+            instance_builder.set_job_due_date(new_job_id, job.due_date);
+        instance_builder.set_job_weight(new_job_id, job.weight);
+    }
+    for (const NewJob& new_job: delta.new_jobs) {
+        JobId new_job_id = instance_builder.add_job();
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            OperationId operation_id = instance_builder.add_operation(new_job_id);
+            instance_builder.add_alternative(
+                    new_job_id,
+                    operation_id,
+                    machine_id,
+                    new_job.processing_times[machine_id]);
+        }
+        instance_builder.set_job_release_date(
+                new_job_id,
+                (std::max)(new_job.release_date, delta.frozen_time));
+        if (new_job.due_date >= 0)
+            instance_builder.set_job_due_date(new_job_id, new_job.due_date);
+        instance_builder.set_job_weight(new_job_id, new_job.weight);
+    }
+    return {instance_builder.build(), job_ids};
+}
+
+namespace
+{
+
+/**
+ * Build the instance of the jobs which are not frozen.
+ *
+ * The frozen jobs are replaced by machine availability times equal to their
+ * completion times and to the frozen time. The release dates which are not
+ * later than the availability time of the first machine are not binding and
+ * are dropped, since 'local_search_pfss_makespan' doesn't support them.
+ */
+Instance build_free_instance(
+        const Instance& instance,
+        const std::vector<Time>& machines_availability_times,
+        const std::vector<JobId>& free_job_ids)
+{
+    InstanceBuilder instance_builder;
+    instance_builder.set_objective(instance.objective());
+    instance_builder.set_permutation(instance.permutation());
+    instance_builder.set_number_of_machines(instance.number_of_machines());
+    for (MachineId machine_id = 0;
+            machine_id < instance.number_of_machines();
+            ++machine_id) {
+        instance_builder.set_machine_availability_time(
+                machine_id,
+                machines_availability_times[machine_id]);
+    }
+    for (JobId job_id: free_job_ids) {
+        const Job& job = instance.job(job_id);
+        JobId free_job_id = instance_builder.add_job();
+        for (const Operation& operation: job.operations) {
+            const Alternative& alternative = operation.alternatives[0];
+            OperationId operation_id = instance_builder.add_operation(free_job_id);
+            instance_builder.add_alternative(
+                    free_job_id,
+                    operation_id,
+                    alternative.machine_id,
+                    alternative.processing_time);
+        }
+        if (job.release_date > machines_availability_times[0])
+            instance_builder.set_job_release_date(free_job_id, job.release_date);
+        if (job.due_date >= 0)
+            instance_builder.set_job_due_date(free_job_id, job.due_date);
+        instance_builder.set_job_weight(free_job_id, job.weight);
+    }
+    return instance_builder.build();
+}
+
+/**
+ * Build the solution of the updated instance from the starts of the frozen
+ * operations in the previous solution and from a solution of the instance of
+ * the jobs which are not frozen.
+ */
+Solution build_solution(
+        const Instance& instance,
+        const Solution& previous_solution,
+        const std::vector<JobId>& job_ids,
+        const std::vector<JobId>& frozen_job_ids,
+        const std::vector<JobId>& free_job_ids,
+        const Solution& free_solution)
+{
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    for (JobId previous_job_id: frozen_job_ids) {
+        for (SolutionOperationId solution_operation_id: previous_solution.job(previous_job_id).operations) {
+            const Solution::Operation& solution_operation = previous_solution.operation(solution_operation_id);
+            solution_builder.append_operation(
+                    job_ids[previous_job_id],
+                    solution_operation.operation_id,
+                    solution_operation.alternative_id,
+                    solution_operation.start);
+        }
+    }
+    for (JobId free_job_id = 0;
+            free_job_id < (JobId)free_job_ids.size();
+            ++free_job_id) {
+        for (SolutionOperationId solution_operation_id: free_solution.job(free_job_id).operations) {
+            const Solution::Operation& solution_operation = free_solution.operation(solution_operation_id);
+            solution_builder.append_operation(
+                    free_job_ids[free_job_id],
+                    solution_operation.operation_id,
+                    solution_operation.alternative_id,
+                    solution_operation.start);
+        }
+    }
+    solution_builder.sort_machines();
+    solution_builder.sort_jobs();
+    return solution_builder.build();
+}
+
+}
+
+const ReschedulingOutput shopschedulingsolver::reschedule(
+        const Solution& previous_solution,
+        const InstanceDelta& delta,
+        const UpdatedInstance& updated_instance,
+        std::mt19937_64& generator,
+        const ReschedulingParameters& parameters)
+{
+    const Instance& previous_instance = previous_solution.instance();
+    const Instance& instance = updated_instance.instance;
+    ReschedulingOutput output(instance);
+    AlgorithmFormatter algorithm_formatter(instance, parameters, output);
+    algorithm_formatter.start("Rescheduling");
+
+    if ((JobId)updated_instance.job_ids.size() != previous_instance.number_of_jobs()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the updated instance does not correspond to the previous solution; "
+                "updated_instance.job_ids.size(): " + std::to_string(updated_instance.job_ids.size()) + "; "
+                "previous_instance.number_of_jobs(): " + std::to_string(previous_instance.number_of_jobs()) + ".");
+    }
+    if (!instance.flow_shop() || instance.flexible()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the instance must be a flow shop.");
+    }
+    if (instance.no_wait() || instance.blocking() || instance.mixed_no_idle()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": no-wait, blocking and no-idle are not supported.");
+    }
+    if (instance.number_of_fixed_operations() > 0) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations are not supported; "
+                "the executed jobs are frozen through the frozen time of the delta.");
+    }
+    if (instance.objective() != Objective::Makespan
+            && instance.objective() != Objective::TotalFlowTime
+            && instance.objective() != Objective::TotalTardiness) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": unsupported objective; "
+                "only Makespan, TotalFlowTime and TotalTardiness are supported.");
+    }
+
+    // Retrieve the sequence of the previous solution, that is, the order of
+    // the jobs on the first machine, and its frozen jobs.
+    std::vector<uint8_t> frozen(instance.number_of_jobs(), 0);
+    std::vector<JobId> frozen_job_ids;
+    std::vector<JobId> sequence;
+    for (SolutionOperationId solution_operation_id: previous_solution.machine(0).solution_operations) {
+        const Solution::Operation& solution_operation = previous_solution.operation(solution_operation_id);
+        JobId job_id = updated_instance.job_ids[solution_operation.job_id];
+        if (solution_operation.start < delta.frozen_time) {
+            if (job_id == -1) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "a frozen job cannot be removed; "
+                        "job_id: " + std::to_string(solution_operation.job_id) + "; "
+                        "start: " + std::to_string(solution_operation.start) + "; "
+                        "frozen_time: " + std::to_string(delta.frozen_time) + ".");
+            }
+            frozen[job_id] = 1;
+            frozen_job_ids.push_back(solution_operation.job_id);
+            output.number_of_frozen_jobs++;
+        } else if (job_id != -1
+                && parameters.warm_start == ReschedulingWarmStart::PreviousSequence) {
+            sequence.push_back(job_id);
+        }
+    }
+    output.number_of_inserted_jobs = instance.number_of_jobs()
+        - output.number_of_frozen_jobs
+        - sequence.size();
+
+    // The frozen operations keep their starts in the previous solution; the
+    // other operations start after them and after the frozen time.
+    std::vector<Time> machines_availability_times(instance.number_of_machines());
+    for (MachineId machine_id = 0;
+            machine_id < instance.number_of_machines();
+            ++machine_id) {
+        machines_availability_times[machine_id] = (std::max)(
+                instance.machine(machine_id).availability_time,
+                delta.frozen_time);
+    }
+    for (JobId previous_job_id: frozen_job_ids) {
+        const Job& job = instance.job(updated_instance.job_ids[previous_job_id]);
+        for (SolutionOperationId solution_operation_id: previous_solution.job(previous_job_id).operations) {
+            const Solution::Operation& solution_operation = previous_solution.operation(solution_operation_id);
+            const Alternative& alternative = job.operations[solution_operation.operation_id].alternatives[0];
+            machines_availability_times[alternative.machine_id] = (std::max)(
+                    machines_availability_times[alternative.machine_id],
+                    solution_operation.start + alternative.processing_time);
+        }
+    }
+    std::vector<JobId> free_job_ids;
+    std::vector<JobId> free_job_positions(instance.number_of_jobs(), -1);
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+        if (frozen[job_id])
+            continue;
+        free_job_positions[job_id] = free_job_ids.size();
+        free_job_ids.push_back(job_id);
+    }
+    const Instance free_instance = build_free_instance(
+            instance,
+            machines_availability_times,
+            free_job_ids);
+
+    algorithm_formatter.print_header();
+
+    // Run the local search from the partial solution; it inserts the missing
+    // jobs at their best positions.
+    std::vector<JobId> free_sequence;
+    for (JobId job_id: sequence)
+        free_sequence.push_back(free_job_positions[job_id]);
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(free_instance);
+    solution_builder.from_permutation(free_sequence);
+    Solution initial_solution = solution_builder.build();
+
+    if (free_instance.number_of_jobs() == 0) {
+        algorithm_formatter.update_solution(
+                build_solution(
+                    instance,
+                    previous_solution,
+                    updated_instance.job_ids,
+                    frozen_job_ids,
+                    free_job_ids,
+                    initial_solution),
+                "frozen jobs");
+        algorithm_formatter.end();
+        return output;
+    }
+
+    LocalSearchPfssParameters local_search_parameters = parameters.local_search_parameters;
+    local_search_parameters.timer = parameters.timer;
+    local_search_parameters.verbosity_level = 0;
+    local_search_parameters.log_path = "";
+    local_search_parameters.log_to_stderr = false;
+    local_search_parameters.messages_to_stdout = false;
+    local_search_parameters.new_solution_callback = [&](
+            const Output& local_search_output)
+    {
+        algorithm_formatter.update_solution(
+                build_solution(
+                    instance,
+                    previous_solution,
+                    updated_instance.job_ids,
+                    frozen_job_ids,
+                    free_job_ids,
+                    local_search_output.solution),
+                "local search");
+    };
+    local_search_parameters.end_callback = [](const Output&) { };
+    local_search_parameters.number_of_frozen_jobs = 0;
+    if (instance.objective() == Objective::Makespan) {
+        local_search_pfss_makespan(
+                free_instance,
+                generator,
+                &initial_solution,
+                local_search_parameters);
+    } else {
+        local_search_pfss(
+                free_instance,
+                generator,
+                &initial_solution,
+                local_search_parameters);
+    }
+
+    algorithm_formatter.end();
+    return output;
+}
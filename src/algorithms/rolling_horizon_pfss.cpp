@@ -0,0 +1,433 @@
+#include "shopschedulingsolver/algorithms/rolling_horizon_pfss.hpp"
+
+#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/instance_builder.hpp"
+
+#include <memory>
+#include <numeric>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+// Set the parameters left to automatic and check the others.
+RollingHorizonPfssParameters resolve_parameters(
+        const RollingHorizonPfssParameters& parameters)
+{
+    RollingHorizonPfssParameters resolved_parameters = parameters;
+
+    if (resolved_parameters.window_size < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "'window_size' must be positive; "
+                "window_size: " + std::to_string(resolved_parameters.window_size) + ".");
+    }
+    if (resolved_parameters.window_step < 1
+            || resolved_parameters.window_step > resolved_parameters.window_size) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "'window_step' must be in [1, window_size]; "
+                "window_step: " + std::to_string(resolved_parameters.window_step) + "; "
+                "window_size: " + std::to_string(resolved_parameters.window_size) + ".");
+    }
+    if (resolved_parameters.number_of_threads < 1) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "'number_of_threads' must be positive; "
+                "number_of_threads: " + std::to_string(resolved_parameters.number_of_threads) + ".");
+    }
+
+    LocalSearchPfssParameters& local_search_parameters = resolved_parameters.local_search_parameters;
+    if (local_search_parameters.maximum_number_of_iterations_without_improvement < 0) {
+        local_search_parameters.maximum_number_of_iterations_without_improvement
+            = resolved_parameters.window_maximum_number_of_iterations_without_improvement;
+    }
+    local_search_parameters.verbosity_level = 0;
+    local_search_parameters.log_path = "";
+    local_search_parameters.log_to_stderr = false;
+    local_search_parameters.messages_to_stdout = false;
+    local_search_parameters.new_solution_callback = [](const Output&) { };
+    local_search_parameters.end_callback = [](const Output&) { };
+
+    return resolved_parameters;
+}
+
+// Update the completion times of the last scheduled operation of each machine
+// when a job is appended to a partial sequence.
+void append_job(
+        const Instance& instance,
+        JobId job_id,
+        std::vector<Time>& completion_times)
+{
+    const Job& job = instance.job(job_id);
+    Time time = job.release_date;
+    for (const Operation& operation: job.operations) {
+        const Alternative& alternative = operation.alternatives[0];
+        time = (std::max)(time, completion_times[alternative.machine_id])
+            + alternative.processing_time;
+        completion_times[alternative.machine_id] = time;
+    }
+}
+
+// Build the solution of a sequence of the jobs which are not fixed. The fixed
+// jobs are scheduled first.
+Solution build_solution(
+        const Instance& instance,
+        const std::vector<JobId>& sequence)
+{
+    std::vector<JobId> job_ids = instance.fixed_jobs();
+    job_ids.insert(job_ids.end(), sequence.begin(), sequence.end());
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.from_permutation(job_ids);
+    return solution_builder.build();
+}
+
+// Return the completion times of the last scheduled operation of each machine
+// before the jobs which are not fixed, that is, after the availability times
+// of the machines and the fixed jobs.
+std::vector<Time> initial_completion_times(
+        const Instance& instance)
+{
+    std::vector<Time> completion_times(instance.number_of_machines(), 0);
+    for (MachineId machine_id = 0;
+            machine_id < instance.number_of_machines();
+            ++machine_id) {
+        completion_times[machine_id] = instance.machine(machine_id).availability_time;
+    }
+    for (JobId job_id: instance.fixed_jobs()) {
+        for (const Operation& operation: instance.job(job_id).operations) {
+            const Alternative& alternative = operation.alternatives[0];
+            completion_times[alternative.machine_id]
+                = operation.fixed_start + alternative.processing_time;
+        }
+    }
+    return completion_times;
+}
+
+/**
+ * Sequence the jobs of a window after a partial sequence.
+ *
+ * The partial sequence is replaced by machine availability times equal to
+ * the given completion times.
+ *
+ * Return the jobs of the window in their new order.
+ */
+std::vector<JobId> solve_window(
+        const Instance& instance,
+        const std::vector<Time>& completion_times,
+        const std::vector<JobId>& job_ids,
+        std::mt19937_64& generator,
+        const RollingHorizonPfssParameters& parameters)
+{
+    if (job_ids.size() <= 1)
+        return job_ids;
+
+    InstanceBuilder instance_builder;
+    instance_builder.set_objective(instance.objective());
+    instance_builder.set_permutation(instance.permutation());
+    instance_builder.set_number_of_machines(instance.number_of_machines());
+
+    for (MachineId machine_id = 0;
+            machine_id < instance.number_of_machines();
+            ++machine_id) {
+        instance_builder.set_machine_availability_time(
+                machine_id,
+                completion_times[machine_id]);
+    }
+    for (JobId job_id: job_ids) {
+        const Job& job = instance.job(job_id);
+        JobId window_job_id = instance_builder.add_job();
+        for (const Operation& operation: job.operations) {
+            const Alternative& alternative = operation.alternatives[0];
+            OperationId operation_id = instance_builder.add_operation(window_job_id);
+            instance_builder.add_alternative(
+                    window_job_id,
+                    operation_id,
+                    alternative.machine_id,
+                    alternative.processing_time);
+        }
+        instance_builder.set_job_release_date(window_job_id, job.release_date);
+        if (job.due_date >= 0)
+            instance_builder.set_job_due_date(window_job_id, job.due_date);
+        instance_builder.set_job_weight(window_job_id, job.weight);
+    }
+    const Instance window_instance = instance_builder.build();
+
+    std::vector<JobId> window_sequence(window_instance.number_of_jobs());
+    std::iota(window_sequence.begin(), window_sequence.end(), 0);
+    Solution initial_solution = build_solution(window_instance, window_sequence);
+
+    LocalSearchPfssParameters local_search_parameters = parameters.local_search_parameters;
+    local_search_parameters.timer = parameters.timer;
+    if (parameters.window_time_limit >= 0) {
+        local_search_parameters.timer.set_time_limit(
+                local_search_parameters.timer.elapsed_time()
+                + (std::min)(
+                    local_search_parameters.timer.remaining_time(),
+                    parameters.window_time_limit));
+    }
+    Solution solution = (instance.objective() == Objective::Makespan)?
+        local_search_pfss_makespan(
+                window_instance,
+                generator,
+                &initial_solution,
+                local_search_parameters).solution:
+        local_search_pfss(
+                window_instance,
+                generator,
+                &initial_solution,
+                local_search_parameters).solution;
+    if (!solution.feasible())
+        return job_ids;
+
+    std::vector<JobId> sequence;
+    for (SolutionOperationId solution_operation_id: solution.machine(0).solution_operations) {
+        JobId window_job_id = solution.operation(solution_operation_id).job_id;
+        sequence.push_back(job_ids[window_job_id]);
+    }
+    return sequence;
+}
+
+/**
+ * Sequence the jobs of a segment of the initial order with a rolling horizon,
+ * after a partial sequence ending at the given completion times.
+ *
+ * Once the end of the algorithm is reached, the remaining jobs are appended
+ * in their initial order.
+ */
+std::vector<JobId> rolling_horizon(
+        const Instance& instance,
+        std::vector<Time> completion_times,
+        const std::vector<JobId>& segment,
+        std::mt19937_64& generator,
+        const RollingHorizonPfssParameters& parameters,
+        Counter& number_of_windows)
+{
+    std::vector<JobId> sequence;
+    std::vector<JobId> window;
+    JobId pos = 0;
+    for (;;) {
+        while ((JobId)window.size() < parameters.window_size
+                && pos < (JobId)segment.size()) {
+            window.push_back(segment[pos]);
+            pos++;
+        }
+        if (window.empty())
+            break;
+
+        if (!parameters.timer.needs_to_end()) {
+            window = solve_window(
+                    instance,
+                    completion_times,
+                    window,
+                    generator,
+                    parameters);
+            number_of_windows++;
+        }
+
+        // Commit the first jobs of the window; all of them for the last one.
+        JobId number_of_committed_jobs = (pos == (JobId)segment.size())?
+            window.size():
+            parameters.window_step;
+        for (JobId window_pos = 0;
+                window_pos < number_of_committed_jobs;
+                ++window_pos) {
+            sequence.push_back(window[window_pos]);
+            append_job(instance, window[window_pos], completion_times);
+        }
+        window.erase(window.begin(), window.begin() + number_of_committed_jobs);
+    }
+    return sequence;
+}
+
+}
+
+const RollingHorizonPfssOutput shopschedulingsolver::rolling_horizon_pfss(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        const RollingHorizonPfssParameters& input_parameters)
+{
+    const RollingHorizonPfssParameters parameters = resolve_parameters(input_parameters);
+    RollingHorizonPfssOutput output(instance);
+    AlgorithmFormatter algorithm_formatter(instance, parameters, output);
+    algorithm_formatter.start("Rolling horizon");
+
+    if (!instance.flow_shop() || instance.flexible()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": the instance must be a flow shop.");
+    }
+    if (instance.no_wait() || instance.blocking() || instance.mixed_no_idle()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": no-wait, blocking and no-idle are not supported.");
+    }
+    // The fixed jobs are scheduled first; the windows start after them.
+    if (!instance.fixed_prefix()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations and machine availability times are only "
+                "supported when the fixed jobs are processed first in the same "
+                "order on all the machines.");
+    }
+    if (instance.objective() != Objective::Makespan
+            && instance.objective() != Objective::TotalFlowTime
+            && instance.objective() != Objective::TotalTardiness) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": unsupported objective; "
+                "only Makespan, TotalFlowTime and TotalTardiness are supported.");
+    }
+    // The windows are solved with 'local_search_pfss_makespan' for the
+    // makespan, which doesn't support release dates.
+    if (instance.objective() == Objective::Makespan) {
+        for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+            if (instance.job(job_id).release_date != 0) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "release dates are not supported with the Makespan objective.");
+            }
+        }
+    }
+
+    algorithm_formatter.print_header();
+
+    // Initial order.
+    std::vector<Time> total_processing_times(instance.number_of_jobs(), 0);
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+        for (const Operation& operation: instance.job(job_id).operations)
+            total_processing_times[job_id] += operation.alternatives[0].processing_time;
+    std::vector<JobId> order;
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+        if (!instance.job(job_id).fixed)
+            order.push_back(job_id);
+    switch (parameters.initial_order) {
+    case RollingHorizonOrder::ReleaseDates: {
+        std::stable_sort(
+                order.begin(),
+                order.end(),
+                [&instance](JobId job_id_1, JobId job_id_2)
+                {
+                    return instance.job(job_id_1).release_date
+                        < instance.job(job_id_2).release_date;
+                });
+        break;
+    } case RollingHorizonOrder::DecreasingTotalProcessingTime: {
+        std::stable_sort(
+                order.begin(),
+                order.end(),
+                [&total_processing_times](JobId job_id_1, JobId job_id_2)
+                {
+                    return total_processing_times[job_id_1]
+                        > total_processing_times[job_id_2];
+                });
+        break;
+    }
+    }
+    algorithm_formatter.update_solution(
+            build_solution(instance, order),
+            "initial order");
+
+    // Split the initial order into segments, and compute the completion times
+    // of the initial order before each of them.
+    JobId number_of_jobs = order.size();
+    Counter number_of_segments = (std::min)(
+            parameters.number_of_threads,
+            (Counter)((number_of_jobs + parameters.window_size - 1) / parameters.window_size));
+    number_of_segments = (std::max)(number_of_segments, (Counter)1);
+    output.number_of_segments = number_of_segments;
+    std::vector<JobId> segments_starts(number_of_segments + 1);
+    for (Counter segment_id = 0; segment_id <= number_of_segments; ++segment_id)
+        segments_starts[segment_id] = number_of_jobs * segment_id / number_of_segments;
+    std::vector<std::vector<JobId>> segments(number_of_segments);
+    std::vector<std::vector<Time>> segments_completion_times(number_of_segments);
+    std::vector<Time> completion_times = initial_completion_times(instance);
+    for (Counter segment_id = 0; segment_id < number_of_segments; ++segment_id) {
+        segments_completion_times[segment_id] = completion_times;
+        for (JobId pos = segments_starts[segment_id];
+                pos < segments_starts[segment_id + 1];
+                ++pos) {
+            segments[segment_id].push_back(order[pos]);
+            append_job(instance, order[pos], completion_times);
+        }
+    }
+
+    // Sequence the segments. A segment skipped because the time limit has
+    // been reached keeps its initial order.
+    std::vector<std::vector<JobId>> segments_sequences = segments;
+    std::vector<Counter> segments_numbers_of_windows(number_of_segments, 0);
+    std::unique_ptr<ThreadPool> local_thread_pool;
+    if (parameters.thread_pool == nullptr)
+        local_thread_pool.reset(new ThreadPool(number_of_segments - 1));
+    ThreadPool& thread_pool = (parameters.thread_pool != nullptr)?
+        *parameters.thread_pool:
+        *local_thread_pool;
+    TaskGroup task_group(thread_pool, generator, parameters.timer);
+    for (Counter segment_id = 0; segment_id < number_of_segments; ++segment_id) {
+        task_group.run([&, segment_id](TaskContext& task_context)
+        {
+            RollingHorizonPfssParameters segment_parameters = parameters;
+            segment_parameters.timer = task_context.timer;
+            if (segment_parameters.local_search_parameters.thread_pool == nullptr)
+                segment_parameters.local_search_parameters.thread_pool = &thread_pool;
+            segments_sequences[segment_id] = rolling_horizon(
+                    instance,
+                    segments_completion_times[segment_id],
+                    segments[segment_id],
+                    task_context.generator,
+                    segment_parameters,
+                    segments_numbers_of_windows[segment_id]);
+        });
+    }
+    task_group.wait();
+
+    std::vector<JobId> sequence;
+    for (Counter segment_id = 0; segment_id < number_of_segments; ++segment_id) {
+        output.number_of_windows += segments_numbers_of_windows[segment_id];
+        sequence.insert(
+                sequence.end(),
+                segments_sequences[segment_id].begin(),
+                segments_sequences[segment_id].end());
+    }
+    Solution solution = build_solution(instance, sequence);
+    algorithm_formatter.update_solution(solution, "segments");
+
+    // Solve again the windows around the boundaries between the segments,
+    // from the actual completion times.
+    for (Counter segment_id = 1; segment_id < number_of_segments; ++segment_id) {
+        if (parameters.timer.needs_to_end())
+            break;
+        JobId window_start = (std::max)(
+                (JobId)0,
+                segments_starts[segment_id] - parameters.window_size / 2);
+        JobId window_end = (std::min)(
+                number_of_jobs,
+                window_start + parameters.window_size);
+        completion_times = initial_completion_times(instance);
+        for (JobId pos = 0; pos < window_start; ++pos)
+            append_job(instance, sequence[pos], completion_times);
+        std::vector<JobId> window(
+                sequence.begin() + window_start,
+                sequence.begin() + window_end);
+        window = solve_window(
+                instance,
+                completion_times,
+                window,
+                generator,
+                parameters);
+        output.number_of_windows++;
+
+        std::vector<JobId> new_sequence = sequence;
+        std::copy(window.begin(), window.end(), new_sequence.begin() + window_start);
+        Solution new_solution = build_solution(instance, new_sequence);
+        if (new_solution.strictly_better(solution)) {
+            sequence.swap(new_sequence);
+            solution = new_solution;
+            algorithm_formatter.update_solution(
+                    solution,
+                    "boundary " + std::to_string(segment_id));
+        }
+    }
+
+    algorithm_formatter.end();
+    return output;
+}
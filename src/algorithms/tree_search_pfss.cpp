@@ -10,11 +10,15 @@
  *   - 3: total completion time and weighted idle time (TFT)
  *   - 4: total tardiness, total earliness and weighted idle time
  *        (default for TotalTardiness; Fernandez-Viagas et al., 2018)
+ *
+ * Job weights and release dates are taken into account: the objectives are
+ * the total weighted flow time and the total weighted tardiness.
  */
 
 #include "shopschedulingsolver/algorithms/tree_search_pfss.hpp"
 
 #include "shopschedulingsolver/solution_builder.hpp"
+#include "shopschedulingsolver/profiler.hpp"
 
 #include "treesearchsolver/iterative_beam_search_2.hpp"
 
@@ -57,10 +61,19 @@ public:
         /** Machines. */
         std::vector<NodeMachine> machines;
 
-        /** Total completion time of the partial solution. */
+        /** Total (weighted) flow time of the partial solution. */
         Time total_completion_time = 0;
 
-        /** Total tardiness of the scheduled jobs. */
+        /** Total weight of the unscheduled jobs. */
+        Time unscheduled_weight = 0;
+
+        /**
+         * Sum over the unscheduled jobs of their weight times their
+         * processing time on the last machine minus their release date.
+         */
+        Time unscheduled_weighted_offset = 0;
+
+        /** Total (weighted) tardiness of the scheduled jobs. */
         Time total_tardiness_scheduled = 0;
 
         /** Lower bound on the tardiness of the unscheduled jobs. */
@@ -72,11 +85,11 @@ public:
         /** Index in sorted_jobs_ up to which due dates are < machines[last].time. */
         JobId due_date_pos = 0;
 
-        /** Number of unscheduled jobs with due date < machines[last].time. */
-        JobId number_of_late_unscheduled = 0;
+        /** Total weight of the unscheduled jobs with due date < machines[last].time. */
+        Time late_unscheduled_weight = 0;
 
-        /** Sum of due dates of those jobs. */
-        Time sum_late_unscheduled_due_dates = 0;
+        /** Sum of the weighted due dates of those jobs. */
+        Time sum_late_unscheduled_weighted_due_dates = 0;
 
         /** Total earliness of the partial solution. */
         Time total_earliness = 0;
@@ -136,12 +149,76 @@ public:
         r->available_jobs.resize(instance_.number_of_jobs(), true);
         r->machines.resize(instance_.number_of_machines());
         r->bound = 0;
-        if (instance_.objective() == Objective::TotalFlowTime) {
-            for (JobId job_id = 0; job_id < instance_.number_of_jobs(); ++job_id) {
-                const Job& job = instance_.job(job_id);
-                MachineId machine_id = instance_.number_of_machines() - 1;
-                r->bound += job.operations[machine_id].alternatives[0].processing_time;
+        MachineId last_machine_id = instance_.number_of_machines() - 1;
+
+        // The partial solution of the root is made of the fixed jobs, after
+        // the availability times of the machines.
+        for (MachineId machine_id = 0;
+                machine_id < instance_.number_of_machines();
+                ++machine_id) {
+            r->machines[machine_id].time = instance_.machine(machine_id).availability_time;
+        }
+        for (JobId job_id: instance_.fixed_jobs()) {
+            const Job& job = instance_.job(job_id);
+            r->available_jobs[job_id] = false;
+            r->number_of_jobs++;
+            for (MachineId machine_id = 0;
+                    machine_id < instance_.number_of_machines();
+                    ++machine_id) {
+                const Operation& operation = job.operations[machine_id];
+                r->machines[machine_id].time
+                    = operation.fixed_start + operation.alternatives[0].processing_time;
+            }
+            Time completion_time = r->machines[last_machine_id].time;
+            r->total_completion_time += job.weight * (completion_time - job.release_date);
+            if (job.due_date >= 0) {
+                r->total_tardiness_scheduled += job.weight
+                    * std::max((Time)0, completion_time - job.due_date);
+                r->total_earliness += job.weight
+                    * std::max((Time)0, job.due_date - completion_time);
+            }
+        }
+
+        for (JobId job_id = 0; job_id < instance_.number_of_jobs(); ++job_id) {
+            if (!r->available_jobs[job_id])
+                continue;
+            const Job& job = instance_.job(job_id);
+            r->unscheduled_weight += job.weight;
+            r->unscheduled_weighted_offset += job.weight
+                * (job.operations[last_machine_id].alternatives[0].processing_time
+                        - job.release_date);
+        }
+
+        // Unscheduled jobs already late at the root.
+        Time time = r->machines[last_machine_id].time;
+        while (r->due_date_pos < (JobId)sorted_jobs_.size()
+                && sorted_jobs_[r->due_date_pos].first < time) {
+            JobId job_id = sorted_jobs_[r->due_date_pos].second;
+            if (r->available_jobs[job_id]) {
+                Time weight = instance_.job(job_id).weight;
+                r->late_unscheduled_weight += weight;
+                r->sum_late_unscheduled_weighted_due_dates
+                    += weight * sorted_jobs_[r->due_date_pos].first;
             }
+            r->due_date_pos++;
+        }
+        r->total_tardiness_unscheduled = r->late_unscheduled_weight * time
+            - r->sum_late_unscheduled_weighted_due_dates;
+        r->total_tardiness = r->total_tardiness_scheduled + r->total_tardiness_unscheduled;
+
+        switch (instance_.objective()) {
+        case Objective::TotalFlowTime: {
+            r->bound = r->total_completion_time
+                + r->unscheduled_weight * time
+                + r->unscheduled_weighted_offset;
+            break;
+        }
+        case Objective::TotalTardiness: {
+            r->bound = r->total_tardiness;
+            break;
+        }
+        default:
+            r->bound = 0;
         }
         return r;
     }
@@ -155,7 +232,7 @@ public:
         node->available_jobs[node->job_id] = false;
         node->machines.resize(instance_.number_of_machines());
         if (!instance_.blocking()) {
-            Time t_prec = 0;
+            Time t_prec = job.release_date;
             for (MachineId machine_id = 0;
                     machine_id < instance_.number_of_machines();
                     ++machine_id) {
@@ -175,18 +252,20 @@ public:
         } else {
             MachineId last_machine_id = instance_.number_of_machines() - 1;
             Time p0 = job.operations[0].alternatives[0].processing_time;
+            Time start0 = std::max(parent->machines[0].time, job.release_date);
+            Time idle_time_0 = parent->machines[0].idle_time
+                + (start0 - parent->machines[0].time);
             if (last_machine_id == 0) {
-                node->machines[0].time = parent->machines[0].time + p0;
-                node->machines[0].idle_time = parent->machines[0].idle_time;
-            } else if (parent->machines[0].time + p0 > parent->machines[1].time) {
-                node->machines[0].time = parent->machines[0].time + p0;
-                node->machines[0].idle_time = parent->machines[0].idle_time;
+                node->machines[0].time = start0 + p0;
+                node->machines[0].idle_time = idle_time_0;
+            } else if (start0 + p0 > parent->machines[1].time) {
+                node->machines[0].time = start0 + p0;
+                node->machines[0].idle_time = idle_time_0;
             } else {
                 Time idle_time = parent->machines[1].time
-                    - parent->machines[0].time - p0;
+                    - start0 - p0;
                 node->machines[0].time = parent->machines[1].time;
-                node->machines[0].idle_time =
-                    parent->machines[0].idle_time + idle_time;
+                node->machines[0].idle_time = idle_time_0 + idle_time;
             }
             for (MachineId machine_id = 1;
                     machine_id < last_machine_id;
@@ -224,6 +303,7 @@ public:
     inline std::vector<std::shared_ptr<Node>> children(
             const std::shared_ptr<Node>& parent) const
     {
+        SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("TreeSearchPfss/Children");
         // Compute parent's structures if needed.
         if (parent->machines.empty())
             compute_structures(parent);
@@ -247,7 +327,7 @@ public:
             child->number_of_jobs = parent->number_of_jobs + 1;
             child->idle_time = parent->idle_time;
 
-            Time t_prec = 0;
+            Time t_prec = job_next.release_date;
             double ti_job = 0.0;
 
             if (!instance_.blocking()) {
@@ -277,14 +357,20 @@ public:
                 MachineId last_machine_id = instance_.number_of_machines() - 1;
                 Time p0 = job_next.operations[0].alternatives[0].processing_time;
                 Time machine_idle_time_0 = parent->machines[0].idle_time;
+                Time start0 = std::max(parent->machines[0].time, job_next.release_date);
+                if (start0 > parent->machines[0].time) {
+                    Time idle_time = start0 - parent->machines[0].time;
+                    machine_idle_time_0 += idle_time;
+                    child->idle_time += idle_time;
+                }
                 if (last_machine_id == 0) {
-                    t_prec = parent->machines[0].time + p0;
-                } else if (parent->machines[0].time + p0
+                    t_prec = start0 + p0;
+                } else if (start0 + p0
                         > parent->machines[1].time) {
-                    t_prec = parent->machines[0].time + p0;
+                    t_prec = start0 + p0;
                 } else {
                     Time idle_time = parent->machines[1].time
-                        - parent->machines[0].time - p0;
+                        - start0 - p0;
                     machine_idle_time_0 += idle_time;
                     child->idle_time += idle_time;
                     t_prec = parent->machines[1].time;
@@ -322,54 +408,63 @@ public:
                 }
             }
 
-            child->total_completion_time = parent->total_completion_time + t_prec;
+            // Bound
+            MachineId last_machine_id = instance_.number_of_machines() - 1;
+
+            Time weight = job_next.weight;
+            child->total_completion_time = parent->total_completion_time
+                + weight * (t_prec - job_next.release_date);
+            child->unscheduled_weight = parent->unscheduled_weight - weight;
+            child->unscheduled_weighted_offset = parent->unscheduled_weighted_offset
+                - weight * (job_next.operations[last_machine_id].alternatives[0].processing_time
+                        - job_next.release_date);
             child->weighted_idle_time_tt = parent->weighted_idle_time_tt + ti_job;
 
             // TT / TE
             Time due_date = job_next.due_date;
             if (due_date >= 0) {
                 child->total_tardiness_scheduled = parent->total_tardiness_scheduled
-                    + std::max((Time)0, t_prec - due_date);
+                    + weight * std::max((Time)0, t_prec - due_date);
                 child->total_earliness = parent->total_earliness
-                    + std::max((Time)0, due_date - t_prec);
+                    + weight * std::max((Time)0, due_date - t_prec);
             } else {
                 child->total_tardiness_scheduled = parent->total_tardiness_scheduled;
                 child->total_earliness = parent->total_earliness;
             }
 
-            // Bound
-            MachineId last_machine_id = instance_.number_of_machines() - 1;
-
             // LB on unscheduled tardiness
             if (instance_.objective() == Objective::TotalTardiness) {
                 Time t_parent = parent->machines[last_machine_id].time;
                 child->due_date_pos = parent->due_date_pos;
-                child->number_of_late_unscheduled = parent->number_of_late_unscheduled;
-                child->sum_late_unscheduled_due_dates = parent->sum_late_unscheduled_due_dates;
+                child->late_unscheduled_weight = parent->late_unscheduled_weight;
+                child->sum_late_unscheduled_weighted_due_dates = parent->sum_late_unscheduled_weighted_due_dates;
                 if (due_date >= 0 && due_date < t_parent) {
-                    child->number_of_late_unscheduled--;
-                    child->sum_late_unscheduled_due_dates -= due_date;
+                    child->late_unscheduled_weight -= weight;
+                    child->sum_late_unscheduled_weighted_due_dates -= weight * due_date;
                 }
                 while (child->due_date_pos < (JobId)sorted_jobs_.size()
                        && sorted_jobs_[child->due_date_pos].first < t_prec) {
                     JobId other_id = sorted_jobs_[child->due_date_pos].second;
                     if (other_id != job_next_id && parent->available_jobs[other_id]) {
-                        child->number_of_late_unscheduled++;
-                        child->sum_late_unscheduled_due_dates += sorted_jobs_[child->due_date_pos].first;
+                        Time other_weight = instance_.job(other_id).weight;
+                        child->late_unscheduled_weight += other_weight;
+                        child->sum_late_unscheduled_weighted_due_dates
+                            += other_weight * sorted_jobs_[child->due_date_pos].first;
                     }
                     child->due_date_pos++;
                 }
-                child->total_tardiness_unscheduled = child->number_of_late_unscheduled * t_prec
-                    - child->sum_late_unscheduled_due_dates;
+                child->total_tardiness_unscheduled = child->late_unscheduled_weight * t_prec
+                    - child->sum_late_unscheduled_weighted_due_dates;
             }
             child->total_tardiness = child->total_tardiness_scheduled + child->total_tardiness_unscheduled;
 
             switch (instance_.objective()) {
             case Objective::TotalFlowTime: {
-                child->bound = parent->bound
-                    + (instance_.number_of_jobs() - parent->number_of_jobs)
-                    * (t_prec - parent->machines[last_machine_id].time)
-                    - job_next.operations[last_machine_id].alternatives[0].processing_time;
+                // Each unscheduled job completes at least at t_prec plus its
+                // processing time on the last machine.
+                child->bound = child->total_completion_time
+                    + child->unscheduled_weight * t_prec
+                    + child->unscheduled_weighted_offset;
                 break;
             }
             case Objective::TotalTardiness: {
@@ -594,6 +689,17 @@ Output shopschedulingsolver::tree_search_pfss(
     Output output(instance);
     AlgorithmFormatter algorithm_formatter(instance, parameters, output);
     algorithm_formatter.start("Tree search");
+
+    // The fixed jobs are scheduled at the root.
+    if (!instance.fixed_prefix()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations and machine availability times are only "
+                "supported on flow shops without no-wait, blocking and no-idle "
+                "machines, the fixed jobs being processed first in the same "
+                "order on all the machines.");
+    }
+
     algorithm_formatter.print_header();
 
     BranchingScheme::Parameters branching_scheme_parameters;
@@ -618,22 +724,31 @@ Output shopschedulingsolver::tree_search_pfss(
                     node_tmp = node_tmp->parent) {
                 jobs.push_back(node_tmp->job_id);
             }
+            jobs.insert(jobs.end(), instance.fixed_jobs().rbegin(), instance.fixed_jobs().rend());
             std::reverse(jobs.begin(), jobs.end());
 
             SolutionBuilder solution_builder;
             solution_builder.set_instance(instance);
             std::vector<Time> machines_current_departure_times(instance.number_of_machines(), 0);
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                machines_current_departure_times[machine_id] = instance.machine(machine_id).availability_time;
+            }
             for (JobId job_id: jobs) {
                 const Job& job = instance.job(job_id);
                 std::vector<Time> next_departure_times(instance.number_of_machines(), 0);
-                Time t_prec = 0;
+                Time t_prec = job.release_date;
 
                 if (!instance.blocking()) {
                     for (MachineId machine_id = 0;
                             machine_id < instance.number_of_machines();
                             ++machine_id) {
-                        Time p = job.operations[machine_id].alternatives[0].processing_time;
-                        Time start = std::max(t_prec, machines_current_departure_times[machine_id]);
+                        const Operation& operation = job.operations[machine_id];
+                        Time p = operation.alternatives[0].processing_time;
+                        Time start = (operation.fixed_start != -1)?
+                            operation.fixed_start:
+                            std::max(t_prec, machines_current_departure_times[machine_id]);
                         solution_builder.append_operation(
                                 job_id,
                                 machine_id,
@@ -681,6 +796,7 @@ Output shopschedulingsolver::tree_search_pfss(
             ss << "queue " << ibs_output.maximum_size_of_the_queue;
             algorithm_formatter.update_solution(solution, ss.str());
         };
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("TreeSearchPfss/IterativeBeamSearch");
     auto ts_output = treesearchsolver::iterative_beam_search_2(branching_scheme, ibs_parameters);
 
     if (ts_output.optimal) {
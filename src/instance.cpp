@@ -86,6 +86,7 @@ void Instance::write(
             ++machine_id) {
         const Machine& machine = this->machine(machine_id);
         json["machines"][machine_id]["no_idle"] = machine.no_idle;
+        json["machines"][machine_id]["availability_time"] = machine.availability_time;
     }
     for (JobId job_id = 0; job_id < this->number_of_jobs(); ++job_id) {
         const Job& job = this->job(job_id);
@@ -103,6 +104,10 @@ void Instance::write(
                 json["jobs"][job_id]["operations"][operation_id]["alternatives"][alternative_id]["machine"] = alternative.machine_id;
                 json["jobs"][job_id]["operations"][operation_id]["alternatives"][alternative_id]["processing_time"] = alternative.processing_time;
             }
+            if (operation.fixed_start != -1) {
+                json["jobs"][job_id]["operations"][operation_id]["fixed_start"] = operation.fixed_start;
+                json["jobs"][job_id]["operations"][operation_id]["fixed_alternative"] = operation.fixed_alternative_id;
+            }
         }
     }
 
@@ -127,6 +132,8 @@ std::ostream& Instance::format(
             << "Permutation:                 " << this->permutation() << std::endl
             << "Flow shop:                   " << this->flow_shop() << std::endl
             << "Flexible:                    " << this->flexible() << std::endl
+            << "Number of fixed operations:  " << this->number_of_fixed_operations() << std::endl
+            << "Machine availability times:  " << this->has_machine_availability_times() << std::endl
             ;
     }
 
@@ -167,10 +174,12 @@ std::ostream& Instance::format(
             << std::setw(12) << "Machine"
             << std::setw(12) << "# op."
             << std::setw(12) << "No-idle"
+            << std::setw(12) << "Avail. time"
             << std::endl
             << std::setw(12) << "-------"
             << std::setw(12) << "-----"
             << std::setw(12) << "-------"
+            << std::setw(12) << "-----------"
             << std::endl;
         for (MachineId machine_id = 0;
                 machine_id < this->number_of_machines();
@@ -180,6 +189,7 @@ std::ostream& Instance::format(
                 << std::setw(12) << machine_id
                 << std::setw(12) << machine.operations.size()
                 << std::setw(12) << machine.no_idle
+                << std::setw(12) << machine.availability_time
                 << std::endl;
         }
     }
@@ -189,10 +199,12 @@ std::ostream& Instance::format(
             << std::setw(12) << "Job"
             << std::setw(12) << "Operation"
             << std::setw(12) << "# machines"
+            << std::setw(12) << "Fixed start"
             << std::endl
             << std::setw(12) << "---"
             << std::setw(12) << "---------"
             << std::setw(12) << "----------"
+            << std::setw(12) << "-----------"
             << std::endl;
         for (JobId job_id = 0; job_id < this->number_of_jobs(); ++job_id) {
             const Job& job = this->job(job_id);
@@ -204,6 +216,7 @@ std::ostream& Instance::format(
                     << std::setw(12) << job_id
                     << std::setw(12) << operation_id
                     << std::setw(12) << operation.alternatives.size()
+                    << std::setw(12) << operation.fixed_start
                     << std::endl;
             }
         }
@@ -1,5 +1,6 @@
 #include "shopschedulingsolver/instance_builder.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 using namespace shopschedulingsolver;
@@ -33,6 +34,27 @@ void InstanceBuilder::set_all_machines_no_idle(
     }
 }
 
+void InstanceBuilder::set_machine_availability_time(
+        MachineId machine_id,
+        Time availability_time)
+{
+    if (machine_id < 0 || machine_id >= instance_.machines_.size()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid 'machine_id'; "
+                "machine_id: " + std::to_string(machine_id) + "; "
+                "instance_.machines_.size(): " + std::to_string(instance_.machines_.size()) + ".");
+    }
+    if (availability_time < 0) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "'availability_time' must be >= 0; "
+                "availability_time: " + std::to_string(availability_time) + ".");
+    }
+
+    instance_.machines_[machine_id].availability_time = availability_time;
+}
+
 JobId InstanceBuilder::add_job()
 {
     JobId job_id = instance_.jobs_.size();
@@ -169,6 +191,46 @@ void InstanceBuilder::set_job_weight(
     instance_.jobs_[job_id].weight = weight;
 }
 
+void InstanceBuilder::fix_operation(
+        JobId job_id,
+        OperationId operation_id,
+        AlternativeId alternative_id,
+        Time start)
+{
+    if (job_id < 0 || job_id >= instance_.jobs_.size()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid 'job_id'; "
+                "job_id: " + std::to_string(job_id) + "; "
+                "instance_.jobs_.size(): " + std::to_string(instance_.jobs_.size()) + ".");
+    }
+    Job& job = instance_.jobs_[job_id];
+    if (operation_id < 0 || operation_id >= job.operations.size()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid 'operation_id'; "
+                "operation_id: " + std::to_string(operation_id) + "; "
+                "job.operations.size(): " + std::to_string(job.operations.size()) + ".");
+    }
+    Operation& operation = job.operations[operation_id];
+    if (alternative_id < 0 || alternative_id >= operation.alternatives.size()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "invalid 'alternative_id'; "
+                "alternative_id: " + std::to_string(alternative_id) + "; "
+                "operation.alternatives.size(): " + std::to_string(operation.alternatives.size()) + ".");
+    }
+    if (start < 0) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "'start' must be >= 0; "
+                "start: " + std::to_string(start) + ".");
+    }
+
+    operation.fixed_start = start;
+    operation.fixed_alternative_id = alternative_id;
+}
+
 void InstanceBuilder::read(
         const std::string& instance_path,
         const std::string& format)
@@ -179,7 +241,13 @@ void InstanceBuilder::read(
                 FUNC_SIGNATURE + ": "
                 "unable to open file \"" + instance_path + "\".");
     }
+    read(file, format);
+}
 
+void InstanceBuilder::read(
+        std::istream& file,
+        const std::string& format)
+{
     if (format == "" || format == "json") {
         read_json(file);
     } else if (format == "flow-shop" || format == "flow-shop-jobcol") {
@@ -197,10 +265,9 @@ void InstanceBuilder::read(
                 FUNC_SIGNATURE + ": "
                 "unknown instance format \"" + format + "\".");
     }
-    file.close();
 }
 
-void InstanceBuilder::read_json(std::ifstream& file)
+void InstanceBuilder::read_json(std::istream& file)
 {
     nlohmann ::json j;
     file >> j;
@@ -228,6 +295,8 @@ void InstanceBuilder::read_json(std::ifstream& file)
     for (const auto& json_machine: j["machines"]) {
         if (json_machine.contains("no_idle"))
             set_machine_no_idle(machine_id, json_machine["no_idle"]);
+        if (json_machine.contains("availability_time"))
+            set_machine_availability_time(machine_id, json_machine["availability_time"]);
         machine_id++;
     }
 
@@ -249,11 +318,18 @@ void InstanceBuilder::read_json(std::ifstream& file)
                         json_alternative["machine"],
                         json_alternative["processing_time"]);
             }
+            if (json_operation.contains("fixed_start")) {
+                fix_operation(
+                        job_id,
+                        operation_id,
+                        json_operation["fixed_alternative"],
+                        json_operation["fixed_start"]);
+            }
         }
     }
 }
 
-void InstanceBuilder::read_flow_shop_jobcol(std::ifstream& file)
+void InstanceBuilder::read_flow_shop_jobcol(std::istream& file)
 {
     JobId number_of_jobs = -1;
     MachineId number_of_machines = -1;
@@ -280,7 +356,7 @@ void InstanceBuilder::read_flow_shop_jobcol(std::ifstream& file)
     this->set_objective(Objective::Makespan);
 }
 
-void InstanceBuilder::read_flow_shop_jobrow(std::ifstream& file)
+void InstanceBuilder::read_flow_shop_jobrow(std::istream& file)
 {
     JobId number_of_jobs = -1;
     MachineId number_of_machines = -1;
@@ -307,7 +383,7 @@ void InstanceBuilder::read_flow_shop_jobrow(std::ifstream& file)
     this->set_objective(Objective::Makespan);
 }
 
-void InstanceBuilder::read_flow_shop_vallada2008(std::ifstream& file)
+void InstanceBuilder::read_flow_shop_vallada2008(std::istream& file)
 {
     JobId number_of_jobs;
     MachineId number_of_machines;
@@ -342,7 +418,7 @@ void InstanceBuilder::read_flow_shop_vallada2008(std::ifstream& file)
     this->set_objective(Objective::TotalTardiness);
 }
 
-void InstanceBuilder::read_job_shop(std::ifstream& file)
+void InstanceBuilder::read_job_shop(std::istream& file)
 {
     JobId number_of_jobs = -1;
     MachineId number_of_machines = -1;
@@ -370,7 +446,7 @@ void InstanceBuilder::read_job_shop(std::ifstream& file)
     this->set_objective(Objective::Makespan);
 }
 
-void InstanceBuilder::read_flexible_job_shop(std::ifstream& file)
+void InstanceBuilder::read_flexible_job_shop(std::istream& file)
 {
     JobId number_of_jobs = -1;
     MachineId number_of_machines = -1;
@@ -466,5 +542,131 @@ Instance InstanceBuilder::build()
         }
     }
 
+    // Machine availability times.
+    this->instance_.has_machine_availability_times_ = false;
+    for (MachineId machine_id = 0;
+            machine_id < this->instance_.number_of_machines();
+            ++machine_id) {
+        if (this->instance_.machine(machine_id).availability_time > 0)
+            this->instance_.has_machine_availability_times_ = true;
+    }
+
+    // Fixed operations.
+    // Check that they are consistent: they respect the release dates, the
+    // precedences, and they don't overlap.
+    this->instance_.number_of_fixed_operations_ = 0;
+    this->instance_.fixed_jobs_.clear();
+    std::vector<std::vector<std::pair<Time, Time>>> machines_fixed_intervals(
+            this->instance_.number_of_machines());
+    for (JobId job_id = 0; job_id < this->instance_.number_of_jobs(); ++job_id) {
+        Job& job = this->instance_.jobs_[job_id];
+        job.fixed = !job.operations.empty();
+        std::vector<std::pair<Time, Time>> job_fixed_intervals;
+        for (OperationId operation_id = 0;
+                operation_id < (OperationId)job.operations.size();
+                ++operation_id) {
+            const Operation& operation = job.operations[operation_id];
+            if (operation.fixed_start == -1) {
+                job.fixed = false;
+                continue;
+            }
+            this->instance_.number_of_fixed_operations_++;
+            const Alternative& alternative = operation.alternatives[operation.fixed_alternative_id];
+            Time end = operation.fixed_start + alternative.processing_time;
+            if (operation.fixed_start < job.release_date) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "a fixed operation starts before the release date of its job; "
+                        "job_id: " + std::to_string(job_id) + "; "
+                        "operation_id: " + std::to_string(operation_id) + "; "
+                        "fixed_start: " + std::to_string(operation.fixed_start) + "; "
+                        "release_date: " + std::to_string(job.release_date) + ".");
+            }
+            if (!this->instance_.operations_arbitrary_order()
+                    && !job_fixed_intervals.empty()
+                    && operation.fixed_start < job_fixed_intervals.back().second) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "a fixed operation starts before the end of a previous fixed operation of its job; "
+                        "job_id: " + std::to_string(job_id) + "; "
+                        "operation_id: " + std::to_string(operation_id) + ".");
+            }
+            job_fixed_intervals.push_back({operation.fixed_start, end});
+            machines_fixed_intervals[alternative.machine_id].push_back({operation.fixed_start, end});
+        }
+        std::sort(job_fixed_intervals.begin(), job_fixed_intervals.end());
+        for (std::size_t pos = 1; pos < job_fixed_intervals.size(); ++pos) {
+            if (job_fixed_intervals[pos].first < job_fixed_intervals[pos - 1].second) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "fixed operations of a job overlap; "
+                        "job_id: " + std::to_string(job_id) + ".");
+            }
+        }
+        if (job.fixed)
+            this->instance_.fixed_jobs_.push_back(job_id);
+    }
+    for (MachineId machine_id = 0;
+            machine_id < this->instance_.number_of_machines();
+            ++machine_id) {
+        std::vector<std::pair<Time, Time>>& intervals = machines_fixed_intervals[machine_id];
+        std::sort(intervals.begin(), intervals.end());
+        for (std::size_t pos = 1; pos < intervals.size(); ++pos) {
+            if (intervals[pos].first < intervals[pos - 1].second) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "fixed operations of a machine overlap; "
+                        "machine_id: " + std::to_string(machine_id) + ".");
+            }
+        }
+    }
+    std::stable_sort(
+            this->instance_.fixed_jobs_.begin(),
+            this->instance_.fixed_jobs_.end(),
+            [this](JobId job_id_1, JobId job_id_2)
+            {
+                return this->instance_.jobs_[job_id_1].operations[0].fixed_start
+                    < this->instance_.jobs_[job_id_2].operations[0].fixed_start;
+            });
+
+    // Check if the fixed operations form a frozen prefix of a permutation,
+    // the machine availability times being the initial state of the
+    // machines.
+    this->instance_.fixed_prefix_ = true;
+    if (this->instance_.number_of_fixed_operations_ > 0
+            || this->instance_.has_machine_availability_times_) {
+        if (!this->instance_.flow_shop()
+                || this->instance_.flexible()
+                || this->instance_.no_wait()
+                || this->instance_.blocking()
+                || this->instance_.mixed_no_idle()
+                || this->instance_.number_of_fixed_operations_
+                != (OperationId)this->instance_.fixed_jobs_.size() * this->instance_.number_of_machines()) {
+            this->instance_.fixed_prefix_ = false;
+        }
+    }
+    if (this->instance_.fixed_prefix_) {
+        // The fixed jobs must be processed in the same order on all the
+        // machines, after the availability times of the machines.
+        std::vector<Time> machines_current_times(this->instance_.number_of_machines(), 0);
+        for (MachineId machine_id = 0;
+                machine_id < this->instance_.number_of_machines();
+                ++machine_id) {
+            machines_current_times[machine_id] = this->instance_.machine(machine_id).availability_time;
+        }
+        for (JobId job_id: this->instance_.fixed_jobs_) {
+            const Job& job = this->instance_.job(job_id);
+            for (MachineId machine_id = 0;
+                    machine_id < this->instance_.number_of_machines();
+                    ++machine_id) {
+                const Operation& operation = job.operations[machine_id];
+                if (operation.fixed_start < machines_current_times[machine_id])
+                    this->instance_.fixed_prefix_ = false;
+                machines_current_times[machine_id] = operation.fixed_start
+                    + operation.alternatives[0].processing_time;
+            }
+        }
+    }
+
     return std::move(instance_);
 }
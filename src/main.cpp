@@ -1,19 +1,17 @@
 #include "shopschedulingsolver/algorithm_formatter.hpp"
+#include "shopschedulingsolver/algorithm_options.hpp"
 #include "shopschedulingsolver/instance_builder.hpp"
-#include "shopschedulingsolver/algorithms/tree_search_pfss_makespan.hpp"
-#include "shopschedulingsolver/algorithms/tree_search_pfss.hpp"
-#include "shopschedulingsolver/algorithms/milp_positional.hpp"
-#include "shopschedulingsolver/algorithms/milp_disjunctive.hpp"
-#ifdef OPTALCP_FOUND
-#include "shopschedulingsolver/algorithms/constraint_programming_optalcp.hpp"
-#endif
-#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
-#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
-
+#include "shopschedulingsolver/output_writer.hpp"
+#include "shopschedulingsolver/thread_pool.hpp"
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <string>
+#include <thread>
 
 using namespace shopschedulingsolver;
 namespace po = boost::program_options;
@@ -22,7 +20,9 @@ void read_args(
         Parameters& parameters,
         const po::variables_map& vm)
 {
-    parameters.timer.set_sigint_handler();
+    // In batch mode, the handler is installed once for all the runs.
+    if (!vm.count("batch"))
+        parameters.timer.set_sigint_handler();
     parameters.messages_to_stdout = true;
     if (vm.count("time-limit"))
         parameters.timer.set_time_limit(vm["time-limit"].as<double>());
@@ -31,6 +31,8 @@ void read_args(
     if (vm.count("log"))
         parameters.log_path = vm["log"].as<std::string>();
     parameters.log_to_stderr = vm.count("log-to-stderr");
+    if (vm.count("maximum-number-of-intermediary-outputs"))
+        parameters.maximum_number_of_intermediary_outputs = vm["maximum-number-of-intermediary-outputs"].as<Counter>();
     bool only_write_at_the_end = vm.count("only-write-at-the-end");
     if (!only_write_at_the_end) {
 
@@ -46,23 +48,34 @@ void read_args(
         if (vm.count("output"))
             json_output_path = vm["output"].as<std::string>();
 
-        parameters.new_solution_callback = [
-            json_output_path,
-            certificate_path,
-            certificate_format](
+        double write_interval = 0.0;
+        if (vm.count("write-interval"))
+            write_interval = vm["write-interval"].as<double>();
+
+        if (!json_output_path.empty() || !certificate_path.empty()) {
+            auto output_writer = std::make_shared<OutputWriter>(
+                    json_output_path,
+                    certificate_path,
+                    certificate_format,
+                    write_interval);
+            parameters.new_solution_callback = [output_writer](
                     const Output& output)
-        {
-            if (!json_output_path.empty())
-                output.write_json_output(json_output_path);
-            if (!certificate_path.empty())
-                output.solution.write(certificate_path, certificate_format);
-        };
+            {
+                output_writer->push(output);
+            };
+            parameters.end_callback = [output_writer](
+                    const Output&)
+            {
+                output_writer->flush();
+            };
+        }
     }
 }
 
 Output run(
         const Instance& instance,
-        const po::variables_map& vm)
+        const po::variables_map& vm,
+        ThreadPool* thread_pool = nullptr)
 {
     Seed seed = 0;
     if (vm.count("seed"))
@@ -73,61 +86,332 @@ Output run(
     //    Solution(instance);
 
     // Run algorithm.
-    std::string algorithm = vm["algorithm"].as<std::string>();
-
-    if (algorithm == "tree-search-pfss-makespan") {
-        Parameters parameters;
-        read_args(parameters, vm);
-        return tree_search_pfss_makespan(instance, parameters);
-
-    } else if (algorithm == "tree-search-pfss") {
-        TreeSearchPfssParameters parameters;
-        read_args(parameters, vm);
-        return tree_search_pfss(instance, parameters);
-
-    } else if (algorithm == "milp-positional") {
-        MilpPositionalParameters parameters;
-        read_args(parameters, vm);
-        if (vm.count("solver"))
-            parameters.solver = vm["solver"].as<mathoptsolverscmake::SolverName>();
-        return milp_positional(instance, nullptr, parameters);
-
-    } else if (algorithm == "milp-disjunctive") {
-        MilpDisjunctiveParameters parameters;
-        read_args(parameters, vm);
-        if (vm.count("solver"))
-            parameters.solver = vm["solver"].as<mathoptsolverscmake::SolverName>();
-        return milp_disjunctive(instance, nullptr, parameters);
-
-#ifdef OPTALCP_FOUND
-    } else if (algorithm == "constraint-programming-optalcp") {
-        Parameters parameters;
-        read_args(parameters, vm);
-        return constraint_programming_optalcp(instance, parameters);
-#endif
-
-    } else if (algorithm == "local-search-pfss-makespan") {
-        if (instance.objective() == Objective::Makespan) {
-            LocalSearchParameters parameters;
-            read_args(parameters, vm);
-            return local_search_pfss_makespan(instance, generator, nullptr, parameters);
-        }
+    return run_algorithm(
+            instance,
+            vm["algorithm"].as<std::string>(),
+            generator,
+            vm,
+            [&vm](Parameters& parameters) { read_args(parameters, vm); },
+            thread_pool);
+}
+
+Instance build_instance(
+        const po::variables_map& vm)
+{
+    InstanceBuilder instance_builder;
+    instance_builder.read(
+            vm["input"].as<std::string>(),
+            vm["format"].as<std::string>());
+    if (vm.count("objective"))
+        instance_builder.set_objective(vm["objective"].as<Objective>());
+    if (vm.count("operations-arbitrary-order"))
+        instance_builder.set_operations_arbitrary_order(vm["operations-arbitrary-order"].as<bool>());
+    if (vm.count("no-wait"))
+        instance_builder.set_no_wait(vm["no-wait"].as<bool>());
+    if (vm.count("no-idle"))
+        instance_builder.set_all_machines_no_idle(vm["no-idle"].as<bool>());
+    if (vm.count("blocking"))
+        instance_builder.set_blocking(vm["blocking"].as<bool>());
+    if (vm.count("permutation"))
+        instance_builder.set_permutation(vm["permutation"].as<bool>());
+    return instance_builder.build();
+}
+
+void write_outputs(
+        const Output& output,
+        const po::variables_map& vm)
+{
+    if (vm.count("certificate")) {
+        std::string certificate_format = "";
+        if (vm.count("certificate-format"))
+            certificate_format = vm["certificate-format"].as<std::string>();
+        output.solution.write(
+                vm["certificate"].as<std::string>(),
+                certificate_format);
+    }
+    if (vm.count("output"))
+        output.write_json_output(vm["output"].as<std::string>());
+}
+
+/*
+ * Batch mode
+ */
+
+/** Row of a batch manifest, from column names to values. */
+using ManifestRow = std::map<std::string, std::string>;
 
-    } else if (algorithm == "local-search-pfss") {
-        if (instance.objective() == Objective::TotalFlowTime
-                || instance.objective() == Objective::TotalTardiness) {
-            LocalSearchPfssParameters parameters;
-            read_args(parameters, vm);
-            return local_search_pfss(instance, generator, nullptr, parameters);
+std::vector<std::string> split_csv_line(
+        const std::string& line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (std::string::size_type pos = 0; pos < line.size(); ++pos) {
+        char c = line[pos];
+        if (quoted) {
+            if (c == '"' && pos + 1 < line.size() && line[pos + 1] == '"') {
+                fields.back() += '"';
+                pos++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back("");
+        } else if (c != '\r') {
+            fields.back() += c;
         }
+    }
+    return fields;
+}
 
-    } else {
-        throw std::invalid_argument(
+/**
+ * Read a batch manifest.
+ *
+ * The manifest is either a CSV file with a header line, or a JSONL file (one
+ * JSON object per line) if its extension is ".jsonl".
+ */
+std::vector<ManifestRow> read_manifest(
+        const std::string& manifest_path)
+{
+    std::ifstream file(manifest_path);
+    if (!file.good()) {
+        throw std::runtime_error(
                 FUNC_SIGNATURE + ": "
-                "unknown algorithm \"" + algorithm + "\".");
+                "unable to open file \"" + manifest_path + "\".");
+    }
+
+    std::vector<ManifestRow> rows;
+    std::string line;
+    if (boost::filesystem::path(manifest_path).extension() == ".jsonl") {
+        while (std::getline(file, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+            nlohmann::json json = nlohmann::json::parse(line);
+            ManifestRow row;
+            for (auto it = json.begin(); it != json.end(); ++it)
+                row[it.key()] = (it->is_string())? it->get<std::string>(): it->dump();
+            rows.push_back(row);
+        }
+    } else {
+        std::getline(file, line);
+        std::vector<std::string> header = split_csv_line(line);
+        while (std::getline(file, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+            std::vector<std::string> fields = split_csv_line(line);
+            ManifestRow row;
+            for (std::size_t column_id = 0;
+                    column_id < header.size() && column_id < fields.size();
+                    ++column_id) {
+                row[header[column_id]] = fields[column_id];
+            }
+            rows.push_back(row);
+        }
+    }
+
+    for (const ManifestRow& row: rows) {
+        auto it = row.find("Path");
+        if (it == row.end() || it->second.empty()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "each row of the manifest must have a path; "
+                    "manifest_path: " + manifest_path + ".");
+        }
+    }
+    return rows;
+}
+
+/** Get the extension of a certificate file from its format. */
+std::string certificate_extension(
+        const std::string& certificate_format)
+{
+    if (certificate_format == "csv")
+        return ".csv";
+    if (certificate_format == "binary")
+        return ".bin";
+    return ".json";
+}
+
+/**
+ * Solve the instance of a row of a batch manifest and return its summary.
+ *
+ * The options of a run are, by decreasing priority: the columns of the row,
+ * the options of its "Options" column, and the command line options.
+ */
+nlohmann::json solve_manifest_row(
+        const po::options_description& desc,
+        const po::parsed_options& command_line_options,
+        const boost::filesystem::path& data_directory,
+        const boost::filesystem::path& output_directory,
+        const ManifestRow& row,
+        ThreadPool& thread_pool)
+{
+    const std::string& path = row.at("Path");
+    nlohmann::json summary = {{"Path", path}};
+    try {
+        boost::filesystem::path json_output_path = output_directory / (path + "_output.json");
+        boost::filesystem::create_directories(json_output_path.parent_path());
+
+        std::vector<std::string> args = {
+            "--input", (data_directory / path).string(),
+            "--output", json_output_path.string(),
+        };
+        auto it = row.find("Format");
+        if (it != row.end() && !it->second.empty())
+            args.insert(args.end(), {"--format", it->second});
+        it = row.find("Objective");
+        if (it != row.end() && !it->second.empty())
+            args.insert(args.end(), {"--objective", it->second});
+        it = row.find("Time limit");
+        if (it != row.end() && !it->second.empty()) {
+            args.insert(args.end(), {"--time-limit", it->second});
+            summary["TimeLimit"] = std::stod(it->second);
+        }
+        it = row.find("Options");
+        if (it != row.end()) {
+            std::vector<std::string> options = po::split_unix(it->second);
+            args.insert(args.end(), options.begin(), options.end());
+        }
+
+        // The certificate format might be given by the options of the row.
+        po::variables_map format_vm;
+        po::store(po::command_line_parser(args).options(desc).run(), format_vm);
+        po::store(command_line_options, format_vm);
+        std::string certificate_format;
+        if (format_vm.count("certificate-format"))
+            certificate_format = format_vm["certificate-format"].as<std::string>();
+        boost::filesystem::path certificate_path = output_directory
+            / (path + "_solution" + certificate_extension(certificate_format));
+        args.insert(args.end(), {"--certificate", certificate_path.string()});
+
+        po::variables_map vm;
+        po::store(po::command_line_parser(args).options(desc).run(), vm);
+        po::store(command_line_options, vm);
+        // Runs are silent unless a verbosity level is given explicitly.
+        po::store(po::command_line_parser(std::vector<std::string>{"--verbosity-level", "0"}).options(desc).run(), vm);
+        po::notify(vm);
+
+        Instance instance = build_instance(vm);
+        Output output = run(instance, vm, &thread_pool);
+        write_outputs(output, vm);
+
+        summary["Feasible"] = output.solution.feasible();
+        summary["Value"] = output.solution.objective_value();
+        summary["Bound"] = output.bound();
+        summary["Optimal"] = output.solution.feasible()
+            && output.bound() == output.solution.objective_value();
+        summary["Time"] = output.time;
+    } catch (const std::exception& e) {
+        summary["Error"] = e.what();
+    }
+    return summary;
+}
+
+/**
+ * Solve all the instances of a manifest concurrently.
+ *
+ * Rows are processed by decreasing time limit, so that the longest runs do
+ * not end up alone at the end of the batch.
+ */
+int run_batch(
+        const po::options_description& desc,
+        const po::parsed_options& command_line_options,
+        const po::variables_map& vm)
+{
+    std::string manifest_path = vm["batch"].as<std::string>();
+    std::vector<ManifestRow> rows = read_manifest(manifest_path);
+    boost::filesystem::path data_directory = boost::filesystem::path(manifest_path).parent_path();
+    boost::filesystem::path output_directory = "batch_results";
+    if (vm.count("batch-output-directory"))
+        output_directory = vm["batch-output-directory"].as<std::string>();
+    Counter number_of_threads = std::thread::hardware_concurrency();
+    if (vm.count("batch-number-of-threads"))
+        number_of_threads = vm["batch-number-of-threads"].as<Counter>();
+    if (number_of_threads < 1)
+        number_of_threads = 1;
+
+    std::vector<double> time_limits(rows.size(), std::numeric_limits<double>::infinity());
+    for (std::size_t row_id = 0; row_id < rows.size(); ++row_id) {
+        auto it = rows[row_id].find("Time limit");
+        if (it != rows[row_id].end() && !it->second.empty())
+            time_limits[row_id] = std::stod(it->second);
+    }
+    std::vector<std::size_t> sorted_row_ids(rows.size());
+    std::iota(sorted_row_ids.begin(), sorted_row_ids.end(), 0);
+    std::stable_sort(
+            sorted_row_ids.begin(),
+            sorted_row_ids.end(),
+            [&time_limits](std::size_t row_id_1, std::size_t row_id_2)
+            {
+                return time_limits[row_id_1] > time_limits[row_id_2];
+            });
+
+    // The SIGINT handler is process-wide, so it is installed once rather than
+    // by each of the concurrent runs.
+    optimizationtools::Timer timer;
+    timer.set_sigint_handler();
+
+    // The rows are run as tasks of a pool shared with the parallel
+    // algorithms they run. The calling thread takes part as well.
+    // Rows skipped after an interruption keep an error in their summary.
+    std::vector<nlohmann::json> summaries(rows.size());
+    for (std::size_t row_id = 0; row_id < rows.size(); ++row_id) {
+        summaries[row_id] = {
+            {"Path", rows[row_id].at("Path")},
+            {"Error", "not solved"}};
+    }
+    std::size_t number_of_solved_rows = 0;
+    std::mutex mutex;
+    ThreadPool thread_pool(number_of_threads - 1);
+    std::mt19937_64 generator(0);
+    TaskGroup task_group(thread_pool, generator, timer);
+    for (std::size_t row_id: sorted_row_ids) {
+        task_group.run([&, row_id](TaskContext&)
+        {
+            nlohmann::json summary = solve_manifest_row(
+                    desc,
+                    command_line_options,
+                    data_directory,
+                    output_directory,
+                    rows[row_id],
+                    thread_pool);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            summaries[row_id] = summary;
+            number_of_solved_rows++;
+            std::cout
+                << "[" << number_of_solved_rows << "/" << rows.size() << "] "
+                << summary["Path"].get<std::string>();
+            if (summary.contains("Error")) {
+                std::cout << "  error: " << summary["Error"].get<std::string>();
+            } else {
+                std::cout
+                    << "  value: " << summary["Value"]
+                    << "  bound: " << summary["Bound"]
+                    << "  time: " << summary["Time"];
+            }
+            std::cout << std::endl;
+        });
     }
+    task_group.wait();
 
-    return Output(instance);
+    // Write summary.
+    boost::filesystem::create_directories(output_directory);
+    nlohmann::json json = {
+        {"Manifest", manifest_path},
+        {"Instances", summaries},
+    };
+    std::ofstream summary_file((output_directory / "summary.json").string());
+    summary_file << std::setw(4) << json << std::endl;
+
+    Counter number_of_errors = 0;
+    for (const nlohmann::json& summary: summaries)
+        if (summary.contains("Error"))
+            number_of_errors++;
+    return (number_of_errors == 0)? 0: 1;
 }
 
 int main(int argc, char *argv[])
@@ -151,21 +435,32 @@ int main(int argc, char *argv[])
 
         ("output,o", po::value<std::string>(), "set output path")
         ("certificate,c", po::value<std::string>(), "set certificate path")
+        ("certificate-format,", po::value<std::string>(), "set certificate format (json, json-compact, csv, binary)")
         ("log,l", po::value<std::string>(), "set log path")
         ("time-limit,t", po::value<double>(), "set time limit in seconds")
         ("seed,s", po::value<Seed>(), "set seed (not used)")
         ("only-write-at-the-end,e", "only write output and certificate files at the end")
+        ("write-interval,", po::value<double>(), "set minimum interval in seconds between two writes of intermediary outputs")
+        ("maximum-number-of-intermediary-outputs,", po::value<Counter>(), "set maximum number of intermediary outputs stored (-1 for no limit)")
         ("verbosity-level,v", po::value<int>(), "set verbosity level")
         ("log-to-stderr,w", "write log in stderr")
 
-        ("solver,", po::value<mathoptsolverscmake::SolverName>(), "set solver")
         ;
+    add_algorithm_options(desc);
+    desc.add_options()
+        ("batch,", po::value<std::string>(), "solve all the instances of a manifest (CSV with a header, or JSONL) using the columns \"Path\", \"Format\", \"Objective\", \"Time limit\" and \"Options\"")
+        ("batch-output-directory,", po::value<std::string>(), "set output directory of the batch mode")
+        ("batch-number-of-threads,", po::value<Counter>(), "set number of instances solved concurrently in batch mode (default: number of cores)")
+        ;
+    po::parsed_options command_line_options = po::parse_command_line(argc, argv, desc);
     po::variables_map vm;
-    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::store(command_line_options, vm);
     if (vm.count("help")) {
         std::cout << desc << std::endl;;
         return 1;
     }
+    if (vm.count("batch"))
+        return run_batch(desc, command_line_options, vm);
     try {
         po::notify(vm);
     } catch (const po::required_option& e) {
@@ -174,38 +469,13 @@ int main(int argc, char *argv[])
     }
 
     // Build instance.
-    InstanceBuilder instance_builder;
-    instance_builder.read(
-            vm["input"].as<std::string>(),
-            vm["format"].as<std::string>());
-    if (vm.count("objective"))
-        instance_builder.set_objective(vm["objective"].as<Objective>());
-    if (vm.count("operations-arbitrary-order"))
-        instance_builder.set_operations_arbitrary_order(vm["operations-arbitrary-order"].as<bool>());
-    if (vm.count("no-wait"))
-        instance_builder.set_no_wait(vm["no-wait"].as<bool>());
-    if (vm.count("no-idle"))
-        instance_builder.set_all_machines_no_idle(vm["no-idle"].as<bool>());
-    if (vm.count("blocking"))
-        instance_builder.set_blocking(vm["blocking"].as<bool>());
-    if (vm.count("permutation"))
-        instance_builder.set_permutation(vm["permutation"].as<bool>());
-    Instance instance = instance_builder.build();
+    Instance instance = build_instance(vm);
 
     // Run.
     Output output = run(instance, vm);
 
     // Write outputs.
-    if (vm.count("certificate")) {
-        std::string certificate_format = "";
-        if (vm.count("certificate-format"))
-            certificate_format = vm["certificate-format"].as<std::string>();
-        output.solution.write(
-                vm["certificate"].as<std::string>(),
-                certificate_format);
-    }
-    if (vm.count("output"))
-        output.write_json_output(vm["output"].as<std::string>());
+    write_outputs(output, vm);
 
     return 0;
 }
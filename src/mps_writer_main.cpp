@@ -21,6 +21,7 @@ int main(int argc, char *argv[])
         ("operations-arbitrary-order,", po::value<bool>(), "set operations arbitrary order")
         ("solver,", po::value<mathoptsolverscmake::SolverName>()->required(), "set solver")
         ("output,o", po::value<std::string>()->required(), "set output path")
+        ("time-limit,t", po::value<double>(), "set time limit for the creation of the model")
         ;
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -46,10 +47,14 @@ int main(int argc, char *argv[])
         instance_builder.set_operations_arbitrary_order(vm["operations-arbitrary-order"].as<bool>());
     Instance instance = instance_builder.build();
 
+    Parameters parameters;
+    if (vm.count("time-limit"))
+        parameters.timer.set_time_limit(vm["time-limit"].as<double>());
     write_mps(
             instance,
             vm["solver"].as<mathoptsolverscmake::SolverName>(),
-            vm["output"].as<std::string>());
+            vm["output"].as<std::string>(),
+            parameters);
 
     return 0;
 }
@@ -0,0 +1,116 @@
+#include "shopschedulingsolver/output_writer.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace shopschedulingsolver;
+
+OutputWriter::OutputWriter(
+        const std::string& json_output_path,
+        const std::string& certificate_path,
+        const std::string& certificate_format,
+        double minimum_interval):
+    json_output_path_(json_output_path),
+    certificate_path_(certificate_path),
+    certificate_format_(certificate_format),
+    minimum_interval_(minimum_interval),
+    thread_(&OutputWriter::run, this) { }
+
+OutputWriter::~OutputWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+}
+
+void OutputWriter::push(const Output& output)
+{
+    std::unique_ptr<Snapshot> snapshot(new Snapshot{
+            output.json,
+            output.intermediary_outputs,
+            output.solution});
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = std::move(snapshot);
+    }
+    condition_.notify_all();
+}
+
+void OutputWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    flush_requested_ = true;
+    condition_.notify_all();
+    written_condition_.wait(lock, [this]() { return !pending_ && !writing_; });
+    flush_requested_ = false;
+}
+
+void OutputWriter::run()
+{
+    auto minimum_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(minimum_interval_));
+    bool has_written = false;
+    std::chrono::steady_clock::time_point last_write;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        condition_.wait(lock, [this]() { return stop_ || pending_; });
+        if (!pending_)
+            break;
+
+        // Throttle writes. Snapshots pushed in the meantime replace the
+        // pending one.
+        if (has_written) {
+            condition_.wait_until(
+                    lock,
+                    last_write + minimum_interval,
+                    [this]() { return stop_ || flush_requested_; });
+        }
+
+        std::unique_ptr<Snapshot> snapshot = std::move(pending_);
+        writing_ = true;
+        lock.unlock();
+        try {
+            write(*snapshot);
+        } catch (const std::exception& e) {
+            std::cerr << FUNC_SIGNATURE << ": " << e.what() << std::endl;
+        }
+        lock.lock();
+        writing_ = false;
+        has_written = true;
+        last_write = std::chrono::steady_clock::now();
+        written_condition_.notify_all();
+    }
+}
+
+void OutputWriter::write(Snapshot& snapshot) const
+{
+    // The history of the intermediary outputs is only serialized here, on
+    // the writer thread.
+    snapshot.json["IntermediaryOutputs"] = snapshot.intermediary_outputs.to_json();
+
+    if (!json_output_path_.empty()) {
+        std::string tmp_path = json_output_path_ + ".tmp";
+        {
+            std::ofstream file{tmp_path};
+            if (!file.good()) {
+                throw std::runtime_error(
+                        FUNC_SIGNATURE + ": "
+                        "Unable to open file \"" + tmp_path + "\".");
+            }
+            file << std::setw(4) << snapshot.json << std::endl;
+        }
+        if (std::rename(tmp_path.c_str(), json_output_path_.c_str()) != 0) {
+            std::remove(tmp_path.c_str());
+            throw std::runtime_error(
+                    FUNC_SIGNATURE + ": "
+                    "Unable to rename file \"" + tmp_path + "\" "
+                    "into \"" + json_output_path_ + "\".");
+        }
+    }
+    if (!certificate_path_.empty())
+        snapshot.solution.write(certificate_path_, certificate_format_);
+}
@@ -0,0 +1,229 @@
+#include "shopschedulingsolver/profiler.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <set>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+/**
+ * Thread-local buffer.
+ *
+ * Each buffer is only written by its owning thread. Atomics are only used so
+ * that other threads can read it while taking a snapshot; since there is a
+ * single writer, a relaxed load followed by a relaxed store is enough.
+ */
+struct ProfileBuffer
+{
+    ProfileBuffer();
+
+    ~ProfileBuffer();
+
+    /** Time of each entry, in nanoseconds. */
+    std::atomic<int64_t> times[maximum_number_of_profile_entries];
+
+    /** Count of each entry. */
+    std::atomic<int64_t> counts[maximum_number_of_profile_entries];
+};
+
+/** Global registry. */
+struct ProfileRegistry
+{
+    /** Mutex. */
+    std::mutex mutex;
+
+    /** Names of the entries. */
+    std::vector<std::string> names;
+
+    /** Ids of the entries from their names. */
+    std::unordered_map<std::string, ProfileEntryId> ids;
+
+    /** Buffers of the running threads. */
+    std::set<const ProfileBuffer*> buffers;
+
+    /** Accumulated times of the terminated threads. */
+    std::vector<int64_t> times = std::vector<int64_t>(maximum_number_of_profile_entries, 0);
+
+    /** Accumulated counts of the terminated threads. */
+    std::vector<int64_t> counts = std::vector<int64_t>(maximum_number_of_profile_entries, 0);
+};
+
+ProfileRegistry& profile_registry()
+{
+    // Never destroyed so that buffers of threads terminating after the end
+    // of main can still unregister.
+    static ProfileRegistry* registry = new ProfileRegistry();
+    return *registry;
+}
+
+ProfileBuffer::ProfileBuffer()
+{
+    for (ProfileEntryId profile_entry_id = 0;
+            profile_entry_id < maximum_number_of_profile_entries;
+            ++profile_entry_id) {
+        times[profile_entry_id].store(0, std::memory_order_relaxed);
+        counts[profile_entry_id].store(0, std::memory_order_relaxed);
+    }
+    ProfileRegistry& registry = profile_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.buffers.insert(this);
+}
+
+ProfileBuffer::~ProfileBuffer()
+{
+    ProfileRegistry& registry = profile_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ProfileEntryId profile_entry_id = 0;
+            profile_entry_id < maximum_number_of_profile_entries;
+            ++profile_entry_id) {
+        registry.times[profile_entry_id] += times[profile_entry_id].load(std::memory_order_relaxed);
+        registry.counts[profile_entry_id] += counts[profile_entry_id].load(std::memory_order_relaxed);
+    }
+    registry.buffers.erase(this);
+}
+
+ProfileBuffer& profile_buffer()
+{
+    thread_local ProfileBuffer buffer;
+    return buffer;
+}
+
+/** Run attached to the current thread. */
+thread_local ProfileRun* current_profile_run = nullptr;
+
+}
+
+ProfileEntryId shopschedulingsolver::profile_register(const std::string& name)
+{
+    ProfileRegistry& registry = profile_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.ids.find(name);
+    if (it != registry.ids.end())
+        return it->second;
+    ProfileEntryId profile_entry_id = registry.names.size();
+    if (profile_entry_id >= maximum_number_of_profile_entries) {
+        throw std::runtime_error(
+                FUNC_SIGNATURE + ": "
+                "too many profile entries; "
+                "maximum_number_of_profile_entries: " + std::to_string(maximum_number_of_profile_entries) + ".");
+    }
+    registry.names.push_back(name);
+    registry.ids[name] = profile_entry_id;
+    return profile_entry_id;
+}
+
+void shopschedulingsolver::profile_add(
+        ProfileEntryId profile_entry_id,
+        int64_t time,
+        Counter count)
+{
+    ProfileBuffer& buffer = profile_buffer();
+    std::atomic<int64_t>& t = buffer.times[profile_entry_id];
+    std::atomic<int64_t>& c = buffer.counts[profile_entry_id];
+    t.store(t.load(std::memory_order_relaxed) + time, std::memory_order_relaxed);
+    c.store(c.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+
+    // A run might be shared by several threads.
+    for (ProfileRun* profile_run = current_profile_run;
+            profile_run != nullptr;
+            profile_run = profile_run->parent_) {
+        profile_run->times_[profile_entry_id].fetch_add(time, std::memory_order_relaxed);
+        profile_run->counts_[profile_entry_id].fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+Profile shopschedulingsolver::profile_snapshot()
+{
+    ProfileRegistry& registry = profile_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    Profile profile;
+    for (ProfileEntryId profile_entry_id = 0;
+            profile_entry_id < (ProfileEntryId)registry.names.size();
+            ++profile_entry_id) {
+        int64_t time = registry.times[profile_entry_id];
+        int64_t count = registry.counts[profile_entry_id];
+        for (const ProfileBuffer* buffer: registry.buffers) {
+            time += buffer->times[profile_entry_id].load(std::memory_order_relaxed);
+            count += buffer->counts[profile_entry_id].load(std::memory_order_relaxed);
+        }
+        ProfileEntry entry;
+        entry.name = registry.names[profile_entry_id];
+        entry.time = (double)time / 1e9;
+        entry.count = count;
+        profile.entries.push_back(entry);
+    }
+    return profile;
+}
+
+ProfileRun::ProfileRun():
+    parent_(current_profile_run)
+{
+    for (ProfileEntryId profile_entry_id = 0;
+            profile_entry_id < maximum_number_of_profile_entries;
+            ++profile_entry_id) {
+        times_[profile_entry_id].store(0, std::memory_order_relaxed);
+        counts_[profile_entry_id].store(0, std::memory_order_relaxed);
+    }
+}
+
+Profile ProfileRun::profile() const
+{
+    ProfileRegistry& registry = profile_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    Profile profile;
+    for (ProfileEntryId profile_entry_id = 0;
+            profile_entry_id < (ProfileEntryId)registry.names.size();
+            ++profile_entry_id) {
+        ProfileEntry entry;
+        entry.name = registry.names[profile_entry_id];
+        entry.time = (double)times_[profile_entry_id].load(std::memory_order_relaxed) / 1e9;
+        entry.count = counts_[profile_entry_id].load(std::memory_order_relaxed);
+        profile.entries.push_back(entry);
+    }
+    return profile;
+}
+
+ProfileRun* shopschedulingsolver::profile_current_run()
+{
+    return current_profile_run;
+}
+
+ScopedProfileRun::ScopedProfileRun(ProfileRun* profile_run):
+    previous_profile_run_(current_profile_run)
+{
+    current_profile_run = profile_run;
+}
+
+ScopedProfileRun::~ScopedProfileRun()
+{
+    current_profile_run = previous_profile_run_;
+}
+
+Profile Profile::operator-(const Profile& profile) const
+{
+    Profile output = *this;
+    for (std::size_t pos = 0;
+            pos < profile.entries.size() && pos < output.entries.size();
+            ++pos) {
+        output.entries[pos].time -= profile.entries[pos].time;
+        output.entries[pos].count -= profile.entries[pos].count;
+    }
+    return output;
+}
+
+nlohmann::json Profile::to_json() const
+{
+    nlohmann::json json = nlohmann::json::object();
+    for (const ProfileEntry& entry: entries) {
+        if (entry.count == 0)
+            continue;
+        json[entry.name] = {
+            {"Time", entry.time},
+            {"Count", entry.count}};
+    }
+    return json;
+}
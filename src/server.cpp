@@ -0,0 +1,483 @@
+#include "shopschedulingsolver/server.hpp"
+
+#include "shopschedulingsolver/instance_builder.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+/** Maximum size of a message, in bytes. */
+const uint32_t maximum_message_size = 1 << 30;
+
+bool write_bytes(
+        int fd,
+        const char* buffer,
+        std::size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::send(fd, buffer, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        buffer += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool read_bytes(
+        int fd,
+        char* buffer,
+        std::size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::recv(fd, buffer, size, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        buffer += n;
+        size -= n;
+    }
+    return true;
+}
+
+/** Return the 64-bit FNV-1a hash of a string, in hexadecimal. */
+std::string content_hash(
+        const std::string& s)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c: s) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return ss.str();
+}
+
+}
+
+bool shopschedulingsolver::write_message(
+        int fd,
+        const nlohmann::json& message)
+{
+    std::string payload = message.dump();
+    if (payload.size() > maximum_message_size) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "message too large; "
+                "size: " + std::to_string(payload.size()) + ".");
+    }
+    uint32_t size = payload.size();
+    char header[4] = {
+        static_cast<char>((size >> 24) & 0xff),
+        static_cast<char>((size >> 16) & 0xff),
+        static_cast<char>((size >> 8) & 0xff),
+        static_cast<char>(size & 0xff),
+    };
+    return write_bytes(fd, header, 4)
+        && write_bytes(fd, payload.data(), payload.size());
+}
+
+bool shopschedulingsolver::read_message(
+        int fd,
+        nlohmann::json& message)
+{
+    unsigned char header[4];
+    if (!read_bytes(fd, reinterpret_cast<char*>(header), 4))
+        return false;
+    uint32_t size = (static_cast<uint32_t>(header[0]) << 24)
+        | (static_cast<uint32_t>(header[1]) << 16)
+        | (static_cast<uint32_t>(header[2]) << 8)
+        | static_cast<uint32_t>(header[3]);
+    // The stream cannot be resynchronized after an invalid length, so the
+    // connection is considered closed.
+    if (size > maximum_message_size)
+        return false;
+    std::string payload(size, '\0');
+    if (!read_bytes(fd, &payload[0], size))
+        return false;
+    message = nlohmann::json::parse(payload);
+    return true;
+}
+
+Server::Connection::~Connection()
+{
+    if (fd >= 0)
+        ::close(fd);
+}
+
+void Server::Connection::send(
+        const nlohmann::json& message)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    write_message(fd, message);
+}
+
+Server::Server(
+        const ServerParameters& parameters,
+        const ServerSolveFunction& solve_function):
+    parameters_(parameters),
+    solve_function_(solve_function)
+{
+    if (parameters_.socket_path.empty()) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "the socket path must not be empty.");
+    }
+    if (parameters_.socket_path.size() >= sizeof(sockaddr_un::sun_path)) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "socket path too long; "
+                "socket_path: " + parameters_.socket_path + ".");
+    }
+    if (parameters_.number_of_threads < 1)
+        parameters_.number_of_threads = 1;
+    if (parameters_.maximum_number_of_cached_instances < 1)
+        parameters_.maximum_number_of_cached_instances = 1;
+}
+
+void Server::run()
+{
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error(
+                FUNC_SIGNATURE + ": "
+                "unable to create socket; "
+                "error: " + std::strerror(errno) + ".");
+    }
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, parameters_.socket_path.c_str(), sizeof(address.sun_path) - 1);
+    // Remove the socket file left by a previous run.
+    ::unlink(parameters_.socket_path.c_str());
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+            || ::listen(listen_fd_, 16) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(listen_fd_);
+        throw std::runtime_error(
+                FUNC_SIGNATURE + ": "
+                "unable to listen on socket \"" + parameters_.socket_path + "\"; "
+                "error: " + error + ".");
+    }
+
+    for (Counter thread_id = 0;
+            thread_id < parameters_.number_of_threads;
+            ++thread_id) {
+        worker_threads_.push_back(std::thread(&Server::run_worker, this));
+    }
+    listening_ = true;
+
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_)
+                break;
+        }
+        pollfd poll_fd;
+        poll_fd.fd = listen_fd_;
+        poll_fd.events = POLLIN;
+        if (::poll(&poll_fd, 1, 100) <= 0)
+            continue;
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        join_ended_connections();
+        auto connection = std::make_shared<Connection>();
+        connection->fd = fd;
+        // The thread is started with the lock held, so that it cannot end
+        // before being stored in its connection.
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_.push_back(connection);
+        connection->thread = std::thread(&Server::run_connection, this, connection);
+    }
+    listening_ = false;
+    ::close(listen_fd_);
+    ::unlink(parameters_.socket_path.c_str());
+
+    // Unblock the connection threads and wait for them.
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (const auto& connection: connections_)
+            ::shutdown(connection->fd, SHUT_RDWR);
+        condition_.wait(lock, [this]() { return connections_.empty(); });
+    }
+    join_ended_connections();
+
+    condition_.notify_all();
+    for (std::thread& thread: worker_threads_)
+        thread.join();
+    worker_threads_.clear();
+}
+
+void Server::stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    for (const auto& p: solves_)
+        p.second->cancelled = true;
+    condition_.notify_all();
+}
+
+void Server::run_connection(
+        std::shared_ptr<Connection> connection)
+{
+    for (;;) {
+        nlohmann::json request;
+        nlohmann::json reply;
+        try {
+            if (!read_message(connection->fd, request))
+                break;
+            std::string type = request.at("type").get<std::string>();
+            if (type == "submit") {
+                reply = submit(request);
+            } else if (type == "solve") {
+                queue_solve(connection, request);
+                continue;
+            } else if (type == "cancel") {
+                reply = cancel(connection, request);
+            } else {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "unknown request type \"" + type + "\".");
+            }
+        } catch (const std::exception& e) {
+            reply = {{"type", "error"}, {"message", e.what()}};
+        }
+        connection->send(reply);
+    }
+
+    // Cancel the solves of the connection.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& p: solves_)
+        if (p.second->connection == connection)
+            p.second->cancelled = true;
+    connections_.erase(std::find(connections_.begin(), connections_.end(), connection));
+    ended_connections_.push_back(connection);
+    condition_.notify_all();
+}
+
+void Server::join_ended_connections()
+{
+    std::vector<std::shared_ptr<Connection>> ended_connections;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ended_connections.swap(ended_connections_);
+    }
+    // The threads might still be releasing the mutex.
+    for (const auto& connection: ended_connections)
+        connection->thread.join();
+}
+
+void Server::run_worker()
+{
+    for (;;) {
+        std::shared_ptr<Solve> solve;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+            if (queue_.empty())
+                break;
+            solve = queue_.front();
+            queue_.pop_front();
+        }
+
+        Counter solve_id = solve->id;
+        std::shared_ptr<Connection> connection = solve->connection;
+        ServerSolve& server_solve = solve->solve;
+        server_solve.parameters = Parameters();
+        server_solve.parameters.verbosity_level = 0;
+        server_solve.parameters.log_to_stderr = false;
+        server_solve.parameters.messages_to_stdout = false;
+        if (solve->time_limit != std::numeric_limits<double>::infinity())
+            server_solve.parameters.timer.set_time_limit(solve->time_limit);
+        server_solve.parameters.timer.add_end_boolean(&solve->cancelled);
+        server_solve.parameters.new_solution_callback = [connection, solve_id](
+                const Output& output)
+        {
+            connection->send({
+                    {"type", "solution"},
+                    {"solve_id", solve_id},
+                    {"output", output.to_json()}});
+        };
+
+        nlohmann::json reply;
+        try {
+            // A solve cancelled in the queue is still run, and stops at once,
+            // so that the client gets the same reply as for a running solve.
+            Output output = solve_function_(server_solve);
+            std::lock_guard<std::mutex> lock(mutex_);
+            reply = {
+                {"type", "end"},
+                {"solve_id", solve_id},
+                {"cancelled", solve->cancelled},
+                {"output", output.to_json()}};
+        } catch (const std::exception& e) {
+            reply = {
+                {"type", "error"},
+                {"solve_id", solve_id},
+                {"message", e.what()}};
+        }
+        connection->send(reply);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        solves_.erase(solve_id);
+    }
+}
+
+nlohmann::json Server::submit(
+        const nlohmann::json& request)
+{
+    nlohmann::json key_json = request;
+    key_json.erase("type");
+    std::string key = key_json.dump();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool cached = false;
+        std::string instance_id = find_instance_id(key, cached);
+        if (cached) {
+            return {
+                {"type", "instance"},
+                {"instance_id", instance_id},
+                {"cached", true}};
+        }
+    }
+
+    // Build the instance without holding the lock, since it might be long.
+    std::string format = "";
+    if (request.contains("format"))
+        format = request["format"].get<std::string>();
+    std::stringstream content_ss(request.at("content").get<std::string>());
+    InstanceBuilder instance_builder;
+    instance_builder.read(content_ss, format);
+    if (request.contains("objective")) {
+        std::stringstream objective_ss(request["objective"].get<std::string>());
+        Objective objective;
+        objective_ss >> objective;
+        instance_builder.set_objective(objective);
+    }
+    if (request.contains("operations_arbitrary_order"))
+        instance_builder.set_operations_arbitrary_order(request["operations_arbitrary_order"].get<bool>());
+    if (request.contains("no_wait"))
+        instance_builder.set_no_wait(request["no_wait"].get<bool>());
+    if (request.contains("no_idle"))
+        instance_builder.set_all_machines_no_idle(request["no_idle"].get<bool>());
+    if (request.contains("blocking"))
+        instance_builder.set_blocking(request["blocking"].get<bool>());
+    if (request.contains("permutation"))
+        instance_builder.set_permutation(request["permutation"].get<bool>());
+    auto instance = std::make_shared<const Instance>(instance_builder.build());
+
+    // The instance might have been cached meanwhile by another connection.
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool cached = false;
+    std::string instance_id = find_instance_id(key, cached);
+    if (!cached) {
+        instances_[instance_id] = {key, instance};
+        instance_ids_.push_back(instance_id);
+        while ((Counter)instance_ids_.size() > parameters_.maximum_number_of_cached_instances) {
+            instances_.erase(instance_ids_.front());
+            instance_ids_.pop_front();
+        }
+    }
+    return {
+        {"type", "instance"},
+        {"instance_id", instance_id},
+        {"cached", false}};
+}
+
+std::string Server::find_instance_id(
+        const std::string& key,
+        bool& cached) const
+{
+    std::string hash = content_hash(key);
+    for (Counter collision_id = 0;; ++collision_id) {
+        std::string instance_id = (collision_id == 0)?
+            hash:
+            hash + "-" + std::to_string(collision_id);
+        auto it = instances_.find(instance_id);
+        if (it == instances_.end()) {
+            cached = false;
+            return instance_id;
+        }
+        if (it->second.key == key) {
+            cached = true;
+            return instance_id;
+        }
+    }
+}
+
+void Server::queue_solve(
+        const std::shared_ptr<Connection>& connection,
+        const nlohmann::json& request)
+{
+    auto solve = std::make_shared<Solve>();
+    solve->connection = connection;
+    std::string instance_id = request.at("instance_id").get<std::string>();
+    solve->solve.algorithm = request.at("algorithm").get<std::string>();
+    if (request.contains("seed"))
+        solve->solve.seed = request["seed"].get<Seed>();
+    if (request.contains("parameters"))
+        solve->solve.algorithm_parameters = request["parameters"];
+    if (request.contains("time_limit"))
+        solve->time_limit = request["time_limit"].get<double>();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = instances_.find(instance_id);
+        if (it == instances_.end()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "unknown instance; "
+                    "instance_id: " + instance_id + ".");
+        }
+        solve->solve.instance = it->second.instance;
+        solve->id = next_solve_id_++;
+        solves_[solve->id] = solve;
+    }
+
+    // The reply is sent before the solve is queued, so that it reaches the
+    // client before the first solution.
+    connection->send({{"type", "solve"}, {"solve_id", solve->id}});
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_)
+        solve->cancelled = true;
+    queue_.push_back(solve);
+    condition_.notify_all();
+}
+
+nlohmann::json Server::cancel(
+        const std::shared_ptr<Connection>& connection,
+        const nlohmann::json& request)
+{
+    Counter solve_id = request.at("solve_id").get<Counter>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = solves_.find(solve_id);
+    // Solves which already ended are ignored.
+    if (it != solves_.end()) {
+        if (it->second->connection != connection) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "the solve belongs to another connection; "
+                    "solve_id: " + std::to_string(solve_id) + ".");
+        }
+        it->second->cancelled = true;
+    }
+    return {{"type", "cancel"}, {"solve_id", solve_id}};
+}
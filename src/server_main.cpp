@@ -0,0 +1,95 @@
+#include "shopschedulingsolver/server.hpp"
+#include "shopschedulingsolver/algorithm_options.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <csignal>
+#include <string>
+#include <thread>
+
+using namespace shopschedulingsolver;
+namespace po = boost::program_options;
+
+namespace
+{
+
+/**
+ * Run the algorithm of a solve.
+ *
+ * The parameters of the algorithms are read as the options of the command
+ * line solver, with underscores instead of dashes.
+ */
+Output solve(
+        const po::options_description& desc,
+        const ServerSolve& solve)
+{
+    po::variables_map vm = read_algorithm_options(desc, solve.algorithm_parameters);
+    std::mt19937_64 generator(solve.seed);
+    return run_algorithm(
+            *solve.instance,
+            solve.algorithm,
+            generator,
+            vm,
+            [&solve](Parameters& parameters) { solve.set_parameters(parameters); });
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    // Parse program options
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        (",h", "Produce help message")
+        ("socket,s", po::value<std::string>()->required(), "set path of the Unix domain socket")
+        ("number-of-threads,t", po::value<Counter>(), "set number of solves run concurrently (default: number of cores)")
+        ("maximum-number-of-cached-instances,", po::value<Counter>(), "set maximum number of instances kept in cache")
+        ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;;
+        return 1;
+    }
+    try {
+        po::notify(vm);
+    } catch (const po::required_option& e) {
+        std::cout << desc << std::endl;;
+        return 1;
+    }
+
+    ServerParameters parameters;
+    parameters.socket_path = vm["socket"].as<std::string>();
+    if (vm.count("number-of-threads"))
+        parameters.number_of_threads = vm["number-of-threads"].as<Counter>();
+    if (vm.count("maximum-number-of-cached-instances"))
+        parameters.maximum_number_of_cached_instances = vm["maximum-number-of-cached-instances"].as<Counter>();
+
+    po::options_description algorithm_desc;
+    add_algorithm_options(algorithm_desc);
+    Server server(
+            parameters,
+            [&algorithm_desc](const ServerSolve& server_solve)
+            {
+                return solve(algorithm_desc, server_solve);
+            });
+
+    // Stop the server on SIGINT and SIGTERM. The signals are blocked in all
+    // the threads and waited for by a dedicated one, since stopping the
+    // server is not async-signal-safe.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::thread([&server, signals]()
+    {
+        int signal = 0;
+        sigwait(&signals, &signal);
+        server.stop();
+    }).detach();
+
+    std::cout << "Listening on " << parameters.socket_path << std::endl;
+    server.run();
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include "shopschedulingsolver/solution.hpp"
 
+#include <cstdio>
+
 using namespace shopschedulingsolver;
 
 double Solution::objective_value() const
@@ -28,6 +30,8 @@ bool Solution::feasible() const
         && this->number_of_job_overlaps() == 0
         && this->number_of_machine_overlaps() == 0
         && this->number_of_precedence_violations() == 0
+        && this->number_of_fixed_operation_violations() == 0
+        && this->number_of_machine_availability_violations() == 0
         && (!this->instance().no_wait() || this->no_wait())
         && (!this->instance().no_idle() || this->no_idle())
         && (!this->instance().blocking() || this->blocking())
@@ -55,41 +59,158 @@ bool Solution::strictly_better(const Solution& solution) const
     return false;
 }
 
+namespace
+{
+
+void write_json(
+        const Solution& solution,
+        std::ostream& os,
+        bool compact)
+{
+    const std::string nl = (compact)? "": "\n";
+    const std::string i1 = (compact)? "": "    ";
+    const std::string i2 = (compact)? "": "        ";
+    const std::string i3 = (compact)? "": "            ";
+    const std::string sep = (compact)? ":": ": ";
+    os << "{" << nl
+        << i1 << "\"number_of_machines\"" << sep << solution.instance().number_of_machines() << "," << nl
+        << i1 << "\"number_of_jobs\"" << sep << solution.instance().number_of_jobs() << "," << nl
+        << i1 << "\"number_of_operations\"" << sep << solution.instance().number_of_operations() << "," << nl
+        << i1 << "\"operations\"" << sep << "[";
+    for (SolutionOperationId solution_operation_id = 0;
+            solution_operation_id < solution.number_of_operations();
+            ++solution_operation_id) {
+        const Solution::Operation& solution_operation = solution.operation(solution_operation_id);
+        const auto& job = solution.instance().job(solution_operation.job_id);
+        const auto& operation = job.operations[solution_operation.operation_id];
+        const auto& alternative = operation.alternatives[solution_operation.alternative_id];
+        if (solution_operation_id > 0)
+            os << ",";
+        os << nl << i2 << "{" << nl
+            << i3 << "\"job_id\"" << sep << solution_operation.job_id << "," << nl
+            << i3 << "\"job_position\"" << sep << solution_operation.job_position << "," << nl
+            << i3 << "\"operation_id\"" << sep << solution_operation.operation_id << "," << nl
+            << i3 << "\"alternative_id\"" << sep << solution_operation.alternative_id << "," << nl
+            << i3 << "\"machine_id\"" << sep << solution_operation.machine_id << "," << nl
+            << i3 << "\"machine_position\"" << sep << solution_operation.machine_position << "," << nl
+            << i3 << "\"start\"" << sep << solution_operation.start << "," << nl
+            << i3 << "\"processing_time\"" << sep << alternative.processing_time << "," << nl
+            << i3 << "\"end\"" << sep << solution_operation.start + alternative.processing_time << nl
+            << i2 << "}";
+    }
+    if (solution.number_of_operations() > 0)
+        os << nl << i1;
+    os << "]" << nl << "}" << std::endl;
+}
+
+void write_csv(
+        const Solution& solution,
+        std::ostream& os)
+{
+    os << "job_id,job_position,operation_id,alternative_id,machine_id,machine_position,start,processing_time,end\n";
+    for (SolutionOperationId solution_operation_id = 0;
+            solution_operation_id < solution.number_of_operations();
+            ++solution_operation_id) {
+        const Solution::Operation& solution_operation = solution.operation(solution_operation_id);
+        const auto& job = solution.instance().job(solution_operation.job_id);
+        const auto& operation = job.operations[solution_operation.operation_id];
+        const auto& alternative = operation.alternatives[solution_operation.alternative_id];
+        os
+            << solution_operation.job_id << ","
+            << solution_operation.job_position << ","
+            << solution_operation.operation_id << ","
+            << solution_operation.alternative_id << ","
+            << solution_operation.machine_id << ","
+            << solution_operation.machine_position << ","
+            << solution_operation.start << ","
+            << alternative.processing_time << ","
+            << solution_operation.start + alternative.processing_time << "\n";
+    }
+}
+
+void write_int64(
+        std::ostream& os,
+        int64_t value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write_binary(
+        const Solution& solution,
+        std::ostream& os)
+{
+    os.write(solution_binary_format_magic, 4);
+    write_int64(os, solution_binary_format_version);
+    write_int64(os, solution.instance().number_of_machines());
+    write_int64(os, solution.instance().number_of_jobs());
+    write_int64(os, solution.number_of_operations());
+    for (SolutionOperationId solution_operation_id = 0;
+            solution_operation_id < solution.number_of_operations();
+            ++solution_operation_id) {
+        const Solution::Operation& solution_operation = solution.operation(solution_operation_id);
+        write_int64(os, solution_operation.job_id);
+        write_int64(os, solution_operation.operation_id);
+        write_int64(os, solution_operation.alternative_id);
+        write_int64(os, solution_operation.start);
+    }
+}
+
+}
+
 void Solution::write(
         const std::string& certificate_path,
         const std::string& format) const
 {
     if (certificate_path.empty())
         return;
-    std::ofstream file{certificate_path};
-    if (!file.good()) {
+
+    // Write into a temporary file first and rename it afterwards so that
+    // readers never see a partially written certificate.
+    std::string tmp_path = certificate_path + ".tmp";
+    {
+        std::ofstream file{tmp_path, std::ios::out | std::ios::binary | std::ios::trunc};
+        if (!file.good()) {
+            throw std::runtime_error(
+                    FUNC_SIGNATURE + ": "
+                    "Unable to open file \"" + tmp_path + "\".");
+        }
+
+        try {
+            if (format == "" || format == "default" || format == "json") {
+                write_json(*this, file, false);
+            } else if (format == "json-compact") {
+                write_json(*this, file, true);
+            } else if (format == "csv") {
+                write_csv(*this, file);
+            } else if (format == "binary") {
+                write_binary(*this, file);
+            } else {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "unknown certificate format \"" + format + "\".");
+            }
+        } catch (...) {
+            file.close();
+            std::remove(tmp_path.c_str());
+            throw;
+        }
+
+        // Closing flushes the buffer, which might fail as well.
+        file.close();
+        if (!file.good()) {
+            std::remove(tmp_path.c_str());
+            throw std::runtime_error(
+                    FUNC_SIGNATURE + ": "
+                    "Unable to write file \"" + tmp_path + "\".");
+        }
+    }
+    if (std::rename(tmp_path.c_str(), certificate_path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
         throw std::runtime_error(
                 FUNC_SIGNATURE + ": "
-                "Unable to open file \"" + certificate_path + "\".");
-    }
-
-    nlohmann::json json;
-    json["number_of_machines"] = this->instance().number_of_machines();
-    json["number_of_jobs"] = this->instance().number_of_jobs();
-    json["number_of_operations"] = this->instance().number_of_operations();
-    for (SolutionOperationId solution_operation_id = 0;
-            solution_operation_id < this->number_of_operations();
-            ++solution_operation_id) {
-        const Solution::Operation& solution_operation = this->operation(solution_operation_id);
-        const auto& job = this->instance().job(solution_operation.job_id);
-        const auto& operation = job.operations[solution_operation.operation_id];
-        const auto& alternative = operation.alternatives[solution_operation.alternative_id];
-        json["operations"][solution_operation_id]["job_id"] = solution_operation.job_id;
-        json["operations"][solution_operation_id]["job_position"] = solution_operation.job_position;
-        json["operations"][solution_operation_id]["operation_id"] = solution_operation.operation_id;
-        json["operations"][solution_operation_id]["alternative_id"] = solution_operation.alternative_id;
-        json["operations"][solution_operation_id]["machine_id"] = solution_operation.machine_id;
-        json["operations"][solution_operation_id]["machine_position"] = solution_operation.machine_position;
-        json["operations"][solution_operation_id]["start"] = solution_operation.start;
-        json["operations"][solution_operation_id]["processing_time"] = alternative.processing_time;
-        json["operations"][solution_operation_id]["end"] = solution_operation.start + alternative.processing_time;
+                "Unable to rename file \"" + tmp_path + "\" "
+                "into \"" + certificate_path + "\".");
     }
-    file << std::setw(4) << json << std::endl;
 }
 
 nlohmann::json Solution::to_json() const
@@ -100,6 +221,8 @@ nlohmann::json Solution::to_json() const
         {"NumberOfMachinesOverlaps", this->number_of_machine_overlaps()},
         {"NumberOfPrecedence violations", this->number_of_precedence_violations()},
         {"NumberOfReleaseDateViolations", this->number_of_release_date_violations()},
+        {"NumberOfFixedOperationViolations", this->number_of_fixed_operation_violations()},
+        {"NumberOfMachineAvailabilityViolations", this->number_of_machine_availability_violations()},
         {"Makespan", this->makespan()},
         {"TotalFlowTime", this->total_flow_time()},
         {"Throughput", this->throughput()},
@@ -119,6 +242,8 @@ void Solution::format(
             << "# machine overlaps:          " << this->number_of_machine_overlaps() << std::endl
             << "# precedence violations:     " << this->number_of_precedence_violations() << std::endl
             << "# release dates violations:  " << this->number_of_release_date_violations() << std::endl
+            << "# fixed op. violations:      " << this->number_of_fixed_operation_violations() << std::endl
+            << "# mach. avail. violations:   " << this->number_of_machine_availability_violations() << std::endl
             << "No-wait:                     " << this->no_wait() << std::endl
             << "No-idle:                     " << this->no_idle() << std::endl
             << "Blocking:                    " << this->blocking() << std::endl
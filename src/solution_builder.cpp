@@ -1,5 +1,10 @@
 #include "shopschedulingsolver/solution_builder.hpp"
 
+#include "shopschedulingsolver/profiler.hpp"
+
+#include <algorithm>
+#include <sstream>
+
 using namespace shopschedulingsolver;
 
 SolutionBuilder& SolutionBuilder::set_instance(
@@ -100,6 +105,7 @@ void SolutionBuilder::sort_jobs()
 
 Solution SolutionBuilder::build()
 {
+    SHOPSCHEDULINGSOLVER_PROFILE_SCOPE("SolutionBuilder/Build");
     const Instance& instance = this->solution_.instance();
 
     for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
@@ -124,6 +130,13 @@ Solution SolutionBuilder::build()
                     && o.start != current_time) {
                 this->solution_.no_wait_ = false;
             }
+            // Check fixed operation.
+            const Operation& operation = job.operations[o.operation_id];
+            if (operation.fixed_start != -1
+                    && (o.start != operation.fixed_start
+                        || o.alternative_id != operation.fixed_alternative_id)) {
+                this->solution_.number_of_fixed_operation_violations_++;
+            }
             // Check precedences.
             if (!instance.operations_arbitrary_order())
                 if (o.operation_id < operation_prev_id)
@@ -167,6 +180,11 @@ Solution SolutionBuilder::build()
             // Check machine overlap.
             if (o.start < current_time)
                 this->solution_.number_of_machine_overlaps_++;
+            // Check machine availability.
+            if (o.start < machine.availability_time
+                    && instance.job(o.job_id).operations[o.operation_id].fixed_start == -1) {
+                this->solution_.number_of_machine_availability_violations_++;
+            }
             // Check no-idle.
             if (o.start != solution_machine.start
                     && o.start != current_time) {
@@ -224,13 +242,23 @@ void SolutionBuilder::from_permutation(
         const std::vector<JobId>& job_ids)
 {
     const Instance& instance = this->solution_.instance();
+    if ((instance.blocking() || instance.mixed_no_idle() || instance.no_wait())
+            && (instance.number_of_fixed_operations() > 0
+                || instance.has_machine_availability_times())) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "fixed operations and machine availability times are only "
+                "supported without blocking, no-idle machines and no-wait.");
+    }
     if (instance.blocking()) {
         std::vector<Time> machines_departure_times(instance.number_of_machines(), 0);
         MachineId last_machine_id = instance.number_of_machines() - 1;
         for (JobId job_id: job_ids) {
             const Job& job = instance.job(job_id);
             {
-                Time start0 = machines_departure_times[0];
+                Time start0 = (std::max)(
+                        machines_departure_times[0],
+                        job.release_date);
                 this->append_operation(
                         job_id,
                         0,  // operation_id
@@ -277,17 +305,113 @@ void SolutionBuilder::from_permutation(
                 machines_departure_times[last_machine_id] = start + p;
             }
         }
-    } else if (instance.no_idle()) {
-        throw std::invalid_argument(
-                FUNC_SIGNATURE + ": no-idle not supported.");
+    } else if (instance.mixed_no_idle()) {
+        if (instance.no_wait()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": no-wait with no-idle machines not supported.");
+        }
+        // Schedule machine by machine. On a no-idle machine, the jobs are
+        // first scheduled as early as possible, then right-shifted so that
+        // they are processed contiguously and the last one doesn't move.
+        JobId number_of_jobs = job_ids.size();
+        std::vector<Time> completion_times(
+                instance.number_of_machines() * number_of_jobs);
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            Time* machine_completion_times = completion_times.data()
+                + machine_id * number_of_jobs;
+            Time current_time = 0;
+            for (JobId pos = 0; pos < number_of_jobs; ++pos) {
+                const Job& job = instance.job(job_ids[pos]);
+                Time ready_time = (machine_id == 0)?
+                    job.release_date:
+                    machine_completion_times[pos - number_of_jobs];
+                current_time = (std::max)(current_time, ready_time)
+                    + job.operations[machine_id].alternatives[0].processing_time;
+                machine_completion_times[pos] = current_time;
+            }
+            if (instance.machine(machine_id).no_idle) {
+                for (JobId pos = number_of_jobs - 2; pos >= 0; --pos) {
+                    const Job& next_job = instance.job(job_ids[pos + 1]);
+                    machine_completion_times[pos] = machine_completion_times[pos + 1]
+                        - next_job.operations[machine_id].alternatives[0].processing_time;
+                }
+            }
+        }
+        for (JobId pos = 0; pos < number_of_jobs; ++pos) {
+            JobId job_id = job_ids[pos];
+            const Job& job = instance.job(job_id);
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                Time p = job.operations[machine_id].alternatives[0].processing_time;
+                this->append_operation(
+                        job_id,
+                        machine_id,  // operation_id
+                        0,  // operation_machine_id
+                        completion_times[machine_id * number_of_jobs + pos] - p);
+            }
+        }
     } else if (instance.no_wait()) {
-        throw std::invalid_argument(
-                FUNC_SIGNATURE + ": no-wait not supported.");
+        // Each job is processed without interruption, so its schedule is
+        // determined by its start on machine 0. The start of a job is the
+        // start of the previous job plus the minimum delay between them,
+        // i.e. the smallest shift such that the job never starts on a
+        // machine before the previous job has left it.
+        JobId previous_job_id = -1;
+        Time previous_start = 0;
+        for (JobId job_id: job_ids) {
+            const Job& job = instance.job(job_id);
+            Time start = job.release_date;
+            if (previous_job_id != -1) {
+                const Job& previous_job = instance.job(previous_job_id);
+                Time delay = 0;
+                Time previous_end = 0;
+                Time current_start = 0;
+                for (MachineId machine_id = 0;
+                        machine_id < instance.number_of_machines();
+                        ++machine_id) {
+                    previous_end += previous_job.operations[machine_id].alternatives[0].processing_time;
+                    delay = (std::max)(delay, previous_end - current_start);
+                    current_start += job.operations[machine_id].alternatives[0].processing_time;
+                }
+                start = (std::max)(start, previous_start + delay);
+            }
+            Time current_time = start;
+            for (MachineId machine_id = 0;
+                    machine_id < instance.number_of_machines();
+                    ++machine_id) {
+                this->append_operation(
+                        job_id,
+                        machine_id,  // operation_id
+                        0,  // operation_machine_id
+                        current_time);
+                current_time += job.operations[machine_id].alternatives[0].processing_time;
+            }
+            previous_job_id = job_id;
+            previous_start = start;
+        }
     } else {
+        // Fixed operations are scheduled at their fixed starts; the other
+        // operations are scheduled as early as possible, after the
+        // availability times of the machines.
         std::vector<Time> machines_current_times(instance.number_of_machines(), 0);
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            machines_current_times[machine_id] = instance.machine(machine_id).availability_time;
+        }
         for (JobId job_id: job_ids) {
             const Job& job = instance.job(job_id);
-            Time start0 = machines_current_times[0];
+            // The machines might become available after the end of the
+            // fixed operations.
+            Time start0 = (std::max)({
+                    machines_current_times[0],
+                    instance.machine(0).availability_time,
+                    job.release_date});
+            if (job.operations[0].fixed_start != -1)
+                start0 = job.operations[0].fixed_start;
             this->append_operation(
                     job_id,
                     0,  // operation_id
@@ -305,6 +429,9 @@ void SolutionBuilder::from_permutation(
                 } else {
                     start = machines_current_times[machine_id];
                 }
+                start = (std::max)(start, instance.machine(machine_id).availability_time);
+                if (job.operations[machine_id].fixed_start != -1)
+                    start = job.operations[machine_id].fixed_start;
                 this->append_operation(
                         job_id,
                         machine_id,  // operation_id
@@ -321,14 +448,15 @@ void SolutionBuilder::read(
         const std::string& certificate_path,
         const std::string& format)
 {
-    std::ifstream file(certificate_path);
+    std::ifstream file(certificate_path, std::ios::in | std::ios::binary);
     if (!file.good()) {
         throw std::runtime_error(
                 FUNC_SIGNATURE + ": "
                 "unable to open file \"" + certificate_path + "\".");
     }
 
-    if (format == "" || format == "default") {
+    if (format == "" || format == "default"
+            || format == "json" || format == "json-compact") {
         nlohmann ::json j;
         file >> j;
         for (const auto& json_operation: j["operations"]) {
@@ -349,5 +477,86 @@ void SolutionBuilder::read(
             job_ids.push_back(job_id);
         }
         from_permutation(job_ids);
+    } else if (format == "csv") {
+        std::string line;
+        std::getline(file, line);  // Header.
+        while (std::getline(file, line)) {
+            if (line.empty())
+                continue;
+            std::vector<Time> values;
+            std::stringstream ss(line);
+            std::string value;
+            while (std::getline(ss, value, ','))
+                values.push_back(std::stoll(value));
+            if (values.size() < 7) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "invalid line \"" + line + "\".");
+            }
+            this->append_operation(
+                    values[0],  // job_id
+                    values[2],  // operation_id
+                    values[3],  // alternative_id
+                    values[6]);  // start
+        }
+        sort_machines();
+        sort_jobs();
+    } else if (format == "binary") {
+        auto read_int64 = [&file]()
+        {
+            int64_t value = 0;
+            file.read(reinterpret_cast<char*>(&value), sizeof(value));
+            return value;
+        };
+        char magic[4];
+        file.read(magic, 4);
+        if (!file.good()
+                || std::string(magic, 4) != std::string(solution_binary_format_magic, 4)
+                || read_int64() != solution_binary_format_version) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "invalid binary certificate \"" + certificate_path + "\".");
+        }
+        // The certificate must have been written for an instance of the same
+        // size; otherwise, its ids refer to other jobs and machines.
+        const Instance& instance = this->solution_.instance();
+        int64_t number_of_machines = read_int64();
+        int64_t number_of_jobs = read_int64();
+        if (number_of_machines != instance.number_of_machines()
+                || number_of_jobs != instance.number_of_jobs()) {
+            throw std::invalid_argument(
+                    FUNC_SIGNATURE + ": "
+                    "the binary certificate \"" + certificate_path + "\" "
+                    "does not match the instance; "
+                    "number of machines: " + std::to_string(number_of_machines) + " "
+                    "(instance: " + std::to_string(instance.number_of_machines()) + "); "
+                    "number of jobs: " + std::to_string(number_of_jobs) + " "
+                    "(instance: " + std::to_string(instance.number_of_jobs()) + ").");
+        }
+        SolutionOperationId number_of_operations = read_int64();
+        for (SolutionOperationId solution_operation_id = 0;
+                solution_operation_id < number_of_operations;
+                ++solution_operation_id) {
+            JobId job_id = read_int64();
+            OperationId operation_id = read_int64();
+            AlternativeId alternative_id = read_int64();
+            Time start = read_int64();
+            if (!file.good()) {
+                throw std::invalid_argument(
+                        FUNC_SIGNATURE + ": "
+                        "truncated binary certificate \"" + certificate_path + "\".");
+            }
+            this->append_operation(
+                    job_id,
+                    operation_id,
+                    alternative_id,
+                    start);
+        }
+        sort_machines();
+        sort_jobs();
+    } else {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "unknown certificate format \"" + format + "\".");
     }
 }
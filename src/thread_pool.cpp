@@ -0,0 +1,233 @@
+#include "shopschedulingsolver/thread_pool.hpp"
+
+#include <chrono>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+/** Thread pool of which the current thread is a worker. */
+thread_local ThreadPool* current_thread_pool = nullptr;
+
+/** Id of the current thread in its thread pool. */
+thread_local Counter current_worker_id = -1;
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// ThreadPool ///////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ThreadPool::ThreadPool(
+        Counter number_of_threads):
+    worker_deques_((number_of_threads >= 0)? number_of_threads: 0)
+{
+    if (number_of_threads < 0) {
+        throw std::invalid_argument(
+                FUNC_SIGNATURE + ": "
+                "'number_of_threads' must be non-negative; "
+                "number_of_threads: " + std::to_string(number_of_threads) + ".");
+    }
+    for (Counter worker_id = 0; worker_id < number_of_threads; ++worker_id)
+        worker_threads_.push_back(std::thread(&ThreadPool::run_worker, this, worker_id));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    for (std::thread& thread: worker_threads_)
+        thread.join();
+}
+
+void ThreadPool::submit(Task&& task)
+{
+    WorkerDeque& deque = (current_thread_pool == this)?
+        worker_deques_[current_worker_id]:
+        shared_deque_;
+    {
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        deque.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        number_of_queued_tasks_++;
+    }
+    condition_.notify_one();
+}
+
+bool ThreadPool::run_one()
+{
+    Task task;
+    bool found = false;
+
+    // Most recent task of the deque of the current thread.
+    if (current_thread_pool == this) {
+        WorkerDeque& deque = worker_deques_[current_worker_id];
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        if (!deque.tasks.empty()) {
+            task = std::move(deque.tasks.back());
+            deque.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    // Oldest task of the shared deque.
+    if (!found) {
+        std::lock_guard<std::mutex> lock(shared_deque_.mutex);
+        if (!shared_deque_.tasks.empty()) {
+            task = std::move(shared_deque_.tasks.front());
+            shared_deque_.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    // Oldest task of the deque of another worker.
+    Counter number_of_deques = worker_deques_.size();
+    Counter worker_id = (current_thread_pool == this)? current_worker_id: 0;
+    for (Counter offset = 0;
+            !found && offset < number_of_deques;
+            ++offset) {
+        WorkerDeque& deque = worker_deques_[(worker_id + offset) % number_of_deques];
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        if (!deque.tasks.empty()) {
+            task = std::move(deque.tasks.front());
+            deque.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found)
+        return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        number_of_queued_tasks_--;
+    }
+    task.task_group->execute(task);
+    return true;
+}
+
+void ThreadPool::run_worker(Counter worker_id)
+{
+    current_thread_pool = this;
+    current_worker_id = worker_id;
+    for (;;) {
+        if (run_one())
+            continue;
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return stop_ || number_of_queued_tasks_ > 0; });
+        if (stop_)
+            break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////// TaskGroup ///////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+TaskGroup::TaskGroup(
+        ThreadPool& thread_pool,
+        std::mt19937_64& generator,
+        const optimizationtools::Timer& timer):
+    thread_pool_(thread_pool),
+    generator_(generator),
+    timer_(timer)
+{
+    timer_.add_end_boolean(&cancelled_);
+}
+
+TaskGroup::~TaskGroup()
+{
+    cancel();
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(const TaskFunction& function)
+{
+    ThreadPool::Task task;
+    task.task_group = this;
+    task.task_id = number_of_tasks_;
+    task.seed = generator_();
+    task.profile_run = profile_current_run();
+    task.function = function;
+    number_of_tasks_++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        number_of_pending_tasks_++;
+    }
+    thread_pool_.submit(std::move(task));
+}
+
+void TaskGroup::wait()
+{
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (number_of_pending_tasks_ == 0)
+                break;
+        }
+        // Run tasks meanwhile; they might not belong to this group.
+        if (thread_pool_.run_one())
+            continue;
+        // The remaining tasks of the group are running in other threads,
+        // which might still submit tasks that this thread could run.
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait_for(
+                lock,
+                std::chrono::milliseconds(1),
+                [this]() { return number_of_pending_tasks_ == 0; });
+    }
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        exception = exception_;
+        exception_ = nullptr;
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void TaskGroup::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+}
+
+bool TaskGroup::cancelled()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+}
+
+void TaskGroup::execute(ThreadPool::Task& task)
+{
+    if (!timer_.needs_to_end()) {
+        try {
+            ScopedProfileRun scoped_profile_run(task.profile_run);
+            TaskContext task_context {
+                task.task_id,
+                std::mt19937_64(task.seed),
+                timer_};
+            task.function(task_context);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!exception_)
+                exception_ = std::current_exception();
+            cancelled_ = true;
+        }
+    }
+
+    // The group might be destroyed as soon as its last task ends, so it is
+    // not accessed after the notification.
+    std::lock_guard<std::mutex> lock(mutex_);
+    number_of_pending_tasks_--;
+    condition_.notify_all();
+}
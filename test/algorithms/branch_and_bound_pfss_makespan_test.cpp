@@ -0,0 +1,104 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/branch_and_bound_pfss_makespan.hpp"
+#include "shopschedulingsolver/solution_builder.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+Time optimal_makespan(
+        const Instance& instance)
+{
+    std::vector<JobId> jobs(instance.number_of_jobs());
+    std::iota(jobs.begin(), jobs.end(), 0);
+    Time makespan = std::numeric_limits<Time>::max();
+    do {
+        SolutionBuilder solution_builder;
+        solution_builder.set_instance(instance);
+        solution_builder.from_permutation(jobs);
+        makespan = (std::min)(makespan, solution_builder.build().makespan());
+    } while (std::next_permutation(jobs.begin(), jobs.end()));
+    return makespan;
+}
+
+}
+
+TEST(BranchAndBoundPfssMakespan, Enumeration)
+{
+    for (bool blocking: {false, true}) {
+        for (std::mt19937_64::result_type seed: {0, 1, 2}) {
+            const Instance instance = build_random_instance(7, 4, Objective::Makespan, blocking, seed);
+            Time makespan = optimal_makespan(instance);
+            for (BranchAndBoundPfssMakespanLowerBound lower_bound: {
+                    BranchAndBoundPfssMakespanLowerBound::Lb1,
+                    BranchAndBoundPfssMakespanLowerBound::Lb2}) {
+                for (Counter number_of_threads: {1, 4}) {
+                    std::mt19937_64 generator(0);
+                    BranchAndBoundPfssMakespanParameters parameters;
+                    parameters.verbosity_level = 0;
+                    parameters.lower_bound = lower_bound;
+                    parameters.number_of_threads = number_of_threads;
+                    // Keep the initial upper bound weak so that the tree is
+                    // actually explored.
+                    parameters.local_search_parameters.maximum_number_of_iterations = 0;
+                    BranchAndBoundPfssMakespanOutput output = branch_and_bound_pfss_makespan(
+                            instance,
+                            generator,
+                            parameters);
+                    EXPECT_TRUE(output.solution.feasible());
+                    EXPECT_EQ(output.solution.makespan(), makespan);
+                    EXPECT_EQ(output.makespan_bound, makespan);
+                }
+            }
+        }
+    }
+}
+
+TEST(BranchAndBoundPfssMakespan, TimeLimit)
+{
+    const Instance instance = build_random_instance(30, 10);
+    std::mt19937_64 generator(0);
+    BranchAndBoundPfssMakespanParameters parameters;
+    parameters.verbosity_level = 0;
+    parameters.number_of_threads = 2;
+    parameters.timer.set_time_limit(0.5);
+    BranchAndBoundPfssMakespanOutput output = branch_and_bound_pfss_makespan(
+            instance,
+            generator,
+            parameters);
+    EXPECT_TRUE(output.solution.feasible());
+    EXPECT_GT(output.makespan_bound, 0);
+    EXPECT_LE(output.makespan_bound, output.solution.makespan());
+}
+
+TEST_P(ExactAlgorithmTest, ExactAlgorithm)
+{
+    TestParams test_params = GetParam();
+    const Instance instance = get_instance(test_params.files);
+    const Solution solution = get_solution(instance, test_params.files);
+    auto output = test_params.algorithm(instance);
+    std::cout << std::endl;
+    std::cout << "Reference solution" << std::endl;
+    std::cout << "------------------" << std::endl;
+    solution.format(std::cout, 1);
+    EXPECT_EQ(output.solution.objective_value(), solution.objective_value());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        BranchAndBoundPfssMakespan,
+        ExactAlgorithmTest,
+        testing::ValuesIn(get_test_params(
+                {
+                    [](const Instance& instance)
+                    {
+                        std::mt19937_64 generator(0);
+                        return branch_and_bound_pfss_makespan(instance, generator);
+                    },
+                },
+                {
+                    get_test_instance_paths(get_path({"test", "algorithms", "tree_search_pfss_makespan_test.txt"})),
+                })));
@@ -0,0 +1,271 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
+#include "shopschedulingsolver/algorithms/tree_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/algorithms/tree_search_pfss.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+/**
+ * Build the small flow shop instance with the operations of some jobs fixed at
+ * their starts in a solution, delayed by 'delays[machine_id]'.
+ */
+Instance build_fixed_instance(
+        const Solution& solution,
+        const std::vector<JobId>& fixed_job_ids,
+        const std::vector<Time>& delays = {0, 0, 0},
+        Objective objective = Objective::Makespan)
+{
+    InstanceBuilder instance_builder = flow_shop_instance_builder(
+            small_flow_shop_instance,
+            objective);
+    for (JobId job_id: fixed_job_ids) {
+        const Solution::Job& solution_job = solution.job(job_id);
+        for (OperationId operation_id = 0;
+                operation_id < (OperationId)solution_job.operations.size();
+                ++operation_id) {
+            const Solution::Operation& solution_operation
+                = solution.operation(solution_job.operations[operation_id]);
+            instance_builder.fix_operation(
+                    job_id,
+                    operation_id,
+                    solution_operation.alternative_id,
+                    solution_operation.start + delays[solution_operation.machine_id]);
+        }
+    }
+    return instance_builder.build();
+}
+
+/**
+ * Return the best objective value of the permutations starting with the fixed
+ * jobs, by enumeration.
+ */
+double best_objective_value(const Instance& instance)
+{
+    std::vector<JobId> free_job_ids;
+    for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id)
+        if (!instance.job(job_id).fixed)
+            free_job_ids.push_back(job_id);
+    double best = std::numeric_limits<double>::infinity();
+    do {
+        std::vector<JobId> job_ids = instance.fixed_jobs();
+        job_ids.insert(job_ids.end(), free_job_ids.begin(), free_job_ids.end());
+        const Solution solution = build_permutation_solution(instance, job_ids);
+        EXPECT_TRUE(solution.feasible());
+        best = (std::min)(best, solution.objective_value());
+    } while (std::next_permutation(free_job_ids.begin(), free_job_ids.end()));
+    return best;
+}
+
+}
+
+TEST(FixedOperations, FixedPrefix)
+{
+    const Instance instance = build_flow_shop_instance(small_flow_shop_instance);
+    const Solution previous_solution = build_permutation_solution(instance, {3, 0, 4, 1, 5, 2});
+    const Instance fixed_instance = build_fixed_instance(previous_solution, {0, 3});
+    EXPECT_EQ(fixed_instance.number_of_fixed_operations(), 6);
+    EXPECT_EQ(fixed_instance.fixed_jobs(), std::vector<JobId>({3, 0}));
+    EXPECT_TRUE(fixed_instance.fixed_prefix());
+
+    // The fixed operations keep their starts whatever their positions in the
+    // permutation; out of order, they overlap.
+    const Solution solution = build_permutation_solution(fixed_instance, {0, 3, 4, 1, 5, 2});
+    EXPECT_EQ(solution.number_of_fixed_operation_violations(), 0);
+    EXPECT_FALSE(solution.feasible());
+
+    std::mt19937_64 generator(0);
+    LocalSearchParameters parameters;
+    parameters.verbosity_level = 0;
+    parameters.maximum_number_of_iterations = 50;
+    LocalSearchOutput output = local_search_pfss_makespan(
+            fixed_instance,
+            generator,
+            nullptr,
+            parameters);
+    EXPECT_TRUE(output.solution.feasible());
+    std::vector<JobId> job_ids = permutation(output.solution);
+    ASSERT_EQ(job_ids.size(), 6);
+    EXPECT_EQ(job_ids[0], 3);
+    EXPECT_EQ(job_ids[1], 0);
+}
+
+TEST(FixedOperations, NonAsapFixedStarts)
+{
+    const Instance instance = build_flow_shop_instance(small_flow_shop_instance);
+    const Solution previous_solution = build_permutation_solution(instance, {3, 0, 4, 1, 5, 2});
+
+    // The fixed operations start later than as early as possible, with gaps
+    // between the fixed jobs on the last machine.
+    const Instance fixed_instance = build_fixed_instance(
+            previous_solution, {0, 3}, {2, 4, 9});
+    ASSERT_TRUE(fixed_instance.fixed_prefix());
+    double best = best_objective_value(fixed_instance);
+
+    std::mt19937_64 generator(0);
+    LocalSearchParameters parameters;
+    parameters.verbosity_level = 0;
+    parameters.maximum_number_of_iterations = 50;
+    LocalSearchOutput output = local_search_pfss_makespan(
+            fixed_instance,
+            generator,
+            nullptr,
+            parameters);
+    EXPECT_TRUE(output.solution.feasible());
+    EXPECT_EQ(output.solution.objective_value(), best);
+    std::vector<JobId> job_ids = permutation(output.solution);
+    ASSERT_EQ(job_ids.size(), 6);
+    EXPECT_EQ(job_ids[0], 3);
+    EXPECT_EQ(job_ids[1], 0);
+
+    TreeSearchPfssMakespanParameters tree_search_parameters;
+    tree_search_parameters.verbosity_level = 0;
+    Output tree_search_output = tree_search_pfss_makespan(
+            fixed_instance,
+            tree_search_parameters);
+    EXPECT_TRUE(tree_search_output.solution.feasible());
+    EXPECT_EQ(tree_search_output.solution.objective_value(), best);
+}
+
+TEST(FixedOperations, NonAsapFixedStartsTotalFlowTime)
+{
+    const Instance instance = build_flow_shop_instance(small_flow_shop_instance);
+    const Solution previous_solution = build_permutation_solution(instance, {3, 0, 4, 1, 5, 2});
+    const Instance fixed_instance = build_fixed_instance(
+            previous_solution, {0, 3}, {2, 4, 9}, Objective::TotalFlowTime);
+    ASSERT_TRUE(fixed_instance.fixed_prefix());
+    double best = best_objective_value(fixed_instance);
+
+    std::mt19937_64 generator(0);
+    LocalSearchPfssParameters parameters;
+    parameters.verbosity_level = 0;
+    parameters.maximum_number_of_iterations = 50;
+    LocalSearchPfssOutput output = local_search_pfss(
+            fixed_instance,
+            generator,
+            nullptr,
+            parameters);
+    EXPECT_TRUE(output.solution.feasible());
+    EXPECT_EQ(output.solution.objective_value(), best);
+    std::vector<JobId> job_ids = permutation(output.solution);
+    ASSERT_EQ(job_ids.size(), 6);
+    EXPECT_EQ(job_ids[0], 3);
+    EXPECT_EQ(job_ids[1], 0);
+
+    TreeSearchPfssParameters tree_search_parameters;
+    tree_search_parameters.verbosity_level = 0;
+    Output tree_search_output = tree_search_pfss(
+            fixed_instance,
+            tree_search_parameters);
+    EXPECT_TRUE(tree_search_output.solution.feasible());
+    EXPECT_EQ(tree_search_output.solution.objective_value(), best);
+}
+
+TEST(FixedOperations, FixedJobsInDifferentOrders)
+{
+    // Job 1 is processed before job 0 on the first machine, and after it on
+    // the second one.
+    InstanceBuilder instance_builder = flow_shop_instance_builder(
+            "2 2\n"
+            "2 2\n"
+            "2 2\n");
+    instance_builder.fix_operation(0, 0, 0, 2);
+    instance_builder.fix_operation(0, 1, 0, 4);
+    instance_builder.fix_operation(1, 0, 0, 0);
+    instance_builder.fix_operation(1, 1, 0, 6);
+    const Instance instance = instance_builder.build();
+    EXPECT_FALSE(instance.fixed_prefix());
+}
+
+TEST(FixedOperations, OverlappingFixedOperations)
+{
+    InstanceBuilder instance_builder = flow_shop_instance_builder(
+            "2 1\n"
+            "5 2\n");
+    instance_builder.fix_operation(0, 0, 0, 0);
+    instance_builder.fix_operation(1, 0, 0, 3);
+    EXPECT_THROW(instance_builder.build(), std::invalid_argument);
+}
+
+TEST(FixedOperations, MachineAvailabilityTimes)
+{
+    InstanceBuilder instance_builder = flow_shop_instance_builder(
+            "2 2\n"
+            "5 2\n"
+            "4 6\n");
+    instance_builder.set_machine_availability_time(1, 10);
+    const Instance instance = instance_builder.build();
+    EXPECT_TRUE(instance.has_machine_availability_times());
+    EXPECT_TRUE(instance.fixed_prefix());
+
+    const Solution solution = build_permutation_solution(instance, {0, 1});
+    EXPECT_TRUE(solution.feasible());
+    EXPECT_EQ(solution.makespan(), 20);
+
+    // The local search starts from the machine availability times.
+    std::mt19937_64 generator(0);
+    LocalSearchParameters parameters;
+    parameters.verbosity_level = 0;
+    parameters.maximum_number_of_iterations = 10;
+    LocalSearchOutput output = local_search_pfss_makespan(
+            instance,
+            generator,
+            nullptr,
+            parameters);
+    EXPECT_TRUE(output.solution.feasible());
+    EXPECT_EQ(output.solution.objective_value(), best_objective_value(instance));
+
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.append_operation(0, 0, 0, 0);
+    solution_builder.append_operation(0, 1, 0, 5);
+    solution_builder.append_operation(1, 0, 0, 5);
+    solution_builder.append_operation(1, 1, 0, 10);
+    solution_builder.sort_machines();
+    solution_builder.sort_jobs();
+    const Solution infeasible_solution = solution_builder.build();
+    EXPECT_EQ(infeasible_solution.number_of_machine_availability_violations(), 1);
+    EXPECT_FALSE(infeasible_solution.feasible());
+}
+
+TEST(FixedOperations, LargeMachineAvailabilityTimes)
+{
+    // The completion times exceed the range of an int32_t because of the
+    // machine availability time, not of the processing times.
+    for (Objective objective: {Objective::Makespan, Objective::TotalFlowTime}) {
+        InstanceBuilder instance_builder = flow_shop_instance_builder(
+                small_flow_shop_instance,
+                objective);
+        instance_builder.set_machine_availability_time(
+                1,
+                std::numeric_limits<int32_t>::max() - 10);
+        const Instance instance = instance_builder.build();
+        double best = best_objective_value(instance);
+
+        std::mt19937_64 generator(0);
+        LocalSearchPfssParameters parameters;
+        parameters.verbosity_level = 0;
+        parameters.maximum_number_of_iterations = 50;
+        const Solution solution = (objective == Objective::Makespan)?
+            local_search_pfss_makespan(
+                    instance,
+                    generator,
+                    nullptr,
+                    parameters).solution:
+            local_search_pfss(
+                    instance,
+                    generator,
+                    nullptr,
+                    parameters).solution;
+        EXPECT_TRUE(solution.feasible());
+        EXPECT_EQ(solution.objective_value(), best);
+    }
+}
@@ -0,0 +1,202 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/lns_pfss.hpp"
+#include "shopschedulingsolver/solution_builder.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace shopschedulingsolver;
+
+TEST(LnsPfss, Subproblems)
+{
+    for (Objective objective: {Objective::Makespan, Objective::TotalFlowTime}) {
+        const Instance instance = build_random_instance(20, 4, objective);
+        std::vector<JobId> sequence(instance.number_of_jobs());
+        std::iota(sequence.begin(), sequence.end(), 0);
+        SolutionBuilder solution_builder;
+        solution_builder.set_instance(instance);
+        solution_builder.from_permutation(sequence);
+        const Solution initial_solution = solution_builder.build();
+
+        for (Counter number_of_threads: {1, 2}) {
+            std::mt19937_64 generator(0);
+            LnsPfssParameters parameters;
+            parameters.verbosity_level = 0;
+            parameters.maximum_number_of_iterations = 10;
+            parameters.initial_subproblem_size = 5;
+            parameters.minimum_subproblem_size = 4;
+            parameters.maximum_subproblem_size = 6;
+            parameters.number_of_threads = number_of_threads;
+            LnsPfssOutput output = lns_pfss(
+                    instance,
+                    generator,
+                    &initial_solution,
+                    parameters);
+            EXPECT_TRUE(output.solution.feasible());
+            EXPECT_EQ(output.number_of_iterations, 10);
+            EXPECT_LT(
+                    output.solution.objective_value(),
+                    initial_solution.objective_value());
+            EXPECT_GE(output.subproblem_size, 4);
+            EXPECT_LE(output.subproblem_size, 6);
+        }
+    }
+}
+
+TEST(LnsPfss, MakespanSubproblem)
+{
+    const Instance instance = build_random_instance(10, 4, Objective::Makespan);
+    std::vector<JobId> sequence(instance.number_of_jobs());
+    std::iota(sequence.begin(), sequence.end(), 0);
+    // The freed jobs are reinserted after jobs 0, 1 and 3, and before jobs
+    // 4, 7 and 9.
+    std::vector<JobId> job_ids = {2, 5, 6, 8};
+    LnsPfssSubproblemInstance subproblem_instance = build_lns_pfss_subproblem_instance(
+            instance,
+            sequence,
+            job_ids,
+            3);
+    ASSERT_EQ(subproblem_instance.instance.number_of_jobs(), 5);
+    ASSERT_EQ(subproblem_instance.tail_job_ids, std::vector<JobId>({4}));
+
+    auto full_sequence = [&job_ids](const std::vector<JobId>& subproblem_sequence)
+    {
+        std::vector<JobId> sequence = {0, 1, 3};
+        for (JobId subproblem_job_id: subproblem_sequence)
+            if (subproblem_job_id < (JobId)job_ids.size())
+                sequence.push_back(job_ids[subproblem_job_id]);
+        for (JobId job_id: {4, 7, 9})
+            sequence.push_back(job_id);
+        return sequence;
+    };
+    auto makespan = [](const Instance& instance, const std::vector<JobId>& sequence)
+    {
+        SolutionBuilder solution_builder;
+        solution_builder.set_instance(instance);
+        solution_builder.from_permutation(sequence);
+        return solution_builder.build().makespan();
+    };
+
+    // With the tail job last, the makespan of the subproblem is the makespan
+    // of the whole sequence.
+    Time optimal_makespan = -1;
+    std::vector<JobId> subproblem_sequence = {0, 1, 2, 3};
+    do {
+        std::vector<JobId> subproblem_sequence_tail = subproblem_sequence;
+        subproblem_sequence_tail.push_back(4);
+        Time subproblem_makespan = makespan(
+                subproblem_instance.instance,
+                subproblem_sequence_tail);
+        EXPECT_EQ(
+                subproblem_makespan,
+                makespan(instance, full_sequence(subproblem_sequence)));
+        if (optimal_makespan == -1 || optimal_makespan > subproblem_makespan)
+            optimal_makespan = subproblem_makespan;
+    } while (std::next_permutation(
+                subproblem_sequence.begin(),
+                subproblem_sequence.end()));
+
+    // The MILP keeps the tail job last.
+    MilpPositionalParameters milp_parameters;
+    milp_parameters.verbosity_level = 0;
+    milp_parameters.last_job_ids = subproblem_instance.tail_job_ids;
+    Output milp_output = milp_positional(
+            subproblem_instance.instance,
+            nullptr,
+            milp_parameters);
+    ASSERT_TRUE(milp_output.solution.feasible());
+    std::vector<JobId> milp_sequence;
+    for (SolutionOperationId solution_operation_id: milp_output.solution.machine(0).solution_operations)
+        milp_sequence.push_back(milp_output.solution.operation(solution_operation_id).job_id);
+    EXPECT_EQ(milp_sequence.back(), 4);
+    EXPECT_EQ(milp_output.solution.makespan(), optimal_makespan);
+    EXPECT_EQ(
+            milp_output.solution.makespan(),
+            makespan(instance, full_sequence(milp_sequence)));
+}
+
+TEST(LnsPfss, TotalFlowTimeSubproblem)
+{
+    // The freed jobs are reinserted after jobs 0 and 1. Jobs 3 and 5, between
+    // the freed ones, are moved after the block with job 7; they are kept in
+    // the subproblem, at the last positions.
+    const Instance instance = build_random_instance(8, 3, Objective::TotalFlowTime);
+    std::vector<JobId> sequence(instance.number_of_jobs());
+    std::iota(sequence.begin(), sequence.end(), 0);
+    std::vector<JobId> job_ids = {2, 4, 6};
+    LnsPfssSubproblemInstance subproblem_instance = build_lns_pfss_subproblem_instance(
+            instance,
+            sequence,
+            job_ids,
+            2);
+    ASSERT_EQ(subproblem_instance.instance.number_of_jobs(), 6);
+    ASSERT_EQ(subproblem_instance.tail_job_ids, std::vector<JobId>({3, 4, 5}));
+
+    auto full_sequence = [&job_ids](const std::vector<JobId>& subproblem_sequence)
+    {
+        std::vector<JobId> sequence = {0, 1};
+        for (JobId subproblem_job_id: subproblem_sequence)
+            if (subproblem_job_id < (JobId)job_ids.size())
+                sequence.push_back(job_ids[subproblem_job_id]);
+        for (JobId job_id: {3, 5, 7})
+            sequence.push_back(job_id);
+        return sequence;
+    };
+
+    // The objective of the subproblem is the objective of the whole
+    // sequence, up to the contribution of jobs 0 and 1.
+    double offset = -1;
+    double optimal_objective_value = -1;
+    std::vector<JobId> subproblem_sequence = {0, 1, 2};
+    do {
+        std::vector<JobId> subproblem_sequence_tail = subproblem_sequence;
+        for (JobId subproblem_job_id: subproblem_instance.tail_job_ids)
+            subproblem_sequence_tail.push_back(subproblem_job_id);
+        double subproblem_objective_value = build_permutation_solution(
+                subproblem_instance.instance,
+                subproblem_sequence_tail).objective_value();
+        double objective_value = build_permutation_solution(
+                instance,
+                full_sequence(subproblem_sequence)).objective_value();
+        if (offset == -1)
+            offset = objective_value - subproblem_objective_value;
+        EXPECT_EQ(objective_value - subproblem_objective_value, offset);
+        if (optimal_objective_value == -1
+                || optimal_objective_value > subproblem_objective_value) {
+            optimal_objective_value = subproblem_objective_value;
+        }
+    } while (std::next_permutation(
+                subproblem_sequence.begin(),
+                subproblem_sequence.end()));
+
+    // The MILP keeps the tail jobs last, in their order.
+    MilpPositionalParameters milp_parameters;
+    milp_parameters.verbosity_level = 0;
+    milp_parameters.last_job_ids = subproblem_instance.tail_job_ids;
+    Output milp_output = milp_positional(
+            subproblem_instance.instance,
+            nullptr,
+            milp_parameters);
+    ASSERT_TRUE(milp_output.solution.feasible());
+    std::vector<JobId> milp_sequence = permutation(milp_output.solution);
+    EXPECT_EQ(
+            std::vector<JobId>(milp_sequence.begin() + 3, milp_sequence.end()),
+            subproblem_instance.tail_job_ids);
+    EXPECT_EQ(milp_output.solution.objective_value(), optimal_objective_value);
+}
+
+TEST(LnsPfss, WholeInstance)
+{
+    // With subproblems containing all the jobs, the search stops once the
+    // MILP proves the optimality of its solution.
+    const Instance instance = build_random_instance(5, 3, Objective::Makespan);
+    std::mt19937_64 generator(0);
+    LnsPfssParameters parameters;
+    parameters.verbosity_level = 0;
+    parameters.neighborhoods = {LnsPfssNeighborhood::Window};
+    parameters.initial_subproblem_size = 5;
+    parameters.maximum_subproblem_size = 5;
+    LnsPfssOutput output = lns_pfss(instance, generator, nullptr, parameters);
+    EXPECT_TRUE(output.solution.feasible());
+    EXPECT_EQ(output.bound(), output.solution.objective_value());
+}
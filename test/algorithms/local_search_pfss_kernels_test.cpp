@@ -0,0 +1,153 @@
+// The kernels of the local search are internal to its translation unit, so
+// it is included directly. This target must not link against
+// ShopSchedulingSolver_local_search_pfss.
+#include "algorithms/local_search_pfss.cpp"
+
+#include "tests.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+/**
+ * Build a random permutation flow shop instance with release dates, due
+ * dates, weights and, without blocking, machine availability times.
+ */
+Instance build_instance(
+        Objective objective,
+        bool blocking,
+        std::mt19937_64::result_type seed)
+{
+    const JobId number_of_jobs = 12;
+    const MachineId number_of_machines = 4;
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Time> processing_time_distribution(1, 20);
+    std::uniform_int_distribution<Time> release_date_distribution(0, 10 * number_of_jobs);
+    std::uniform_int_distribution<Time> due_date_distribution(0, 20 * number_of_jobs);
+    std::uniform_int_distribution<Time> weight_distribution(1, 3);
+    InstanceBuilder instance_builder;
+    instance_builder.set_objective(objective);
+    instance_builder.set_blocking(blocking);
+    instance_builder.set_number_of_machines(number_of_machines);
+    if (!blocking)
+        instance_builder.set_machine_availability_time(1, 15);
+    for (JobId job_id = 0; job_id < number_of_jobs; ++job_id) {
+        instance_builder.add_job();
+        for (MachineId machine_id = 0;
+                machine_id < number_of_machines;
+                ++machine_id) {
+            OperationId operation_id = instance_builder.add_operation(job_id);
+            instance_builder.add_alternative(
+                    job_id,
+                    operation_id,
+                    machine_id,
+                    processing_time_distribution(generator));
+        }
+        instance_builder.set_job_release_date(job_id, release_date_distribution(generator));
+        instance_builder.set_job_due_date(job_id, due_date_distribution(generator));
+        instance_builder.set_job_weight(job_id, weight_distribution(generator));
+    }
+    return instance_builder.build();
+}
+
+/**
+ * Check that the completion times and the prefix objectives repaired after
+ * the moves are the ones rebuilt from scratch.
+ */
+template <bool Blocking, typename TimeType>
+void check_data(
+        const Instance& instance,
+        const LocalSearchData<TimeType>& data)
+{
+    LocalSearchData<TimeType> rebuilt_data = data;
+    update_completion_times<Blocking>(instance, rebuilt_data, 0);
+    update_prefix_objective(instance, rebuilt_data);
+    for (JobId pos = 0; pos <= (JobId)data.solution.jobs.size(); ++pos) {
+        for (MachineId machine_id = 0;
+                machine_id < instance.number_of_machines();
+                ++machine_id) {
+            ASSERT_EQ(
+                    data.completion_times[pos][machine_id],
+                    rebuilt_data.completion_times[pos][machine_id])
+                << "pos " << pos << " machine_id " << machine_id;
+        }
+        ASSERT_EQ(data.prefix_objective[pos], rebuilt_data.prefix_objective[pos])
+            << "pos " << pos;
+    }
+    ASSERT_EQ(data.solution.objective, rebuilt_data.solution.objective);
+}
+
+template <bool Blocking, typename TimeType>
+void test_repair_completion_times(
+        Objective objective,
+        std::mt19937_64::result_type seed)
+{
+    const Instance instance = build_instance(objective, Blocking, seed);
+    std::mt19937_64 generator(seed);
+    JobId n = instance.number_of_jobs();
+    LocalSearchData<TimeType> data;
+    initialize_data(instance, data);
+    std::vector<JobId> job_ids(n);
+    std::iota(job_ids.begin(), job_ids.end(), 0);
+    std::shuffle(job_ids.begin(), job_ids.end(), generator);
+    load_solution<Blocking>(data, instance, build_permutation_solution(instance, job_ids));
+    check_data<Blocking>(instance, data);
+
+    for (Counter move_id = 0; move_id < 200; ++move_id) {
+        switch (generator() % 3) {
+        case 0: {
+            // Shift a block.
+            JobId size = 1 + generator() % 3;
+            JobId pos_old = generator() % (n - size + 1);
+            JobId pos_new = generator() % (n - size + 1);
+            if (pos_old != pos_new)
+                shift_jobs<Blocking>(instance, data, size, pos_old, pos_new);
+            break;
+        } case 1: {
+            // Swap two blocks.
+            JobId size_1 = 1 + generator() % 2;
+            JobId size_2 = 1 + generator() % 2;
+            JobId pos_1 = generator() % (n - size_1 - size_2 + 1);
+            JobId pos_2 = pos_1 + size_1
+                + generator() % (n - size_2 - pos_1 - size_1 + 1);
+            swap_jobs<Blocking>(instance, data, pos_1, size_1, pos_2, size_2);
+            break;
+        } case 2: {
+            // Remove a block and insert it back at another position.
+            JobId size = 1 + generator() % 3;
+            JobId pos = generator() % (n - size + 1);
+            std::vector<JobId> block(
+                    data.solution.jobs.begin() + pos,
+                    data.solution.jobs.begin() + pos + size);
+            remove_block<Blocking>(instance, data, pos, size);
+            for (JobId job_id: block)
+                data.solution.jobs_positions[job_id] = -1;
+            check_data<Blocking>(instance, data);
+            add_block<Blocking>(
+                    instance,
+                    data,
+                    block,
+                    generator() % (n - size + 1));
+            break;
+        }
+        }
+        check_data<Blocking>(instance, data);
+        if (testing::Test::HasFatalFailure())
+            return;
+    }
+}
+
+}
+
+TEST(LocalSearchPfssKernels, RepairCompletionTimes)
+{
+    for (Objective objective: {Objective::TotalFlowTime, Objective::TotalTardiness}) {
+        for (std::mt19937_64::result_type seed = 0; seed < 5; ++seed) {
+            test_repair_completion_times<false, Time>(objective, seed);
+            test_repair_completion_times<true, Time>(objective, seed);
+            test_repair_completion_times<false, int32_t>(objective, seed);
+            test_repair_completion_times<true, int32_t>(objective, seed);
+        }
+    }
+}
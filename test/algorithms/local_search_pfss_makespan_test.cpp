@@ -0,0 +1,93 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss_makespan.hpp"
+#include "shopschedulingsolver/solution_builder.hpp"
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+/** Return true iff no machine of a solution is idle between its operations. */
+bool no_idle_time(const Solution& solution)
+{
+    const Instance& instance = solution.instance();
+    for (MachineId machine_id = 0;
+            machine_id < instance.number_of_machines();
+            ++machine_id) {
+        Time current_time = -1;
+        for (SolutionOperationId solution_operation_id:
+                solution.machine(machine_id).solution_operations) {
+            const Solution::Operation& solution_operation = solution.operation(solution_operation_id);
+            if (current_time != -1 && solution_operation.start != current_time)
+                return false;
+            current_time = solution_operation.start
+                + instance.job(solution_operation.job_id).operations[
+                    solution_operation.operation_id].alternatives[
+                    solution_operation.alternative_id].processing_time;
+        }
+    }
+    return true;
+}
+
+class NoIdlePermutationTest: public testing::TestWithParam<TestInstancePath> { };
+
+}
+
+TEST_P(NoIdlePermutationTest, FromPermutation)
+{
+    TestInstancePath files = GetParam();
+    const Instance instance = get_instance(files);
+    ASSERT_TRUE(instance.no_idle());
+    const Solution reference_solution = get_solution(instance, files);
+    std::vector<JobId> job_ids;
+    for (SolutionOperationId solution_operation_id:
+            reference_solution.machine(0).solution_operations) {
+        job_ids.push_back(reference_solution.operation(solution_operation_id).job_id);
+    }
+
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.from_permutation(job_ids);
+    const Solution solution = solution_builder.build();
+    EXPECT_TRUE(solution.feasible());
+    EXPECT_TRUE(no_idle_time(solution));
+    EXPECT_EQ(solution.makespan(), reference_solution.makespan());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        LocalSearchPfssMakespan,
+        NoIdlePermutationTest,
+        testing::ValuesIn(get_test_instance_paths(
+                get_path({"test", "algorithms", "local_search_pfss_makespan_test.txt"}))));
+
+TEST_P(ExactAlgorithmTest, ExactAlgorithm)
+{
+    TestParams test_params = GetParam();
+    const Instance instance = get_instance(test_params.files);
+    const Solution solution = get_solution(instance, test_params.files);
+    auto output = test_params.algorithm(instance);
+    std::cout << std::endl;
+    std::cout << "Reference solution" << std::endl;
+    std::cout << "------------------" << std::endl;
+    solution.format(std::cout, 1);
+    EXPECT_TRUE(output.solution.feasible());
+    EXPECT_TRUE(no_idle_time(output.solution));
+    EXPECT_EQ(output.solution.objective_value(), solution.objective_value());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        LocalSearchPfssMakespan,
+        ExactAlgorithmTest,
+        testing::ValuesIn(get_test_params(
+                {
+                    [](const Instance& instance)
+                    {
+                        std::mt19937_64 generator(0);
+                        LocalSearchParameters parameters;
+                        parameters.maximum_number_of_iterations = 1000;
+                        return local_search_pfss_makespan(instance, generator, nullptr, parameters);
+                    },
+                },
+                {
+                    get_test_instance_paths(get_path({"test", "algorithms", "local_search_pfss_makespan_test.txt"})),
+                })));
@@ -0,0 +1,47 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss_no_wait.hpp"
+
+using namespace shopschedulingsolver;
+
+TEST_P(ExactAlgorithmTest, ExactAlgorithm)
+{
+    TestParams test_params = GetParam();
+    const Instance instance = get_instance(test_params.files);
+    const Solution solution = get_solution(instance, test_params.files);
+    auto output = test_params.algorithm(instance);
+    std::cout << std::endl;
+    std::cout << "Reference solution" << std::endl;
+    std::cout << "------------------" << std::endl;
+    solution.format(std::cout, 1);
+    EXPECT_EQ(output.solution.objective_value(), solution.objective_value());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        LocalSearchPfssNoWait,
+        ExactAlgorithmTest,
+        testing::ValuesIn(get_test_params(
+                {
+                    [](const Instance& instance)
+                    {
+                        std::mt19937_64 generator(0);
+                        LocalSearchPfssNoWaitParameters parameters;
+                        parameters.maximum_number_of_iterations = 1000;
+                        return local_search_pfss_no_wait(instance, generator, nullptr, parameters);
+                    },
+                },
+                {
+                    get_test_instance_paths(get_path({"test", "algorithms", "local_search_pfss_no_wait_test.txt"})),
+                })));
+
+TEST(LocalSearchPfssNoWait, NotNoWait)
+{
+    const Instance instance = build_flow_shop_instance(
+            small_flow_shop_instance,
+            Objective::Makespan);
+    std::mt19937_64 generator(0);
+    LocalSearchPfssNoWaitParameters parameters;
+    parameters.verbosity_level = 0;
+    EXPECT_THROW(
+            local_search_pfss_no_wait(instance, generator, nullptr, parameters),
+            std::invalid_argument);
+}
@@ -0,0 +1,163 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/local_search_pfss.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+using namespace shopschedulingsolver;
+
+TEST_P(ExactAlgorithmTest, ExactAlgorithm)
+{
+    TestParams test_params = GetParam();
+    const Instance instance = get_instance(test_params.files);
+    const Solution solution = get_solution(instance, test_params.files);
+    auto output = test_params.algorithm(instance);
+    std::cout << std::endl;
+    std::cout << "Reference solution" << std::endl;
+    std::cout << "------------------" << std::endl;
+    solution.format(std::cout, 1);
+    EXPECT_TRUE(output.solution.feasible());
+    EXPECT_EQ(output.solution.objective_value(), solution.objective_value());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        LocalSearchPfss,
+        ExactAlgorithmTest,
+        testing::ValuesIn(get_test_params(
+                {
+                    [](const Instance& instance)
+                    {
+                        std::mt19937_64 generator(0);
+                        LocalSearchPfssParameters parameters;
+                        parameters.maximum_number_of_iterations = 1000;
+                        return local_search_pfss(instance, generator, nullptr, parameters);
+                    },
+                },
+                {
+                    get_test_instance_paths(get_path({"test", "algorithms", "local_search_pfss_test.txt"})),
+                })));
+
+namespace
+{
+
+/**
+ * Build a random permutation flow shop instance with weights and due dates,
+ * for the total tardiness.
+ */
+Instance build_random_tardiness_instance(
+        JobId number_of_jobs,
+        MachineId number_of_machines,
+        bool blocking,
+        std::mt19937_64::result_type seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Time> processing_time_distribution(1, 99);
+    std::uniform_int_distribution<Time> due_date_distribution(0, 50 * number_of_jobs);
+    std::uniform_int_distribution<Time> weight_distribution(1, 10);
+    InstanceBuilder instance_builder;
+    instance_builder.set_objective(Objective::TotalTardiness);
+    instance_builder.set_blocking(blocking);
+    instance_builder.set_number_of_machines(number_of_machines);
+    for (JobId job_id = 0; job_id < number_of_jobs; ++job_id) {
+        instance_builder.add_job();
+        for (MachineId machine_id = 0;
+                machine_id < number_of_machines;
+                ++machine_id) {
+            OperationId operation_id = instance_builder.add_operation(job_id);
+            instance_builder.add_alternative(
+                    job_id,
+                    operation_id,
+                    machine_id,
+                    processing_time_distribution(generator));
+        }
+        instance_builder.set_job_due_date(job_id, due_date_distribution(generator));
+        instance_builder.set_job_weight(job_id, weight_distribution(generator));
+    }
+    return instance_builder.build();
+}
+
+}
+
+TEST(LocalSearchPfss, MultiLaneShiftEvaluation)
+{
+    // The multi-lane evaluation of the shift neighborhood must find the same
+    // moves as the scalar one, so that both runs are identical.
+    for (bool blocking: {false, true}) {
+        for (std::mt19937_64::result_type seed = 0; seed < 3; ++seed) {
+            for (const Instance& instance: {
+                    build_random_instance(30, 6, Objective::TotalFlowTime, blocking, seed),
+                    build_random_tardiness_instance(30, 6, blocking, seed)}) {
+                std::vector<Solution> solutions;
+                for (bool multi_lane_shift_evaluation: {false, true}) {
+                    std::mt19937_64 generator(seed);
+                    LocalSearchPfssParameters parameters;
+                    parameters.verbosity_level = 0;
+                    parameters.maximum_number_of_iterations = 50;
+                    parameters.multi_lane_shift_evaluation = multi_lane_shift_evaluation;
+                    solutions.push_back(local_search_pfss(
+                                instance,
+                                generator,
+                                nullptr,
+                                parameters).solution);
+                }
+                EXPECT_TRUE(solutions[1].feasible());
+                EXPECT_EQ(permutation(solutions[1]), permutation(solutions[0]));
+                EXPECT_EQ(solutions[1].objective_value(), solutions[0].objective_value());
+            }
+        }
+    }
+}
+
+TEST(LocalSearchPfss, MixedNoIdle)
+{
+    // Only some machines are no-idle; the local search must find the best
+    // permutation, computed by enumeration.
+    for (Objective objective: {Objective::TotalFlowTime, Objective::TotalTardiness}) {
+        for (std::mt19937_64::result_type seed = 0; seed < 3; ++seed) {
+            std::mt19937_64 generator(seed);
+            std::uniform_int_distribution<Time> processing_time_distribution(1, 20);
+            std::uniform_int_distribution<Time> due_date_distribution(0, 100);
+            InstanceBuilder instance_builder;
+            instance_builder.set_objective(objective);
+            instance_builder.set_number_of_machines(4);
+            instance_builder.set_machine_no_idle(1);
+            instance_builder.set_machine_no_idle(3);
+            for (JobId job_id = 0; job_id < 7; ++job_id) {
+                instance_builder.add_job();
+                for (MachineId machine_id = 0; machine_id < 4; ++machine_id) {
+                    OperationId operation_id = instance_builder.add_operation(job_id);
+                    instance_builder.add_alternative(
+                            job_id,
+                            operation_id,
+                            machine_id,
+                            processing_time_distribution(generator));
+                }
+                if (objective == Objective::TotalTardiness)
+                    instance_builder.set_job_due_date(job_id, due_date_distribution(generator));
+            }
+            const Instance instance = instance_builder.build();
+            ASSERT_TRUE(instance.mixed_no_idle());
+
+            std::vector<JobId> job_ids(instance.number_of_jobs());
+            std::iota(job_ids.begin(), job_ids.end(), 0);
+            double best = std::numeric_limits<double>::infinity();
+            do {
+                best = (std::min)(
+                        best,
+                        build_permutation_solution(instance, job_ids).objective_value());
+            } while (std::next_permutation(job_ids.begin(), job_ids.end()));
+
+            LocalSearchPfssParameters parameters;
+            parameters.verbosity_level = 0;
+            parameters.maximum_number_of_iterations = 1000;
+            LocalSearchPfssOutput output = local_search_pfss(
+                    instance,
+                    generator,
+                    nullptr,
+                    parameters);
+            EXPECT_TRUE(output.solution.feasible());
+            EXPECT_EQ(output.solution.objective_value(), best);
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include "tests.hpp"
 #include "shopschedulingsolver/algorithms/milp_positional.hpp"
 
+#include <algorithm>
+
 using namespace shopschedulingsolver;
 
 TEST_P(ExactAlgorithmTest, ExactAlgorithm)
@@ -29,3 +31,45 @@ INSTANTIATE_TEST_SUITE_P(
                 {
                     get_test_instance_paths(get_path({"test", "algorithms", "milp_positional_test.txt"})),
                 })));
+
+TEST(MilpPositional, FixedJobsAndMachineAvailabilityTimes)
+{
+    for (Objective objective: {Objective::Makespan, Objective::TotalFlowTime}) {
+        // Jobs 3 and 0 are fixed at their starts in the sequence 3 0, and the
+        // last machine is unavailable before time 30.
+        InstanceBuilder instance_builder = flow_shop_instance_builder(
+                small_flow_shop_instance,
+                objective);
+        // Job 3 on [0, 3], [3, 11], [11, 17]; job 0 on [3, 8], [11, 15], [17, 20].
+        instance_builder.fix_operation(3, 0, 0, 0);
+        instance_builder.fix_operation(3, 1, 0, 3);
+        instance_builder.fix_operation(3, 2, 0, 11);
+        instance_builder.fix_operation(0, 0, 0, 3);
+        instance_builder.fix_operation(0, 1, 0, 11);
+        instance_builder.fix_operation(0, 2, 0, 17);
+        instance_builder.set_machine_availability_time(2, 30);
+        const Instance instance = instance_builder.build();
+
+        // Enumerate the sequences of the other jobs.
+        std::vector<JobId> job_ids = {1, 2, 4, 5};
+        double best_value = -1;
+        do {
+            std::vector<JobId> sequence = {3, 0};
+            sequence.insert(sequence.end(), job_ids.begin(), job_ids.end());
+            const Solution solution = build_permutation_solution(instance, sequence);
+            ASSERT_TRUE(solution.feasible());
+            if (best_value == -1 || solution.objective_value() < best_value)
+                best_value = solution.objective_value();
+        } while (std::next_permutation(job_ids.begin(), job_ids.end()));
+
+        MilpPositionalParameters parameters;
+        parameters.verbosity_level = 0;
+        Output output = milp_positional(instance, nullptr, parameters);
+        EXPECT_TRUE(output.solution.feasible());
+        EXPECT_EQ(output.solution.objective_value(), best_value);
+        const Solution::Machine& solution_machine = output.solution.machine(0);
+        ASSERT_EQ(solution_machine.solution_operations.size(), 6);
+        EXPECT_EQ(output.solution.operation(solution_machine.solution_operations[0]).job_id, 3);
+        EXPECT_EQ(output.solution.operation(solution_machine.solution_operations[1]).job_id, 0);
+    }
+}
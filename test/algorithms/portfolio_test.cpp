@@ -0,0 +1,39 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/portfolio.hpp"
+
+using namespace shopschedulingsolver;
+
+TEST_P(ExactAlgorithmTest, ExactAlgorithm)
+{
+    TestParams test_params = GetParam();
+    const Instance instance = get_instance(test_params.files);
+    const Solution solution = get_solution(instance, test_params.files);
+    auto output = test_params.algorithm(instance);
+    std::cout << std::endl;
+    std::cout << "Reference solution" << std::endl;
+    std::cout << "------------------" << std::endl;
+    solution.format(std::cout, 1);
+    EXPECT_EQ(output.solution.objective_value(), solution.objective_value());
+    EXPECT_EQ(output.bound(), solution.objective_value());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        Portfolio,
+        ExactAlgorithmTest,
+        testing::ValuesIn(get_test_params(
+                {
+                    [](const Instance& instance)
+                    {
+                        std::mt19937_64 generator(0);
+                        PortfolioParameters parameters;
+                        parameters.algorithms = {
+                            PortfolioAlgorithm::TreeSearchPfssMakespan,
+                            PortfolioAlgorithm::LocalSearchPfssMakespan,
+                        };
+                        parameters.local_search_restart_interval = 100;
+                        return portfolio(instance, generator, nullptr, parameters);
+                    },
+                },
+                {
+                    get_test_instance_paths(get_path({"test", "algorithms", "portfolio_test.txt"})),
+                })));
@@ -0,0 +1,190 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/rescheduling.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace shopschedulingsolver;
+
+TEST(Rescheduling, ApplyInstanceDelta)
+{
+    const Instance instance = build_flow_shop_instance(
+            small_flow_shop_instance,
+            Objective::Makespan);
+    const Solution previous_solution = build_permutation_solution(instance, {0, 1, 2, 3, 4, 5});
+    InstanceDelta delta;
+    delta.removed_job_ids = {1};
+    delta.processing_time_changes = {{2, 0, 10}};
+    NewJob new_job;
+    new_job.processing_times = {1, 2, 3};
+    new_job.due_date = 20;
+    delta.new_jobs = {new_job};
+
+    UpdatedInstance updated_instance = apply_instance_delta(previous_solution, delta);
+    EXPECT_EQ(updated_instance.instance.number_of_jobs(), 6);
+    EXPECT_EQ(updated_instance.job_ids, std::vector<JobId>({0, -1, 1, 2, 3, 4}));
+    const Job& job_2 = updated_instance.instance.job(1);
+    EXPECT_EQ(job_2.operations[0].alternatives[0].processing_time, 10);
+    EXPECT_EQ(job_2.operations[1].alternatives[0].processing_time, 1);
+    const Job& job_new = updated_instance.instance.job(5);
+    EXPECT_EQ(job_new.operations[2].alternatives[0].processing_time, 3);
+    EXPECT_EQ(job_new.due_date, 20);
+}
+
+TEST(Rescheduling, FrozenJobs)
+{
+    for (Objective objective: {Objective::Makespan, Objective::TotalFlowTime}) {
+        const Instance instance = build_flow_shop_instance(
+                small_flow_shop_instance,
+                objective);
+        // Jobs 3 and 0 start at 0 and 3 on the first machine.
+        const Solution previous_solution = build_permutation_solution(instance, {3, 0, 4, 1, 5, 2});
+        InstanceDelta delta;
+        delta.removed_job_ids = {5};
+        NewJob new_job;
+        new_job.processing_times = {1, 2, 3};
+        delta.new_jobs = {new_job, new_job};
+        delta.frozen_time = 4;
+
+        UpdatedInstance updated_instance = apply_instance_delta(previous_solution, delta);
+        for (ReschedulingWarmStart warm_start: {
+                ReschedulingWarmStart::PreviousSequence,
+                ReschedulingWarmStart::FrozenJobs}) {
+            std::mt19937_64 generator(0);
+            ReschedulingParameters parameters;
+            parameters.verbosity_level = 0;
+            parameters.warm_start = warm_start;
+            parameters.local_search_parameters.maximum_number_of_iterations = 50;
+            ReschedulingOutput output = reschedule(
+                    previous_solution,
+                    delta,
+                    updated_instance,
+                    generator,
+                    parameters);
+            EXPECT_TRUE(output.solution.feasible());
+            EXPECT_EQ(output.number_of_frozen_jobs, 2);
+            EXPECT_EQ(
+                    output.number_of_inserted_jobs,
+                    (warm_start == ReschedulingWarmStart::PreviousSequence)? 2: 5);
+            std::vector<JobId> job_ids = permutation(output.solution);
+            ASSERT_EQ(job_ids.size(), 7);
+            EXPECT_EQ(job_ids[0], updated_instance.job_ids[3]);
+            EXPECT_EQ(job_ids[1], updated_instance.job_ids[0]);
+        }
+    }
+}
+
+TEST(Rescheduling, RemovedFrozenJob)
+{
+    const Instance instance = build_flow_shop_instance(
+            small_flow_shop_instance,
+            Objective::Makespan);
+    const Solution previous_solution = build_permutation_solution(instance, {3, 0, 4, 1, 5, 2});
+    InstanceDelta delta;
+    delta.removed_job_ids = {0};
+    delta.frozen_time = 4;
+    EXPECT_THROW(
+            apply_instance_delta(previous_solution, delta),
+            std::invalid_argument);
+}
+
+TEST(Rescheduling, ChangedFrozenJob)
+{
+    const Instance instance = build_flow_shop_instance(
+            small_flow_shop_instance,
+            Objective::Makespan);
+    const Solution previous_solution = build_permutation_solution(instance, {3, 0, 4, 1, 5, 2});
+    InstanceDelta delta;
+    delta.processing_time_changes = {{0, 1, 10}};
+    delta.frozen_time = 4;
+    EXPECT_THROW(
+            apply_instance_delta(previous_solution, delta),
+            std::invalid_argument);
+}
+
+TEST(Rescheduling, FrozenTime)
+{
+    for (Objective objective: {Objective::Makespan, Objective::TotalFlowTime}) {
+        // Jobs 3 and 0 are processed on [0, 3] and [3, 8] on the first
+        // machine; job 4 is released at 10, so the first machine is idle on
+        // [8, 10] in the previous solution.
+        InstanceBuilder instance_builder = flow_shop_instance_builder(
+                small_flow_shop_instance,
+                objective);
+        instance_builder.set_job_release_date(4, 10);
+        const Instance instance = instance_builder.build();
+        const Solution previous_solution = build_permutation_solution(instance, {3, 0, 4, 1, 5, 2});
+        InstanceDelta delta;
+        delta.processing_time_changes = {{1, 0, 1}};
+        NewJob new_job;
+        new_job.processing_times = {1, 2, 3};
+        delta.new_jobs = {new_job};
+        delta.frozen_time = 10;
+
+        UpdatedInstance updated_instance = apply_instance_delta(previous_solution, delta);
+        for (ReschedulingWarmStart warm_start: {
+                ReschedulingWarmStart::PreviousSequence,
+                ReschedulingWarmStart::FrozenJobs}) {
+            std::mt19937_64 generator(0);
+            ReschedulingParameters parameters;
+            parameters.verbosity_level = 0;
+            parameters.warm_start = warm_start;
+            parameters.local_search_parameters.maximum_number_of_iterations = 50;
+            ReschedulingOutput output = reschedule(
+                    previous_solution,
+                    delta,
+                    updated_instance,
+                    generator,
+                    parameters);
+            ASSERT_TRUE(output.solution.feasible());
+            EXPECT_EQ(output.number_of_frozen_jobs, 2);
+
+            // The frozen operations keep their starts; the other ones start
+            // after the frozen time.
+            for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+                const Solution::Job& previous_solution_job = previous_solution.job(job_id);
+                const Solution::Job& solution_job = output.solution.job(updated_instance.job_ids[job_id]);
+                for (OperationId operation_id = 0;
+                        operation_id < (OperationId)solution_job.operations.size();
+                        ++operation_id) {
+                    Time start = output.solution.operation(solution_job.operations[operation_id]).start;
+                    if (job_id == 3 || job_id == 0) {
+                        EXPECT_EQ(
+                                start,
+                                previous_solution.operation(previous_solution_job.operations[operation_id]).start);
+                    } else {
+                        EXPECT_GE(start, delta.frozen_time);
+                    }
+                }
+            }
+            const Solution::Job& new_solution_job = output.solution.job(6);
+            for (SolutionOperationId solution_operation_id: new_solution_job.operations)
+                EXPECT_GE(output.solution.operation(solution_operation_id).start, delta.frozen_time);
+        }
+    }
+}
+
+TEST(Rescheduling, AllJobsFrozen)
+{
+    // Nothing is left to optimize; the warm start itself must be returned.
+    const Instance instance = build_flow_shop_instance(
+            small_flow_shop_instance,
+            Objective::TotalFlowTime);
+    const Solution previous_solution = build_permutation_solution(instance, {3, 0, 4, 1, 5, 2});
+    InstanceDelta delta;
+    delta.frozen_time = 100;
+    UpdatedInstance updated_instance = apply_instance_delta(previous_solution, delta);
+    std::mt19937_64 generator(0);
+    ReschedulingParameters parameters;
+    parameters.verbosity_level = 0;
+    ReschedulingOutput output = reschedule(
+            previous_solution,
+            delta,
+            updated_instance,
+            generator,
+            parameters);
+    EXPECT_EQ(output.number_of_frozen_jobs, 6);
+    EXPECT_EQ(output.number_of_inserted_jobs, 0);
+    ASSERT_TRUE(output.solution.feasible());
+    EXPECT_EQ(permutation(output.solution), std::vector<JobId>({3, 0, 4, 1, 5, 2}));
+    EXPECT_EQ(output.solution.total_flow_time(), previous_solution.total_flow_time());
+}
@@ -0,0 +1,154 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/algorithms/rolling_horizon_pfss.hpp"
+#include "shopschedulingsolver/instance_builder.hpp"
+
+using namespace shopschedulingsolver;
+
+TEST(RollingHorizonPfss, Segments)
+{
+    for (Objective objective: {Objective::Makespan, Objective::TotalFlowTime}) {
+        const Instance instance = build_random_instance(60, 5, objective);
+        for (Counter number_of_threads: {1, 3}) {
+            std::mt19937_64 generator(0);
+            RollingHorizonPfssParameters parameters;
+            parameters.verbosity_level = 0;
+            parameters.window_size = 12;
+            parameters.window_step = 8;
+            parameters.number_of_threads = number_of_threads;
+            parameters.local_search_parameters.maximum_number_of_iterations = 20;
+            RollingHorizonPfssOutput output = rolling_horizon_pfss(
+                    instance,
+                    generator,
+                    parameters);
+            EXPECT_TRUE(output.solution.feasible());
+            EXPECT_EQ(output.solution.machine(0).solution_operations.size(), 60);
+            EXPECT_EQ(output.number_of_segments, number_of_threads);
+            EXPECT_GE(output.number_of_windows, 7);
+            // The first intermediary output is the initial order.
+            ASSERT_FALSE(output.intermediary_outputs.values.empty());
+            EXPECT_LE(
+                    output.solution.objective_value(),
+                    output.intermediary_outputs.values.front());
+        }
+    }
+}
+
+TEST(RollingHorizonPfss, InvalidWindowStep)
+{
+    const Instance instance = build_random_instance(10, 3, Objective::Makespan);
+    std::mt19937_64 generator(0);
+    RollingHorizonPfssParameters parameters;
+    parameters.verbosity_level = 0;
+    parameters.window_size = 4;
+    parameters.window_step = 5;
+    EXPECT_THROW(
+            rolling_horizon_pfss(instance, generator, parameters),
+            std::invalid_argument);
+}
+
+TEST(RollingHorizonPfss, MakespanReleaseDates)
+{
+    InstanceBuilder instance_builder;
+    instance_builder.set_objective(Objective::Makespan);
+    instance_builder.set_number_of_machines(3);
+    for (JobId job_id = 0; job_id < 10; ++job_id) {
+        instance_builder.add_job();
+        for (MachineId machine_id = 0; machine_id < 3; ++machine_id) {
+            OperationId operation_id = instance_builder.add_operation(job_id);
+            instance_builder.add_alternative(job_id, operation_id, machine_id, 5);
+        }
+        instance_builder.set_job_release_date(job_id, 10 * job_id);
+    }
+    const Instance instance = instance_builder.build();
+    std::mt19937_64 generator(0);
+    RollingHorizonPfssParameters parameters;
+    parameters.verbosity_level = 0;
+    parameters.window_size = 4;
+    parameters.window_step = 2;
+    EXPECT_THROW(
+            rolling_horizon_pfss(instance, generator, parameters),
+            std::invalid_argument);
+}
+
+TEST(RollingHorizonPfss, CompletionTimesOnAllMachines)
+{
+    // The first machine is almost always idle while the other ones are busy:
+    // the windows must start from the completion times of the committed jobs
+    // on all machines, not only on the first one.
+    std::mt19937_64 instance_generator(0);
+    std::uniform_int_distribution<Time> distribution(1, 20);
+    for (Objective objective: {Objective::Makespan, Objective::TotalFlowTime}) {
+        InstanceBuilder instance_builder;
+        instance_builder.set_objective(objective);
+        instance_builder.set_number_of_machines(3);
+        for (JobId job_id = 0; job_id < 8; ++job_id) {
+            instance_builder.add_job();
+            for (MachineId machine_id = 0; machine_id < 3; ++machine_id) {
+                OperationId operation_id = instance_builder.add_operation(job_id);
+                instance_builder.add_alternative(
+                        job_id,
+                        operation_id,
+                        machine_id,
+                        (machine_id == 0)? 1: distribution(instance_generator));
+            }
+        }
+        const Instance instance = instance_builder.build();
+
+        std::mt19937_64 generator(0);
+        RollingHorizonPfssParameters parameters;
+        parameters.verbosity_level = 0;
+        parameters.window_size = 4;
+        parameters.window_step = 4;
+        parameters.number_of_threads = 1;
+        parameters.local_search_parameters.maximum_number_of_iterations = 100;
+        RollingHorizonPfssOutput output = rolling_horizon_pfss(
+                instance,
+                generator,
+                parameters);
+        ASSERT_TRUE(output.solution.feasible());
+        std::vector<JobId> sequence = permutation(output.solution);
+        ASSERT_EQ(sequence.size(), 8);
+
+        // Objective of a window scheduled after the given completion times.
+        auto window_objective_value = [&instance](
+                const std::vector<JobId>& window,
+                std::vector<Time>& completion_times)
+        {
+            Time objective_value = 0;
+            for (JobId job_id: window) {
+                Time time = 0;
+                for (MachineId machine_id = 0; machine_id < 3; ++machine_id) {
+                    time = (std::max)(time, completion_times[machine_id])
+                        + instance.job(job_id).operations[machine_id].alternatives[0].processing_time;
+                    completion_times[machine_id] = time;
+                }
+                objective_value = (instance.objective() == Objective::Makespan)?
+                    time:
+                    objective_value + time;
+            }
+            return objective_value;
+        };
+        // Each window is optimal after the jobs of the previous one.
+        std::vector<Time> completion_times(3, 0);
+        for (JobId window_start: {0, 4}) {
+            std::vector<JobId> window(
+                    sequence.begin() + window_start,
+                    sequence.begin() + window_start + 4);
+            std::vector<Time> window_completion_times = completion_times;
+            Time objective_value = window_objective_value(
+                    window,
+                    window_completion_times);
+            std::vector<JobId> other_window = window;
+            std::sort(other_window.begin(), other_window.end());
+            do {
+                std::vector<Time> other_completion_times = completion_times;
+                EXPECT_LE(
+                        objective_value,
+                        window_objective_value(other_window, other_completion_times));
+            } while (std::next_permutation(
+                        other_window.begin(),
+                        other_window.end()));
+            completion_times = window_completion_times;
+        }
+    }
+}
@@ -5,6 +5,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include <sstream>
+
 using namespace shopschedulingsolver;
 
 namespace fs = boost::filesystem;
@@ -82,3 +84,75 @@ const Solution shopschedulingsolver::get_solution(
     solution_builder.read(certificate_path, files.certificate_format);
     return solution_builder.build();
 }
+
+const Instance shopschedulingsolver::build_random_instance(
+        JobId number_of_jobs,
+        MachineId number_of_machines,
+        Objective objective,
+        bool blocking,
+        std::mt19937_64::result_type seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Time> distribution(1, 99);
+    InstanceBuilder instance_builder;
+    instance_builder.set_objective(objective);
+    instance_builder.set_blocking(blocking);
+    instance_builder.set_number_of_machines(number_of_machines);
+    for (JobId job_id = 0; job_id < number_of_jobs; ++job_id) {
+        instance_builder.add_job();
+        for (MachineId machine_id = 0;
+                machine_id < number_of_machines;
+                ++machine_id) {
+            OperationId operation_id = instance_builder.add_operation(job_id);
+            instance_builder.add_alternative(
+                    job_id,
+                    operation_id,
+                    machine_id,
+                    distribution(generator));
+        }
+    }
+    return instance_builder.build();
+}
+
+const std::string shopschedulingsolver::small_flow_shop_instance
+    = "6 3\n"
+    "5 2 7 3 4 6\n"
+    "4 6 1 8 2 3\n"
+    "3 5 2 6 7 1\n";
+
+InstanceBuilder shopschedulingsolver::flow_shop_instance_builder(
+        const std::string& instance_content,
+        Objective objective)
+{
+    std::stringstream ss(instance_content);
+    InstanceBuilder instance_builder;
+    instance_builder.read(ss, "flow-shop");
+    instance_builder.set_objective(objective);
+    return instance_builder;
+}
+
+const Instance shopschedulingsolver::build_flow_shop_instance(
+        const std::string& instance_content,
+        Objective objective)
+{
+    return flow_shop_instance_builder(instance_content, objective).build();
+}
+
+const Solution shopschedulingsolver::build_permutation_solution(
+        const Instance& instance,
+        const std::vector<JobId>& job_ids)
+{
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.from_permutation(job_ids);
+    return solution_builder.build();
+}
+
+std::vector<JobId> shopschedulingsolver::permutation(
+        const Solution& solution)
+{
+    std::vector<JobId> job_ids;
+    for (SolutionOperationId solution_operation_id: solution.machine(0).solution_operations)
+        job_ids.push_back(solution.operation(solution_operation_id).job_id);
+    return job_ids;
+}
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "shopschedulingsolver/algorithm_formatter.hpp"
+#include "shopschedulingsolver/instance_builder.hpp"
 
 #include <gtest/gtest.h>
 
+#include <random>
+
 namespace shopschedulingsolver
 {
 
@@ -39,6 +42,53 @@ const Solution get_solution(
         const Instance& instance,
         const TestInstancePath& files);
 
+/**
+ * Build a random permutation flow shop instance, with processing times drawn
+ * uniformly in [1, 99].
+ */
+const Instance build_random_instance(
+        JobId number_of_jobs,
+        MachineId number_of_machines,
+        Objective objective = Objective::Makespan,
+        bool blocking = false,
+        std::mt19937_64::result_type seed = 0);
+
+/**
+ * Permutation flow shop instance with 6 jobs and 3 machines, in the
+ * "flow-shop" format.
+ */
+extern const std::string small_flow_shop_instance;
+
+/**
+ * Return an instance builder initialized from an instance in the "flow-shop"
+ * format.
+ */
+InstanceBuilder flow_shop_instance_builder(
+        const std::string& instance_content,
+        Objective objective = Objective::Makespan);
+
+/**
+ * Build a permutation flow shop instance from its content in the "flow-shop"
+ * format.
+ */
+const Instance build_flow_shop_instance(
+        const std::string& instance_content,
+        Objective objective = Objective::Makespan);
+
+/**
+ * Build the solution of a permutation flow shop instance in which the jobs
+ * are processed in the order of 'job_ids'.
+ */
+const Solution build_permutation_solution(
+        const Instance& instance,
+        const std::vector<JobId>& job_ids);
+
+/**
+ * Return the order in which the jobs are processed on the first machine.
+ */
+std::vector<JobId> permutation(
+        const Solution& solution);
+
 class ExactAlgorithmTest: public testing::TestWithParam<TestParams> { };
 class ExactNoSolutionAlgorithmTest: public testing::TestWithParam<TestParams> { };
 
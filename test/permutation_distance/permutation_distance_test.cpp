@@ -0,0 +1,100 @@
+#include "shopschedulingsolver/permutation_distance.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+PermutationAdjacency adjacency(
+        const std::vector<JobId>& jobs,
+        Counter sketch_size = 0)
+{
+    PermutationAdjacency adjacency;
+    compute_permutation_adjacency(jobs, jobs.size(), sketch_size, adjacency);
+    return adjacency;
+}
+
+std::vector<JobId> identity(JobId number_of_jobs)
+{
+    std::vector<JobId> jobs(number_of_jobs);
+    std::iota(jobs.begin(), jobs.end(), 0);
+    return jobs;
+}
+
+}
+
+TEST(PermutationDistance, Identical)
+{
+    std::vector<JobId> jobs = {3, 0, 4, 1, 5, 2};
+    EXPECT_EQ(permutation_distance(adjacency(jobs), adjacency(jobs)), 0);
+}
+
+TEST(PermutationDistance, Reversed)
+{
+    // All the predecessors and all the successors differ.
+    std::vector<JobId> jobs = identity(10);
+    std::vector<JobId> reversed_jobs(jobs.rbegin(), jobs.rend());
+    EXPECT_EQ(permutation_distance(adjacency(jobs), adjacency(reversed_jobs)), 20);
+}
+
+TEST(PermutationDistance, OneSwap)
+{
+    std::vector<JobId> jobs = identity(10);
+
+    // Swapping consecutive jobs 3 and 4 changes the successor of job 2, the
+    // predecessor of job 5 and both neighbors of jobs 3 and 4.
+    std::vector<JobId> jobs_consecutive = jobs;
+    std::swap(jobs_consecutive[3], jobs_consecutive[4]);
+    EXPECT_EQ(permutation_distance(adjacency(jobs), adjacency(jobs_consecutive)), 6);
+
+    // Swapping jobs 2 and 7 also changes a neighbor of jobs 1, 3, 6 and 8.
+    std::vector<JobId> jobs_apart = jobs;
+    std::swap(jobs_apart[2], jobs_apart[7]);
+    EXPECT_EQ(permutation_distance(adjacency(jobs), adjacency(jobs_apart)), 8);
+
+    // Swapping the first and the last jobs.
+    std::vector<JobId> jobs_ends = jobs;
+    std::swap(jobs_ends.front(), jobs_ends.back());
+    EXPECT_EQ(permutation_distance(adjacency(jobs), adjacency(jobs_ends)), 6);
+
+    // The distance is symmetric.
+    EXPECT_EQ(permutation_distance(adjacency(jobs_apart), adjacency(jobs)), 8);
+}
+
+TEST(PermutationDistance, Estimate)
+{
+    JobId number_of_jobs = 1000;
+    Counter sketch_size = 256;
+    std::mt19937_64 generator(0);
+    std::uniform_int_distribution<JobId> d_pos(0, number_of_jobs - 1);
+    std::vector<JobId> jobs = identity(number_of_jobs);
+    std::shuffle(jobs.begin(), jobs.end(), generator);
+    PermutationAdjacency adjacency_1 = adjacency(jobs, sketch_size);
+
+    // Identical permutations have identical sketches.
+    EXPECT_EQ(permutation_distance_estimate(
+                adjacency_1,
+                adjacency(jobs, sketch_size),
+                number_of_jobs), 0);
+
+    // From a few swaps to unrelated permutations.
+    for (Counter number_of_swaps: {10, 50, 200, 1000, 10000}) {
+        std::vector<JobId> jobs_2 = jobs;
+        for (Counter swap_id = 0; swap_id < number_of_swaps; ++swap_id)
+            std::swap(jobs_2[d_pos(generator)], jobs_2[d_pos(generator)]);
+        PermutationAdjacency adjacency_2 = adjacency(jobs_2, sketch_size);
+        Counter distance = permutation_distance(adjacency_1, adjacency_2);
+        Counter distance_estimate = permutation_distance_estimate(
+                adjacency_1,
+                adjacency_2,
+                number_of_jobs);
+        EXPECT_NEAR(distance_estimate, distance, 0.1 * 2 * (number_of_jobs + 1))
+            << "number_of_swaps: " << number_of_swaps;
+    }
+}
@@ -0,0 +1,251 @@
+#include "shopschedulingsolver/server.hpp"
+#include "shopschedulingsolver/instance_builder.hpp"
+#include "shopschedulingsolver/algorithms/tree_search_pfss_makespan.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+const std::string instance_content =
+    "4 3\n"
+    "5 2 7 3\n"
+    "4 6 1 8\n"
+    "3 5 2 6\n";
+
+Output solve(
+        const ServerSolve& solve)
+{
+    if (solve.algorithm == "tree-search-pfss-makespan") {
+        TreeSearchPfssMakespanParameters parameters;
+        solve.set_parameters(parameters);
+        return tree_search_pfss_makespan(*solve.instance, parameters);
+    } else if (solve.algorithm == "wait") {
+        // Run until cancelled.
+        while (!solve.parameters.timer.needs_to_end())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return Output(*solve.instance);
+    }
+    throw std::invalid_argument("unknown algorithm \"" + solve.algorithm + "\".");
+}
+
+class ServerTest: public testing::Test
+{
+
+protected:
+
+    void SetUp() override
+    {
+        ServerParameters parameters;
+        parameters.socket_path = socket_path_;
+        parameters.number_of_threads = 2;
+        server_.reset(new Server(parameters, solve));
+        thread_ = std::thread([this]() { server_->run(); });
+        while (!server_->listening())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        fd_ = connect();
+        ASSERT_GE(fd_, 0);
+    }
+
+    /** Open a new connection to the server; return -1 on failure. */
+    int connect()
+    {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void TearDown() override
+    {
+        ::close(fd_);
+        server_->stop();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    nlohmann::json receive()
+    {
+        nlohmann::json message;
+        EXPECT_TRUE(read_message(fd_, message));
+        return message;
+    }
+
+    nlohmann::json request(const nlohmann::json& message)
+    {
+        EXPECT_TRUE(write_message(fd_, message));
+        return receive();
+    }
+
+    std::string submit()
+    {
+        nlohmann::json reply = request({
+                {"type", "submit"},
+                {"format", "flow-shop"},
+                {"content", instance_content}});
+        EXPECT_EQ(reply["type"], "instance");
+        return reply["instance_id"];
+    }
+
+    std::string socket_path_ = "/tmp/shopschedulingsolver_server_test_" + std::to_string(::getpid()) + ".sock";
+
+    std::unique_ptr<Server> server_;
+
+    std::thread thread_;
+
+    int fd_ = -1;
+
+};
+
+}
+
+TEST_F(ServerTest, SubmitCached)
+{
+    nlohmann::json submit_request = {
+        {"type", "submit"},
+        {"format", "flow-shop"},
+        {"content", instance_content}};
+    nlohmann::json reply_1 = request(submit_request);
+    EXPECT_EQ(reply_1["type"], "instance");
+    EXPECT_EQ(reply_1["cached"], false);
+    nlohmann::json reply_2 = request(submit_request);
+    EXPECT_EQ(reply_2["instance_id"], reply_1["instance_id"]);
+    EXPECT_EQ(reply_2["cached"], true);
+
+    // A different objective gives a different instance.
+    submit_request["objective"] = "total-flow-time";
+    nlohmann::json reply_3 = request(submit_request);
+    EXPECT_NE(reply_3["instance_id"], reply_1["instance_id"]);
+    EXPECT_EQ(reply_3["cached"], false);
+}
+
+TEST_F(ServerTest, Connections)
+{
+    // The connections closed by the clients and the ones still open when the
+    // server stops are all ended before 'run' returns.
+    nlohmann::json submit_request = {
+        {"type", "submit"},
+        {"format", "flow-shop"},
+        {"content", instance_content}};
+    std::vector<int> fds;
+    for (Counter connection_id = 0; connection_id < 8; ++connection_id) {
+        int fd = connect();
+        ASSERT_GE(fd, 0);
+        EXPECT_TRUE(write_message(fd, submit_request));
+        nlohmann::json reply;
+        EXPECT_TRUE(read_message(fd, reply));
+        EXPECT_EQ(reply["type"], "instance");
+        fds.push_back(fd);
+    }
+    for (Counter connection_id = 0; connection_id < 4; ++connection_id)
+        ::close(fds[connection_id]);
+    server_->stop();
+    thread_.join();
+    for (Counter connection_id = 4; connection_id < 8; ++connection_id) {
+        nlohmann::json reply;
+        EXPECT_FALSE(read_message(fds[connection_id], reply));
+        ::close(fds[connection_id]);
+    }
+}
+
+TEST_F(ServerTest, Solve)
+{
+    std::stringstream content_ss(instance_content);
+    InstanceBuilder instance_builder;
+    instance_builder.read(content_ss, "flow-shop");
+    const Instance instance = instance_builder.build();
+    TreeSearchPfssMakespanParameters parameters;
+    parameters.verbosity_level = 0;
+    Output reference_output = tree_search_pfss_makespan(instance, parameters);
+
+    std::string instance_id = submit();
+    nlohmann::json reply = request({
+            {"type", "solve"},
+            {"instance_id", instance_id},
+            {"algorithm", "tree-search-pfss-makespan"},
+            {"time_limit", 10}});
+    ASSERT_EQ(reply["type"], "solve");
+    Counter solve_id = reply["solve_id"];
+
+    Counter number_of_solutions = 0;
+    for (;;) {
+        nlohmann::json message = receive();
+        ASSERT_EQ(message["solve_id"], solve_id);
+        if (message["type"] == "solution") {
+            number_of_solutions++;
+            continue;
+        }
+        ASSERT_EQ(message["type"], "end");
+        EXPECT_EQ(message["cancelled"], false);
+        EXPECT_EQ(message["output"]["Value"], reference_output.solution.objective_value());
+        EXPECT_EQ(message["output"]["Bound"], reference_output.bound());
+        break;
+    }
+    EXPECT_GE(number_of_solutions, 1);
+}
+
+TEST_F(ServerTest, Cancel)
+{
+    std::string instance_id = submit();
+    nlohmann::json reply = request({
+            {"type", "solve"},
+            {"instance_id", instance_id},
+            {"algorithm", "wait"}});
+    ASSERT_EQ(reply["type"], "solve");
+    Counter solve_id = reply["solve_id"];
+
+    EXPECT_TRUE(write_message(fd_, {{"type", "cancel"}, {"solve_id", solve_id}}));
+    bool cancel_received = false;
+    bool end_received = false;
+    while (!cancel_received || !end_received) {
+        nlohmann::json message = receive();
+        ASSERT_EQ(message["solve_id"], solve_id);
+        if (message["type"] == "cancel") {
+            cancel_received = true;
+        } else {
+            ASSERT_EQ(message["type"], "end");
+            EXPECT_EQ(message["cancelled"], true);
+            end_received = true;
+        }
+    }
+}
+
+TEST_F(ServerTest, Errors)
+{
+    nlohmann::json reply = request({
+            {"type", "solve"},
+            {"instance_id", "0000000000000000"},
+            {"algorithm", "tree-search-pfss-makespan"}});
+    EXPECT_EQ(reply["type"], "error");
+
+    reply = request({{"type", "unknown"}});
+    EXPECT_EQ(reply["type"], "error");
+
+    // An error of the algorithm is reported with the id of the solve.
+    std::string instance_id = submit();
+    reply = request({
+            {"type", "solve"},
+            {"instance_id", instance_id},
+            {"algorithm", "unknown"}});
+    ASSERT_EQ(reply["type"], "solve");
+    reply = receive();
+    EXPECT_EQ(reply["type"], "error");
+    EXPECT_EQ(reply["solve_id"], 0);
+}
@@ -0,0 +1,90 @@
+#include "tests.hpp"
+#include "shopschedulingsolver/solution_builder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+using namespace shopschedulingsolver;
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+
+Solution build_solution(
+        const Instance& instance)
+{
+    std::vector<JobId> job_ids;
+    for (JobId job_id = instance.number_of_jobs() - 1; job_id >= 0; --job_id)
+        job_ids.push_back(job_id);
+    return build_permutation_solution(instance, job_ids);
+}
+
+Solution read_solution(
+        const Instance& instance,
+        const std::string& certificate_path,
+        const std::string& format)
+{
+    SolutionBuilder solution_builder;
+    solution_builder.set_instance(instance);
+    solution_builder.read(certificate_path, format);
+    return solution_builder.build();
+}
+
+std::string certificate_path()
+{
+    return (fs::temp_directory_path() / fs::unique_path()).string();
+}
+
+}
+
+TEST(Solution, RoundTrip)
+{
+    const Instance instance = build_random_instance(6, 3);
+    const Solution solution = build_solution(instance);
+    for (std::string format: {"json", "json-compact", "csv", "binary"}) {
+        std::string path = certificate_path();
+        solution.write(path, format);
+        const Solution read_back_solution = read_solution(instance, path, format);
+        fs::remove(path);
+
+        EXPECT_EQ(read_back_solution.number_of_operations(), solution.number_of_operations()) << format;
+        for (JobId job_id = 0; job_id < instance.number_of_jobs(); ++job_id) {
+            const Solution::Job& solution_job = solution.job(job_id);
+            const Solution::Job& read_back_solution_job = read_back_solution.job(job_id);
+            ASSERT_EQ(read_back_solution_job.operations.size(), solution_job.operations.size()) << format;
+            for (OperationId operation_id = 0;
+                    operation_id < (OperationId)solution_job.operations.size();
+                    ++operation_id) {
+                EXPECT_EQ(
+                        read_back_solution.operation(read_back_solution_job.operations[operation_id]).start,
+                        solution.operation(solution_job.operations[operation_id]).start)
+                    << format;
+            }
+        }
+        EXPECT_TRUE(read_back_solution.feasible()) << format;
+        EXPECT_EQ(read_back_solution.objective_value(), solution.objective_value()) << format;
+    }
+}
+
+TEST(Solution, BinaryInstanceMismatch)
+{
+    const Instance instance = build_random_instance(6, 3);
+    const Solution solution = build_solution(instance);
+    std::string path = certificate_path();
+    solution.write(path, "binary");
+    const Instance other_instance = build_random_instance(5, 3);
+    EXPECT_THROW(read_solution(other_instance, path, "binary"), std::invalid_argument);
+    fs::remove(path);
+}
+
+TEST(Solution, UnknownFormat)
+{
+    const Instance instance = build_random_instance(6, 3);
+    const Solution solution = build_solution(instance);
+    std::string path = certificate_path();
+    EXPECT_THROW(solution.write(path, "xml"), std::invalid_argument);
+    EXPECT_FALSE(fs::exists(path));
+    EXPECT_FALSE(fs::exists(path + ".tmp"));
+}
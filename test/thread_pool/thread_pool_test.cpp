@@ -0,0 +1,189 @@
+#include "shopschedulingsolver/thread_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+using namespace shopschedulingsolver;
+
+namespace
+{
+
+/**
+ * Run groups of tasks nested on three levels and return the seeds drawn by
+ * the innermost tasks, indexed by their position in the tree.
+ */
+std::vector<std::mt19937_64::result_type> run_nested_task_groups(
+        ThreadPool& thread_pool)
+{
+    const Counter number_of_tasks = 4;
+    std::vector<std::mt19937_64::result_type> seeds(
+            number_of_tasks * number_of_tasks * number_of_tasks, 0);
+    std::mt19937_64 generator(0);
+    TaskGroup task_group(thread_pool, generator);
+    for (Counter task_id_1 = 0; task_id_1 < number_of_tasks; ++task_id_1) {
+        task_group.run([&seeds, &thread_pool, task_id_1](TaskContext& task_context_1)
+        {
+            EXPECT_EQ(task_context_1.task_id, task_id_1);
+            TaskGroup task_group_2(thread_pool, task_context_1.generator, task_context_1.timer);
+            for (Counter task_id_2 = 0; task_id_2 < number_of_tasks; ++task_id_2) {
+                task_group_2.run([&seeds, &thread_pool, task_id_1, task_id_2](TaskContext& task_context_2)
+                {
+                    TaskGroup task_group_3(thread_pool, task_context_2.generator, task_context_2.timer);
+                    for (Counter task_id_3 = 0; task_id_3 < number_of_tasks; ++task_id_3) {
+                        task_group_3.run([&seeds, task_id_1, task_id_2, task_id_3](TaskContext& task_context_3)
+                        {
+                            Counter pos = (task_id_1 * number_of_tasks + task_id_2) * number_of_tasks + task_id_3;
+                            seeds[pos] = task_context_3.generator();
+                        });
+                    }
+                    task_group_3.wait();
+                });
+            }
+            task_group_2.wait();
+        });
+    }
+    task_group.wait();
+    return seeds;
+}
+
+}
+
+TEST(ThreadPool, NestedTaskGroups)
+{
+    ThreadPool thread_pool_0(0);
+    std::vector<std::mt19937_64::result_type> seeds = run_nested_task_groups(thread_pool_0);
+    for (std::mt19937_64::result_type seed: seeds)
+        EXPECT_NE(seed, 0);
+
+    // The seeds do not depend on the threads running the tasks.
+    for (Counter number_of_threads: {1, 4}) {
+        ThreadPool thread_pool(number_of_threads);
+        EXPECT_EQ(thread_pool.number_of_threads(), number_of_threads);
+        EXPECT_EQ(run_nested_task_groups(thread_pool), seeds);
+    }
+}
+
+TEST(ThreadPool, Cancellation)
+{
+    ThreadPool thread_pool(2);
+    std::mt19937_64 generator(0);
+    bool end = false;
+    optimizationtools::Timer timer;
+    timer.add_end_boolean(&end);
+    std::atomic<Counter> number_of_started_tasks(0);
+    std::atomic<Counter> number_of_ended_tasks(0);
+
+    // Latch holding the tasks until the timer has ended. A worker waiting
+    // for the nested group of its task runs the nested task first, and the
+    // shared queue still holds tasks, so no task is stolen meanwhile: exactly
+    // one task per worker starts.
+    std::mutex latch_mutex;
+    std::condition_variable latch_condition;
+    Counter number_of_held_tasks = 0;
+    bool released = false;
+
+    TaskGroup task_group(thread_pool, generator, timer);
+    for (Counter task_id = 0; task_id < 8; ++task_id) {
+        task_group.run([&](TaskContext& task_context)
+        {
+            number_of_started_tasks++;
+            // Nested groups end with the timer of the task.
+            TaskGroup task_group_2(thread_pool, task_context.generator, task_context.timer);
+            task_group_2.run([&](TaskContext& task_context_2)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(latch_mutex);
+                    number_of_held_tasks++;
+                    latch_condition.notify_all();
+                    latch_condition.wait(lock, [&released]() { return released; });
+                }
+                while (!task_context_2.timer.needs_to_end())
+                    std::this_thread::yield();
+            });
+            task_group_2.wait();
+            number_of_ended_tasks++;
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(latch_mutex);
+        latch_condition.wait(lock, [&number_of_held_tasks]() { return number_of_held_tasks == 2; });
+        // The group ends with the timer it was given.
+        end = true;
+        released = true;
+    }
+    latch_condition.notify_all();
+    task_group.wait();
+    EXPECT_TRUE(task_group.timer().needs_to_end());
+    EXPECT_EQ(number_of_started_tasks, 2);
+    EXPECT_EQ(number_of_ended_tasks, 2);
+
+    // Cancelling a group does not end the timer it was given.
+    end = false;
+    TaskGroup task_group_2(thread_pool, generator, timer);
+    task_group_2.cancel();
+    Counter number_of_tasks_2 = 0;
+    task_group_2.run([&number_of_tasks_2](TaskContext&) { number_of_tasks_2++; });
+    task_group_2.wait();
+    EXPECT_TRUE(task_group_2.cancelled());
+    EXPECT_EQ(number_of_tasks_2, 0);
+    EXPECT_FALSE(timer.needs_to_end());
+}
+
+TEST(ThreadPool, Exception)
+{
+    ThreadPool thread_pool(2);
+    std::mt19937_64 generator(0);
+    TaskGroup task_group(thread_pool, generator);
+    for (Counter task_id = 0; task_id < 4; ++task_id) {
+        task_group.run([](TaskContext& task_context)
+        {
+            if (task_context.task_id == 2)
+                throw std::runtime_error("task 2");
+        });
+    }
+    EXPECT_THROW(task_group.wait(), std::runtime_error);
+    EXPECT_TRUE(task_group.cancelled());
+}
+
+TEST(ThreadPool, ProfileRun)
+{
+    ThreadPool thread_pool(2);
+    ProfileEntryId profile_entry_id = profile_register("ThreadPoolTest/ProfileRun");
+
+    // Two runs executed concurrently, whose tasks share the pool, only count
+    // their own tasks.
+    std::vector<Counter> counts(2, 0);
+    std::vector<std::thread> threads;
+    for (Counter run_id = 0; run_id < 2; ++run_id) {
+        threads.push_back(std::thread([&, run_id]()
+        {
+            ProfileRun profile_run;
+            {
+                ScopedProfileRun scoped_profile_run(&profile_run);
+                std::mt19937_64 generator(run_id);
+                TaskGroup task_group(thread_pool, generator);
+                for (Counter task_id = 0; task_id < 8 * (run_id + 1); ++task_id) {
+                    task_group.run([&thread_pool, profile_entry_id](TaskContext& task_context)
+                    {
+                        TaskGroup task_group_2(thread_pool, task_context.generator, task_context.timer);
+                        task_group_2.run([profile_entry_id](TaskContext&)
+                        {
+                            profile_add(profile_entry_id, 0, 1);
+                        });
+                        task_group_2.wait();
+                    });
+                }
+                task_group.wait();
+            }
+            EXPECT_EQ(profile_current_run(), nullptr);
+            counts[run_id] = profile_run.profile().entries[profile_entry_id].count;
+        }));
+    }
+    for (std::thread& thread: threads)
+        thread.join();
+    EXPECT_EQ(counts[0], 8);
+    EXPECT_EQ(counts[1], 16);
+}